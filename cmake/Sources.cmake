@@ -14,13 +14,21 @@ set(PROJECT_SOURCES
   ${CMAKE_SOURCE_DIR}/src/aboutdialog.h
   ${CMAKE_SOURCE_DIR}/src/analysis.cpp
   ${CMAKE_SOURCE_DIR}/src/analysis.h
+  ${CMAKE_SOURCE_DIR}/src/chartbatch.cpp
+  ${CMAKE_SOURCE_DIR}/src/chartbatch.h
+  ${CMAKE_SOURCE_DIR}/src/chartcolumn.cpp
+  ${CMAKE_SOURCE_DIR}/src/chartcolumn.h
   ${CMAKE_SOURCE_DIR}/src/chartviewer.cpp
   ${CMAKE_SOURCE_DIR}/src/chartviewer.h
+  ${CMAKE_SOURCE_DIR}/src/plotrenderer.cpp
+  ${CMAKE_SOURCE_DIR}/src/plotrenderer.h
   ${CMAKE_SOURCE_DIR}/src/plotwidget.cpp
   ${CMAKE_SOURCE_DIR}/src/plotwidget.h
   ${CMAKE_SOURCE_DIR}/src/plotseries.h
   ${CMAKE_SOURCE_DIR}/src/plotaxismath.cpp
   ${CMAKE_SOURCE_DIR}/src/plotaxismath.h
+  ${CMAKE_SOURCE_DIR}/src/plotdecimate.cpp
+  ${CMAKE_SOURCE_DIR}/src/plotdecimate.h
   ${CMAKE_SOURCE_DIR}/src/codeeditor.cpp
   ${CMAKE_SOURCE_DIR}/src/codeeditor.h
   ${CMAKE_SOURCE_DIR}/src/colormaps.cpp
@@ -30,6 +38,8 @@ set(PROJECT_SOURCES
   ${CMAKE_SOURCE_DIR}/src/tutorials.h
   ${CMAKE_SOURCE_DIR}/src/customfunc.cpp
   ${CMAKE_SOURCE_DIR}/src/customfunc.h
+  ${CMAKE_SOURCE_DIR}/src/decompress.cpp
+  ${CMAKE_SOURCE_DIR}/src/decompress.h
   ${CMAKE_SOURCE_DIR}/src/downloadprogress.cpp
   ${CMAKE_SOURCE_DIR}/src/downloadprogress.h
   ${CMAKE_SOURCE_DIR}/src/dumpimage.cpp
@@ -62,19 +72,29 @@ set(PROJECT_SOURCES
   ${CMAKE_SOURCE_DIR}/src/syntaxcheck.h
   ${CMAKE_SOURCE_DIR}/src/lammpswrapper.cpp
   ${CMAKE_SOURCE_DIR}/src/lammpswrapper.h
+  ${CMAKE_SOURCE_DIR}/src/largefileviewer.cpp
+  ${CMAKE_SOURCE_DIR}/src/largefileviewer.h
   ${CMAKE_SOURCE_DIR}/src/leastsquares.cpp
   ${CMAKE_SOURCE_DIR}/src/leastsquares.h
   ${CMAKE_SOURCE_DIR}/src/levmar.cpp
   ${CMAKE_SOURCE_DIR}/src/levmar.h
+  ${CMAKE_SOURCE_DIR}/src/lineindex.cpp
+  ${CMAKE_SOURCE_DIR}/src/lineindex.h
   ${CMAKE_SOURCE_DIR}/src/linenumberarea.h
   ${CMAKE_SOURCE_DIR}/src/logwindow.cpp
   ${CMAKE_SOURCE_DIR}/src/logwindow.h
   ${CMAKE_SOURCE_DIR}/src/movieimport.cpp
   ${CMAKE_SOURCE_DIR}/src/movieimport.h
+  ${CMAKE_SOURCE_DIR}/src/packedcolumn.cpp
+  ${CMAKE_SOURCE_DIR}/src/packedcolumn.h
+  ${CMAKE_SOURCE_DIR}/src/plotcache.cpp
+  ${CMAKE_SOURCE_DIR}/src/plotcache.h
   ${CMAKE_SOURCE_DIR}/src/plotdata.cpp
   ${CMAKE_SOURCE_DIR}/src/plotdata.h
   ${CMAKE_SOURCE_DIR}/src/plotdatadialog.cpp
   ${CMAKE_SOURCE_DIR}/src/plotdatadialog.h
+  ${CMAKE_SOURCE_DIR}/src/plotparse.cpp
+  ${CMAKE_SOURCE_DIR}/src/plotparse.h
   ${CMAKE_SOURCE_DIR}/src/preferences.cpp
   ${CMAKE_SOURCE_DIR}/src/preferences.h
   ${CMAKE_SOURCE_DIR}/src/qaddon.cpp
@@ -89,6 +109,8 @@ set(PROJECT_SOURCES
   ${CMAKE_SOURCE_DIR}/src/slideshow.h
   ${CMAKE_SOURCE_DIR}/src/stdcapture.cpp
   ${CMAKE_SOURCE_DIR}/src/stdcapture.h
+  ${CMAKE_SOURCE_DIR}/src/thermoparser.cpp
+  ${CMAKE_SOURCE_DIR}/src/thermoparser.h
   ${CMAKE_SOURCE_DIR}/src/tutorialwizard.cpp
   ${CMAKE_SOURCE_DIR}/src/tutorialwizard.h
   ${CMAKE_SOURCE_DIR}/src/urldownloader.cpp
@@ -101,6 +123,7 @@ qt6_add_resources(PROJECT_SOURCES resources/lammpsgui.qrc)
 # vendored, JIT-less subset of the Lepton expression parser (namespace
 # LeptonMini) used for custom-function plotting and nonlinear fits.
 add_library(lepton_mini STATIC
+  ${CMAKE_SOURCE_DIR}/thirdparty/lepton_mini/src/ArrayProgram.cpp
   ${CMAKE_SOURCE_DIR}/thirdparty/lepton_mini/src/ExpressionProgram.cpp
   ${CMAKE_SOURCE_DIR}/thirdparty/lepton_mini/src/ExpressionTreeNode.cpp
   ${CMAKE_SOURCE_DIR}/thirdparty/lepton_mini/src/Operation.cpp
@@ -11,6 +11,96 @@
 
 #include "analysis.h"
 
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <utility>
+
+namespace {
+
+using complex_vect = std::vector<std::complex<double>>;
+
+// M_PI is not standard C++ and not defined by MSVC by default
+constexpr double PI = 3.14159265358979323846;
+
+// In-place iterative radix-2 FFT; the length of data must be a power of two.
+// The inverse transform is not normalized.
+void fft(complex_vect &data, bool inverse)
+{
+    const std::size_t n = data.size();
+
+    // bit-reversal permutation
+    for (std::size_t i = 1, j = 0; i < n; ++i) {
+        std::size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(data[i], data[j]);
+    }
+
+    // twiddle factors for the full length, computed directly rather than by
+    // repeated multiplication to avoid accumulating round-off
+    const double sign = inverse ? 1.0 : -1.0;
+    complex_vect twiddle(n / 2);
+    for (std::size_t k = 0; k < n / 2; ++k)
+        twiddle[k] =
+            std::polar(1.0, sign * 2.0 * PI * static_cast<double>(k) / static_cast<double>(n));
+
+    // butterflies of growing length
+    for (std::size_t len = 2; len <= n; len <<= 1) {
+        const std::size_t half   = len / 2;
+        const std::size_t stride = n / len;
+        for (std::size_t i = 0; i < n; i += len) {
+            for (std::size_t k = 0; k < half; ++k) {
+                const std::complex<double> w = twiddle[k * stride];
+                const std::complex<double> u = data[i + k];
+                const std::complex<double> v = data[i + k + half] * w;
+                data[i + k]                  = u + v;
+                data[i + k + half]           = u - v;
+            }
+        }
+    }
+}
+
+// Unnormalized autocovariance sums sum_i d_i d_(i+k) for k = 0..maxlag from the
+// power spectrum of the zero-padded deviations (Wiener-Khinchin theorem).  The
+// padding to at least 2N points keeps the circular correlation from wrapping.
+std::vector<double> autocovarianceFFT(const std::vector<double> &d, int maxlag)
+{
+    std::size_t m = 1;
+    while (m < 2 * d.size())
+        m <<= 1;
+
+    complex_vect data(m);
+    for (std::size_t i = 0; i < d.size(); ++i)
+        data[i] = d[i];
+    fft(data, false);
+    for (auto &c : data)
+        c = std::norm(c);
+    fft(data, true);
+
+    std::vector<double> sums(maxlag + 1);
+    for (int k = 0; k <= maxlag; ++k)
+        sums[k] = data[k].real() / static_cast<double>(m);
+    return sums;
+}
+
+} // namespace
+
+void dropNonFinite(std::vector<double> &x, std::vector<double> &y)
+{
+    const std::size_t n = std::min(x.size(), y.size());
+    std::size_t kept    = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!std::isfinite(x[i]) || !std::isfinite(y[i])) continue;
+        x[kept] = x[i];
+        y[kept] = y[i];
+        ++kept;
+    }
+    x.resize(kept);
+    y.resize(kept);
+}
+
 std::vector<double> autocorrelation(const std::vector<double> &y, int maxlag)
 {
     const int n = static_cast<int>(y.size());
@@ -24,24 +114,223 @@ std::vector<double> autocorrelation(const std::vector<double> &y, int maxlag)
         mean += v;
     mean /= static_cast<double>(n);
 
-    // total variance (denominator); zero for a constant series
+    // deviations and total variance (denominator); zero for a constant series
+    std::vector<double> d(n);
     double denom = 0.0;
-    for (double v : y) {
-        const double d = v - mean;
-        denom += d * d;
+    for (int i = 0; i < n; ++i) {
+        d[i] = y[i] - mean;
+        denom += d[i] * d[i];
     }
     if (denom <= 0.0) return {};
 
+    // the direct sums cost about 2 N maxlag operations, the two FFTs about
+    // 10 M log2(M) for the padded length M; use whichever is cheaper
+    double m = 1.0;
+    while (m < 2.0 * n)
+        m *= 2.0;
+    const double directCost = 2.0 * static_cast<double>(n) * static_cast<double>(maxlag + 1);
+    const double fftCost    = 10.0 * m * std::log2(m);
+
     std::vector<double> acf(maxlag + 1, 0.0);
+    if (directCost > fftCost) {
+        const std::vector<double> sums = autocovarianceFFT(d, maxlag);
+        for (int k = 0; k <= maxlag; ++k)
+            acf[k] = sums[k] / denom;
+        return acf;
+    }
     for (int k = 0; k <= maxlag; ++k) {
         double num = 0.0;
         for (int i = 0; i + k < n; ++i)
-            num += (y[i] - mean) * (y[i + k] - mean);
+            num += d[i] * d[i + k];
         acf[k] = num / denom;
     }
     return acf;
 }
 
+std::vector<BlockAverage> blockAverages(const std::vector<double> &y)
+{
+    std::vector<BlockAverage> levels;
+    std::vector<double> means(y);
+    int blockSize = 1;
+    while (means.size() >= 2) {
+        const auto n = static_cast<double>(means.size());
+        double mean  = 0.0;
+        for (double v : means)
+            mean += v;
+        mean /= n;
+        double c0 = 0.0;
+        for (double v : means)
+            c0 += (v - mean) * (v - mean);
+        c0 /= n;
+
+        BlockAverage level;
+        level.blockSize  = blockSize;
+        level.blocks     = static_cast<int>(means.size());
+        level.error      = std::sqrt(c0 / (n - 1.0));
+        level.errorError = level.error / std::sqrt(2.0 * (n - 1.0));
+        levels.push_back(level);
+
+        // next level: average pairs of blocks, dropping an odd last one
+        const std::size_t half = means.size() / 2;
+        for (std::size_t i = 0; i < half; ++i)
+            means[i] = 0.5 * (means[2 * i] + means[(2 * i) + 1]);
+        means.resize(half);
+        blockSize *= 2;
+    }
+    return levels;
+}
+
+CorrelationTime correlationTime(const std::vector<double> &y)
+{
+    CorrelationTime result;
+    const int n = static_cast<int>(y.size());
+    const std::vector<double> acf = autocorrelation(y, n - 1);
+    if (acf.empty()) return result;
+
+    for (double v : y)
+        result.mean += v;
+    result.mean /= static_cast<double>(n);
+    for (double v : y)
+        result.variance += (v - result.mean) * (v - result.mean);
+    result.variance /= static_cast<double>(n - 1);
+
+    // Sokal's automatic windowing: stop summing once the window is long
+    // compared to the correlation time, where the ACF is mostly noise
+    constexpr double WINDOW_FACTOR = 5.0;
+    double tau = 0.5;
+    int window = 0;
+    for (int k = 1; k < n; ++k) {
+        tau += acf[k];
+        window = k;
+        if (static_cast<double>(k) >= WINDOW_FACTOR * tau) break;
+    }
+    // a noisy ACF can push the sum below the uncorrelated limit
+    result.tau          = std::max(tau, 0.5);
+    result.window       = window;
+    result.inefficiency = 2.0 * result.tau;
+    result.error = std::sqrt(result.inefficiency * result.variance / static_cast<double>(n));
+    result.ok    = true;
+    return result;
+}
+
+/* -------------------------------------------------------------------- */
+
+RunningStats::RunningStats(std::size_t window) : m_ring(std::max<std::size_t>(window, 1))
+{
+    reset();
+}
+
+void RunningStats::reset()
+{
+    m_count   = 0;
+    m_mean    = 0.0;
+    m_m2      = 0.0;
+    m_min     = 0.0;
+    m_max     = 0.0;
+    m_last    = 0.0;
+    m_head    = 0;
+    m_wcount  = 0;
+    m_wmean   = 0.0;
+    m_wm2     = 0.0;
+    m_removed = 0;
+}
+
+void RunningStats::add(double v)
+{
+    if (!std::isfinite(v)) return;
+
+    // Welford's update of the mean and the sum of squared deviations
+    ++m_count;
+    const double delta = v - m_mean;
+    m_mean += delta / static_cast<double>(m_count);
+    m_m2 += delta * (v - m_mean);
+    m_min  = (m_count == 1) ? v : std::min(m_min, v);
+    m_max  = (m_count == 1) ? v : std::max(m_max, v);
+    m_last = v;
+
+    // sliding window: drop the oldest sample once full, then add the new one
+    if (m_wcount == m_ring.size()) {
+        const double old = m_ring[m_head];
+        --m_wcount;
+        if (m_wcount == 0) {
+            m_wmean = 0.0;
+            m_wm2   = 0.0;
+        } else {
+            const double oldMean = m_wmean;
+            m_wmean -= (old - m_wmean) / static_cast<double>(m_wcount);
+            m_wm2 -= (old - oldMean) * (old - m_wmean);
+        }
+        ++m_removed;
+    }
+    m_ring[m_head] = v;
+    m_head         = (m_head + 1) % m_ring.size();
+    ++m_wcount;
+    const double wdelta = v - m_wmean;
+    m_wmean += wdelta / static_cast<double>(m_wcount);
+    m_wm2 += wdelta * (v - m_wmean);
+
+    // removing samples is less stable than adding them; recomputing the window
+    // sums once per window length bounds the round-off at O(1) amortized cost
+    if (m_removed >= m_ring.size()) resyncWindow();
+}
+
+void RunningStats::resyncWindow()
+{
+    m_wmean = 0.0;
+    for (std::size_t i = 0; i < m_wcount; ++i)
+        m_wmean += m_ring[i];
+    m_wmean /= static_cast<double>(m_wcount);
+    m_wm2 = 0.0;
+    for (std::size_t i = 0; i < m_wcount; ++i)
+        m_wm2 += (m_ring[i] - m_wmean) * (m_ring[i] - m_wmean);
+    m_removed = 0;
+}
+
+double RunningStats::mean() const
+{
+    return (m_count > 0) ? m_mean : std::nan("");
+}
+
+double RunningStats::variance() const
+{
+    return (m_count > 1) ? m_m2 / static_cast<double>(m_count - 1) : std::nan("");
+}
+
+double RunningStats::stddev() const
+{
+    return std::sqrt(std::max(variance(), 0.0));
+}
+
+double RunningStats::min() const
+{
+    return (m_count > 0) ? m_min : std::nan("");
+}
+
+double RunningStats::max() const
+{
+    return (m_count > 0) ? m_max : std::nan("");
+}
+
+double RunningStats::last() const
+{
+    return (m_count > 0) ? m_last : std::nan("");
+}
+
+double RunningStats::windowMean() const
+{
+    return (m_wcount > 0) ? m_wmean : std::nan("");
+}
+
+double RunningStats::windowVariance() const
+{
+    return (m_wcount > 1) ? m_wm2 / static_cast<double>(m_wcount - 1) : std::nan("");
+}
+
+double RunningStats::windowStddev() const
+{
+    return std::sqrt(std::max(windowVariance(), 0.0));
+}
+
 // Local Variables:
 // c-basic-offset: 4
 // End:
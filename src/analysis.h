@@ -12,12 +12,27 @@
 #ifndef ANALYSIS_H
 #define ANALYSIS_H
 
-// Small, self-contained (Qt-free) post-processing analyses on a data series.
-// Pure functions on std::vector<double> so they can be unit-tested without a
-// GUI and reused by the chart post-processing dialog.
+// Small, self-contained (Qt-free) post-processing analyses on a data series:
+// the autocorrelation function and statistical error estimates for the mean
+// of correlated data (block averaging and integrated correlation time), plus
+// running statistics updated as samples arrive.  Pure functions on
+// std::vector<double> and plain value types so they can be unit-tested without
+// a GUI and reused by the chart window and its post-processing dialog.
 
+#include <cstddef>
 #include <vector>
 
+/**
+ * @brief Remove the (x, y) pairs in which either value is not finite
+ * @param x X values; shortened in place
+ * @param y Y values, paired with @p x by index; shortened in place
+ *
+ * Cells of a merged data table that a run never filled are NaN; an analysis
+ * fed such a pair would silently return NaN results.  Keeps the order of the
+ * remaining pairs.  If the vectors differ in length the excess is dropped.
+ */
+void dropNonFinite(std::vector<double> &x, std::vector<double> &y);
+
 /**
  * @brief Normalized autocorrelation function (ACF) of a data series
  * @param y      Input samples (assumed equally spaced)
@@ -33,6 +48,127 @@
  */
 std::vector<double> autocorrelation(const std::vector<double> &y, int maxlag);
 
+/**
+ * @brief Standard error of the mean estimated from blocks of one size
+ */
+struct BlockAverage {
+    int blockSize     = 0;   ///< number of consecutive samples averaged into one block
+    int blocks        = 0;   ///< number of blocks
+    double error      = 0.0; ///< standard error of the mean estimated from the block means
+    double errorError = 0.0; ///< statistical uncertainty of @c error
+};
+
+/**
+ * @brief Block averaging analysis of a correlated data series
+ * @param y Input samples (assumed equally spaced)
+ * @return One entry per blocking level, for block sizes 1, 2, 4, ... as long
+ *         as at least two blocks remain; empty if the input has fewer than two
+ *         samples
+ *
+ * Uses the blocking transformation of Flyvbjerg and Petersen: each level
+ * averages pairs of the previous level's block means (dropping an odd last
+ * one), and the error of the mean is estimated as if the block means were
+ * independent.  For correlated data the estimate grows with the block size
+ * and levels off at the true error once the blocks are longer than the
+ * correlation time.  The whole analysis costs O(N).
+ */
+std::vector<BlockAverage> blockAverages(const std::vector<double> &y);
+
+/**
+ * @brief Mean and its error of a correlated data series from the integrated
+ *        autocorrelation time
+ */
+struct CorrelationTime {
+    bool ok             = false; ///< false if the input is too short or constant
+    double mean         = 0.0;   ///< sample mean
+    double variance     = 0.0;   ///< sample variance (unbiased)
+    double tau          = 0.5;   ///< integrated autocorrelation time, in samples
+    double inefficiency = 1.0;   ///< statistical inefficiency g = 2 tau
+    double error        = 0.0;   ///< standard error of the mean, sqrt(g variance / N)
+    int window          = 0;     ///< number of ACF lags summed for tau
+};
+
+/**
+ * @brief Integrated autocorrelation time and statistical inefficiency of a series
+ * @param y Input samples (assumed equally spaced)
+ * @return Correlation time, statistical inefficiency, and error of the mean
+ *
+ * Computes @f$ \tau = \frac{1}{2} + \sum_{k=1}^{M}\mathrm{ACF}(k) @f$ from the
+ * autocorrelation() of the whole series, with Sokal's automatic window: the
+ * smallest M with @f$ M \ge 5\tau(M) @f$.  The number of effectively
+ * independent samples is N / g with @f$ g = 2\tau @f$.
+ */
+CorrelationTime correlationTime(const std::vector<double> &y);
+
+/**
+ * @brief Statistics of a data series that are updated as samples are appended
+ *
+ * Keeps the count, mean, variance (Welford's algorithm), minimum, maximum, and
+ * last value of all samples, and the mean and variance of the most recent
+ * samples in a sliding window.  Every add() costs O(1), so live charts can
+ * show the statistics without rescanning their data; comparing the window
+ * mean with the overall mean tells whether a property is still drifting.
+ */
+class RunningStats {
+public:
+    /**
+     * @brief Constructor
+     * @param window Number of most recent samples in the sliding window (at least 1)
+     */
+    explicit RunningStats(std::size_t window = 100);
+
+    /**
+     * @brief Include one sample
+     * @param v Sample value; non-finite values are ignored
+     */
+    void add(double v);
+
+    /** @brief Forget all samples, keeping the window size */
+    void reset();
+
+    /** @brief Number of samples */
+    std::size_t count() const { return m_count; }
+    /** @brief Mean of all samples (NaN if there are none) */
+    double mean() const;
+    /** @brief Unbiased variance of all samples (NaN for fewer than two) */
+    double variance() const;
+    /** @brief Standard deviation of all samples (NaN for fewer than two) */
+    double stddev() const;
+    /** @brief Smallest sample (NaN if there are none) */
+    double min() const;
+    /** @brief Largest sample (NaN if there are none) */
+    double max() const;
+    /** @brief Most recent sample (NaN if there are none) */
+    double last() const;
+
+    /** @brief Size of the sliding window */
+    std::size_t window() const { return m_ring.size(); }
+    /** @brief Number of samples currently in the sliding window */
+    std::size_t windowCount() const { return m_wcount; }
+    /** @brief Mean of the samples in the window (NaN if there are none) */
+    double windowMean() const;
+    /** @brief Unbiased variance of the samples in the window (NaN for fewer than two) */
+    double windowVariance() const;
+    /** @brief Standard deviation of the samples in the window (NaN for fewer than two) */
+    double windowStddev() const;
+
+private:
+    /// Recompute the window mean and sum of squares from the stored samples
+    void resyncWindow();
+
+    std::size_t m_count;        ///< number of samples
+    double m_mean;              ///< running mean
+    double m_m2;                ///< running sum of squared deviations from the mean
+    double m_min, m_max;        ///< extreme samples
+    double m_last;              ///< most recent sample
+    std::vector<double> m_ring; ///< samples in the window (ring buffer)
+    std::size_t m_head;         ///< ring position of the next sample
+    std::size_t m_wcount;       ///< number of samples in the window
+    double m_wmean;             ///< window mean
+    double m_wm2;               ///< window sum of squared deviations from the mean
+    std::size_t m_removed;      ///< samples dropped from the window since the last resync
+};
+
 #endif
 
 // Local Variables:
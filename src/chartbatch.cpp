@@ -0,0 +1,291 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "chartbatch.h"
+
+#include "helpers.h"
+#include "leastsquares.h"
+#include "plotdata.h"
+#include "plotrenderer.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QImage>
+#include <QPainter>
+#include <QRegularExpression>
+#include <QSvgGenerator>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// serializes the progress and error messages of the worker threads
+std::mutex messageMutex;
+
+void report(const QString &msg)
+{
+    const std::lock_guard<std::mutex> lock(messageMutex);
+    std::fprintf(stderr, "%s\n", msg.toLocal8Bit().constData());
+    std::fflush(stderr);
+}
+
+// Resolve a column given by name or 1-based index; -1 if there is no such column.
+int findColumn(const QStringList &names, const QString &spec)
+{
+    const int byName = static_cast<int>(names.indexOf(spec));
+    if (byName >= 0) return byName;
+    bool ok         = false;
+    const int index = spec.toInt(&ok);
+    if (ok && (index >= 1) && (index <= names.size())) return index - 1;
+    return -1;
+}
+
+// Replace characters that are not safe in file names (e.g. "/" in "v_a/b").
+QString fileNamePart(const QString &name)
+{
+    QString part = name;
+    for (auto &c : part) {
+        if (!c.isLetterOrNumber() && !QStringLiteral("_.+-[]").contains(c)) c = QLatin1Char('_');
+    }
+    return part;
+}
+
+// Draw the chart on any paint device (image or SVG generator).
+bool paintChart(const PlotRenderer &plot, QPaintDevice *device, const QSize &size)
+{
+    QPainter p;
+    if (!p.begin(device)) return false;
+    plot.render(p, QRectF(QPointF(0.0, 0.0), QSizeF(size)));
+    return p.end();
+}
+
+// Render all selected y columns of one file with the worker's PlotRenderer,
+// parsing the file with the given number of threads (0: one per core).
+// Returns false if the file could not be read or an image could not be written.
+bool renderFile(PlotRenderer &plot, const ChartBatchOptions &opts, const QString &file,
+                const QString &outStem, int parseThreads)
+{
+    // the x and y columns are chosen from the column names, and only those are
+    // loaded: column 0 of the data is the x column, the others are the y columns
+    QString missing;
+    auto chooseColumns = [&](const QStringList &names) {
+        const int xcol = opts.xcol.isEmpty() ? 0 : findColumn(names, opts.xcol);
+        if (xcol < 0) {
+            missing = opts.xcol;
+            return QList<int>();
+        }
+        QList<int> columns{xcol};
+        if (opts.ycols.isEmpty()) {
+            for (int c = 0; c < names.size(); ++c)
+                if (c != xcol) columns << c;
+            // a single-column file is plotted against itself, as in the chart window
+            if (columns.size() == 1) columns << xcol;
+        } else {
+            for (const auto &spec : opts.ycols) {
+                const int c = findColumn(names, spec);
+                if (c < 0) {
+                    missing = spec;
+                    return QList<int>();
+                }
+                columns << c;
+            }
+        }
+        return columns;
+    };
+
+    QString error;
+    const PlotData data = loadPlotColumns(file, chooseColumns, &error, nullptr, parseThreads);
+    if (!missing.isEmpty()) {
+        report(QString("%1: no column \"%2\"").arg(file, missing));
+        return false;
+    }
+    if (data.isEmpty()) {
+        report(QString("%1: could not read data: %2").arg(file, error));
+        return false;
+    }
+    const int xcol = 0;
+    QList<int> ycols;
+    for (int c = 1; c < data.columnCount(); ++c)
+        ycols << c;
+
+    const bool smoothing = (opts.smoothWindow > 0);
+    const bool wantLines = (opts.mode != ChartDisplayMode::Points);
+    const bool wantDots  = (opts.mode != ChartDisplayMode::Lines);
+    const QSize size(opts.width, opts.height);
+    bool ok = true;
+    for (int ycol : ycols) {
+        // the raw data is a view of the parsed table; the smoothed data owns its points
+        std::vector<std::unique_ptr<PlotSeries>> series;
+        auto addSeries = [&](const PlotSeries &proto, const QColor &color) {
+            if (wantLines) {
+                series.push_back(std::make_unique<PlotSeries>(proto));
+                series.back()->color = color;
+                series.back()->width = opts.lineWidth;
+            }
+            if (wantDots) {
+                series.push_back(std::make_unique<PlotSeries>(proto));
+                series.back()->type       = PlotSeriesType::Scatter;
+                series.back()->color      = color;
+                series.back()->markerSize = opts.pointSize;
+            }
+        };
+
+        ChartBounds bounds;
+        PlotSeries raw;
+        raw.setView(&data, xcol, ycol);
+        raw.name = data.columnName(ycol);
+        for (int i = 0; i < raw.count(); ++i)
+            bounds.extend(raw.x(i), raw.y(i));
+        if (!smoothing || opts.showRaw) addSeries(raw, opts.rawColor);
+
+        if (smoothing) {
+            const int n = raw.count();
+            // as in the chart window, short series shrink the window to fit
+            const int window =
+                (n < ((2 * opts.smoothWindow) + 2)) ? (n / 2) - 1 : opts.smoothWindow;
+            PlotSeries smooth;
+            smooth.name = QStringLiteral("Smooth");
+            if (window > 1) {
+                const float_vect out = sg_smooth(data.column(ycol), window, opts.smoothOrder);
+                for (int i = 0; i < n; ++i)
+                    smooth.append(raw.x(i), out[i]);
+            } else {
+                for (int i = 0; i < n; ++i)
+                    smooth.append(raw.x(i), raw.y(i));
+            }
+            for (int i = 0; i < n; ++i)
+                bounds.extend(smooth.x(i), smooth.y(i));
+            addSeries(smooth, opts.smoothColor);
+        }
+
+        plot.clearSeries();
+        for (const auto &s : series)
+            plot.addSeries(s.get());
+        const QRectF range = chartRange(bounds);
+        plot.setXRange(range.left(), range.right());
+        plot.setYRange(range.bottom(), range.top());
+        plot.setTitle(QFileInfo(file).fileName());
+        plot.setXTitle(data.columnName(xcol));
+        plot.setYTitle(data.columnName(ycol));
+
+        const QString outName =
+            QString("%1.%2.%3").arg(outStem, fileNamePart(data.columnName(ycol)), opts.format);
+        bool written = false;
+        if (opts.format == QLatin1String("svg")) {
+            QSvgGenerator svg;
+            svg.setFileName(outName);
+            svg.setSize(size);
+            svg.setViewBox(QRect(QPoint(0, 0), size));
+            svg.setTitle(plot.yTitle());
+            written = paintChart(plot, &svg, size);
+        } else {
+            QImage image(size, QImage::Format_ARGB32_Premultiplied);
+            image.fill(Qt::white);
+            written = paintChart(plot, &image, size) && image.save(outName, "PNG");
+        }
+        plot.clearSeries();
+        if (written) {
+            report(QString("%1 -> %2").arg(file, outName));
+        } else {
+            report(QString("%1: could not write %2").arg(file, outName));
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+} // namespace
+
+QStringList expandFileArguments(const QStringList &args)
+{
+    static const QRegularExpression wildcard(QStringLiteral("[*?\\[]"));
+    QStringList files;
+    for (const auto &arg : args) {
+        const QFileInfo info(arg);
+        if (info.exists() || !info.fileName().contains(wildcard)) {
+            files << arg;
+            continue;
+        }
+        QDir dir = info.dir();
+        const QStringList matches =
+            dir.entryList({info.fileName()}, QDir::Files | QDir::Readable, QDir::Name);
+        if (matches.isEmpty()) {
+            files << arg; // reported as unreadable later
+            continue;
+        }
+        for (const auto &match : matches)
+            files << dir.filePath(match);
+    }
+    return files;
+}
+
+int runChartBatch(const ChartBatchOptions &opts)
+{
+    const int nfiles = static_cast<int>(opts.files.size());
+    if (nfiles == 0) return 0;
+
+    // output names: next to the input file, or in the output directory; inputs
+    // sharing a stem there (e.g. run*/ave.dat) are told apart by their folder
+    QStringList stems;
+    QHash<QString, int> stemCount;
+    for (const auto &file : opts.files) {
+        stems << defaultFileStem(file);
+        ++stemCount[stems.back()];
+    }
+    QStringList outStems;
+    for (int i = 0; i < nfiles; ++i) {
+        const QFileInfo info(opts.files[i]);
+        if (opts.outdir.isEmpty()) {
+            outStems << info.dir().filePath(stems[i]);
+        } else {
+            QString stem = stems[i];
+            if (stemCount[stem] > 1) stem = info.absoluteDir().dirName() + "_" + stem;
+            outStems << QDir(opts.outdir).filePath(stem);
+        }
+    }
+
+    int nthreads = (opts.jobs > 0) ? opts.jobs : QThread::idealThreadCount();
+    nthreads     = std::max(1, std::min(nthreads, nfiles));
+
+    // each worker configures and paints its own PlotRenderer into a QImage or
+    // SVG generator; no QWidget is involved, as those are GUI-thread only.
+    // Parallel workers parse their files single-threaded, so the parser does
+    // not start another thread per core inside each of them.
+    const int parseThreads = (nthreads > 1) ? 1 : 0;
+    std::atomic<int> next{0};
+    std::atomic<int> failed{0};
+    auto worker = [&]() {
+        PlotRenderer plot;
+        for (int i = next++; i < nfiles; i = next++) {
+            if (!renderFile(plot, opts, opts.files[i], outStems[i], parseThreads)) ++failed;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 1; i < nthreads; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (auto &t : threads)
+        t.join();
+
+    return failed;
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,76 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CHARTBATCH_H
+#define CHARTBATCH_H
+
+// Headless rendering of plot data files to PNG or SVG images for the
+// --batch command-line mode.  The charts are drawn with the same PlotRenderer
+// as the chart window, but no widget is ever created, so this works under the
+// "offscreen" Qt platform plugin without a display.
+
+#include "chartcolumn.h" // ChartDisplayMode
+
+#include <QColor>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Settings of a batch chart rendering run
+ */
+struct ChartBatchOptions {
+    QStringList files;                               ///< Input data files
+    QString xcol;                                    ///< X column name or 1-based index
+    QStringList ycols;                               ///< Y column names or indices (empty: all)
+    QString format;                                  ///< Output image format, "png" or "svg"
+    QString outdir;                                  ///< Output directory (empty: input's)
+    int width        = 800;                          ///< Image width in pixels
+    int height       = 600;                          ///< Image height in pixels
+    int smoothWindow = 0;                            ///< Smoothing half window (0: no smoothing)
+    int smoothOrder  = 4;                            ///< Smoothing polynomial order
+    bool showRaw     = true;                         ///< Draw raw data next to the smoothed
+    ChartDisplayMode mode = ChartDisplayMode::Lines; ///< How the data is drawn
+    qreal lineWidth       = 2.0;                     ///< Line width
+    qreal pointSize       = 6.0;                     ///< Marker diameter
+    QColor rawColor;                                 ///< Raw data color
+    QColor smoothColor;                              ///< Smoothed data color
+    int jobs = 0;                                    ///< Number of worker threads (0: one per core)
+};
+
+/**
+ * @brief Expand wildcard patterns in a list of file arguments
+ * @param args File names or patterns with *, ?, or [...] in the file name part
+ * @return Matching files in sorted order per pattern; patterns without a
+ *         match and plain names are passed through unchanged
+ *
+ * Shells usually expand patterns themselves, but quoted patterns (or shells
+ * that do not, e.g. on Windows) would otherwise hit command-line length
+ * limits or reach the program unexpanded.
+ */
+QStringList expandFileArguments(const QStringList &args);
+
+/**
+ * @brief Render one image per input file and y column
+ * @param opts Batch settings
+ * @return Number of input files that could not be read or written
+ *
+ * Images are named "<stem>.<ycolumn>.<format>" after the input file, the same
+ * default name the chart window uses for "Save Graph As...".  The files are
+ * processed in parallel; progress and errors are reported on stderr.  Must be
+ * called from the GUI thread with a QApplication instance.
+ */
+int runChartBatch(const ChartBatchOptions &opts);
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,711 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "chartcolumn.h"
+
+#include "constants.h"
+#include "plotwidget.h"
+
+#include <QBrush>
+#include <QSettings>
+#include <QVBoxLayout>
+
+#include <cmath>
+
+namespace {
+
+// Widen a (near) empty [lo, hi] range to a small symmetric/relative band so the
+// axis is never degenerate. Shared by the X and Y branches of getMinMax().
+void padEmptyRange(double &lo, double &hi)
+{
+    // compare against the magnitude: dividing by a signed hi made the test
+    // true for every all-negative range, padding ranges that were not empty
+    const double delta = hi - lo;
+    if ((delta / ((hi == 0.0) ? 1.0 : fabs(hi))) < 1.0e-10) {
+        if ((lo == 0.0) || (hi == 0.0)) {
+            lo = -0.025;
+            hi = 0.025;
+        } else {
+            lo -= 0.025 * fabs(lo);
+            hi += 0.025 * fabs(hi);
+        }
+    }
+}
+
+// brush color index must be kept in sync with preferences
+
+const QList<QBrush> mybrushes = {
+    QBrush(QColor(0, 0, 0)),       // black
+    QBrush(QColor(100, 150, 255)), // blue
+    QBrush(QColor(255, 125, 125)), // red
+    QBrush(QColor(100, 200, 100)), // green
+    QBrush(QColor(120, 120, 120)), // grey
+};
+
+} // namespace
+
+/* -------------------------------------------------------------------- */
+
+bool ChartBounds::extend(double x, double y)
+{
+    if (!std::isfinite(x) || !std::isfinite(y)) return false;
+    xmin = qMin(xmin, x);
+    xmax = qMax(xmax, x);
+    ymin = qMin(ymin, y);
+    ymax = qMax(ymax, y);
+    return true;
+}
+
+void ChartBounds::extend(const ChartBounds &other)
+{
+    xmin = qMin(xmin, other.xmin);
+    xmax = qMax(xmax, other.xmax);
+    ymin = qMin(ymin, other.ymin);
+    ymax = qMax(ymax, other.ymax);
+}
+
+void ChartBounds::extend(const QList<QPointF> &points)
+{
+    for (const auto &p : points)
+        extend(p.x(), p.y());
+}
+
+QRectF chartRange(ChartBounds b)
+{
+    // avoid (nearly) empty ranges on either axis
+    padEmptyRange(b.xmin, b.xmax);
+    padEmptyRange(b.ymin, b.ymax);
+
+    // add a little buffer space between the data extremes and the y-axis limits;
+    // a tighter framing is still available through the range sliders
+    const double ypad = Cfg::CHART_YPAD_FRACTION * (b.ymax - b.ymin);
+    b.ymin -= ypad;
+    b.ymax += ypad;
+
+    return {b.xmin, b.ymax, b.xmax - b.xmin, b.ymin - b.ymax};
+}
+
+void chartDefaultColors(QColor &raw, QColor &smooth)
+{
+    QSettings settings;
+    settings.beginGroup(Keys::GROUP_CHARTS);
+    int rawidx    = settings.value(Keys::RAWBRUSH, 1).toInt();
+    int smoothidx = settings.value(Keys::SMOOTHBRUSH, 2).toInt();
+    if ((rawidx < 0) || (rawidx >= mybrushes.size())) rawidx = 0;
+    if ((smoothidx < 0) || (smoothidx >= mybrushes.size())) smoothidx = 0;
+    settings.endGroup();
+    raw    = mybrushes[rawidx].color();
+    smooth = mybrushes[smoothidx].color();
+}
+
+/* -------------------------------------------------------------------- */
+
+// ---- column rendering pipeline ------------------------------------------
+// These free functions render a ChartColumn onto a given PlotWidget. They are
+// deliberately independent of any particular ChartViewer instance so that the
+// single shared PlotWidget can be pointed at any column. ChartViewer's methods
+// below are thin forwarders onto them.
+
+namespace {
+
+// Savitzky-Golay smoothing of a column's raw series into its smooth series: the
+// y values are smoothed via the shared least-squares core while the x values are
+// preserved.  The column keeps the smoother between calls, so when points were
+// only appended just the last few smoothed points are recomputed.
+void smoothColumn(ChartColumn &col)
+{
+    const PlotSeries &input = *col.series;
+    // trailing cells that are not filled in yet are smoothed once they are
+    int ndat = input.count();
+    while ((ndat > 0) && (!std::isfinite(input.x(ndat - 1)) || !std::isfinite(input.y(ndat - 1))))
+        --ndat;
+    const int window = (ndat < ((2 * col.window) + 2)) ? (ndat / 2) - 1 : col.window;
+
+    QList<QPointF> &rv = col.smooth->edit();
+    if (window <= 1) {
+        col.smoother.reset();
+        col.smoothBounds  = ChartBounds();
+        col.smoothSettled = 0;
+        rv.resize(ndat);
+        for (int i = 0; i < ndat; ++i)
+            rv[i] = input.at(i);
+        return;
+    }
+
+    // filter coefficients are computed once per (window, order)
+    if (!col.smoother || (col.smoother->width() != static_cast<std::size_t>(window)) ||
+        (col.smoother->degree() != col.order))
+        col.smoother = std::make_unique<SGSmoother>(window, col.order);
+
+    // a column in full precision is read in place; otherwise only the samples
+    // the smoother reads are copied, i.e. the tail around the new points
+    float_vect copy;
+    const double *in  = nullptr;
+    std::size_t start = 0;
+    if (input.isView() && (input.table->packing(input.ycol) == ColumnPacking::Double)) {
+        in = input.table->column(input.ycol).data();
+    } else {
+        start = col.smoother->inputStart(ndat);
+        copy.resize(ndat - start);
+        if (input.isView()) {
+            input.table->packedColumn(input.ycol).decode(start, copy.size(), copy.data());
+        } else {
+            for (int i = static_cast<int>(start); i < ndat; ++i)
+                copy[i - start] = input.y(i);
+        }
+        in = copy.data();
+    }
+    const auto first      = static_cast<int>(col.smoother->update(in, ndat, start));
+    const float_vect &out = col.smoother->values();
+    rv.resize(ndat);
+    for (int i = first; i < ndat; ++i)
+        rv[i] = QPointF(input.x(i), out[i]);
+
+    // points before the first changed one stay put while data is appended;
+    // collect their bounds once so columnMinMax() only scans the tail
+    if (first < col.smoothSettled) {
+        col.smoothBounds  = ChartBounds();
+        col.smoothSettled = 0;
+    }
+    for (int i = col.smoothSettled; i < first; ++i)
+        col.smoothBounds.extend(rv[i].x(), rv[i].y());
+    col.smoothSettled = first;
+}
+
+// Min/max of a column: the cached raw bounds plus any smoothed, fit, or overlay
+// curves, widened by a small y margin so extrema are not drawn on the plot
+// frame itself. All bounds are cached when the curves change, only the few
+// smoothed points that may still change are scanned. Pure -- touches no PlotWidget.
+QRectF columnMinMax(const ChartColumn &col)
+{
+    ChartBounds b = col.raw;
+
+    // if plotting the smoothed data, include its range too
+    if (col.doSmooth && col.smooth) {
+        b.extend(col.smoothBounds);
+        const auto &points = col.smooth->points;
+        for (int i = col.smoothSettled; i < static_cast<int>(points.size()); ++i)
+            b.extend(points[i].x(), points[i].y());
+    }
+
+    // include any visible fit/overlay curve (EOS, polynomial, custom)
+    if (col.fit && col.fit->isVisible() && !col.fit->points.isEmpty()) b.extend(col.fitBounds);
+
+    // include extra overlay data series added from secondary files
+    for (std::size_t i = 0; i < col.overlaySeries.size(); ++i) {
+        if (col.overlaySeries[i] && col.overlaySeries[i]->isVisible())
+            b.extend(col.overlayBounds[i]);
+    }
+    // note: vlines (reference lines) are decorative and excluded
+
+    return chartRange(b);
+}
+
+// Register a series on the plot with the given color/width.
+void addColumnSeries(PlotWidget *plot, PlotSeries *s, const QColor &color, qreal width)
+{
+    s->color = color;
+    if (s->type == PlotSeriesType::Line) s->width = width;
+    plot->addSeries(s);
+}
+
+// Restyle an already-registered series and repaint.
+void styleColumnSeries(PlotWidget *plot, PlotSeries *s, const QColor &color, qreal width)
+{
+    s->color = color;
+    if (s->type == PlotSeriesType::Line) s->width = width;
+    plot->update();
+}
+
+// Draw a line series and, per the display mode, an accompanying scatter series
+// (created on demand and kept in sync with the line).
+void renderColumnSeries(PlotWidget *plot, PlotSeries *line, std::unique_ptr<PlotSeries> &points,
+                        ChartDisplayMode mode, const QColor &color, qreal width, qreal pointSize)
+{
+    const bool wantLines  = (mode != ChartDisplayMode::Points);
+    const bool wantPoints = (mode != ChartDisplayMode::Lines);
+
+    // line series
+    if (!plot->hasSeries(line))
+        addColumnSeries(plot, line, color, width);
+    else
+        styleColumnSeries(plot, line, color, width);
+    line->setVisible(wantLines);
+
+    // matching points, created on demand and kept in sync with the line
+    if (wantPoints) {
+        if (!points) {
+            points       = std::make_unique<PlotSeries>();
+            points->type = PlotSeriesType::Scatter;
+        }
+        points->name = line->name; // share the line's name so the legend dedups them
+        if (line->isView()) {
+            // re-binding the same view would make the plot repaint all markers
+            if ((points->table != line->table) || (points->xcol != line->xcol) ||
+                (points->ycol != line->ycol))
+                points->setView(line->table, line->xcol, line->ycol);
+        } else
+            points->replace(line->points);
+        if (!plot->hasSeries(points.get()))
+            addColumnSeries(plot, points.get(), color, width);
+        else
+            styleColumnSeries(plot, points.get(), color, width);
+        points->markerSize = pointSize;
+        points->setVisible(true);
+    } else if (points) {
+        points->setVisible(false);
+    }
+}
+
+// Recompute and (re)draw a column's raw and smoothed series onto the plot.
+void refreshColumn(PlotWidget *plot, ChartColumn &col)
+{
+    QColor rawcol, smcol;
+    chartDefaultColors(rawcol, smcol);
+    if (col.rawColor.isValid()) rawcol = col.rawColor;
+    if (col.smoothcolor.isValid()) smcol = col.smoothcolor;
+
+    if (col.doRaw)
+        renderColumnSeries(plot, col.series.get(), col.scatter, col.dispmode, rawcol, col.rawWidth,
+                           col.rawPointSize);
+
+    if (col.doSmooth) {
+        if (col.eosMode && col.fit && !col.fit->points.isEmpty()) {
+            // EOS fit acts as the "processed" series; suppress the SG smooth
+            col.fit->setVisible(true);
+            if (col.smooth) col.smooth->setVisible(false);
+            if (col.smoothScatter) col.smoothScatter->setVisible(false);
+        } else if (!col.eosMode && col.series->count() > (2 * col.window)) {
+            if (col.fit) col.fit->setVisible(false);
+            if (!col.smooth) {
+                col.smooth       = std::make_unique<PlotSeries>();
+                col.smooth->name = QStringLiteral("Smooth"); // legend label for the SG series
+            }
+            smoothColumn(col);
+            renderColumnSeries(plot, col.smooth.get(), col.smoothScatter, col.smoothmode, smcol,
+                               col.smoothwidth, col.smoothpointsize);
+        }
+    } else {
+        if (col.eosMode && col.fit) col.fit->setVisible(false);
+    }
+    plot->update();
+}
+
+// Set the plot ranges and re-anchor the column's reference lines to them.
+void applyColumnRange(PlotWidget *plot, ChartColumn &col, const QRectF &ranges)
+{
+    // update reference lines to span the current data range along their axis
+    const double ybot = ranges.bottom();
+    const double ytop = ranges.top();
+    for (std::size_t i = 0; i < col.vlines.size(); ++i) {
+        const RefLine &rl = col.reflineDefs[static_cast<int>(i)];
+        if (rl.orient == RefOrient::Vertical)
+            col.vlines[i]->replace(QList<QPointF>{{rl.value, ybot}, {rl.value, ytop}});
+        else
+            col.vlines[i]->replace(
+                QList<QPointF>{{ranges.left(), rl.value}, {ranges.right(), rl.value}});
+    }
+    plot->setXRange(ranges.left(), ranges.right());
+    plot->setYRange(ybot, ytop);
+    plot->update();
+}
+
+// Reset the plot ranges to fit the column's data and re-anchor its reference lines.
+void resetColumnZoom(PlotWidget *plot, ChartColumn &col)
+{
+    applyColumnRange(plot, col, columnMinMax(col));
+}
+
+// Ranges for a live run: keep the current view while it contains the data and
+// otherwise extend the exceeded sides by a fraction of the data span, so the axes
+// change (and the whole chart is repainted) only a few times per run.  Uses the
+// columnMinMax() convention of top() = ymax and bottom() = ymin.  Pure.
+QRectF growLiveRange(const QRectF &view, const QRectF &data)
+{
+    if (view.isNull()) {
+        // the x range grows with the run: start with headroom to the right
+        QRectF grown = data;
+        grown.setRight(data.right() + Cfg::CHART_LIVE_HEADROOM * data.width());
+        return grown;
+    }
+    const double xpad = Cfg::CHART_LIVE_HEADROOM * data.width();
+    const double ypad = Cfg::CHART_LIVE_HEADROOM * (data.top() - data.bottom());
+    QRectF grown      = view;
+    if (data.left() < view.left()) grown.setLeft(data.left() - xpad);
+    if (data.right() > view.right()) grown.setRight(data.right() + xpad);
+    if (data.top() > view.top()) grown.setTop(data.top() + ypad);
+    if (data.bottom() < view.bottom()) grown.setBottom(data.bottom() - ypad);
+    return grown;
+}
+
+// Set the raw-series display style and redraw.
+void setColumnDisplayStyle(PlotWidget *plot, ChartColumn &col, ChartDisplayMode mode,
+                           const QColor &color, qreal width, qreal pointSize)
+{
+    col.dispmode     = mode;
+    col.rawColor     = color;
+    col.rawWidth     = width;
+    col.rawPointSize = pointSize;
+    refreshColumn(plot, col);
+    resetColumnZoom(plot, col);
+}
+
+// Set the processed-series display style and redraw.
+void setColumnSmoothStyle(PlotWidget *plot, ChartColumn &col, ChartDisplayMode mode,
+                          const QColor &color, qreal width, qreal pointSize)
+{
+    col.smoothmode      = mode;
+    col.smoothcolor     = color;
+    col.smoothwidth     = width;
+    col.smoothpointsize = pointSize;
+    refreshColumn(plot, col);
+    resetColumnZoom(plot, col);
+}
+
+// Set or replace the column's fit-curve overlay (EOS, polynomial, custom).
+void setColumnFitCurve(PlotWidget *plot, ChartColumn &col, const QList<QPointF> &points,
+                       const QString &name, bool eos)
+{
+    col.eosMode = eos;
+    if (!col.fit) {
+        col.fit = std::make_unique<PlotSeries>();
+        addColumnSeries(plot, col.fit.get(), QColor(220, 30, 30), 2.0); // distinct fit-curve color
+    }
+    if (!name.isEmpty()) col.fit->name = name;
+    col.fit->replace(points);
+    col.fitBounds = ChartBounds();
+    col.fitBounds.extend(points);
+    if (col.eosMode) {
+        // visibility follows doSmooth: refreshColumn will show/hide it correctly
+        refreshColumn(plot, col);
+    } else {
+        col.fit->setVisible(true);
+    }
+    resetColumnZoom(plot, col);
+}
+
+// Add an extra overlay data series (from a secondary file) to the column.
+void addColumnOverlay(PlotWidget *plot, ChartColumn &col, const QList<QPointF> &pts,
+                      const QString &name, const QColor &color)
+{
+    auto s  = std::make_unique<PlotSeries>();
+    s->name = name;
+    s->replace(pts);
+    addColumnSeries(plot, s.get(), color, col.rawWidth);
+    col.overlaySeries.push_back(std::move(s));
+    col.overlayBounds.emplace_back();
+    col.overlayBounds.back().extend(pts);
+    resetColumnZoom(plot, col);
+}
+
+// Remove all reference lines from the column and the plot.
+void clearColumnVerticalLines(PlotWidget *plot, ChartColumn &col)
+{
+    for (auto &s : col.vlines)
+        plot->removeSeries(s.get());
+    col.vlines.clear();
+    col.reflineDefs.clear();
+}
+
+// Replace the column's reference lines with the given definitions.
+void setColumnReferenceLines(PlotWidget *plot, ChartColumn &col, const QList<RefLine> &lines)
+{
+    clearColumnVerticalLines(plot, col);
+    if (lines.isEmpty()) return;
+    auto ranges = columnMinMax(col);
+    for (const auto &rl : lines) {
+        auto s  = std::make_unique<PlotSeries>();
+        s->name = rl.label;
+        if (rl.orient == RefOrient::Vertical)
+            s->replace(QList<QPointF>{{rl.value, ranges.bottom()}, {rl.value, ranges.top()}});
+        else
+            s->replace(QList<QPointF>{{ranges.left(), rl.value}, {ranges.right(), rl.value}});
+        const QColor c = rl.color.isValid() ? rl.color : QColor(80, 80, 80);
+        // dashed reference line, with an optional label drawn next to it
+        s->style = Qt::DashLine;
+        if (!rl.label.isEmpty()) {
+            s->isReference = true;
+            s->refLabel    = rl.label;
+            s->refAnchor   = rl.anchor;
+        }
+        addColumnSeries(plot, s.get(), c, 1.5);
+        col.vlines.push_back(std::move(s));
+        col.reflineDefs.append(rl);
+    }
+    // reference lines are annotations anchored to the full data extent (and
+    // clipped to the view); they do not change the data range, so leave the
+    // displayed range -- and the range sliders that drive it -- untouched
+    plot->update();
+}
+
+} // namespace
+
+/* -------------------------------------------------------------------- */
+
+bool extendColumnBounds(ChartColumn &col, double x, double y)
+{
+    if (!col.raw.extend(x, y)) return false;
+    col.stats.add(y);
+    return true;
+}
+
+/* -------------------------------------------------------------------- */
+
+void updateColumnBounds(ChartColumn &col)
+{
+    col.raw = ChartBounds();
+    col.stats.reset();
+    const int npoints = col.series->count();
+    for (int i = 0; i < npoints; ++i)
+        extendColumnBounds(col, col.series->x(i), col.series->y(i));
+}
+
+/* -------------------------------------------------------------------- */
+
+void setColumnSmoothFlags(ChartColumn &col, bool doRaw, bool doSmooth, int window, int order)
+{
+    // hide raw plot (keep the series alive; data is still needed for smoothing)
+    if (!doRaw) {
+        if (col.series) col.series->setVisible(false);
+        if (col.scatter) col.scatter->setVisible(false);
+    }
+    // hide processed plot (keep the series alive for quick re-enable)
+    if (!doSmooth) {
+        if (col.smooth) col.smooth->setVisible(false);
+        if (col.smoothScatter) col.smoothScatter->setVisible(false);
+        if (col.eosMode && col.fit) col.fit->setVisible(false);
+    }
+    col.doRaw    = doRaw;
+    col.doSmooth = doSmooth;
+    col.window   = window;
+    col.order    = order;
+}
+
+/* -------------------------------------------------------------------- */
+
+ChartViewer::ChartViewer(QWidget *parent) :
+    QWidget(parent), plot(nullptr), updChart(Cfg::CHART_UPDATE_INTERVAL_DEFAULT), col(nullptr),
+    live(false)
+{
+    plot = new PlotWidget(this);
+    plot->setXTitle("Time step");
+    plot->setXLabelFormat("%d");
+
+    QSettings settings;
+    // cache the live-update throttle interval once; re-reading it per appended
+    // point would construct a QSettings object on the hot thermo path
+    updChart = settings.value(Keys::UPDCHART, Cfg::CHART_UPDATE_INTERVAL_DEFAULT).toInt();
+    settings.beginGroup(Keys::GROUP_CHARTS);
+    plot->setGrid(settings.value(Keys::GRID, true).toBool(),
+                  settings.value(Keys::MINORGRID, true).toBool());
+    settings.endGroup();
+
+    auto *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(plot);
+}
+
+/* -------------------------------------------------------------------- */
+
+ChartViewer::~ChartViewer() = default;
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::setColumn(ChartColumn *c)
+{
+    plot->clearSeries();
+    col      = c;
+    liveView = QRectF();
+    if (!col) {
+        plot->update();
+        return;
+    }
+    // re-register the column's persistent overlays/fit (they keep their styling);
+    // the raw/smoothed series are (re)created and styled by refreshColumn, and the
+    // reference lines are (re)applied by ChartWindow after binding.
+    if (col->fit) plot->addSeries(col->fit.get());
+    for (auto &s : col->overlaySeries)
+        plot->addSeries(s.get());
+    refreshColumn(plot, *col);
+    plot->setYTitle(col->yTitle);
+    resetColumnZoom(plot, *col);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::updateLive()
+{
+    if (!col) return;
+    // update the chart display only after at least updChart milliseconds have passed
+    if (col->lastUpdate.msecsTo(QTime::currentTime()) > updChart) {
+        col->lastUpdate = QTime::currentTime();
+        refreshColumn(plot, *col);
+        if (live) {
+            const QRectF grown = growLiveRange(liveView, columnMinMax(*col));
+            if (grown != liveView) {
+                liveView = grown;
+                applyColumnRange(plot, *col, liveView);
+            }
+        } else {
+            resetColumnZoom(plot, *col);
+        }
+    }
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::setLive(bool enable)
+{
+    live     = enable;
+    liveView = QRectF();
+    plot->setIncremental(enable);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::setXAxisRange(double min, double max)
+{
+    plot->setXRange(min, max);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::setYAxisRange(double min, double max)
+{
+    plot->setYRange(min, max);
+}
+
+/* -------------------------------------------------------------------- */
+
+QString ChartViewer::getName() const
+{
+    return col->series->name;
+}
+
+/* -------------------------------------------------------------------- */
+
+QString ChartViewer::getXLabel() const
+{
+    return plot->xTitle();
+}
+
+/* -------------------------------------------------------------------- */
+
+QString ChartViewer::getYLabel() const
+{
+    return plot->yTitle();
+}
+
+/* -------------------------------------------------------------------- */
+
+QRectF ChartViewer::getMinMax() const
+{
+    return columnMinMax(*col);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::resetZoom()
+{
+    liveView = QRectF();
+    resetColumnZoom(plot, *col);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::setTLabel(const QString &tlabel)
+{
+    plot->setTitle(tlabel);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::setYLabel(const QString &ylabel)
+{
+    plot->setYTitle(ylabel);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::setXLabel(const QString &xlabel)
+{
+    plot->setXTitle(xlabel);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::setXLabelFormat(const QString &fmt)
+{
+    plot->setXLabelFormat(fmt);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::setDisplayStyle(ChartDisplayMode mode, const QColor &color, qreal width,
+                                  qreal pointSize)
+{
+    setColumnDisplayStyle(plot, *col, mode, color, width, pointSize);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::setSmoothStyle(ChartDisplayMode mode, const QColor &color, qreal width,
+                                 qreal pointSize)
+{
+    setColumnSmoothStyle(plot, *col, mode, color, width, pointSize);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::setFitCurve(const QList<QPointF> &points, const QString &name, bool eos)
+{
+    setColumnFitCurve(plot, *col, points, name, eos);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::addOverlaySeries(const QList<QPointF> &pts, const QString &name,
+                                   const QColor &color)
+{
+    addColumnOverlay(plot, *col, pts, name, color);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::setReferenceLines(const QList<RefLine> &lines)
+{
+    setColumnReferenceLines(plot, *col, lines);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::setLegendPos(LegendPos pos)
+{
+    plot->setLegendPos(pos);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::setRefLabelStyle(double pointSize, double distance, bool boxed)
+{
+    plot->setRefLabelStyle(pointSize, distance, boxed);
+}
+
+/* -------------------------------------------------------------------- */
+
+void ChartViewer::updateSmooth()
+{
+    refreshColumn(plot, *col);
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,412 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CHARTCOLUMN_H
+#define CHARTCOLUMN_H
+
+// The per-column chart state and the view that renders it.  Kept apart from
+// ChartWindow so that the column pipeline (bounds, smoothing, rendering) can
+// be used and measured without the rest of the GUI.
+
+#include "analysis.h"     // RunningStats held by ChartColumn
+#include "leastsquares.h" // SGSmoother held by ChartColumn
+#include "plotseries.h"   // PlotSeries model + RefAnchor used by RefLine below
+
+#include <QColor>
+#include <QList>
+#include <QPointF>
+#include <QRectF>
+#include <QString>
+#include <QTime>
+#include <QWidget>
+
+#include <memory>
+#include <vector>
+
+class PlotWidget;
+enum class LegendPos; // defined in plotwidget.h
+
+/** @brief Orientation of a reference line: a vertical line at x, or a horizontal line at y */
+enum class RefOrient { Vertical, Horizontal };
+
+/**
+ * @brief A labeled vertical or horizontal reference line for chart overlays
+ *
+ * Used by the "Reference Lines..." dialog to annotate charts with vertical
+ * markers at specific x positions (e.g. high-symmetry k-points in
+ * phonon-dispersion plots) or horizontal markers at specific y values.
+ */
+struct RefLine {
+    RefOrient orient = RefOrient::Vertical; ///< vertical (fixed x) or horizontal (fixed y)
+    double value;                           ///< x position (vertical) or y position (horizontal)
+    QString label;                          ///< text label (in line color)
+    QColor color;                           ///< line color (default: dark gray)
+    RefAnchor anchor = RefAnchor::Start;    ///< where the label sits along the line
+};
+
+/**
+ * @brief How a chart's raw data series is drawn
+ */
+enum class ChartDisplayMode {
+    Lines,          ///< connect data points with lines only
+    Points,         ///< draw data points as markers only
+    LinesAndPoints, ///< draw both lines and markers
+};
+
+/**
+ * @brief Bounding box of chart data, grown one point at a time
+ *
+ * Empty until the first point is added; non-finite points are ignored.
+ */
+struct ChartBounds {
+    double xmin = 1.0e100;  ///< smallest x
+    double xmax = -1.0e100; ///< largest x
+    double ymin = 1.0e100;  ///< smallest y
+    double ymax = -1.0e100; ///< largest y
+
+    /** @brief Include one point; returns false (and ignores it) if it is not finite */
+    bool extend(double x, double y);
+    /** @brief Include another bounding box */
+    void extend(const ChartBounds &other);
+    /** @brief Include all points of a list */
+    void extend(const QList<QPointF> &points);
+};
+
+/**
+ * @brief Displayed axis ranges for the given data bounds
+ * @param b Data bounds
+ * @return Rectangle with its top-left corner at (xmin, ymax) and a negative
+ *         height, as returned by ChartViewer::getMinMax()
+ *
+ * Widens (nearly) empty ranges and adds a small y margin so that extrema are
+ * not drawn on the plot frame.
+ */
+QRectF chartRange(ChartBounds b);
+
+/**
+ * @brief Default colors of the raw and the processed data series
+ * @param raw    Set to the raw-series color chosen in the preferences
+ * @param smooth Set to the processed-series color chosen in the preferences
+ */
+void chartDefaultColors(QColor &raw, QColor &smooth);
+
+/**
+ * @brief The per-column data and display state of one chart
+ *
+ * Holds everything specific to a single plotted column: its neutral PlotSeries
+ * objects, cached data bounds, smoothing parameters, display style, and the
+ * overlay/reference-line state. It is a plain (non-QWidget) value type,
+ * move-only because of its unique_ptr<PlotSeries> members, so that the single
+ * shared renderer can be pointed at any column on demand.
+ */
+struct ChartColumn {
+    int index = -1;                            ///< Chart index (thermo column id)
+    ChartBounds raw;                           ///< Running bounds of the raw series (live path)
+    RunningStats stats;                        ///< Running statistics of the raw y values
+    int window = 10;                           ///< Smoothing window
+    int order  = 4;                            ///< Smoothing polynomial order
+    std::unique_ptr<PlotSeries> series;        ///< Raw data (a view of the window's data store)
+    std::unique_ptr<PlotSeries> smooth;        ///< Smoothed data series (created on demand)
+    std::unique_ptr<SGSmoother> smoother;      ///< Incremental smoothing state of the smooth series
+    ChartBounds smoothBounds;                  ///< Bounds of the settled smoothed points
+    int smoothSettled = 0;                     ///< Smoothed points that appending no longer changes
+    std::unique_ptr<PlotSeries> scatter;       ///< Raw data as points (created on demand)
+    std::unique_ptr<PlotSeries> smoothScatter; ///< Processed data as points (created on demand)
+    std::unique_ptr<PlotSeries> fit;           ///< Optional fit-curve overlay (created on demand)
+    ChartBounds fitBounds;                     ///< Bounds of the fit curve
+    QTime lastUpdate;                          ///< Time of last chart update
+    bool doRaw    = true;                      ///< Show raw data series
+    bool doSmooth = false;                     ///< Show smoothed data series
+    bool eosMode  = false; ///< True when fit is a BM EOS overlay (visibility follows doSmooth)
+    ChartDisplayMode dispmode = ChartDisplayMode::Lines; ///< How the raw series is drawn
+    QColor rawColor;                   ///< Raw series color override (invalid = theme default)
+    qreal rawWidth              = 3.0; ///< Raw series line width
+    qreal rawPointSize          = 8.0; ///< Raw series marker diameter
+    ChartDisplayMode smoothmode = ChartDisplayMode::Lines; ///< How the processed series is drawn
+    QColor smoothcolor;          ///< Processed series color (invalid = theme default)
+    qreal smoothwidth     = 3.0; ///< Processed series line width
+    qreal smoothpointsize = 8.0; ///< Processed series marker diameter
+    std::vector<std::unique_ptr<PlotSeries>> overlaySeries; ///< Extra series from secondary files
+    std::vector<ChartBounds> overlayBounds;                 ///< Bounds of each overlay series
+    std::vector<std::unique_ptr<PlotSeries>> vlines;        ///< Reference line series (decorative)
+    QList<RefLine> reflineDefs; ///< Reference line definitions (parallel to vlines)
+    QString yTitle;             ///< This column's Y-axis label (restored on the shared plot)
+    QString procLabel = QStringLiteral("Smooth"); ///< Label of the processed-series slot in the
+                                                  ///< Plot combo ("Smooth", or a fit/function name)
+};
+
+/**
+ * @brief Include a point appended to the shared data store in a column
+ * @param col Column whose cached bounds and running statistics are updated
+ * @param x   X value of the new point
+ * @param y   Y value of the new point
+ * @return false (and nothing changes) if the point is not finite
+ */
+bool extendColumnBounds(ChartColumn &col, double x, double y);
+
+/**
+ * @brief Recompute a column's cached bounds and statistics from its raw series
+ *
+ * Does not redraw, so it can be used for columns that are not displayed.
+ */
+void updateColumnBounds(ChartColumn &col);
+
+/**
+ * @brief Apply smoothing flags and parameters to a column without redrawing
+ *
+ * Hidden series are kept alive so they can be shown again quickly.
+ */
+void setColumnSmoothFlags(ChartColumn &col, bool doRaw, bool doSmooth, int window, int order);
+
+/**
+ * @brief Rebindable view of a single ChartColumn
+ *
+ * ChartViewer renders whichever ChartColumn it is currently bound to
+ * (via setColumn()) with its PlotWidget, supporting both raw and
+ * smoothed data display. The column data objects are owned by
+ * ChartWindow; this class is only the view.
+ *
+ * @see PlotWidget, PlotSeries, ChartColumn
+ */
+class ChartViewer : public QWidget {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor -- creates the renderer; no column is bound yet
+     * @param parent Parent widget
+     */
+    explicit ChartViewer(QWidget *parent = nullptr);
+
+    /**
+     * @brief Destructor
+     */
+    ~ChartViewer() override;
+
+    ChartViewer(const ChartViewer &)            = delete;
+    ChartViewer(ChartViewer &&)                 = delete;
+    ChartViewer &operator=(const ChartViewer &) = delete;
+    ChartViewer &operator=(ChartViewer &&)      = delete;
+
+    /**
+     * @brief Bind this view to a column (or nullptr) and render it
+     *
+     * Unregisters the previous column's series from the shared plot and
+     * (re)attaches and draws @p c, restoring its Y-axis label. The column is
+     * owned by ChartWindow, not by the viewer.
+     */
+    void setColumn(ChartColumn *c);
+
+    /**
+     * @brief Redraw after data was appended to the bound column
+     *
+     * The chart display is updated only if at least the configured chart
+     * update interval has passed since the last update.
+     */
+    void updateLive();
+
+    /**
+     * @brief Switch between live-run and interactive display
+     * @param enable true while a run appends data
+     *
+     * During a live run the plot paints incrementally and its axis ranges
+     * only grow, with some headroom, so most updates merely add the new
+     * points to the cached drawing instead of repainting the whole chart.
+     */
+    void setLive(bool enable);
+
+    /**
+     * @brief Get the min/max bounds of the data
+     * @return Rectangle containing data bounds
+     */
+    QRectF getMinMax() const;
+
+    /** @brief Set the displayed X-axis range (used by the range sliders) */
+    void setXAxisRange(double min, double max);
+    /** @brief Set the displayed Y-axis range (used by the range sliders) */
+    void setYAxisRange(double min, double max);
+
+    /**
+     * @brief Reset zoom to show all data
+     */
+    void resetZoom();
+
+    /**
+     * @brief Recalculate and update smoothed data
+     */
+    void updateSmooth();
+
+    /**
+     * @brief Get number of data points
+     * @return Number of points in series
+     */
+    int getCount() const { return col->series->count(); }
+
+    /**
+     * @brief Get the series (data column) name
+     * @return The property/column name this chart was created with
+     *
+     * This is the per-column identifier (e.g. the thermo keyword), distinct
+     * from the shared plot title. Used for data-export column headers.
+     */
+    QString getName() const;
+
+    /**
+     * @brief Get step number at given index
+     * @param index Data point index
+     * @return Step number (X value)
+     */
+    double getStep(int index) const { return (index < 0) ? 0.0 : col->series->at(index).x(); }
+
+    /**
+     * @brief Get data value at given index
+     * @param index Data point index
+     * @return Data value (Y value)
+     */
+    double getData(int index) const { return (index < 0) ? 0.0 : col->series->at(index).y(); }
+
+    /**
+     * @brief Set chart title
+     * @param tlabel New title
+     */
+    void setTLabel(const QString &tlabel);
+
+    /**
+     * @brief Set Y-axis label
+     * @param ylabel New Y-axis label
+     */
+    void setYLabel(const QString &ylabel);
+
+    /**
+     * @brief Set the X-axis label
+     * @param xlabel New X-axis label
+     */
+    void setXLabel(const QString &xlabel);
+
+    /**
+     * @brief Set the X-axis tick label format
+     * @param fmt printf-style format string (e.g. "%.6g" for floating-point,
+     *            "%d" for integer steps)
+     *
+     * Call after setXLabel() when the x-axis carries non-integer data (e.g.
+     * lattice constants from a Plot Data file).  The thermo live-feed path
+     * leaves the default integer format in place.
+     */
+    void setXLabelFormat(const QString &fmt);
+
+    /**
+     * @brief Add an overlay data series from a second file
+     * @param pts   (x, y) data points
+     * @param name  Series name (shown as a tooltip / legend entry)
+     * @param color Line color
+     *
+     * Overlay series are always shown in full (no smoothing); they are
+     * included in the axis range calculation.
+     */
+    void addOverlaySeries(const QList<QPointF> &pts, const QString &name, const QColor &color);
+
+    /** @brief Number of overlay series currently displayed */
+    int overlaySeriesCount() const { return static_cast<int>(col->overlaySeries.size()); }
+
+    /**
+     * @brief Set reference lines (replaces any existing set)
+     * @param lines List of reference line descriptors
+     *
+     * Each line spans the full data range perpendicular to its orientation
+     * and is updated on every zoom reset. Lines are described by their
+     * orientation, position, label (series name), anchor, and color.
+     */
+    void setReferenceLines(const QList<RefLine> &lines);
+
+    /** @brief Set the in-plot legend placement (corner, or off) */
+    void setLegendPos(LegendPos pos);
+
+    /** @brief Set the window-wide reference-label style (font size, gap, boxed) */
+    void setRefLabelStyle(double pointSize, double distance, bool boxed);
+
+    /**
+     * @brief Set how the raw data series is displayed
+     * @param mode  Lines, points, or both
+     * @param color Series color (invalid color falls back to the theme default)
+     * @param width Line width (used for the line and lines+points modes)
+     * @param pointSize Marker diameter (used for the points and lines+points modes)
+     */
+    void setDisplayStyle(ChartDisplayMode mode, const QColor &color, qreal width, qreal pointSize);
+
+    /** @brief Current display mode */
+    ChartDisplayMode displayMode() const { return col->dispmode; }
+    /** @brief Current series color (may be invalid, meaning the theme default) */
+    QColor displayColor() const { return col->rawColor; }
+    /** @brief Current line width */
+    qreal displayWidth() const { return col->rawWidth; }
+    /** @brief Current marker diameter */
+    qreal displayPointSize() const { return col->rawPointSize; }
+
+    /**
+     * @brief Set how the processed (smoothed) data series is displayed
+     * @param mode  Lines, points, or both
+     * @param color Series color (invalid color falls back to the theme default)
+     * @param width Line width (used for the line and lines+points modes)
+     * @param pointSize Marker diameter (used for the points and lines+points modes)
+     */
+    void setSmoothStyle(ChartDisplayMode mode, const QColor &color, qreal width, qreal pointSize);
+
+    /** @brief Current processed-series display mode */
+    ChartDisplayMode smoothMode() const { return col->smoothmode; }
+    /** @brief Current processed-series color (may be invalid, meaning the theme default) */
+    QColor smoothColor() const { return col->smoothcolor; }
+    /** @brief Current processed-series line width */
+    qreal smoothWidth() const { return col->smoothwidth; }
+    /** @brief Current processed-series marker diameter */
+    qreal smoothPointSize() const { return col->smoothpointsize; }
+
+    /**
+     * @brief Overlay a fit curve on the chart
+     * @param points  Curve points (x, y) drawn as an overlay line; created on
+     *                the first call and replaced on subsequent calls
+     * @param name    Optional series name for the overlay (e.g. the fitted
+     *                expression or a user label); shown wherever series names
+     *                are surfaced
+     * @param eosFit  When true the curve is treated as an EOS fit: its
+     *                visibility follows the doSmooth flag (hidden in Raw mode,
+     *                visible in Smoothed/Both mode) and it replaces the
+     *                Savitzky-Golay series while active.
+     */
+    void setFitCurve(const QList<QPointF> &points, const QString &name = QString(),
+                     bool eosFit = false);
+
+    /** @brief True when the current fit overlay is a Birch-Murnaghan EOS fit */
+    bool isEosFit() const { return col->eosMode && col->fit && !col->fit->points.isEmpty(); }
+
+    /**
+     * @brief Get X-axis label
+     * @return X-axis label
+     */
+    QString getXLabel() const;
+
+    /**
+     * @brief Get Y-axis label
+     * @return Y-axis label
+     */
+    QString getYLabel() const;
+
+private:
+    PlotWidget *plot; ///< Renderer (Qt child of this widget)
+    int updChart;     ///< Cached live-update throttle interval (ms)
+    ChartColumn *col; ///< Column currently rendered (owned by ChartWindow, not here)
+    bool live;        ///< a run is appending data (incremental painting)
+    QRectF liveView;  ///< displayed ranges during a live run (null: not set yet)
+};
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -14,6 +14,7 @@
 #include "analysis.h"
 #include "constants.h"
 #include "customfunc.h"
+#include "decompress.h"
 #include "fitting.h"
 #include "helpers.h"
 #include "lammpsgui.h"
@@ -22,8 +23,10 @@
 #include "plotdatadialog.h"
 #include "qaddon.h"
 #include "rangeslider.h"
+#include "thermoparser.h"
 
 #include <QAction>
+#include <QActionGroup>
 #include <QApplication>
 #include <QCheckBox>
 #include <QClipboard>
@@ -35,10 +38,13 @@
 #include <QDir>
 #include <QDoubleSpinBox>
 #include <QEvent>
+#include <QEventLoop>
+#include <QFile>
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QFormLayout>
 #include <QGroupBox>
+#include <QHash>
 #include <QHBoxLayout>
 #include <QIcon>
 #include <QImage>
@@ -51,19 +57,30 @@
 #include <QMenu>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QProgressDialog>
 #include <QPushButton>
+#include <QSaveFile>
 #include <QSettings>
 #include <QSpinBox>
 #include <QStringList>
 #include <QTextStream>
+#include <QThread>
 #include <QTime>
+#include <QTimer>
 #include <QVBoxLayout>
 #include <QVariant>
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "plotwidget.h"
 
 #include <cmath>
+#include <limits>
 
 namespace {
 
@@ -71,6 +88,39 @@ namespace {
 constexpr int SLIDER_RANGE       = 1000;
 constexpr double SLIDER_FRACTION = 1.0 / static_cast<double>(SLIDER_RANGE);
 constexpr int LAYOUT_SPACING     = 6;
+constexpr int LOAD_TICK          = 100; // ms between checks for overlay files that are read
+constexpr int LOAD_DELAY         = 500; // ms before the overlay loading progress dialog appears
+
+// Color of the i-th overlay series: a palette that avoids the primary raw/smooth
+// colors, then hues spread by the golden angle for comparing many files
+QColor overlayColor(int i)
+{
+    static const QList<QColor> palette = {
+        QColor(220, 80, 40),  // red-orange
+        QColor(40, 160, 40),  // green
+        QColor(160, 40, 220), // purple
+        QColor(180, 140, 0),  // amber
+        QColor(0, 160, 180),  // teal
+    };
+    if (i < palette.size()) return palette[i];
+    return QColor::fromHsv((i * 137) % 360, 200, 190);
+}
+
+// Legend prefixes telling overlay files apart: the file stem, and for files
+// sharing a stem (e.g. run*/log.lammps) also the name of their folder
+QStringList overlayPrefixes(const QStringList &files)
+{
+    QStringList stems;
+    QHash<QString, int> stemCount;
+    for (const auto &file : files) {
+        stems << defaultFileStem(file);
+        ++stemCount[stems.back()];
+    }
+    for (int i = 0; i < files.size(); ++i)
+        if (stemCount[stems[i]] > 1)
+            stems[i] = QFileInfo(files[i]).absoluteDir().dirName() + "/" + stems[i];
+    return stems;
+}
 
 // Translate the smoothing-choice index (Raw/Smooth/Both, kept in sync with
 // the preferences dialog) into the raw/smooth display flags.
@@ -93,37 +143,10 @@ void smoothFlagsFromChoice(int choice, bool &doRaw, bool &doSmooth)
     }
 }
 
-// Widen a (near) empty [lo, hi] range to a small symmetric/relative band so the
-// axis is never degenerate. Shared by the X and Y branches of getMinMax().
-void padEmptyRange(double &lo, double &hi)
-{
-    // compare against the magnitude: dividing by a signed hi made the test
-    // true for every all-negative range, padding ranges that were not empty
-    const double delta = hi - lo;
-    if ((delta / ((hi == 0.0) ? 1.0 : fabs(hi))) < 1.0e-10) {
-        if ((lo == 0.0) || (hi == 0.0)) {
-            lo = -0.025;
-            hi = 0.025;
-        } else {
-            lo -= 0.025 * fabs(lo);
-            hi += 0.025 * fabs(hi);
-        }
-    }
-}
-
-// brush color index must be kept in sync with preferences
-
-const QList<QBrush> mybrushes = {
-    QBrush(QColor(0, 0, 0)),       // black
-    QBrush(QColor(100, 150, 255)), // blue
-    QBrush(QColor(255, 125, 125)), // red
-    QBrush(QColor(100, 200, 100)), // green
-    QBrush(QColor(120, 120, 120)), // grey
-};
-
 // Parse a "name=value, name=value, ..." string of nonlinear-fit parameters and
-// their initial guesses into an ordered list. Sets *ok to false on any empty or
-// malformed token (so the caller can report a usage hint).
+// their initial guesses into an ordered list. A guess may be followed by a range
+// "[lower:upper]" for a multi-start fit, e.g. "w=1 [0.1:10]". Sets *ok to false
+// on any empty or malformed token (so the caller can report a usage hint).
 QList<FitParam> parseFitParams(const QString &text, bool *ok)
 {
     QList<FitParam> params;
@@ -135,14 +158,28 @@ QList<FitParam> parseFitParams(const QString &text, bool *ok)
             *ok = false;
             return {};
         }
-        const QString name = kv[0].trimmed();
-        bool valueOk       = false;
-        const double value = kv[1].trimmed().toDouble(&valueOk);
-        if (name.isEmpty() || !valueOk) {
+        FitParam param;
+        param.name     = kv[0].trimmed();
+        QString guess  = kv[1].trimmed();
+        const int open = guess.indexOf('[');
+        bool rangeOk   = true;
+        if (open >= 0) {
+            const QStringList range = guess.mid(open + 1, guess.size() - open - 2).split(':');
+            bool lowerOk = false, upperOk = false;
+            if (guess.endsWith(']') && (range.size() == 2)) {
+                param.lower = range[0].trimmed().toDouble(&lowerOk);
+                param.upper = range[1].trimmed().toDouble(&upperOk);
+            }
+            rangeOk = lowerOk && upperOk && (param.lower < param.upper);
+            guess   = guess.left(open).trimmed();
+        }
+        bool guessOk = false;
+        param.value  = guess.toDouble(&guessOk);
+        if (param.name.isEmpty() || !guessOk || !rangeOk) {
             *ok = false;
             return {};
         }
-        params.append(FitParam{name, value});
+        params.append(param);
     }
     if (params.isEmpty()) *ok = false;
     return params;
@@ -150,14 +187,6 @@ QList<FitParam> parseFitParams(const QString &text, bool *ok)
 
 } // namespace
 
-// Forward declarations of the data-only column helpers (defined in the column
-// rendering-pipeline namespace further down) that ChartWindow needs before that
-// block appears; they are pure (no PlotWidget), so no other helper is required.
-namespace {
-bool appendColumnPoint(ChartColumn &col, double x, double y);
-void setColumnData(ChartColumn &col, const QList<QPointF> &points);
-void setColumnSmoothFlags(ChartColumn &col, bool doRaw, bool doSmooth, int window, int order);
-} // namespace
 
 /* -------------------------------------------------------------------- */
 
@@ -203,8 +232,9 @@ ChartWindow::ChartWindow(const QString &_filename, LammpsGui *_lammpsgui, QWidge
     // be created with the menu bar as its parent to be freed along with it
     QWidget(parent), lammpsgui(_lammpsgui), menu(new QMenuBar), file(new QMenu("&File", menu)),
     smooth(nullptr), window(nullptr), order(nullptr), chartTitle(nullptr), chartYlabel(nullptr),
-    chartXlabel(nullptr), units(nullptr), norm(nullptr), filename(_filename), viewer(nullptr),
-    active(-1)
+    chartXlabel(nullptr), units(nullptr), statsLabel(nullptr), norm(nullptr), filename(_filename),
+    viewer(nullptr), storage(ChartStorage::Full), active(-1), followAct(nullptr),
+    followTimer(new QTimer(this)), followPos(0)
 {
     QSettings settings;
     auto *top  = new QVBoxLayout;
@@ -364,6 +394,10 @@ ChartWindow::ChartWindow(const QString &_filename, LammpsGui *_lammpsgui, QWidge
                   &ChartWindow::exportDat);
     addMenuAction(file, "Export data to &YAML...", ":/icons/yaml-file-icon.svg", this,
                   &ChartWindow::exportYaml);
+    addMenuAction(file, "Export data to &Binary...", ":/icons/binary-file-icon.svg", this,
+                  &ChartWindow::exportBinary);
+    addMenuAction(file, "Export S&tatistics to CSV...", ":/icons/csv-file-icon.svg", this,
+                  &ChartWindow::exportStats);
     file->addSeparator();
     addMenuAction(file, "Chart &Style...", ":/icons/preferences-desktop-personal.svg", this,
                   &ChartWindow::changeStyle);
@@ -371,10 +405,27 @@ ChartWindow::ChartWindow(const QString &_filename, LammpsGui *_lammpsgui, QWidge
                   &ChartWindow::referenceLines);
     addMenuAction(file, "&Postprocess...", ":/icons/chart-smooth.svg", this,
                   &ChartWindow::postProcess);
-    // "Add Data from File..." is only relevant in standalone file-plot mode
+    // compact storage for very long series; a choice of each window
+    auto *storageMenu  = file->addMenu("Data St&orage");
+    auto *storageGroup = new QActionGroup(this);
+    const QStringList storageNames = {"&Full Precision", "Compact &Steps",
+                                      "Compact Steps, Single &Precision Values"};
+    for (int i = 0; i < storageNames.size(); ++i) {
+        auto *act = storageMenu->addAction(storageNames[i]);
+        act->setCheckable(true);
+        act->setChecked(static_cast<ChartStorage>(i) == storage);
+        act->setData(i);
+        storageGroup->addAction(act);
+    }
+    connect(storageGroup, &QActionGroup::triggered, this, &ChartWindow::selectStorage);
+    // "Add Data from Files..." is only relevant in standalone file-plot mode
     if (!lammpsgui) {
-        addMenuAction(file, "&Add Data from File...", ":/icons/application-plot.svg", this,
+        addMenuAction(file, "&Add Data from Files...", ":/icons/application-plot.svg", this,
                       &ChartWindow::addDataFile);
+        followAct = addMenuAction(file, "&Follow File", ":/icons/go-last.svg", this,
+                                  &ChartWindow::setFollow);
+        followAct->setCheckable(true);
+        followAct->setEnabled(false); // until setFollowSource() accepts the file
     }
     file->addSeparator();
     auto *stopAct =
@@ -397,6 +448,10 @@ ChartWindow::ChartWindow(const QString &_filename, LammpsGui *_lammpsgui, QWidge
     viewer->setLegendPos(legendPos);
     viewer->setRefLabelStyle(refLabelSize, refLabelDist, refLabelBoxed);
     layout->addWidget(viewer);
+    // running statistics of the active column, updated as data arrives
+    statsLabel = new QLabel;
+    statsLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addWidget(statsLabel);
     setLayout(layout);
 
     connect(chartTitle, &QLineEdit::editingFinished, this, &ChartWindow::updateTLabel);
@@ -409,6 +464,7 @@ ChartWindow::ChartWindow(const QString &_filename, LammpsGui *_lammpsgui, QWidge
     connect(columns, &QComboBox::currentIndexChanged, this, &ChartWindow::changeChart);
     connect(xrange, &RangeSlider::sliderMoved, this, &ChartWindow::updateXRange);
     connect(yrange, &RangeSlider::sliderMoved, this, &ChartWindow::updateYRange);
+    connect(followTimer, &QTimer::timeout, this, &ChartWindow::readFollowed);
 
     applyWindowFlags(this);
     installEventFilter(this);
@@ -418,11 +474,8 @@ ChartWindow::ChartWindow(const QString &_filename, LammpsGui *_lammpsgui, QWidge
 
 int ChartWindow::getStep() const
 {
-    if (!cols.empty()) {
-        const auto &series = cols[0]->series;
-        if (series && series->count() > 0)
-            return static_cast<int>(series->at(series->count() - 1).x());
-    }
+    if (!cols.empty() && !store.isEmpty())
+        return static_cast<int>(store.value(store.rowCount() - 1, 0));
     return -1;
 }
 
@@ -431,7 +484,9 @@ void ChartWindow::resetCharts()
     viewer->setColumn(nullptr); // unregister the active column's series from the plot
     cols.clear();
     columns->clear();
+    store  = PlotData();
     active = -1;
+    updateStats();
 }
 
 void ChartWindow::resetZoom()
@@ -441,11 +496,24 @@ void ChartWindow::resetZoom()
 
 void ChartWindow::addChart(const QString &title, int index)
 {
-    auto c          = std::make_unique<ChartColumn>();
-    c->index        = index;
-    c->series       = std::make_unique<PlotSeries>();
+    // the step column is shared by all charts; a chart added to existing rows
+    // starts out without data
+    if (store.columnCount() == 0) store.addColumn("Step", {});
+    store.addColumn(title,
+                    std::vector<double>(store.rowCount(), std::numeric_limits<double>::quiet_NaN()));
+    applyStorage();
+    bindChart(title, index);
+}
+
+void ChartWindow::bindChart(const QString &title, int index)
+{
+    auto c    = std::make_unique<ChartColumn>();
+    c->index  = index;
+    c->series = std::make_unique<PlotSeries>();
+    c->series->setView(&store, 0, static_cast<int>(cols.size()) + 1);
     c->series->name = title;
     c->yTitle       = title;
+    c->stats        = RunningStats(Cfg::CHART_STATS_WINDOW);
     c->lastUpdate   = QTime::currentTime();
     cols.push_back(std::move(c));
     columns->addItem(title, index);
@@ -464,14 +532,54 @@ void ChartWindow::addData(int step, double data, int index)
 {
     for (std::size_t i = 0; i < cols.size(); ++i) {
         if (cols[i]->index != index) continue;
-        if (static_cast<int>(i) == active)
-            viewer->addPoint(step, data); // appends + throttled redraw of the active column
-        else
-            appendColumnPoint(*cols[i], step, data); // accumulate only; drawn when selected
+        // a new step starts a new row for all charts, the others fill it in later
+        const int nrows = store.rowCount();
+        if ((nrows == 0) || (step > store.value(nrows - 1, 0))) {
+            std::vector<double> row(store.columnCount(), std::numeric_limits<double>::quiet_NaN());
+            row[0] = step;
+            store.appendRow(row);
+        } else if (step < store.value(nrows - 1, 0)) {
+            return; // keep the steps monotonic
+        }
+        const int last = store.rowCount() - 1;
+        if (!std::isnan(store.value(last, static_cast<int>(i) + 1))) return; // already set
+        store.setValue(last, static_cast<int>(i) + 1, data);
+        extendColumnBounds(*cols[i], step, data);
+        // throttled redraw of the active column; the others are drawn when selected
+        if (static_cast<int>(i) == active) {
+            viewer->updateLive();
+            updateStats();
+        }
         return;
     }
 }
 
+void ChartWindow::addRows(const std::vector<ThermoRow> &rows)
+{
+    if (rows.empty() || cols.empty()) return;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> values(store.columnCount());
+    bool grew = false;
+    for (const auto &row : rows) {
+        // rows must advance the shared step column
+        const int nrows = store.rowCount();
+        if ((nrows > 0) && (row.step <= store.value(nrows - 1, 0))) continue;
+        values[0] = row.step;
+        for (std::size_t i = 0; i < cols.size(); ++i) {
+            const auto column = static_cast<std::size_t>(cols[i]->index);
+            values[i + 1]     = (column < row.values.size()) ? row.values[column] : nan;
+            extendColumnBounds(*cols[i], row.step, values[i + 1]);
+        }
+        store.appendRow(values);
+        grew = true;
+    }
+    // the non-active columns are drawn when selected
+    if (grew && (active >= 0)) {
+        viewer->updateLive();
+        updateStats();
+    }
+}
+
 void ChartWindow::setUnits(const QString &_units)
 {
     units->setText(_units);
@@ -484,6 +592,8 @@ void ChartWindow::setNorm(bool _norm)
 
 void ChartWindow::setRangeEnabled(bool enabled)
 {
+    // the range sliders are disabled while a run is appending data
+    viewer->setLive(!enabled);
     xrange->setEnabled(enabled);
     yrange->setEnabled(enabled);
     smooth->setEnabled(enabled);
@@ -493,24 +603,31 @@ void ChartWindow::setRangeEnabled(bool enabled)
 
 void ChartWindow::loadData(const PlotData &data, int xcol, const QList<int> &ycols)
 {
+    setFollow(false);
+    tail.reset();
+    fileColumns.clear();
+    if (followAct) followAct->setEnabled(false);
     resetCharts();
     if (data.isEmpty() || ycols.isEmpty()) return;
     if ((xcol < 0) || (xcol >= data.columnCount())) return;
 
-    const std::vector<double> &xvals = data.column(xcol);
-    const int nrow                   = data.rowCount();
-    const QString xlabel             = data.columnName(xcol);
-
-    int idx = 0;
+    // copy the selected columns into the shared store: the x column first, then
+    // one column per chart
+    const QString xlabel = data.columnName(xcol);
+    store.addColumn(xlabel, data.column(xcol));
+    QList<int> selected;
     for (int ycol : ycols) {
         if ((ycol < 0) || (ycol >= data.columnCount())) continue;
-        addChart(data.columnName(ycol), idx); // the first one binds the view
-        const std::vector<double> &yvals = data.column(ycol);
-        QList<QPointF> points;
-        points.reserve(nrow);
-        for (int r = 0; r < nrow; ++r)
-            points.append(QPointF(xvals[r], yvals[r]));
-        setColumnData(*cols.back(), points); // data only; the active one is drawn below
+        store.addColumn(data.columnName(ycol), data.column(ycol));
+        selected << ycol;
+    }
+    fileColumns = QList<int>{xcol} + selected;
+    applyStorage();
+
+    int idx = 0;
+    for (int ycol : selected) {
+        bindChart(data.columnName(ycol), idx); // the first one binds the view
+        updateColumnBounds(*cols.back());      // data only; the active one is drawn below
         ++idx;
     }
     // shared X-axis labeling on the single plot (standalone uses %.6g)
@@ -522,6 +639,86 @@ void ChartWindow::loadData(const PlotData &data, int xcol, const QList<int> &yco
     if (chartXlabel) chartXlabel->setText(xlabel);
     setRangeEnabled(true);
     resetZoom();
+    updateStats();
+}
+
+bool ChartWindow::setFollowSource(PlotFormat format, int ncol, qint64 offset)
+{
+    if (!followAct || cols.empty()) return false;
+    if ((format != PlotFormat::Csv) && (format != PlotFormat::Whitespace)) return false;
+    // the bytes appended to a compressed file cannot be decompressed on their own
+    if (Decompress::isCompressed(filename)) return false;
+    // derived columns exist only in the loaded data, not in the file
+    for (int c : fileColumns)
+        if (c >= ncol) return false;
+
+    tail = std::make_unique<PlotParse::TailParser>(format == PlotFormat::Csv,
+                                                   static_cast<std::size_t>(ncol));
+    // start at the last byte that was loaded, so a line that was still being
+    // written when the file was loaded is skipped rather than parsed from its middle
+    followPos = std::max<qint64>(offset - 1, 0);
+    tail->reset(offset > 0);
+    followAct->setEnabled(true);
+    return true;
+}
+
+void ChartWindow::setFollow(bool enable)
+{
+    enable = enable && tail;
+    if (followAct) followAct->setChecked(enable);
+    if (enable == followTimer->isActive()) return;
+
+    if (enable) {
+        // poll less often than the chart redraw throttle, so that the rows of
+        // each poll are drawn right away: the latency is at most one interval
+        QSettings settings;
+        const int updchart =
+            settings.value(Keys::UPDCHART, Cfg::CHART_UPDATE_INTERVAL_DEFAULT).toInt();
+        setRangeEnabled(false);
+        followTimer->start(std::max(Cfg::CHART_FOLLOW_INTERVAL, updchart + 1));
+        readFollowed();
+    } else {
+        followTimer->stop();
+        setRangeEnabled(true);
+        resetZoom();
+    }
+}
+
+void ChartWindow::readFollowed()
+{
+    if (!tail || cols.empty()) return;
+    // reopen the file for every poll: on network file systems this is what
+    // makes the data written on another host visible
+    QFile f(filename);
+    if (!f.open(QIODevice::ReadOnly)) return;
+    const qint64 size = f.size();
+    if (size < followPos) {
+        // truncated or replaced: read it again from the start; the rows that
+        // do not advance the x axis are skipped by addRows()
+        followPos = 0;
+        tail->reset();
+    }
+    if ((size == followPos) || !f.seek(followPos)) return;
+    const QByteArray bytes = f.read(size - followPos);
+    followPos += bytes.size();
+
+    std::vector<double> values;
+    const std::size_t nrows =
+        tail->feed(std::string_view(bytes.constData(), static_cast<std::size_t>(bytes.size())),
+                   values);
+    if (nrows == 0) return;
+
+    // pick the plotted columns out of the parsed rows
+    const std::size_t ncol = values.size() / nrows;
+    std::vector<ThermoRow> rows(nrows);
+    for (std::size_t r = 0; r < nrows; ++r) {
+        const double *row = values.data() + (r * ncol);
+        rows[r].step      = row[fileColumns[0]];
+        rows[r].values.reserve(fileColumns.size() - 1);
+        for (int i = 1; i < fileColumns.size(); ++i)
+            rows[r].values.push_back(row[fileColumns[i]]);
+    }
+    addRows(rows);
 }
 
 void ChartWindow::copy()
@@ -691,19 +888,25 @@ void ChartWindow::postProcess()
     ChartViewer *chart = currentChart();
     if (!chart) return;
 
-    const int npoints = chart->getCount();
+    // gather the (x, y) data of the selected chart; cells that were never filled
+    // (e.g. a keyword missing from some runs of a merged log) are NaN and skipped
+    std::vector<double> xs, ys;
+    xs.reserve(chart->getCount());
+    ys.reserve(chart->getCount());
+    for (int i = 0; i < chart->getCount(); ++i) {
+        xs.push_back(chart->getStep(i));
+        ys.push_back(chart->getData(i));
+    }
+    dropNonFinite(xs, ys);
+    const int npoints = static_cast<int>(xs.size());
     if (npoints < 2) {
         warning(this, "Postprocess", "Not enough data points to analyze.");
         return;
     }
 
     // pre-compute x range for fit-range spinbox initialization
-    double dataXmin = chart->getStep(0), dataXmax = chart->getStep(0);
-    for (int i = 1; i < npoints; ++i) {
-        const double x = chart->getStep(i);
-        if (x < dataXmin) dataXmin = x;
-        if (x > dataXmax) dataXmax = x;
-    }
+    const double dataXmin = *std::min_element(xs.begin(), xs.end());
+    const double dataXmax = *std::max_element(xs.begin(), xs.end());
 
     QDialog dialog(this);
     dialog.setWindowTitle("Postprocess Chart Data");
@@ -715,6 +918,7 @@ void ChartWindow::postProcess()
     analysisbox->addItem("Birch-Murnaghan EOS fit");
     analysisbox->addItem("Custom function");
     analysisbox->addItem("Custom fit");
+    analysisbox->addItem("Statistical error");
     form->addRow("Analysis:", analysisbox);
 
     auto *paramLabel = new QLabel;
@@ -731,7 +935,7 @@ void ChartWindow::postProcess()
     // parameter (initial-guess) and label fields, shown only for the custom fit
     auto *paramsLabel = new QLabel("Parameters:");
     auto *paramsEdit  = new QLineEdit;
-    paramsEdit->setPlaceholderText("name=guess, e.g. a=1, b=0.5");
+    paramsEdit->setPlaceholderText("name=guess [lower:upper], e.g. a=1, w=0.5 [0.1:10]");
     paramsEdit->setMinimumWidth(Cfg::POSTPROCESS_EXPR_WIDTH);
     form->addRow(paramsLabel, paramsEdit);
 
@@ -741,7 +945,7 @@ void ChartWindow::postProcess()
     fitLabelEdit->setMinimumWidth(Cfg::POSTPROCESS_EXPR_WIDTH);
     form->addRow(fitLabelLabel, fitLabelEdit);
 
-    // fit x-range (hidden for autocorrelation, shown for all fitting analyses)
+    // fit/data x-range (hidden for autocorrelation, shown for all other analyses)
     auto *fitRangeLabel  = new QLabel("Fit x-range:");
     auto *fitRangeWidget = new QWidget;
     auto *fitRangeRow    = new QHBoxLayout(fitRangeWidget);
@@ -766,6 +970,7 @@ void ChartWindow::postProcess()
         const bool fit       = (idx == 4); // custom-function nonlinear fit
         const bool expr      = plot || fit;
         const bool eos       = (idx == 2);
+        const bool stats     = (idx == 5); // error of the mean of correlated data
         const bool showRange = (idx != 0); // show for all except autocorrelation
         exprLabel->setVisible(expr);
         exprEdit->setVisible(expr);
@@ -775,7 +980,8 @@ void ChartWindow::postProcess()
         fitLabelEdit->setVisible(fit);
         fitRangeLabel->setVisible(showRange);
         fitRangeWidget->setVisible(showRange);
-        paramLabel->setVisible(!expr && !eos);
+        fitRangeLabel->setText(stats ? "Data x-range:" : "Fit x-range:");
+        paramLabel->setVisible(!plot && !eos && !stats);
         if (idx == 1) { // polynomial degree
             paramLabel->setText("Degree:");
             paramSpin->setVisible(true);
@@ -783,7 +989,12 @@ void ChartWindow::postProcess()
             paramSpin->setValue(qMin(3, qMin(npoints - 1, 8)));
         } else if (eos) { // EOS: only show the x-axis confirmation
             paramSpin->setVisible(false);
-        } else if (expr) { // custom function/fit: expression field(s) only
+        } else if (fit) { // number of starting points of a multi-start fit
+            paramLabel->setText("Starts:");
+            paramSpin->setVisible(true);
+            paramSpin->setRange(1, 1000);
+            paramSpin->setValue(1);
+        } else if (plot || stats) { // custom function, statistical error: no parameter
             paramSpin->setVisible(false);
         } else { // autocorrelation max lag
             paramLabel->setText("Max lag:");
@@ -804,15 +1015,6 @@ void ChartWindow::postProcess()
 
     if (dialog.exec() != QDialog::Accepted) return;
 
-    // gather the (x, y) data of the selected chart
-    std::vector<double> xs, ys;
-    xs.reserve(npoints);
-    ys.reserve(npoints);
-    for (int i = 0; i < npoints; ++i) {
-        xs.push_back(chart->getStep(i));
-        ys.push_back(chart->getData(i));
-    }
-
     const int which = analysisbox->currentIndex();
 
     // filter to the user-specified x-range for fitting analyses (not autocorrelation)
@@ -859,6 +1061,47 @@ void ChartWindow::postProcess()
         return;
     }
 
+    if (which == 5) { // error of the mean -> blocking curve in a new window plus a report
+        const CorrelationTime ct               = correlationTime(ys);
+        const std::vector<BlockAverage> levels = blockAverages(ys);
+        if (!ct.ok || levels.empty()) {
+            warning(this, "Postprocess",
+                    "Could not estimate the statistical error (constant or insufficient data).");
+            return;
+        }
+        PlotData result;
+        result.setColumnNames({"block size", "Error of mean: " + chart->getName()});
+        for (const auto &level : levels)
+            result.appendRow({static_cast<double>(level.blockSize), level.error});
+
+        auto *win = new ChartWindow(filename + " (blocking)", nullptr);
+        win->setAttribute(Qt::WA_DeleteOnClose);
+        win->setWindowTitle("Block Averaging - LAMMPS-GUI");
+        win->setWindowIcon(QIcon(Cfg::MAIN_ICON));
+        win->setMinimumSize(Cfg::MINIMUM_WIDTH, Cfg::MINIMUM_HEIGHT);
+        win->loadData(result, 0, {1});
+        win->show();
+
+        // the x spacing converts the correlation time from samples to x units
+        const double dx = (xs.size() > 1) ? (xs.back() - xs.front()) / (xs.size() - 1) : 1.0;
+        QString report = QString("Statistical error of %1 (%2 samples)\n\n")
+                             .arg(chart->getName())
+                             .arg(ys.size());
+        report += QString("  mean                 = %1\n").arg(ct.mean, 0, 'g', 8);
+        report += QString("  standard deviation   = %1\n").arg(std::sqrt(ct.variance), 0, 'g', 6);
+        report += QString("  error of the mean    = %1\n").arg(ct.error, 0, 'g', 6);
+        report += QString("  correlation time     = %1 samples (%2 in x)\n")
+                      .arg(ct.tau, 0, 'g', 4)
+                      .arg(ct.tau * dx, 0, 'g', 4);
+        report += QString("  stat. inefficiency   = %1\n").arg(ct.inefficiency, 0, 'g', 4);
+        report += QString("  independent samples  = %1\n\n")
+                      .arg(static_cast<double>(ys.size()) / ct.inefficiency, 0, 'f', 0);
+        report += "The block averaging error should level off at the error of the mean\n"
+                  "once the blocks are longer than the correlation time.";
+        information(this, "Statistical Error", report);
+        return;
+    }
+
     // fits: build a smooth curve over the data x range and overlay it
     const auto mm        = std::minmax_element(xs.begin(), xs.end());
     const double xmin    = *mm.first;
@@ -896,10 +1139,14 @@ void ChartWindow::postProcess()
         const QList<FitParam> initial = parseFitParams(paramsEdit->text(), &paramsOk);
         if (!paramsOk) {
             warning(this, "Custom Fit",
-                    "Enter fit parameters as name=guess pairs, e.g. \"a=1, b=0.5\".");
+                    "Enter fit parameters as name=guess pairs, e.g. \"a=1, b=0.5\", "
+                    "optionally with a range for a multi-start fit, e.g. \"w=1 [0.1:10]\".");
             return;
         }
-        const CustomFit fit = fitCustomCurve(expr, initial, xs, ys, xmin, xmax, Ncurve);
+        const int starts    = paramSpin->value();
+        const CustomFit fit = (starts > 1)
+            ? fitCustomCurveMultiStart(expr, initial, xs, ys, xmin, xmax, Ncurve, starts)
+            : fitCustomCurve(expr, initial, xs, ys, xmin, xmax, Ncurve);
         if (!fit.ok) {
             warning(this, "Custom Fit",
                     QString("The fit could not be completed:\n%1").arg(fit.error));
@@ -920,6 +1167,25 @@ void ChartWindow::postProcess()
         report += QString("\n  RMS residual = %1\n  iterations   = %2")
                       .arg(fit.rms, 0, 'g', 6)
                       .arg(fit.iterations);
+        if (starts > 1) {
+            // the distinct minima reached from the starting points, best first
+            constexpr int MAX_MINIMA = 5;
+            report += QString("\n\n%1 distinct minima from %2 starting points:")
+                          .arg(fit.minima.size())
+                          .arg(starts);
+            for (int k = 0; (k < fit.minima.size()) && (k < MAX_MINIMA); ++k) {
+                const FitMinimum &m = fit.minima[k];
+                QStringList values;
+                for (const auto &p : m.params)
+                    values << QString("%1=%2").arg(p.name).arg(p.value, 0, 'g', 6);
+                report += QString("\n  %1. RMS %2 (%3x): %4")
+                              .arg(k + 1)
+                              .arg(m.rms, 0, 'g', 6)
+                              .arg(m.count)
+                              .arg(values.join(", "));
+            }
+            if (fit.minima.size() > MAX_MINIMA) report += "\n  ...";
+        }
         information(this, "Custom Fit", report);
         return;
     }
@@ -933,7 +1199,7 @@ void ChartWindow::postProcess()
         QList<QPointF> curve;
         for (int k = 0; k <= Ncurve; ++k) {
             const double x = xmin + (xmax - xmin) * k / Ncurve;
-            curve.append(QPointF(x, evalPolynomial(f.coeffs, x)));
+            curve.append(QPointF(x, evalPolynomialFit(f, x)));
         }
         const QString polyName = QString("Poly deg %1").arg(static_cast<int>(f.coeffs.size()) - 1);
         chart->setFitCurve(curve, polyName, /* eosMode= */ true);
@@ -945,6 +1211,12 @@ void ChartWindow::postProcess()
             QString("Polynomial fit of degree %1\n\n").arg(static_cast<int>(f.coeffs.size()) - 1);
         for (int i = 0; i < static_cast<int>(f.coeffs.size()); ++i)
             report += QString("  c[%1] = %2\n").arg(i).arg(f.coeffs[i], 0, 'g', 8);
+        // the plain coefficients cancel far from x = 0; the curve uses this form
+        report += QString("\n  or, with t = (x - %1) / %2:\n")
+                      .arg(f.xshift, 0, 'g', 8)
+                      .arg(f.xscale, 0, 'g', 8);
+        for (int i = 0; i < static_cast<int>(f.scaled.size()); ++i)
+            report += QString("  b[%1] = %2\n").arg(i).arg(f.scaled[i], 0, 'g', 8);
         report += QString("\n  RMS residual = %1").arg(f.rms, 0, 'g', 6);
         information(this, "Polynomial Fit", report);
         return;
@@ -1059,55 +1331,182 @@ void ChartWindow::postProcess()
 
 void ChartWindow::addDataFile()
 {
-    if (cols.empty()) return;
-
-    const QString fileName = QFileDialog::getOpenFileName(this, "Add Data from File",
-                                                          QDir::currentPath(), Cfg::FILTER_DATA);
-    if (fileName.isEmpty()) return;
-
-    QString error;
-    PlotData data = loadPlotData(fileName, &error);
-    if (data.isEmpty()) {
-        critical(this, "Add Data from File",
-                 "Could not read data from file:", error.isEmpty() ? fileName : error);
-        return;
-    }
-
-    PlotDataDialog dialog(data, this);
-    if (dialog.exec() != QDialog::Accepted) return;
-    const PlotData plotData = dialog.buildData();
-    const QList<int> ycols  = dialog.yColumns();
-    const int xcol          = dialog.xColumn();
-    if (ycols.isEmpty() || xcol < 0 || xcol >= plotData.columnCount()) return;
-
     ChartViewer *chart = currentChart();
-    if (!chart) return;
+    if (cols.empty() || !chart) return;
+
+    const QStringList fileNames = QFileDialog::getOpenFileNames(
+        this, "Add Data from Files", QDir::currentPath(), Cfg::FILTER_DATA);
+    if (fileNames.isEmpty()) return;
+    const int nfiles = static_cast<int>(fileNames.size());
+
+    // the files are parsed on a pool of threads and taken over by the GUI
+    // thread as they are done, so the chart stays responsive and grows file by file
+    struct LoadedFile {
+        PlotData data;
+        QString error;
+        bool done = false;
+    };
+    std::vector<LoadedFile> loaded(nfiles);
+    std::mutex loadedMutex;
+    std::atomic<int> next{0};
+    std::atomic<bool> stop{false};
+    // with several workers each file is parsed single-threaded, so the parser
+    // does not start another thread per core inside every worker
+    const int nthreads     = std::max(1, std::min(QThread::idealThreadCount(), nfiles));
+    const int parseThreads = (nthreads > 1) ? 1 : 0;
+
+    auto worker = [&]() {
+        for (int i = next++; (i < nfiles) && !stop; i = next++) {
+            LoadedFile file;
+            file.data = loadPlotData(fileNames[i], &file.error, nullptr, parseThreads);
+            file.done = true;
+            std::lock_guard<std::mutex> lock(loadedMutex);
+            loaded[i] = std::move(file);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < nthreads; ++i)
+        threads.emplace_back(worker);
+
+    QProgressDialog progress(QString("Reading %1 data files ...").arg(nfiles), "Cancel", 0, nfiles,
+                             this);
+    progress.setWindowTitle("LAMMPS-GUI - Add Data from Files");
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(LOAD_DELAY);
+    progress.setAutoClose(false);
+    progress.setAutoReset(false);
+    progress.setValue(0);
+    QObject::connect(&progress, &QProgressDialog::canceled, &progress, [&]() { stop = true; });
+
+    // the columns are chosen from the first file that is read, and picked by
+    // name from the others; derived columns exist only in the first file
+    bool chosen = false;
+    QString xname;               // name of the x column in the files
+    QStringList ynames, ylabels; // names of the y columns in the files, and their legends
+    const QStringList prefixes = overlayPrefixes(fileNames);
+    int colorIdx               = chart->overlaySeriesCount();
+    QStringList failed;
+
+    auto addOverlays = [&](int file, const PlotData &data, int xcol, const QList<int> &ycols,
+                           const QStringList &labels) {
+        const std::vector<double> &xvals = data.column(xcol);
+        const int nrow                   = data.rowCount();
+        for (int k = 0; k < ycols.size(); ++k) {
+            QList<QPointF> pts;
+            pts.reserve(nrow);
+            const std::vector<double> &yvals = data.column(ycols[k]);
+            for (int r = 0; r < nrow; ++r)
+                pts.append(QPointF(xvals[r], yvals[r]));
+            const QString name = (nfiles > 1) ? prefixes[file] + ": " + labels[k] : labels[k];
+            chart->addOverlaySeries(pts, name, overlayColor(colorIdx++));
+        }
+        // new data was added (and re-fit to the full range): match the sliders to it
+        resetRangeSliders();
+    };
+    auto addFile = [&](int file, const PlotData &data) {
+        const int xcol = xname.isEmpty() ? -1 : static_cast<int>(data.columnNames().indexOf(xname));
+        QList<int> ycols;
+        QStringList labels;
+        for (int k = 0; k < ynames.size(); ++k) {
+            const int ycol =
+                ynames[k].isEmpty() ? -1 : static_cast<int>(data.columnNames().indexOf(ynames[k]));
+            if (ycol < 0) continue;
+            ycols << ycol;
+            labels << ylabels[k];
+        }
+        if ((xcol < 0) || ycols.isEmpty())
+            failed << QString("%1: the chosen columns were not found").arg(fileNames[file]);
+        else
+            addOverlays(file, data, xcol, ycols, labels);
+    };
 
-    const std::vector<double> &xvals = plotData.column(xcol);
-    const int nrow                   = plotData.rowCount();
+    // take over the files that are done; files read before the columns are
+    // chosen wait in `pending`
+    std::vector<bool> taken(nfiles, false);
+    int ntaken = 0;
+    std::vector<std::pair<int, PlotData>> pending;
+    auto poll = [&]() {
+        for (int i = 0; i < nfiles; ++i) {
+            if (taken[i]) continue;
+            LoadedFile file;
+            {
+                std::lock_guard<std::mutex> lock(loadedMutex);
+                if (!loaded[i].done) continue;
+                file = std::move(loaded[i]);
+            }
+            taken[i] = true;
+            ++ntaken;
+            if (file.data.isEmpty())
+                failed << (file.error.isEmpty() ? fileNames[i] : fileNames[i] + ": " + file.error);
+            else if (!chosen)
+                pending.emplace_back(i, std::move(file.data));
+            else if (!stop)
+                addFile(i, file.data);
+        }
+        progress.setValue(ntaken);
+    };
 
-    // auto-color palette for overlay series (avoids primary raw/smooth colors)
-    static const QList<QColor> palette = {
-        QColor(220, 80, 40),  // red-orange
-        QColor(40, 160, 40),  // green
-        QColor(160, 40, 220), // purple
-        QColor(180, 140, 0),  // amber
-        QColor(0, 160, 180),  // teal
+    QEventLoop loop;
+    QTimer ticker;
+    std::function<bool()> ready;
+    QObject::connect(&ticker, &QTimer::timeout, &ticker, [&]() {
+        poll();
+        if (ready()) loop.quit();
+    });
+    auto waitUntil = [&](const std::function<bool()> &condition) {
+        ready = condition;
+        poll();
+        if (ready()) return;
+        ticker.start(LOAD_TICK);
+        loop.exec();
+        ticker.stop();
     };
-    int colorIdx = chart->overlaySeriesCount();
 
-    for (int ycol : ycols) {
-        if (ycol < 0 || ycol >= plotData.columnCount()) continue;
-        QList<QPointF> pts;
-        pts.reserve(nrow);
-        const std::vector<double> &yvals = plotData.column(ycol);
-        for (int r = 0; r < nrow; ++r)
-            pts.append(QPointF(xvals[r], yvals[r]));
-        chart->addOverlaySeries(pts, plotData.columnName(ycol), palette[colorIdx % palette.size()]);
-        ++colorIdx;
+    waitUntil([&]() { return stop || !pending.empty() || (ntaken == nfiles); });
+    if (!stop && !pending.empty()) {
+        const int first     = pending.front().first;
+        const PlotData data = std::move(pending.front().second);
+        pending.erase(pending.begin());
+
+        PlotDataDialog dialog(data, this);
+        if (dialog.exec() == QDialog::Accepted) {
+            const PlotData plotData = dialog.buildData();
+            const QList<int> ycols  = dialog.yColumns();
+            const int xcol          = dialog.xColumn();
+            if (!ycols.isEmpty() && (xcol >= 0) && (xcol < plotData.columnCount())) {
+                chosen = true;
+                // derived columns (past the columns of the file) have no name to look up
+                const auto nameInFile = [&data](int c) {
+                    return (c < data.columnCount()) ? data.columnName(c) : QString();
+                };
+                xname = nameInFile(xcol);
+                QList<int> plotted;
+                for (int ycol : ycols) {
+                    if ((ycol < 0) || (ycol >= plotData.columnCount())) continue;
+                    plotted << ycol;
+                    ynames << nameInFile(ycol);
+                    ylabels << plotData.columnName(ycol);
+                }
+                addOverlays(first, plotData, xcol, plotted, ylabels);
+                for (const auto &file : pending)
+                    addFile(file.first, file.second);
+                pending.clear();
+            }
+        }
+        // without a choice of columns there is nothing to read the other files for
+        if (!chosen) stop = true;
     }
-    // new data was added (and re-fit to the full range): match the sliders to it
-    resetRangeSliders();
+    if (!stop) waitUntil([&]() { return stop || (ntaken == nfiles); });
+
+    // a canceled load waits for the files being read, but does not plot them
+    stop = true;
+    for (auto &t : threads)
+        t.join();
+    // hide() rather than close(): QProgressDialog emits canceled() on a close event
+    progress.hide();
+
+    if (!failed.isEmpty())
+        critical(this, "Add Data from Files", "Could not add data from file:", failed.join('\n'));
 }
 
 void ChartWindow::referenceLines()
@@ -1349,6 +1748,7 @@ void ChartWindow::updateYLabel()
         // into a single legend entry.
         cols[active]->series->name = label;
         if (cols[active]->scatter) cols[active]->scatter->name = label;
+        store.renameColumn(active + 1, label);
         viewer->setYLabel(label);
     }
 }
@@ -1386,62 +1786,148 @@ void ChartWindow::saveAs()
     exportImage(this, &chartimage, "ChartWindow", defaultname);
 }
 
-PlotData ChartWindow::chartsToPlotData() const
+const PlotData &ChartWindow::chartsToPlotData() const
 {
-    PlotData data;
-    QStringList names;
-    names << "Step";
-    for (const auto &c : cols)
-        names << c->series->name;
-    data.setColumnNames(names);
-
-    const int lines = cols.empty() ? 0 : cols[0]->series->count();
-    for (int i = 0; i < lines; ++i) {
-        std::vector<double> row;
-        row.reserve(names.size());
-        row.push_back(cols[0]->series->at(i).x());
-        for (const auto &c : cols)
-            row.push_back(c->series->at(i).y());
-        data.appendRow(row);
-    }
-    return data;
+    return store;
 }
 
-// write the already formatted chart data to a file
+// ask for a file name and stream the chart data to it
 static void writeExport(QWidget *parent, const QString &caption, const QString &defaultname,
-                        const QString &filter, const QString &suffix, const QString &text)
+                        const QString &filter, const QString &suffix,
+                        const std::function<bool(QIODevice &)> &write)
 {
     QString fileName = QFileDialog::getSaveFileName(
         parent, caption, QDir::current().absoluteFilePath(defaultname), filter);
     if (fileName.isEmpty()) return;
     fileName = ensureFileSuffix(fileName, suffix);
-    QFile file(fileName);
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&file);
-        out << text;
-        file.close();
-    }
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text) || !write(file) || !file.commit())
+        warning(parent, caption, "Could not write data to file:", fileName);
 }
 
 void ChartWindow::exportDat()
 {
     if (cols.empty()) return;
     writeExport(this, "Save Chart as Gnuplot data", defaultFileStem(filename) + ".dat",
-                Cfg::FILTER_GNUPLOT, "dat", writePlotDat(chartsToPlotData(), filename));
+                Cfg::FILTER_GNUPLOT, "dat", [this](QIODevice &out) {
+                    return writePlotDat(chartsToPlotData(), out, filename);
+                });
 }
 
 void ChartWindow::exportCsv()
 {
     if (cols.empty()) return;
     writeExport(this, "Save Chart as CSV data", defaultFileStem(filename) + ".csv", Cfg::FILTER_CSV,
-                "csv", writePlotCsv(chartsToPlotData()));
+                "csv", [this](QIODevice &out) { return writePlotCsv(chartsToPlotData(), out); });
 }
 
 void ChartWindow::exportYaml()
 {
     if (cols.empty()) return;
     writeExport(this, "Save Chart as YAML data", defaultFileStem(filename) + ".yaml",
-                Cfg::FILTER_YAML, "yaml", writePlotYaml(chartsToPlotData()));
+                Cfg::FILTER_YAML, "yaml",
+                [this](QIODevice &out) { return writePlotYaml(chartsToPlotData(), out); });
+}
+
+void ChartWindow::exportBinary()
+{
+    if (cols.empty()) return;
+    QString fileName = QFileDialog::getSaveFileName(
+        this, "Save Chart as binary data",
+        QDir::current().absoluteFilePath(defaultFileStem(filename) + ".lgpd"),
+        Cfg::FILTER_PLOTBIN);
+    if (fileName.isEmpty()) return;
+    fileName = ensureFileSuffix(fileName, "lgpd");
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || !writePlotBinary(chartsToPlotData(), file) ||
+        !file.commit())
+        warning(this, "Export Binary Data", "Could not write data to file:", fileName);
+}
+
+void ChartWindow::exportStats()
+{
+    if (cols.empty()) return;
+    QString text;
+    QTextStream out(&text);
+    out << "property,count,mean,stddev,min,max,last,window,window_mean,window_stddev\n";
+    const auto num = [](double v) { return QString::number(v, 'g', 10); };
+    for (const auto &c : cols) {
+        const RunningStats &st = c->stats;
+        out << '"' << c->yTitle << "\"," << st.count() << ',' << num(st.mean()) << ','
+            << num(st.stddev()) << ',' << num(st.min()) << ',' << num(st.max()) << ','
+            << num(st.last()) << ',' << st.windowCount() << ',' << num(st.windowMean()) << ','
+            << num(st.windowStddev()) << '\n';
+    }
+    writeExport(this, "Save Chart Statistics as CSV data", defaultFileStem(filename) + ".stats.csv",
+                Cfg::FILTER_CSV, "csv",
+                [&text](QIODevice &out) { return out.write(text.toUtf8()) >= 0; });
+}
+
+const RunningStats *ChartWindow::statistics(int chart) const
+{
+    if ((chart < 0) || (chart >= static_cast<int>(cols.size()))) return nullptr;
+    return &cols[chart]->stats;
+}
+
+void ChartWindow::selectStorage(QAction *choice)
+{
+    const auto selected = static_cast<ChartStorage>(choice->data().toInt());
+    if (selected == storage) return;
+    storage = selected;
+    applyStorage();
+
+    // single precision rounds the values: re-derive the bounds and statistics, and
+    // have the renderers drop what they cached of the old values
+    for (std::size_t i = 0; i < cols.size(); ++i) {
+        cols[i]->series->setView(&store, 0, static_cast<int>(i) + 1);
+        updateColumnBounds(*cols[i]);
+    }
+    if (active >= 0) {
+        viewer->setColumn(cols[active].get());
+        viewer->setReferenceLines(refLines);
+        applySliderWindow();
+    }
+    updateStats();
+}
+
+void ChartWindow::applyStorage()
+{
+    // the x column is exact in either compact mode (non-integer x values stay in
+    // full precision), while only Compact rounds the chart values
+    for (int c = 0; c < store.columnCount(); ++c) {
+        if (storage == ChartStorage::Full)
+            store.setPacking(c, ColumnPacking::Double);
+        else if (c == 0)
+            store.setPacking(c, ColumnPacking::Delta);
+        else
+            store.setPacking(c, (storage == ChartStorage::Compact) ? ColumnPacking::Float
+                                                                   : ColumnPacking::Double);
+    }
+}
+
+void ChartWindow::updateStats()
+{
+    if (!statsLabel) return;
+    // the tooltip also tells how much memory the chosen data storage takes
+    statsLabel->setToolTip(QString("Statistics of all data of the selected property and of the "
+                                   "last %1 values\nChart data: %2 kB")
+                               .arg(Cfg::CHART_STATS_WINDOW)
+                               .arg((store.memoryUsage() + 1023) / 1024));
+    if ((active < 0) || (cols[active]->stats.count() == 0)) {
+        statsLabel->clear();
+        return;
+    }
+    const RunningStats &st = cols[active]->stats;
+    const auto num         = [](double v) { return QString::number(v, 'g', 6); };
+    QString text           = QString("N: %1   Mean: %2   Std. dev.: %3   Min: %4   Max: %5")
+                       .arg(st.count())
+                       .arg(num(st.mean()), num(st.stddev()), num(st.min()), num(st.max()));
+    // the recent window only tells something new once older data has left it
+    if (st.count() > st.windowCount())
+        text += QString("   Last %1: %2 +/- %3")
+                    .arg(st.windowCount())
+                    .arg(num(st.windowMean()), num(st.windowStddev()));
+    statsLabel->setText(text);
 }
 
 void ChartWindow::changeChart(int)
@@ -1457,6 +1943,7 @@ void ChartWindow::changeChart(int)
         // restore this column's processed-slot label ("Smooth" or its fit name)
         smooth->setItemText(1, cols[active]->procLabel);
     }
+    updateStats();
 
     // sync the SG parameter spinbox state (irrelevant while a fit overrides the slot)
     const bool isEos     = currentChart() && currentChart()->isEosFit();
@@ -1498,553 +1985,6 @@ bool ChartWindow::eventFilter(QObject *watched, QEvent *event)
     return QWidget::eventFilter(watched, event);
 }
 
-/* -------------------------------------------------------------------- */
-
-// ---- column rendering pipeline ------------------------------------------
-// These free functions render a ChartColumn onto a given PlotWidget. They are
-// deliberately independent of any particular ChartViewer instance so that the
-// single shared PlotWidget can be pointed at any column. ChartViewer's methods
-// below are thin forwarders onto them.
-
-namespace {
-
-// Savitzky-Golay smoothing of an (x,y) point series: the y values are smoothed
-// via the shared least-squares core while the x values are preserved.
-QList<QPointF> calc_sgsmooth(const QList<QPointF> &input, std::size_t window, int order)
-{
-    const std::size_t ndat = input.count();
-    if (ndat < ((2 * window) + 2)) window = (ndat / 2) - 1;
-
-    if (window > 1) {
-        float_vect in(ndat);
-        QList<QPointF> rv(input);
-
-        for (std::size_t i = 0; i < ndat; ++i)
-            in[i] = input[i].y();
-
-        float_vect out = sg_smooth(in, window, order);
-
-        for (std::size_t i = 0; i < ndat; ++i)
-            rv[i].setY(out[i]);
-
-        return rv;
-    }
-    return input;
-}
-
-// Min/max of a column: the cached raw bounds plus any smoothed, fit, or overlay
-// curves, widened by a small y margin so extrema are not drawn on the plot
-// frame itself. Pure -- touches no PlotWidget.
-QRectF columnMinMax(const ChartColumn &col)
-{
-    qreal xmin = col.rawXmin;
-    qreal xmax = col.rawXmax;
-    qreal ymin = col.rawYmin;
-    qreal ymax = col.rawYmax;
-
-    // if plotting the smoothed data, include its range too
-    if (col.doSmooth && col.smooth) {
-        for (auto &p : col.smooth->points) {
-            xmin = qMin(xmin, p.x());
-            xmax = qMax(xmax, p.x());
-            ymin = qMin(ymin, p.y());
-            ymax = qMax(ymax, p.y());
-        }
-    }
-
-    // include any visible fit/overlay curve (EOS, polynomial, custom)
-    if (col.fit && col.fit->isVisible() && !col.fit->points.isEmpty()) {
-        for (auto &p : col.fit->points) {
-            xmin = qMin(xmin, p.x());
-            xmax = qMax(xmax, p.x());
-            ymin = qMin(ymin, p.y());
-            ymax = qMax(ymax, p.y());
-        }
-    }
-
-    // include extra overlay data series added from secondary files
-    for (auto &s : col.overlaySeries) {
-        if (s && s->isVisible()) {
-            for (auto &p : s->points) {
-                xmin = qMin(xmin, p.x());
-                xmax = qMax(xmax, p.x());
-                ymin = qMin(ymin, p.y());
-                ymax = qMax(ymax, p.y());
-            }
-        }
-    }
-    // note: vlines (reference lines) are decorative and excluded
-
-    // avoid (nearly) empty ranges on either axis
-    padEmptyRange(xmin, xmax);
-    padEmptyRange(ymin, ymax);
-
-    // add a little buffer space between the data extremes and the y-axis limits;
-    // a tighter framing is still available through the range sliders
-    const double ypad = Cfg::CHART_YPAD_FRACTION * (ymax - ymin);
-    ymin -= ypad;
-    ymax += ypad;
-
-    return {xmin, ymax, xmax - xmin, ymin - ymax};
-}
-
-// Register a series on the plot with the given color/width.
-void addColumnSeries(PlotWidget *plot, PlotSeries *s, const QColor &color, qreal width)
-{
-    s->color = color;
-    if (s->type == PlotSeriesType::Line) s->width = width;
-    plot->addSeries(s);
-}
-
-// Restyle an already-registered series and repaint.
-void styleColumnSeries(PlotWidget *plot, PlotSeries *s, const QColor &color, qreal width)
-{
-    s->color = color;
-    if (s->type == PlotSeriesType::Line) s->width = width;
-    plot->update();
-}
-
-// Draw a line series and, per the display mode, an accompanying scatter series
-// (created on demand and kept in sync with the line).
-void renderColumnSeries(PlotWidget *plot, PlotSeries *line, std::unique_ptr<PlotSeries> &points,
-                        ChartDisplayMode mode, const QColor &color, qreal width, qreal pointSize)
-{
-    const bool wantLines  = (mode != ChartDisplayMode::Points);
-    const bool wantPoints = (mode != ChartDisplayMode::Lines);
-
-    // line series
-    if (!plot->hasSeries(line))
-        addColumnSeries(plot, line, color, width);
-    else
-        styleColumnSeries(plot, line, color, width);
-    line->setVisible(wantLines);
-
-    // matching points, created on demand and kept in sync with the line
-    if (wantPoints) {
-        if (!points) {
-            points       = std::make_unique<PlotSeries>();
-            points->type = PlotSeriesType::Scatter;
-        }
-        points->name = line->name; // share the line's name so the legend dedups them
-        points->replace(line->points);
-        if (!plot->hasSeries(points.get()))
-            addColumnSeries(plot, points.get(), color, width);
-        else
-            styleColumnSeries(plot, points.get(), color, width);
-        points->markerSize = pointSize;
-        points->setVisible(true);
-    } else if (points) {
-        points->setVisible(false);
-    }
-}
-
-// Recompute and (re)draw a column's raw and smoothed series onto the plot.
-void refreshColumn(PlotWidget *plot, ChartColumn &col)
-{
-    QSettings settings;
-    settings.beginGroup(Keys::GROUP_CHARTS);
-    int rawidx    = settings.value(Keys::RAWBRUSH, 1).toInt();
-    int smoothidx = settings.value(Keys::SMOOTHBRUSH, 2).toInt();
-    if ((rawidx < 0) || (rawidx >= mybrushes.size())) rawidx = 0;
-    if ((smoothidx < 0) || (smoothidx >= mybrushes.size())) smoothidx = 0;
-    settings.endGroup();
-
-    const QColor rawcol = col.rawColor.isValid() ? col.rawColor : mybrushes[rawidx].color();
-    const QColor smcol = col.smoothcolor.isValid() ? col.smoothcolor : mybrushes[smoothidx].color();
-
-    if (col.doRaw)
-        renderColumnSeries(plot, col.series.get(), col.scatter, col.dispmode, rawcol, col.rawWidth,
-                           col.rawPointSize);
-
-    if (col.doSmooth) {
-        if (col.eosMode && col.fit && !col.fit->points.isEmpty()) {
-            // EOS fit acts as the "processed" series; suppress the SG smooth
-            col.fit->setVisible(true);
-            if (col.smooth) col.smooth->setVisible(false);
-            if (col.smoothScatter) col.smoothScatter->setVisible(false);
-        } else if (!col.eosMode && col.series->count() > (2 * col.window)) {
-            if (col.fit) col.fit->setVisible(false);
-            if (!col.smooth) {
-                col.smooth       = std::make_unique<PlotSeries>();
-                col.smooth->name = QStringLiteral("Smooth"); // legend label for the SG series
-            }
-            col.smooth->replace(calc_sgsmooth(col.series->points, col.window, col.order));
-            renderColumnSeries(plot, col.smooth.get(), col.smoothScatter, col.smoothmode, smcol,
-                               col.smoothwidth, col.smoothpointsize);
-        }
-    } else {
-        if (col.eosMode && col.fit) col.fit->setVisible(false);
-    }
-    plot->update();
-}
-
-// Reset the plot ranges to fit the column's data and re-anchor its reference lines.
-void resetColumnZoom(PlotWidget *plot, ChartColumn &col)
-{
-    auto ranges = columnMinMax(col);
-    // update reference lines to span the current data range along their axis
-    const double ybot = ranges.bottom();
-    const double ytop = ranges.top();
-    for (std::size_t i = 0; i < col.vlines.size(); ++i) {
-        const RefLine &rl = col.reflineDefs[static_cast<int>(i)];
-        if (rl.orient == RefOrient::Vertical)
-            col.vlines[i]->replace(QList<QPointF>{{rl.value, ybot}, {rl.value, ytop}});
-        else
-            col.vlines[i]->replace(
-                QList<QPointF>{{ranges.left(), rl.value}, {ranges.right(), rl.value}});
-    }
-    plot->setXRange(ranges.left(), ranges.right());
-    plot->setYRange(ybot, ytop);
-    plot->update();
-}
-
-// Append a point to a column's raw series (monotonic in x) and update its cached
-// bounds. Pure data: returns true if the point was appended (x advanced).
-bool appendColumnPoint(ChartColumn &col, double x, double y)
-{
-    if (col.lastX >= x) return false;
-    col.lastX = x;
-    col.series->append(x, y);
-    col.rawXmin = qMin(col.rawXmin, x);
-    col.rawXmax = qMax(col.rawXmax, x);
-    col.rawYmin = qMin(col.rawYmin, y);
-    col.rawYmax = qMax(col.rawYmax, y);
-    return true;
-}
-
-// Set the raw-series display style and redraw.
-void setColumnDisplayStyle(PlotWidget *plot, ChartColumn &col, ChartDisplayMode mode,
-                           const QColor &color, qreal width, qreal pointSize)
-{
-    col.dispmode     = mode;
-    col.rawColor     = color;
-    col.rawWidth     = width;
-    col.rawPointSize = pointSize;
-    refreshColumn(plot, col);
-    resetColumnZoom(plot, col);
-}
-
-// Set the processed-series display style and redraw.
-void setColumnSmoothStyle(PlotWidget *plot, ChartColumn &col, ChartDisplayMode mode,
-                          const QColor &color, qreal width, qreal pointSize)
-{
-    col.smoothmode      = mode;
-    col.smoothcolor     = color;
-    col.smoothwidth     = width;
-    col.smoothpointsize = pointSize;
-    refreshColumn(plot, col);
-    resetColumnZoom(plot, col);
-}
-
-// Set or replace the column's fit-curve overlay (EOS, polynomial, custom).
-void setColumnFitCurve(PlotWidget *plot, ChartColumn &col, const QList<QPointF> &points,
-                       const QString &name, bool eos)
-{
-    col.eosMode = eos;
-    if (!col.fit) {
-        col.fit = std::make_unique<PlotSeries>();
-        addColumnSeries(plot, col.fit.get(), QColor(220, 30, 30), 2.0); // distinct fit-curve color
-    }
-    if (!name.isEmpty()) col.fit->name = name;
-    col.fit->replace(points);
-    if (col.eosMode) {
-        // visibility follows doSmooth: refreshColumn will show/hide it correctly
-        refreshColumn(plot, col);
-    } else {
-        col.fit->setVisible(true);
-    }
-    resetColumnZoom(plot, col);
-}
-
-// Add an extra overlay data series (from a secondary file) to the column.
-void addColumnOverlay(PlotWidget *plot, ChartColumn &col, const QList<QPointF> &pts,
-                      const QString &name, const QColor &color)
-{
-    auto s  = std::make_unique<PlotSeries>();
-    s->name = name;
-    s->replace(pts);
-    addColumnSeries(plot, s.get(), color, col.rawWidth);
-    col.overlaySeries.push_back(std::move(s));
-    resetColumnZoom(plot, col);
-}
-
-// Remove all reference lines from the column and the plot.
-void clearColumnVerticalLines(PlotWidget *plot, ChartColumn &col)
-{
-    for (auto &s : col.vlines)
-        plot->removeSeries(s.get());
-    col.vlines.clear();
-    col.reflineDefs.clear();
-}
-
-// Replace the column's reference lines with the given definitions.
-void setColumnReferenceLines(PlotWidget *plot, ChartColumn &col, const QList<RefLine> &lines)
-{
-    clearColumnVerticalLines(plot, col);
-    if (lines.isEmpty()) return;
-    auto ranges = columnMinMax(col);
-    for (const auto &rl : lines) {
-        auto s  = std::make_unique<PlotSeries>();
-        s->name = rl.label;
-        if (rl.orient == RefOrient::Vertical)
-            s->replace(QList<QPointF>{{rl.value, ranges.bottom()}, {rl.value, ranges.top()}});
-        else
-            s->replace(QList<QPointF>{{ranges.left(), rl.value}, {ranges.right(), rl.value}});
-        const QColor c = rl.color.isValid() ? rl.color : QColor(80, 80, 80);
-        // dashed reference line, with an optional label drawn next to it
-        s->style = Qt::DashLine;
-        if (!rl.label.isEmpty()) {
-            s->isReference = true;
-            s->refLabel    = rl.label;
-            s->refAnchor   = rl.anchor;
-        }
-        addColumnSeries(plot, s.get(), c, 1.5);
-        col.vlines.push_back(std::move(s));
-        col.reflineDefs.append(rl);
-    }
-    // reference lines are annotations anchored to the full data extent (and
-    // clipped to the view); they do not change the data range, so leave the
-    // displayed range -- and the range sliders that drive it -- untouched
-    plot->update();
-}
-
-// Apply smoothing flags/parameters to the column WITHOUT redrawing (so a
-// non-active column can be updated without touching the shared plot).
-void setColumnSmoothFlags(ChartColumn &col, bool doRaw, bool doSmooth, int window, int order)
-{
-    // hide raw plot (keep the series alive; data is still needed for smoothing)
-    if (!doRaw) {
-        if (col.series) col.series->setVisible(false);
-        if (col.scatter) col.scatter->setVisible(false);
-    }
-    // hide processed plot (keep the series alive for quick re-enable)
-    if (!doSmooth) {
-        if (col.smooth) col.smooth->setVisible(false);
-        if (col.smoothScatter) col.smoothScatter->setVisible(false);
-        if (col.eosMode && col.fit) col.fit->setVisible(false);
-    }
-    col.doRaw    = doRaw;
-    col.doSmooth = doSmooth;
-    col.window   = window;
-    col.order    = order;
-}
-
-// Replace a column's raw series with a full point list and recompute its cached
-// bounds, WITHOUT redrawing (for loading non-active columns).
-void setColumnData(ChartColumn &col, const QList<QPointF> &points)
-{
-    col.series->replace(points);
-    col.lastX   = points.isEmpty() ? -1.0 : points.last().x();
-    col.rawXmin = col.rawYmin = 1.0e100;
-    col.rawXmax = col.rawYmax = -1.0e100;
-    for (const auto &p : points) {
-        col.rawXmin = qMin(col.rawXmin, p.x());
-        col.rawXmax = qMax(col.rawXmax, p.x());
-        col.rawYmin = qMin(col.rawYmin, p.y());
-        col.rawYmax = qMax(col.rawYmax, p.y());
-    }
-}
-
-} // namespace
-
-/* -------------------------------------------------------------------- */
-
-ChartViewer::ChartViewer(QWidget *parent) :
-    QWidget(parent), plot(nullptr), updChart(Cfg::CHART_UPDATE_INTERVAL_DEFAULT), col(nullptr)
-{
-    plot = new PlotWidget(this);
-    plot->setXTitle("Time step");
-    plot->setXLabelFormat("%d");
-
-    QSettings settings;
-    // cache the live-update throttle interval once; re-reading it per appended
-    // point would construct a QSettings object on the hot thermo path
-    updChart = settings.value(Keys::UPDCHART, Cfg::CHART_UPDATE_INTERVAL_DEFAULT).toInt();
-    settings.beginGroup(Keys::GROUP_CHARTS);
-    plot->setGrid(settings.value(Keys::GRID, true).toBool(),
-                  settings.value(Keys::MINORGRID, true).toBool());
-    settings.endGroup();
-
-    auto *layout = new QVBoxLayout(this);
-    layout->setContentsMargins(0, 0, 0, 0);
-    layout->addWidget(plot);
-}
-
-/* -------------------------------------------------------------------- */
-
-ChartViewer::~ChartViewer() = default;
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::setColumn(ChartColumn *c)
-{
-    plot->clearSeries();
-    col = c;
-    if (!col) {
-        plot->update();
-        return;
-    }
-    // re-register the column's persistent overlays/fit (they keep their styling);
-    // the raw/smoothed series are (re)created and styled by refreshColumn, and the
-    // reference lines are (re)applied by ChartWindow after binding.
-    if (col->fit) plot->addSeries(col->fit.get());
-    for (auto &s : col->overlaySeries)
-        plot->addSeries(s.get());
-    refreshColumn(plot, *col);
-    plot->setYTitle(col->yTitle);
-    resetColumnZoom(plot, *col);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::addPoint(double x, double y)
-{
-    if (appendColumnPoint(*col, x, y)) {
-        // update the chart display only after at least updChart milliseconds have passed
-        if (col->lastUpdate.msecsTo(QTime::currentTime()) > updChart) {
-            col->lastUpdate = QTime::currentTime();
-            refreshColumn(plot, *col);
-            resetColumnZoom(plot, *col);
-        }
-    }
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::setXAxisRange(double min, double max)
-{
-    plot->setXRange(min, max);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::setYAxisRange(double min, double max)
-{
-    plot->setYRange(min, max);
-}
-
-/* -------------------------------------------------------------------- */
-
-QString ChartViewer::getName() const
-{
-    return col->series->name;
-}
-
-/* -------------------------------------------------------------------- */
-
-QString ChartViewer::getXLabel() const
-{
-    return plot->xTitle();
-}
-
-/* -------------------------------------------------------------------- */
-
-QString ChartViewer::getYLabel() const
-{
-    return plot->yTitle();
-}
-
-/* -------------------------------------------------------------------- */
-
-QRectF ChartViewer::getMinMax() const
-{
-    return columnMinMax(*col);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::resetZoom()
-{
-    resetColumnZoom(plot, *col);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::setTLabel(const QString &tlabel)
-{
-    plot->setTitle(tlabel);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::setYLabel(const QString &ylabel)
-{
-    plot->setYTitle(ylabel);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::setXLabel(const QString &xlabel)
-{
-    plot->setXTitle(xlabel);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::setXLabelFormat(const QString &fmt)
-{
-    plot->setXLabelFormat(fmt);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::setDisplayStyle(ChartDisplayMode mode, const QColor &color, qreal width,
-                                  qreal pointSize)
-{
-    setColumnDisplayStyle(plot, *col, mode, color, width, pointSize);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::setSmoothStyle(ChartDisplayMode mode, const QColor &color, qreal width,
-                                 qreal pointSize)
-{
-    setColumnSmoothStyle(plot, *col, mode, color, width, pointSize);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::setFitCurve(const QList<QPointF> &points, const QString &name, bool eos)
-{
-    setColumnFitCurve(plot, *col, points, name, eos);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::addOverlaySeries(const QList<QPointF> &pts, const QString &name,
-                                   const QColor &color)
-{
-    addColumnOverlay(plot, *col, pts, name, color);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::setReferenceLines(const QList<RefLine> &lines)
-{
-    setColumnReferenceLines(plot, *col, lines);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::setLegendPos(LegendPos pos)
-{
-    plot->setLegendPos(pos);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::setRefLabelStyle(double pointSize, double distance, bool boxed)
-{
-    plot->setRefLabelStyle(pointSize, distance, boxed);
-}
-
-/* -------------------------------------------------------------------- */
-
-void ChartViewer::updateSmooth()
-{
-    refreshColumn(plot, *col);
-}
-
 // Local Variables:
 // c-basic-offset: 4
 // End:
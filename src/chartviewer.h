@@ -12,7 +12,8 @@
 #ifndef CHARTVIEWER_H
 #define CHARTVIEWER_H
 
-#include "plotseries.h" // PlotSeries model + RefAnchor used by RefLine below
+#include "chartcolumn.h"
+#include "plotparse.h"
 
 #include <QColor>
 #include <QComboBox>
@@ -34,28 +35,17 @@ class QPushButton;
 class QSpinBox;
 class RangeSlider;
 
-class ChartViewer;
-struct ChartColumn;
 class LammpsGui;
 class PlotData;
-enum class LegendPos; // defined in plotwidget.h
-
-/** @brief Orientation of a reference line: a vertical line at x, or a horizontal line at y */
-enum class RefOrient { Vertical, Horizontal };
-
-/**
- * @brief A labeled vertical or horizontal reference line for chart overlays
- *
- * Used by the "Reference Lines..." dialog to annotate charts with vertical
- * markers at specific x positions (e.g. high-symmetry k-points in
- * phonon-dispersion plots) or horizontal markers at specific y values.
- */
-struct RefLine {
-    RefOrient orient = RefOrient::Vertical; ///< vertical (fixed x) or horizontal (fixed y)
-    double value;                           ///< x position (vertical) or y position (horizontal)
-    QString label;                          ///< text label (in line color)
-    QColor color;                           ///< line color (default: dark gray)
-    RefAnchor anchor = RefAnchor::Start;    ///< where the label sits along the line
+class QTimer;
+struct ThermoRow;
+enum class PlotFormat; // defined in plotdata.h
+
+/** @brief How a ChartWindow stores its chart data (File > Data Storage) */
+enum class ChartStorage {
+    Full,         ///< all values in full (double) precision
+    CompactSteps, ///< integer x values (steps) as offsets within blocks; exact
+    Compact,      ///< compact steps and the chart values in single precision
 };
 
 /**
@@ -128,9 +118,24 @@ public:
      * @param step Simulation step number
      * @param data Data value
      * @param index Chart index
+     *
+     * A step larger than the last one starts a new data row shared by all
+     * charts; the other charts are expected to add their value for the same
+     * step.  Steps smaller than the last one are ignored.
      */
     void addData(int step, double data, int index);
 
+    /**
+     * @brief Append a batch of thermo rows to all charts
+     * @param rows Rows in output order; each chart takes the value of its
+     *             thermo column (the chart index) from every row
+     *
+     * All rows are appended before the active chart is redrawn (at most once,
+     * subject to the usual update throttling), so the cost of a redraw does
+     * not grow with the number of rows in the batch.
+     */
+    void addRows(const std::vector<ThermoRow> &rows);
+
     /**
      * @brief Set the units displayed for thermodynamic quantities
      * @param _units Units string (e.g., "real", "metal", "lj")
@@ -161,6 +166,40 @@ public:
      */
     void loadData(const PlotData &data, int xcol, const QList<int> &ycols);
 
+    /**
+     * @brief Running statistics of a chart's data
+     * @param chart Position of the chart in the Data drop-down
+     * @return Statistics of all y values added so far, or nullptr for an invalid position
+     *
+     * The statistics are updated in O(1) as data is appended, so they can be
+     * queried at any time during a run.
+     */
+    const RunningStats *statistics(int chart) const;
+
+    /**
+     * @brief Allow following the data file of a standalone window as it grows
+     * @param format Format the file was parsed as
+     * @param ncol   Number of columns of the file
+     * @param offset Size of the file before it was loaded
+     * @return true if the file can be followed
+     *
+     * Call after loadData().  Only CSV and whitespace-separated files can be
+     * followed, and only if the x column and all charts are columns of the file
+     * (not columns derived in the column dialog).  Following then reads the
+     * bytes from @p offset on.
+     */
+    bool setFollowSource(PlotFormat format, int ncol, qint64 offset);
+
+    /**
+     * @brief Start or stop following the data file
+     * @param enable true to append the rows written to the file since the last check
+     *
+     * The file is polled (which also works for files written on another host
+     * of a shared file system), and only the appended bytes are read and
+     * parsed.  While following, the axes grow with the data as during a run.
+     */
+    void setFollow(bool enable);
+
 private slots:
     void quit();                          ///< Close window and quit
     void stopRun();                       ///< Stop running simulation
@@ -168,6 +207,7 @@ private slots:
     void postProcess();                   ///< Run an analysis on the current chart's data
     void addDataFile();                   ///< Add data from another file as overlay series
     void referenceLines();                ///< Edit reference lines for all charts
+    void selectStorage(QAction *choice);  ///< Switch the storage of the chart data
     void selectSmooth(int selection);     ///< Select smoothing algorithm
     void updateSmooth();                  ///< Update smoothing parameters
     void updateTLabel();                  ///< Update chart title
@@ -176,13 +216,16 @@ private slots:
     void updateXRange(int low, int high); ///< Update X-axis range
     void updateYRange(int low, int high); ///< Update Y-axis range
 
-    void copy();       ///< Copy image to clipboard
-    void saveAs();     ///< Save chart as image
-    void exportDat();  ///< Export data in DAT format
-    void exportCsv();  ///< Export data in CSV format
-    void exportYaml(); ///< Export data in YAML format
+    void copy();         ///< Copy image to clipboard
+    void saveAs();       ///< Save chart as image
+    void exportDat();    ///< Export data in DAT format
+    void exportCsv();    ///< Export data in CSV format
+    void exportYaml();   ///< Export data in YAML format
+    void exportBinary(); ///< Export data in binary plot data format
+    void exportStats();  ///< Export the running statistics of all charts in CSV format
 
     void changeChart(int index); ///< Switch to different chart
+    void readFollowed();         ///< Append the rows written to the followed file
 
 protected:
     /**
@@ -200,9 +243,14 @@ protected:
     bool eventFilter(QObject *watched, QEvent *event) override;
 
 private:
-    /// Collect the displayed charts into a PlotData (column 0 "Step", then one
-    /// column per chart) for the data exporters.
-    PlotData chartsToPlotData() const;
+    /// The data of all charts for the data exporters: column 0 holds the shared
+    /// x values ("Step" for thermo data), then one column per chart.  This is the
+    /// chart data store itself, not a copy.
+    const PlotData &chartsToPlotData() const;
+
+    /// Create the column state and Data-combo entry for the chart data already
+    /// present in column numCharts()+1 of the data store.
+    void bindChart(const QString &title, int index);
 
     /// Return the single chart view (bound to the currently selected column),
     /// or nullptr if no column exists yet.
@@ -215,6 +263,12 @@ private:
     /// active column (so it is restored when switching columns).
     void setProcessedLabel(const QString &label);
 
+    /// Convert all columns of the data store to the encoding of `storage`.
+    void applyStorage();
+
+    /// Show the running statistics of the active column below the chart.
+    void updateStats();
+
     /// Move both range-slider handles back to the full extent (no plot update).
     void resetRangeSliders();
 
@@ -232,308 +286,32 @@ private:
     QLineEdit *chartTitle, *chartYlabel,
         *chartXlabel;             ///< Chart labels (chartXlabel standalone only)
     QLabel *units;                ///< Units display
+    QLabel *statsLabel;           ///< Running statistics of the active column
     QCheckBox *norm;              ///< Normalization checkbox
     RangeSlider *xrange, *yrange; ///< Range sliders for axes
 
     QString filename;    ///< Log file path
     ChartViewer *viewer; ///< The single chart view (renders the active column)
     std::vector<std::unique_ptr<ChartColumn>> cols; ///< Per-column data/display state
+    /// Chart data: one shared x (step) column plus one column per chart, viewed
+    /// by the raw series of the charts
+    PlotData store;
+    ChartStorage storage;    ///< Encoding of the chart data (applied to new columns, too)
     int active;              ///< Index into cols of the rendered column (-1 = none)
     QList<RefLine> refLines; ///< Current set of reference lines (applied to the active column)
     LegendPos legendPos;     ///< In-plot legend placement (set in the Chart Style dialog)
     double refLabelSize;     ///< Reference-label font point size (window-wide)
     double refLabelDist;     ///< Reference-label gap from its line, in px (window-wide)
     bool refLabelBoxed;      ///< Whether reference labels get a framed opaque background
-};
-
-/* -------------------------------------------------------------------- */
-
-#include <memory>
-#include <vector>
-
-class PlotWidget;
-
-/**
- * @brief How a chart's raw data series is drawn
- */
-enum class ChartDisplayMode {
-    Lines,          ///< connect data points with lines only
-    Points,         ///< draw data points as markers only
-    LinesAndPoints, ///< draw both lines and markers
-};
 
-/**
- * @brief The per-column data and display state of one chart
- *
- * Holds everything specific to a single plotted column: its neutral PlotSeries
- * objects, cached data bounds, smoothing parameters, display style, and the
- * overlay/reference-line state. It is a plain (non-QWidget) value type,
- * move-only because of its unique_ptr<PlotSeries> members, so that the single
- * shared renderer can be pointed at any column on demand.
- */
-struct ChartColumn {
-    int index      = -1;                       ///< Chart index (thermo column id)
-    double lastX   = -1.0;                     ///< Last (largest) x value appended
-    double rawXmin = 1.0e100;                  ///< Running min x of the raw series (live path)
-    double rawXmax = -1.0e100;                 ///< Running max x of the raw series
-    double rawYmin = 1.0e100;                  ///< Running min y of the raw series
-    double rawYmax = -1.0e100;                 ///< Running max y of the raw series
-    int window     = 10;                       ///< Smoothing window
-    int order      = 4;                        ///< Smoothing polynomial order
-    std::unique_ptr<PlotSeries> series;        ///< Raw data series (always present)
-    std::unique_ptr<PlotSeries> smooth;        ///< Smoothed data series (created on demand)
-    std::unique_ptr<PlotSeries> scatter;       ///< Raw data as points (created on demand)
-    std::unique_ptr<PlotSeries> smoothScatter; ///< Processed data as points (created on demand)
-    std::unique_ptr<PlotSeries> fit;           ///< Optional fit-curve overlay (created on demand)
-    QTime lastUpdate;                          ///< Time of last chart update
-    bool doRaw    = true;                      ///< Show raw data series
-    bool doSmooth = false;                     ///< Show smoothed data series
-    bool eosMode  = false; ///< True when fit is a BM EOS overlay (visibility follows doSmooth)
-    ChartDisplayMode dispmode = ChartDisplayMode::Lines; ///< How the raw series is drawn
-    QColor rawColor;                   ///< Raw series color override (invalid = theme default)
-    qreal rawWidth              = 3.0; ///< Raw series line width
-    qreal rawPointSize          = 8.0; ///< Raw series marker diameter
-    ChartDisplayMode smoothmode = ChartDisplayMode::Lines; ///< How the processed series is drawn
-    QColor smoothcolor;          ///< Processed series color (invalid = theme default)
-    qreal smoothwidth     = 3.0; ///< Processed series line width
-    qreal smoothpointsize = 8.0; ///< Processed series marker diameter
-    std::vector<std::unique_ptr<PlotSeries>> overlaySeries; ///< Extra series from secondary files
-    std::vector<std::unique_ptr<PlotSeries>> vlines;        ///< Reference line series (decorative)
-    QList<RefLine> reflineDefs; ///< Reference line definitions (parallel to vlines)
-    QString yTitle;             ///< This column's Y-axis label (restored on the shared plot)
-    QString procLabel = QStringLiteral("Smooth"); ///< Label of the processed-series slot in the
-                                                  ///< Plot combo ("Smooth", or a fit/function name)
+    QAction *followAct;  ///< Follow File toggle (standalone mode only)
+    QTimer *followTimer; ///< Polls the followed file for appended data
+    /// Parser of the appended bytes (nullptr if the file cannot be followed)
+    std::unique_ptr<PlotParse::TailParser> tail;
+    QList<int> fileColumns; ///< File column of the x axis, then of each chart
+    qint64 followPos;       ///< File offset up to which the followed file was read
 };
 
-/**
- * @brief Rebindable view of a single ChartColumn
- *
- * ChartViewer renders whichever ChartColumn it is currently bound to
- * (via setColumn()) with its PlotWidget, supporting both raw and
- * smoothed data display. The column data objects are owned by
- * ChartWindow; this class is only the view.
- *
- * @see PlotWidget, PlotSeries, ChartColumn
- */
-class ChartViewer : public QWidget {
-    Q_OBJECT
-
-public:
-    /**
-     * @brief Constructor -- creates the renderer; no column is bound yet
-     * @param parent Parent widget
-     */
-    explicit ChartViewer(QWidget *parent = nullptr);
-
-    /**
-     * @brief Destructor
-     */
-    ~ChartViewer() override;
-
-    ChartViewer(const ChartViewer &)            = delete;
-    ChartViewer(ChartViewer &&)                 = delete;
-    ChartViewer &operator=(const ChartViewer &) = delete;
-    ChartViewer &operator=(ChartViewer &&)      = delete;
-
-    /**
-     * @brief Bind this view to a column (or nullptr) and render it
-     *
-     * Unregisters the previous column's series from the shared plot and
-     * (re)attaches and draws @p c, restoring its Y-axis label. The column is
-     * owned by ChartWindow, not by the viewer.
-     */
-    void setColumn(ChartColumn *c);
-
-    /**
-     * @brief Append an (x, y) data point to the chart
-     * @param x X value (e.g. the simulation step, or an arbitrary abscissa)
-     * @param y Y value
-     *
-     * The point is appended only if @p x is greater than the last appended x;
-     * this keeps the live thermo feed monotonic in the step number.
-     */
-    void addPoint(double x, double y);
-
-    /**
-     * @brief Get the min/max bounds of the data
-     * @return Rectangle containing data bounds
-     */
-    QRectF getMinMax() const;
-
-    /** @brief Set the displayed X-axis range (used by the range sliders) */
-    void setXAxisRange(double min, double max);
-    /** @brief Set the displayed Y-axis range (used by the range sliders) */
-    void setYAxisRange(double min, double max);
-
-    /**
-     * @brief Reset zoom to show all data
-     */
-    void resetZoom();
-
-    /**
-     * @brief Recalculate and update smoothed data
-     */
-    void updateSmooth();
-
-    /**
-     * @brief Get number of data points
-     * @return Number of points in series
-     */
-    int getCount() const { return col->series->count(); }
-
-    /**
-     * @brief Get the series (data column) name
-     * @return The property/column name this chart was created with
-     *
-     * This is the per-column identifier (e.g. the thermo keyword), distinct
-     * from the shared plot title. Used for data-export column headers.
-     */
-    QString getName() const;
-
-    /**
-     * @brief Get step number at given index
-     * @param index Data point index
-     * @return Step number (X value)
-     */
-    double getStep(int index) const { return (index < 0) ? 0.0 : col->series->at(index).x(); }
-
-    /**
-     * @brief Get data value at given index
-     * @param index Data point index
-     * @return Data value (Y value)
-     */
-    double getData(int index) const { return (index < 0) ? 0.0 : col->series->at(index).y(); }
-
-    /**
-     * @brief Set chart title
-     * @param tlabel New title
-     */
-    void setTLabel(const QString &tlabel);
-
-    /**
-     * @brief Set Y-axis label
-     * @param ylabel New Y-axis label
-     */
-    void setYLabel(const QString &ylabel);
-
-    /**
-     * @brief Set the X-axis label
-     * @param xlabel New X-axis label
-     */
-    void setXLabel(const QString &xlabel);
-
-    /**
-     * @brief Set the X-axis tick label format
-     * @param fmt printf-style format string (e.g. "%.6g" for floating-point,
-     *            "%d" for integer steps)
-     *
-     * Call after setXLabel() when the x-axis carries non-integer data (e.g.
-     * lattice constants from a Plot Data file).  The thermo live-feed path
-     * leaves the default integer format in place.
-     */
-    void setXLabelFormat(const QString &fmt);
-
-    /**
-     * @brief Add an overlay data series from a second file
-     * @param pts   (x, y) data points
-     * @param name  Series name (shown as a tooltip / legend entry)
-     * @param color Line color
-     *
-     * Overlay series are always shown in full (no smoothing); they are
-     * included in the axis range calculation.
-     */
-    void addOverlaySeries(const QList<QPointF> &pts, const QString &name, const QColor &color);
-
-    /** @brief Number of overlay series currently displayed */
-    int overlaySeriesCount() const { return static_cast<int>(col->overlaySeries.size()); }
-
-    /**
-     * @brief Set reference lines (replaces any existing set)
-     * @param lines List of reference line descriptors
-     *
-     * Each line spans the full data range perpendicular to its orientation
-     * and is updated on every zoom reset. Lines are described by their
-     * orientation, position, label (series name), anchor, and color.
-     */
-    void setReferenceLines(const QList<RefLine> &lines);
-
-    /** @brief Set the in-plot legend placement (corner, or off) */
-    void setLegendPos(LegendPos pos);
-
-    /** @brief Set the window-wide reference-label style (font size, gap, boxed) */
-    void setRefLabelStyle(double pointSize, double distance, bool boxed);
-
-    /**
-     * @brief Set how the raw data series is displayed
-     * @param mode  Lines, points, or both
-     * @param color Series color (invalid color falls back to the theme default)
-     * @param width Line width (used for the line and lines+points modes)
-     * @param pointSize Marker diameter (used for the points and lines+points modes)
-     */
-    void setDisplayStyle(ChartDisplayMode mode, const QColor &color, qreal width, qreal pointSize);
-
-    /** @brief Current display mode */
-    ChartDisplayMode displayMode() const { return col->dispmode; }
-    /** @brief Current series color (may be invalid, meaning the theme default) */
-    QColor displayColor() const { return col->rawColor; }
-    /** @brief Current line width */
-    qreal displayWidth() const { return col->rawWidth; }
-    /** @brief Current marker diameter */
-    qreal displayPointSize() const { return col->rawPointSize; }
-
-    /**
-     * @brief Set how the processed (smoothed) data series is displayed
-     * @param mode  Lines, points, or both
-     * @param color Series color (invalid color falls back to the theme default)
-     * @param width Line width (used for the line and lines+points modes)
-     * @param pointSize Marker diameter (used for the points and lines+points modes)
-     */
-    void setSmoothStyle(ChartDisplayMode mode, const QColor &color, qreal width, qreal pointSize);
-
-    /** @brief Current processed-series display mode */
-    ChartDisplayMode smoothMode() const { return col->smoothmode; }
-    /** @brief Current processed-series color (may be invalid, meaning the theme default) */
-    QColor smoothColor() const { return col->smoothcolor; }
-    /** @brief Current processed-series line width */
-    qreal smoothWidth() const { return col->smoothwidth; }
-    /** @brief Current processed-series marker diameter */
-    qreal smoothPointSize() const { return col->smoothpointsize; }
-
-    /**
-     * @brief Overlay a fit curve on the chart
-     * @param points  Curve points (x, y) drawn as an overlay line; created on
-     *                the first call and replaced on subsequent calls
-     * @param name    Optional series name for the overlay (e.g. the fitted
-     *                expression or a user label); shown wherever series names
-     *                are surfaced
-     * @param eosFit  When true the curve is treated as an EOS fit: its
-     *                visibility follows the doSmooth flag (hidden in Raw mode,
-     *                visible in Smoothed/Both mode) and it replaces the
-     *                Savitzky-Golay series while active.
-     */
-    void setFitCurve(const QList<QPointF> &points, const QString &name = QString(),
-                     bool eosFit = false);
-
-    /** @brief True when the current fit overlay is a Birch-Murnaghan EOS fit */
-    bool isEosFit() const { return col->eosMode && col->fit && !col->fit->points.isEmpty(); }
-
-    /**
-     * @brief Get X-axis label
-     * @return X-axis label
-     */
-    QString getXLabel() const;
-
-    /**
-     * @brief Get Y-axis label
-     * @return Y-axis label
-     */
-    QString getYLabel() const;
-
-private:
-    PlotWidget *plot; ///< Renderer (Qt child of this widget)
-    int updChart;     ///< Cached live-update throttle interval (ms)
-    ChartColumn *col; ///< Column currently rendered (owned by ChartWindow, not here)
-};
 #endif
 
 // Local Variables:
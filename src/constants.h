@@ -65,6 +65,7 @@ inline const QString MIN_LAMMPS_VERSION_STR =
 // ---- Buffer thresholds ---------------------------------------------------
 constexpr double BUFFER_WARNING_THRESHOLD = 0.333; ///< Warn when capture buffer exceeds this
 constexpr int THERMO_SUGGEST_MULTIPLIER   = 5;     ///< Multiplier for thermo interval suggestion
+constexpr int MAX_CAPTURE_READS          = 16;    ///< Max capture buffer reads per log update
 
 // ---- Preferences dialog --------------------------------------------------
 constexpr int PREFERENCES_WIDTH  = 700; ///< Preferences dialog default width in pixels
@@ -86,6 +87,16 @@ constexpr int CHART_HEIGHT_MAX       = 30000; ///< Max configurable chart height
 constexpr int CHART_DEFAULT_WIDTH    = 640;   ///< Default chart width
 constexpr int CHART_DEFAULT_HEIGHT   = 480;   ///< Default chart height
 constexpr double CHART_YPAD_FRACTION = 0.05;  ///< Relative y-axis margin around the data range
+constexpr double CHART_LIVE_HEADROOM = 0.25;  ///< Relative axis growth during a live run
+constexpr int CHART_STATS_WINDOW       = 100;   ///< Samples in the chart's recent-statistics window
+constexpr int CHART_FOLLOW_INTERVAL    = 1000;  ///< Min poll interval (ms) of a followed data file
+
+// ---- Plot data cache -----------------------------------------------------
+// parsed plot data files are kept in a binary cache (see plotcache.h) whose
+// total size is limited by the Keys::PLOTCACHE preference, in MiB
+constexpr int PLOT_CACHE_MIN     = 0;      ///< Min cache size (disables the cache)
+constexpr int PLOT_CACHE_MAX     = 100000; ///< Max cache size
+constexpr int PLOT_CACHE_DEFAULT = 1024;   ///< Default cache size
 
 // ---- Chart post-processing dialog ----------------------------------------
 constexpr int POSTPROCESS_EXPR_WIDTH = 260; ///< Min width of the custom-function expression field
@@ -140,6 +151,10 @@ constexpr qint64 INSPECT_WARN_SIZE = 262144000LL;
 /** divisor turning a restart file size into an estimated RAM demand in GB */
 constexpr double INSPECT_GB_PER_BYTE = 134217728.0;
 
+// ---- File viewer -----------------------------------------------------------
+/** uncompressed files at least this large (bytes) open in the memory-mapped viewer */
+constexpr qint64 LARGE_FILE_SIZE = 16777216LL;
+
 // ---- Fixed RNG seeds for LAMMPS commands ----------------------------------
 /** seed for the create_atoms command placing the temporary molecule */
 constexpr int CREATE_ATOMS_SEED = 312944;
@@ -175,11 +190,16 @@ inline const QString FILTER_YAML = QStringLiteral("YAML files (*.yaml *.yml);;Al
 inline const QString FILTER_CSV = QStringLiteral("CSV data (*.csv);;All files (*)");
 /** name filter for gnuplot data */
 inline const QString FILTER_GNUPLOT = QStringLiteral("Gnuplot data (*.dat);;All files (*)");
+/** name filter for binary plot data */
+inline const QString FILTER_PLOTBIN =
+    QStringLiteral("LAMMPS-GUI binary data (*.lgpd);;All files (*)");
 /** name filter for JSON settings files */
 inline const QString FILTER_JSON = QStringLiteral("JSON files (*.json);;All files (*)");
 /** name filter for the plottable data file formats */
 inline const QString FILTER_DATA = QStringLiteral("Data files (*.dat *.csv *.yaml *.yml "
-                                                  "*.json *.txt);;All files (*)");
+                                                  "*.json *.txt *.lgpd);;Compressed data files "
+                                                  "(*.gz *.bz2 *.zst *.xz *.lzma *.lz4)"
+                                                  ";;All files (*)");
 /** name filter for the image formats supported when saving (Qt or ImageMagick writable) */
 inline const QString FILTER_IMAGE = QStringLiteral("Image files (*.png *.jpg *.jpeg *.gif *.bmp "
                                                    "*.tga *.ppm *.tiff *.webp *.pgm *.xpm *.xbm)"
@@ -266,6 +286,7 @@ inline const QString MONOFAMILY       = QStringLiteral("monofamily");
 inline const QString MONOSIZE         = QStringLiteral("monosize");
 inline const QString NAME             = QStringLiteral("name");
 inline const QString NTHREADS         = QStringLiteral("nthreads");
+inline const QString PLOTCACHE        = QStringLiteral("plotcache");
 inline const QString PLUGIN_PATH      = QStringLiteral("plugin_path");
 inline const QString RAWBRUSH         = QStringLiteral("rawbrush");
 inline const QString RECENT           = QStringLiteral("recent");
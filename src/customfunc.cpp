@@ -14,10 +14,15 @@
 #include "lepton_mini.h"
 #include "levmar.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <exception>
 #include <map>
+#include <numeric>
+#include <random>
 #include <string>
+#include <thread>
 #include <vector>
 
 CompiledExpression::CompiledExpression(const QString &expression)
@@ -42,6 +47,40 @@ double CompiledExpression::evaluate(const std::map<std::string, double> &variabl
     return program->evaluate(variables);
 }
 
+namespace {
+
+std::vector<std::string> toStdStrings(const QStringList &names)
+{
+    std::vector<std::string> result;
+    result.reserve(names.size());
+    for (const QString &name : names)
+        result.push_back(name.toStdString());
+    return result;
+}
+
+} // namespace
+
+bool CompiledExpression::bind(const QStringList &arrays, const QStringList &scalars)
+{
+    batch.reset();
+    if (!valid) return false;
+    try {
+        batch = std::make_unique<LeptonMini::ArrayProgram>(*program, toStdStrings(arrays),
+                                                           toStdStrings(scalars));
+    } catch (const std::exception &e) {
+        errorMsg = QString::fromStdString(e.what());
+        return false;
+    }
+    errorMsg.clear();
+    return true;
+}
+
+void CompiledExpression::evaluateBatch(int n, const double *const *arrays, const double *scalars,
+                                       double *result) const
+{
+    batch->evaluate(n, arrays, scalars, result);
+}
+
 CustomCurve evalCustomCurve(const QString &expression, double xmin, double xmax, int nsamples,
                             const QString &variable)
 {
@@ -54,161 +93,330 @@ CustomCurve evalCustomCurve(const QString &expression, double xmin, double xmax,
     }
     if (nsamples < 1) nsamples = 1;
 
-    const std::string var = variable.toStdString();
-
     CompiledExpression program(expr);
-    if (!program.isValid()) {
+    if (!program.bind({variable})) {
         result.error = program.error();
         return result;
     }
 
-    try {
-        std::map<std::string, double> vars;
-        for (int k = 0; k <= nsamples; ++k) {
-            const double x = xmin + (xmax - xmin) * static_cast<double>(k) / nsamples;
-            vars[var]      = x;
-            const double y = program.evaluate(vars);
-            if (std::isfinite(y)) result.points.append(QPointF(x, y));
-        }
-    } catch (const std::exception &e) {
-        result.error = QString::fromStdString(e.what());
-        result.points.clear();
-        return result;
-    }
+    std::vector<double> xs(nsamples + 1), ys(nsamples + 1);
+    for (int k = 0; k <= nsamples; ++k)
+        xs[k] = xmin + (xmax - xmin) * static_cast<double>(k) / nsamples;
+    const double *arrays = xs.data();
+    program.evaluateBatch(nsamples + 1, &arrays, nullptr, ys.data());
+    for (int k = 0; k <= nsamples; ++k)
+        if (std::isfinite(ys[k])) result.points.append(QPointF(xs[k], ys[k]));
 
     result.ok = true;
     return result;
 }
 
-CustomFit fitCustomCurve(const QString &expression, const QList<FitParam> &initialParams,
-                         const std::vector<double> &xdata, const std::vector<double> &ydata,
-                         double xmin, double xmax, int nsamples, const QString &variable)
-{
-    CustomFit result;
+namespace {
 
-    const QString expr = expression.trimmed();
+// Check the fit setup and collect the parameter names; false with the message in
+// result.error if it is unusable.
+bool checkFit(const QString &expr, const QList<FitParam> &initialParams,
+              const std::vector<double> &xdata, const std::vector<double> &ydata,
+              const QString &variable, CustomFit &result, std::vector<std::string> &pnames)
+{
     if (expr.isEmpty()) {
         result.error = QStringLiteral("The expression is empty.");
-        return result;
+        return false;
     }
     if (initialParams.isEmpty()) {
         result.error = QStringLiteral("No fit parameters were given.");
-        return result;
+        return false;
     }
     if (xdata.size() != ydata.size()) {
         result.error = QStringLiteral("The x and y data have different lengths.");
-        return result;
+        return false;
     }
 
     const int m = static_cast<int>(xdata.size());
     const int n = initialParams.size();
     if (m < n) {
         result.error = QStringLiteral("Too few data points (%1) for %2 parameters.").arg(m).arg(n);
-        return result;
+        return false;
     }
-    if (nsamples < 1) nsamples = 1;
-
-    const std::string var = variable.toStdString();
 
     // collect parameter names; reject empties, duplicates, and clashes with the
     // independent variable
-    std::vector<std::string> pnames;
     pnames.reserve(n);
     for (const FitParam &p : initialParams) {
         const QString nm = p.name.trimmed();
         if (nm.isEmpty()) {
             result.error = QStringLiteral("A fit parameter has an empty name.");
-            return result;
+            return false;
         }
         if (nm == variable) {
             result.error =
                 QStringLiteral("Parameter name '%1' clashes with the variable name.").arg(nm);
-            return result;
+            return false;
         }
         const std::string s = nm.toStdString();
         for (const auto &e : pnames) {
             if (e == s) {
                 result.error = QStringLiteral("Duplicate parameter name '%1'.").arg(nm);
-                return result;
+                return false;
             }
         }
         pnames.push_back(s);
     }
+    return true;
+}
 
-    try {
-        // parse once; build the optimized model and the analytic derivative with
-        // respect to each parameter (the Jacobian columns)
-        const LeptonMini::ParsedExpression base  = LeptonMini::Parser::parse(expr.toStdString());
-        const LeptonMini::ParsedExpression model = base.optimize();
-        std::vector<LeptonMini::ParsedExpression> derivs;
-        derivs.reserve(n);
-        for (const auto &s : pnames)
-            derivs.push_back(base.differentiate(s).optimize());
-
-        // pre-flight evaluation at the initial guess so an expression referencing
-        // an undeclared symbol fails with a descriptive LeptonMini message
-        std::map<std::string, double> probe;
-        probe[var] = xdata.empty() ? 0.0 : xdata.front();
+// Compile the model and its derivatives into one program that computes the values
+// they share only once, binding the independent variable as an array and the
+// parameters as scalars. Throws the LeptonMini exception of a parse error or an
+// undeclared symbol.
+LeptonMini::ArrayProgram compileFit(const QString &expr, const std::vector<std::string> &pnames,
+                                    const std::string &var)
+{
+    // parse once; build the optimized model and the analytic derivative with
+    // respect to each parameter (the Jacobian columns)
+    const LeptonMini::ParsedExpression base = LeptonMini::Parser::parse(expr.toStdString());
+    std::vector<LeptonMini::ExpressionProgram> programs;
+    programs.reserve(pnames.size() + 1);
+    programs.push_back(base.optimize().createProgram());
+    for (const auto &s : pnames)
+        programs.push_back(base.differentiate(s).optimize().createProgram());
+    return LeptonMini::ArrayProgram(programs, {var}, pnames);
+}
+
+// One Levenberg-Marquardt descent of the compiled model from a starting point.
+LevmarResult runFit(const LeptonMini::ArrayProgram &program, const std::vector<double> &xdata,
+                    const std::vector<double> &ydata, const std::vector<double> &initial,
+                    int numThreads)
+{
+    const int m = static_cast<int>(xdata.size());
+    const int n = static_cast<int>(initial.size());
+
+    // residual/Jacobian callback for a range of rows, called concurrently by the
+    // Levenberg-Marquardt solver; the derivatives are computed column by column
+    const LevmarRowModel fn = [&](const std::vector<double> &p, int first, int count, double *res,
+                                  double *jac) -> bool {
+        std::vector<double> columns(static_cast<std::size_t>(count) * n);
+        std::vector<double *> outputs(n + 1);
+        outputs[0] = res;
         for (int j = 0; j < n; ++j)
-            probe[pnames[j]] = initialParams[j].value;
-        (void)model.evaluate(probe);
-
-        // residual/Jacobian callback for the Levenberg-Marquardt solver
-        const LevmarModel fn = [&](const std::vector<double> &p, std::vector<double> &res,
-                                   std::vector<std::vector<double>> &jac) -> bool {
-            std::map<std::string, double> vars;
-            for (int j = 0; j < n; ++j)
-                vars[pnames[j]] = p[j];
-            try {
-                for (int i = 0; i < m; ++i) {
-                    vars[var]            = xdata[i];
-                    const double modeled = model.evaluate(vars);
-                    if (!std::isfinite(modeled)) return false;
-                    res[i] = modeled - ydata[i];
-                    for (int j = 0; j < n; ++j) {
-                        const double d = derivs[j].evaluate(vars);
-                        if (!std::isfinite(d)) return false;
-                        jac[i][j] = d;
-                    }
-                }
-            } catch (const std::exception &) {
-                return false;
+            outputs[j + 1] = columns.data() + static_cast<std::size_t>(count) * j;
+        const double *xs = xdata.data() + first;
+        program.evaluate(count, &xs, p.data(), outputs.data());
+        for (int i = 0; i < count; ++i) {
+            if (!std::isfinite(res[i])) return false;
+            res[i] -= ydata[first + i];
+        }
+        for (int j = 0; j < n; ++j) {
+            const double *column = outputs[j + 1];
+            for (int i = 0; i < count; ++i) {
+                if (!std::isfinite(column[i])) return false;
+                jac[(static_cast<std::size_t>(i) * n) + j] = column[i];
             }
-            return true;
-        };
+        }
+        return true;
+    };
+    return levmarFitParallel(m, n, initial, fn, numThreads);
+}
 
-        std::vector<double> initial(n, 0.0);
-        for (int j = 0; j < n; ++j)
+// Store the fitted parameters in the input order and sample the fitted model over
+// the requested range.
+void storeFit(const LeptonMini::ArrayProgram &program, const QList<FitParam> &initialParams,
+              const LevmarResult &lm, double xmin, double xmax, int nsamples, CustomFit &result)
+{
+    for (int j = 0; j < initialParams.size(); ++j) {
+        FitParam p = initialParams[j];
+        p.name     = p.name.trimmed();
+        p.value    = lm.params[j];
+        result.params.append(p);
+    }
+
+    std::vector<double> xfit(nsamples + 1), yfit(nsamples + 1);
+    for (int k = 0; k <= nsamples; ++k)
+        xfit[k] = xmin + (xmax - xmin) * static_cast<double>(k) / nsamples;
+    const double *xfitp = xfit.data();
+    program.evaluate(nsamples + 1, &xfitp, lm.params.data(), yfit.data());
+    for (int k = 0; k <= nsamples; ++k)
+        if (std::isfinite(yfit[k])) result.curve.append(QPointF(xfit[k], yfit[k]));
+
+    result.rms        = lm.rms;
+    result.iterations = lm.iterations;
+    result.ok         = true;
+}
+
+// Starting points for a multi-start fit: the initial guesses, then a Latin hypercube
+// sample of the ranges of the parameters that have one. A positive range spanning
+// more than two decades is sampled logarithmically.
+std::vector<std::vector<double>> latinHypercube(const QList<FitParam> &params, int numStarts)
+{
+    const int n = params.size();
+    std::vector<std::vector<double>> starts(numStarts, std::vector<double>(n));
+    for (int j = 0; j < n; ++j)
+        starts[0][j] = params[j].value;
+
+    const int strata = numStarts - 1;
+    std::mt19937 rng(20240521U); // fixed seed: the same starts every time
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<int> order(strata);
+    for (int j = 0; j < n; ++j) {
+        const FitParam &p = params[j];
+        const bool ranged = (p.lower < p.upper);
+        const bool logarithmic = ranged && (p.lower > 0.0) && (p.upper > 100.0 * p.lower);
+        const double lo        = logarithmic ? std::log(p.lower) : p.lower;
+        const double hi        = logarithmic ? std::log(p.upper) : p.upper;
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), rng);
+        for (int i = 0; i < strata; ++i) {
+            if (!ranged) {
+                starts[i + 1][j] = p.value;
+                continue;
+            }
+            const double u   = lo + (hi - lo) * (order[i] + uniform(rng)) / strata;
+            starts[i + 1][j] = logarithmic ? std::exp(u) : u;
+        }
+    }
+    return starts;
+}
+
+// whether two descents ended in the same minimum: the RMS residuals and all
+// parameters agree to a relative tolerance
+bool sameMinimum(const LevmarResult &a, const LevmarResult &b, double yscale)
+{
+    constexpr double TOL = 1.0e-4;
+    const double tiny    = 1.0e-10 * yscale;
+    if (std::fabs(a.rms - b.rms) > (TOL * std::max(a.rms, b.rms)) + tiny) return false;
+    for (std::size_t j = 0; j < a.params.size(); ++j) {
+        const double scale = std::max(std::fabs(a.params[j]), std::fabs(b.params[j]));
+        if (std::fabs(a.params[j] - b.params[j]) > (TOL * scale) + 1.0e-12) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+CustomFit fitCustomCurve(const QString &expression, const QList<FitParam> &initialParams,
+                         const std::vector<double> &xdata, const std::vector<double> &ydata,
+                         double xmin, double xmax, int nsamples, const QString &variable)
+{
+    CustomFit result;
+    const QString expr = expression.trimmed();
+    std::vector<std::string> pnames;
+    if (!checkFit(expr, initialParams, xdata, ydata, variable, result, pnames)) return result;
+    if (nsamples < 1) nsamples = 1;
+
+    try {
+        // an expression referencing an undeclared symbol fails here with a
+        // descriptive LeptonMini message
+        const LeptonMini::ArrayProgram program = compileFit(expr, pnames, variable.toStdString());
+
+        std::vector<double> initial(initialParams.size(), 0.0);
+        for (int j = 0; j < initialParams.size(); ++j)
             initial[j] = initialParams[j].value;
 
-        const LevmarResult lm = levmarFit(m, n, initial, fn);
+        const LevmarResult lm = runFit(program, xdata, ydata, initial, 0);
         if (!lm.ok) {
             result.error = QString::fromStdString(lm.message);
             return result;
         }
+        storeFit(program, initialParams, lm, xmin, xmax, nsamples, result);
+    } catch (const std::exception &e) {
+        result.error = QString::fromStdString(e.what());
+        result.params.clear();
+        result.curve.clear();
+        result.ok = false;
+        return result;
+    }
 
-        // report fitted parameters in the input order
-        for (int j = 0; j < n; ++j)
-            result.params.append(FitParam{initialParams[j].name.trimmed(), lm.params[j]});
+    return result;
+}
 
-        // sample the fitted model over the requested range
-        std::map<std::string, double> fitted;
-        for (int j = 0; j < n; ++j)
-            fitted[pnames[j]] = lm.params[j];
-        for (int k = 0; k <= nsamples; ++k) {
-            const double x = xmin + (xmax - xmin) * static_cast<double>(k) / nsamples;
-            fitted[var]    = x;
-            const double y = model.evaluate(fitted);
-            if (std::isfinite(y)) result.curve.append(QPointF(x, y));
+CustomFit fitCustomCurveMultiStart(const QString &expression, const QList<FitParam> &initialParams,
+                                   const std::vector<double> &xdata,
+                                   const std::vector<double> &ydata, double xmin, double xmax,
+                                   int nsamples, int numStarts, const QString &variable)
+{
+    CustomFit result;
+    const QString expr = expression.trimmed();
+    std::vector<std::string> pnames;
+    if (!checkFit(expr, initialParams, xdata, ydata, variable, result, pnames)) return result;
+    if (nsamples < 1) nsamples = 1;
+    numStarts = std::max(numStarts, 1);
+
+    bool ranged = false;
+    for (const FitParam &p : initialParams)
+        ranged = ranged || (p.lower < p.upper);
+    if (!ranged && (numStarts > 1)) {
+        result.error =
+            QStringLiteral("A multi-start fit needs a range for at least one parameter.");
+        return result;
+    }
+
+    try {
+        const LeptonMini::ArrayProgram program = compileFit(expr, pnames, variable.toStdString());
+        const std::vector<std::vector<double>> starts = latinHypercube(initialParams, numStarts);
+
+        // the descents run concurrently, and any cores left over split the rows of
+        // each descent; both give the same results for any number of threads
+        const int cores   = std::max(1U, std::thread::hardware_concurrency());
+        const int workers = std::min(cores, numStarts);
+        std::vector<LevmarResult> fits(numStarts);
+        std::atomic<int> next{0};
+        auto work = [&]() {
+            for (int i = next++; i < numStarts; i = next++)
+                fits[i] = runFit(program, xdata, ydata, starts[i], cores / workers);
+        };
+        std::vector<std::thread> threads;
+        for (int t = 1; t < workers; ++t)
+            threads.emplace_back(work);
+        work();
+        for (auto &t : threads)
+            t.join();
+
+        // rank the successful descents by their residual, then merge those that
+        // ended in the same minimum
+        std::vector<int> ranked;
+        for (int i = 0; i < numStarts; ++i)
+            if (fits[i].ok && std::isfinite(fits[i].rms)) ranked.push_back(i);
+        if (ranked.empty()) {
+            result.error = QString::fromStdString(fits[0].message);
+            return result;
+        }
+        std::stable_sort(ranked.begin(), ranked.end(),
+                         [&](int a, int b) { return fits[a].rms < fits[b].rms; });
+
+        double yscale = 0.0;
+        for (const double y : ydata)
+            yscale += y * y;
+        yscale = std::sqrt(yscale / static_cast<double>(ydata.size()));
+
+        std::vector<int> distinct;
+        for (const int i : ranked) {
+            bool merged = false;
+            for (std::size_t k = 0; (k < distinct.size()) && !merged; ++k) {
+                if (sameMinimum(fits[distinct[k]], fits[i], yscale)) {
+                    ++result.minima[static_cast<int>(k)].count;
+                    merged = true;
+                }
+            }
+            if (merged) continue;
+            distinct.push_back(i);
+            FitMinimum minimum;
+            for (int j = 0; j < initialParams.size(); ++j) {
+                FitParam p = initialParams[j];
+                p.name     = p.name.trimmed();
+                p.value    = fits[i].params[j];
+                minimum.params.append(p);
+            }
+            minimum.rms   = fits[i].rms;
+            minimum.count = 1;
+            result.minima.append(minimum);
         }
 
-        result.rms        = lm.rms;
-        result.iterations = lm.iterations;
-        result.ok         = true;
+        storeFit(program, initialParams, fits[ranked.front()], xmin, xmax, nsamples, result);
     } catch (const std::exception &e) {
         result.error = QString::fromStdString(e.what());
         result.params.clear();
         result.curve.clear();
+        result.minima.clear();
         result.ok = false;
         return result;
     }
@@ -21,6 +21,7 @@
 #include <QList>
 #include <QPointF>
 #include <QString>
+#include <QStringList>
 
 #include <map>
 #include <memory>
@@ -28,6 +29,7 @@
 #include <vector>
 
 namespace LeptonMini {
+class ArrayProgram;
 class ExpressionProgram;
 }
 
@@ -40,6 +42,10 @@ class ExpressionProgram;
  * repeatedly with a name -> value variable map. @ref evaluate propagates the
  * LeptonMini exception thrown for an unbound variable, so callers that may
  * reference variables not present in the map should evaluate inside a try block.
+ *
+ * For many points, @ref bind the variable names once and call
+ * @ref evaluateBatch with whole arrays of values instead: it looks up no names
+ * and applies each operation to a block of points in a tight loop.
  */
 class CompiledExpression {
 public:
@@ -54,15 +60,38 @@ public:
 
     /** @brief True if the expression parsed and compiled successfully */
     bool isValid() const { return valid; }
-    /** @brief Parse-error message (empty when @ref isValid is true) */
+    /** @brief Message of a failed parse or @ref bind (empty if neither failed) */
     const QString &error() const { return errorMsg; }
     /** @brief Evaluate with the given variable bindings (may throw on unbound vars) */
     double evaluate(const std::map<std::string, double> &variables) const;
 
+    /**
+     * @brief Bind variable names to the arguments of @ref evaluateBatch
+     *
+     * A name in both lists is an array variable.
+     *
+     * @param arrays  Names of the variables with one value per point
+     * @param scalars Names of the variables with the same value at all points
+     * @return False, with the message in @ref error, if the expression is
+     *         invalid or uses a variable in neither list
+     */
+    bool bind(const QStringList &arrays, const QStringList &scalars = QStringList());
+
+    /**
+     * @brief Evaluate at many points at once, after a successful @ref bind
+     * @param n       Number of points
+     * @param arrays  One array of @p n values per array variable, in @ref bind order
+     * @param scalars One value per scalar variable, in @ref bind order
+     * @param result  Destination for the @p n values
+     */
+    void evaluateBatch(int n, const double *const *arrays, const double *scalars,
+                       double *result) const;
+
 private:
     std::unique_ptr<LeptonMini::ExpressionProgram> program; ///< compiled program (null if invalid)
+    std::unique_ptr<LeptonMini::ArrayProgram> batch;        ///< program bound by bind() (or null)
     bool valid = false;                                     ///< parse/compile succeeded
-    QString errorMsg;                                       ///< parse error (empty when valid)
+    QString errorMsg;                                       ///< parse or bind error
 };
 
 /**
@@ -83,18 +112,30 @@ struct CustomCurve {
 struct FitParam {
     QString name;       ///< parameter name as it appears in the expression
     double value = 0.0; ///< initial guess (input) / fitted value (output)
+    double lower = 0.0; ///< lower end of the range sampled by a multi-start fit
+    double upper = 0.0; ///< upper end of that range; no range if upper <= lower
+};
+
+/**
+ * @brief A distinct local minimum found by a multi-start fit
+ */
+struct FitMinimum {
+    QList<FitParam> params; ///< parameters at the minimum, in the input order
+    double rms = 0.0;       ///< root-mean-square residual at the minimum
+    int count  = 0;         ///< number of starting points that ended here
 };
 
 /**
  * @brief Result of a nonlinear least-squares fit of a custom expression
  */
 struct CustomFit {
-    bool ok = false;        ///< true if the fit produced a usable solution
-    QString error;          ///< human-readable error message when @ref ok is false
-    QList<FitParam> params; ///< fitted parameters, in the input order
-    QList<QPointF> curve;   ///< fitted model sampled over the x range
-    double rms     = 0.0;   ///< root-mean-square residual at the solution
-    int iterations = 0;     ///< Levenberg-Marquardt iterations performed
+    bool ok = false;          ///< true if the fit produced a usable solution
+    QString error;            ///< human-readable error message when @ref ok is false
+    QList<FitParam> params;   ///< fitted parameters, in the input order
+    QList<QPointF> curve;     ///< fitted model sampled over the x range
+    double rms     = 0.0;     ///< root-mean-square residual at the solution
+    int iterations = 0;       ///< Levenberg-Marquardt iterations performed
+    QList<FitMinimum> minima; ///< distinct minima of a multi-start fit, best first
 };
 
 /**
@@ -141,6 +182,38 @@ CustomFit fitCustomCurve(const QString &expression, const QList<FitParam> &initi
                          double xmin, double xmax, int nsamples,
                          const QString &variable = QStringLiteral("x"));
 
+/**
+ * @brief Nonlinear least-squares fit of a custom expression from many starting points
+ *
+ * Like @ref fitCustomCurve, but runs @p numStarts Levenberg-Marquardt descents
+ * concurrently to escape poor local minima. The first one starts from the
+ * initial guesses; the others start from a Latin hypercube sample of the
+ * [@ref FitParam::lower, @ref FitParam::upper] ranges, with the parameters
+ * that have no range kept at their guesses. A positive range spanning more
+ * than two decades is sampled logarithmically. The starting points are the
+ * same on every call, so the result is reproducible.
+ *
+ * The best solution is returned as for @ref fitCustomCurve, and all distinct
+ * minima that were reached, ranked by their residual, in @ref CustomFit::minima.
+ *
+ * @param expression    Math expression in @p variable and the parameter names
+ * @param initialParams Parameters with their initial guesses and ranges; at
+ *                      least one needs a range if @p numStarts > 1
+ * @param xdata         Independent-variable data
+ * @param ydata         Dependent-variable data (same length as @p xdata)
+ * @param xmin          Lower bound for sampling the fitted curve
+ * @param xmax          Upper bound for sampling the fitted curve
+ * @param nsamples      Number of sub-intervals (clamped to >= 1); nsamples+1 points
+ * @param numStarts     Number of starting points (clamped to >= 1)
+ * @param variable      Name of the independent variable (default "x")
+ * @return Fit result; @ref CustomFit::ok is false if no descent succeeded
+ */
+CustomFit fitCustomCurveMultiStart(const QString &expression, const QList<FitParam> &initialParams,
+                                   const std::vector<double> &xdata,
+                                   const std::vector<double> &ydata, double xmin, double xmax,
+                                   int nsamples, int numStarts,
+                                   const QString &variable = QStringLiteral("x"));
+
 #endif
 
 // Local Variables:
@@ -0,0 +1,181 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "decompress.h"
+
+#include <QFileInfo>
+#include <QProcess>
+
+#include <utility>
+
+namespace Decompress {
+
+namespace {
+
+// lookup table mapping file extensions to decompression programs and extra args
+struct CompressionFormat {
+    const char *extension;
+    const char *program;
+    const char *extraArg; // nullptr if none
+};
+constexpr CompressionFormat compressionFormats[] = {
+    {"gz", "gzip", nullptr}, {"bz2", "bzip2", nullptr},       {"zst", "zstd", nullptr},
+    {"xz", "xz", nullptr},   {"lzma", "xz", "--format=lzma"}, {"lz4", "lz4", nullptr},
+};
+
+const CompressionFormat *formatOf(const QString &fileName)
+{
+    const QString suffix = QFileInfo(fileName).suffix();
+    for (const auto &fmt : compressionFormats)
+        if (suffix == fmt.extension) return &fmt;
+    return nullptr;
+}
+
+// bytes read from the program at a time, and the number of chunks queued ahead of the reader
+constexpr qint64 CHUNK_SIZE     = 1024 * 1024;
+constexpr std::size_t MAX_QUEUE = 8;
+
+// how often a waiting reader thread checks whether it was stopped
+constexpr int POLL_MSEC = 100;
+
+} // namespace
+
+/* -------------------------------------------------------------------- */
+
+bool isCompressed(const QString &fileName)
+{
+    return formatOf(fileName) != nullptr;
+}
+
+/* -------------------------------------------------------------------- */
+
+bool command(const QString &fileName, QString &program, QStringList &args)
+{
+    const CompressionFormat *fmt = formatOf(fileName);
+    if (!fmt) return false;
+    program = fmt->program;
+    args    = QStringList{"-cdf", fileName};
+    if (fmt->extraArg) args.insert(1, fmt->extraArg);
+    return true;
+}
+
+/* -------------------------------------------------------------------- */
+
+QString uncompressedName(const QString &fileName)
+{
+    const CompressionFormat *fmt = formatOf(fileName);
+    if (!fmt) return fileName;
+    return fileName.chopped(static_cast<qsizetype>(qstrlen(fmt->extension)) + 1);
+}
+
+/* -------------------------------------------------------------------- */
+
+Reader::Reader(const QString &fileName) : worker(&Reader::run, this, fileName) {}
+
+Reader::~Reader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    changed.notify_all();
+    worker.join();
+}
+
+/* -------------------------------------------------------------------- */
+
+bool Reader::next(QByteArray &chunk)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return !chunks.empty() || done; });
+    if (chunks.empty()) return false;
+    chunk = std::move(chunks.front());
+    chunks.pop_front();
+    lock.unlock();
+    changed.notify_all();
+    return true;
+}
+
+/* -------------------------------------------------------------------- */
+
+QString Reader::errorString() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return error;
+}
+
+/* -------------------------------------------------------------------- */
+
+// Queue a chunk, waiting while the queue is full; false if the reader was stopped.
+bool Reader::push(QByteArray chunk)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return (chunks.size() < MAX_QUEUE) || stopped; });
+    if (stopped) return false;
+    chunks.push_back(std::move(chunk));
+    lock.unlock();
+    changed.notify_all();
+    return true;
+}
+
+/* -------------------------------------------------------------------- */
+
+// Body of the reader thread.  The process is created and used only here: its
+// blocking functions do not need an event loop.
+void Reader::run(const QString &fileName)
+{
+    QString message;
+    QString program;
+    QStringList args;
+    if (!command(fileName, program, args)) {
+        message = QString("%1 is not a compressed file").arg(fileName);
+    } else {
+        QProcess decomp;
+        decomp.start(program, args, QIODevice::ReadOnly);
+        if (!decomp.waitForStarted()) {
+            message = QString("could not open compressed file %1 with decompression program %2")
+                          .arg(fileName, program);
+        } else {
+            bool keepGoing = true;
+            while (keepGoing) {
+                if (decomp.bytesAvailable() > 0) {
+                    keepGoing = push(decomp.read(CHUNK_SIZE));
+                } else if (decomp.state() == QProcess::NotRunning) {
+                    break;
+                } else if (!decomp.waitForReadyRead(POLL_MSEC)) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    keepGoing = !stopped;
+                }
+            }
+            if (!keepGoing) {
+                decomp.kill();
+                decomp.waitForFinished();
+            } else if ((decomp.exitStatus() != QProcess::NormalExit) || (decomp.exitCode() != 0)) {
+                message = QString("decompression of %1 with %2 failed: %3")
+                              .arg(fileName, program,
+                                   QString::fromLocal8Bit(decomp.readAllStandardError()).trimmed());
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = message;
+        done  = true;
+    }
+    changed.notify_all();
+}
+
+} // namespace Decompress
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
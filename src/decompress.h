@@ -0,0 +1,103 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DECOMPRESS_H
+#define DECOMPRESS_H
+
+// Reading compressed files through external decompression programs (gzip,
+// bzip2, zstd, xz, lz4), selected by the file extension.  The decompressed
+// data is read from the standard output of the program, so no temporary files
+// are needed.  Reader streams it in chunks from a background thread, so that
+// the caller can process one chunk while the next one is decompressed.
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Decompress {
+
+/**
+ * @brief Whether a file name has the extension of a supported compression format
+ * @param fileName Path or name of the file
+ * @return true for .gz, .bz2, .zst, .xz, .lzma, and .lz4 files
+ */
+bool isCompressed(const QString &fileName);
+
+/**
+ * @brief Command line that decompresses a file to its standard output
+ * @param fileName Path to the compressed file
+ * @param program  Set to the decompression program
+ * @param args     Set to the arguments of the program
+ * @return false if the file is not compressed (see isCompressed())
+ */
+bool command(const QString &fileName, QString &program, QStringList &args);
+
+/**
+ * @brief File name without the compression extension
+ * @param fileName Path or name of the file
+ * @return e.g. "thermo.csv" for "thermo.csv.zst"; @p fileName if it is not compressed
+ */
+QString uncompressedName(const QString &fileName);
+
+/**
+ * @brief Streaming reader of the decompressed contents of a file
+ *
+ * The decompression program is started by the constructor and read from a
+ * background thread into a short queue of chunks, which next() hands out in
+ * order.  Destroying the reader before the end stops the program.
+ */
+class Reader {
+public:
+    /**
+     * @brief Start decompressing a file
+     * @param fileName Path to the compressed file
+     */
+    explicit Reader(const QString &fileName);
+    ~Reader();
+
+    Reader(const Reader &)            = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    /**
+     * @brief Wait for the next chunk of decompressed data
+     * @param chunk Set to the chunk
+     * @return false at the end of the data or on failure (see errorString())
+     */
+    bool next(QByteArray &chunk);
+
+    /** @brief Error message once next() returned false; empty on success */
+    QString errorString() const;
+
+private:
+    void run(const QString &fileName);
+    bool push(QByteArray chunk);
+
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<QByteArray> chunks; ///< Decompressed chunks not yet taken by next()
+    QString error;                 ///< Error message of the reader thread
+    bool done    = false;          ///< The reader thread has queued its last chunk
+    bool stopped = false;          ///< Set by the destructor to end the reader thread early
+    std::thread worker;            ///< Runs the decompression program
+};
+
+} // namespace Decompress
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -12,8 +12,10 @@
 #include "fileviewer.h"
 
 #include "constants.h"
+#include "decompress.h"
 #include "helpers.h"
 #include "lammpsgui.h"
+#include "largefileviewer.h"
 
 #include <QEvent>
 #include <QFile>
@@ -43,33 +45,11 @@ FileViewer::FileViewer(const QString &_filename, LammpsGui *_lammpsgui, const QS
 
     // open and read file. Set editor to read-only.
     QFile file(fileName);
-    QFileInfo finfo(file);
     QString content;
     QProcess decomp;
-    QStringList args = {"-cdf", fileName};
-
-    // lookup table mapping file extensions to decompression programs and extra args
-    struct CompressionFormat {
-        const char *extension;
-        const char *program;
-        const char *extraArg; // nullptr if none
-    };
-    static constexpr CompressionFormat compressionFormats[] = {
-        {"gz", "gzip", nullptr}, {"bz2", "bzip2", nullptr},       {"zst", "zstd", nullptr},
-        {"xz", "xz", nullptr},   {"lzma", "xz", "--format=lzma"}, {"lz4", "lz4", nullptr},
-    };
-
-    // match suffix with decompression program
     QString command;
-    bool compressed = false;
-    for (const auto &fmt : compressionFormats) {
-        if (finfo.suffix() == fmt.extension) {
-            command    = fmt.program;
-            compressed = true;
-            if (fmt.extraArg) args.insert(1, fmt.extraArg);
-            break;
-        }
-    }
+    QStringList args;
+    const bool compressed = Decompress::command(fileName, command, args);
 
     // read compressed file from pipe
     if (compressed) {
@@ -138,6 +118,15 @@ bool FileViewer::eventFilter(QObject *watched, QEvent *event)
     return QWidget::eventFilter(watched, event);
 }
 
+// large plain files are mapped; compressed files have to be decompressed in full anyway
+QWidget *createFileViewer(const QString &filename, LammpsGui *lammpsgui, const QString &title)
+{
+    if (!Decompress::isCompressed(filename) &&
+        (QFileInfo(filename).size() >= Cfg::LARGE_FILE_SIZE))
+        return new LargeFileViewer(filename, lammpsgui, title);
+    return new FileViewer(filename, lammpsgui, title);
+}
+
 // Local Variables:
 // c-basic-offset: 4
 // End:
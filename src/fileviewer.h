@@ -68,6 +68,20 @@ private:
     LammpsGui *lammpsgui; ///< Main widget pointer for receiving signals
 };
 
+/**
+ * @brief Create a viewer window suitable for the size of a file
+ *
+ * Uncompressed files of at least Cfg::LARGE_FILE_SIZE bytes are shown in a
+ * LargeFileViewer, which maps the file instead of reading it, all others in a
+ * FileViewer.  The window is not shown yet.
+ *
+ * @param filename Path to file to display
+ * @param lammpsgui Pointer to LammpsGui for sending signals
+ * @param title Window title (defaults to filename if empty)
+ * @return Pointer to the new top-level viewer window
+ */
+QWidget *createFileViewer(const QString &filename, LammpsGui *lammpsgui, const QString &title = "");
+
 #endif
 // Local Variables:
 // c-basic-offset: 4
@@ -13,20 +13,23 @@
 
 #include "leastsquares.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <utility>
 
 namespace {
 
-// Solve the normal equations (A^T A) c = A^T y for the coefficient vector c
-// using the dense LU solver from the leastsquares toolkit.
-std::vector<double> solveNormalEquations(const float_mat &A, const std::vector<double> &y)
+// Least-squares solution c of A c = y via the Householder QR solver from the
+// leastsquares toolkit, which avoids the ill-conditioned normal equations
+// (A^T A) c = A^T y of high-order polynomial fits.
+std::vector<double> solveLeastSquares(const float_mat &A, const std::vector<double> &y)
 {
     float_mat Y(y.size(), 1);
     for (std::size_t i = 0; i < y.size(); ++i)
         Y[i][0] = y[i];
 
-    const float_mat At = transpose(A);
-    const float_mat c  = lin_solve(At * A, At * Y);
+    const float_mat c = qr_solve(A, Y);
 
     std::vector<double> coeffs(c.nr_rows());
     for (std::size_t i = 0; i < c.nr_rows(); ++i)
@@ -47,34 +50,156 @@ double evalPolynomial(const std::vector<double> &coeffs, double x)
     return value;
 }
 
-PolynomialFit polynomialFit(const std::vector<double> &x, const std::vector<double> &y, int degree)
+double evalPolynomialFit(const PolynomialFit &fit, double x)
 {
-    PolynomialFit result;
-    const int n = static_cast<int>(x.size());
-    if ((static_cast<int>(y.size()) != n) || (degree < 0) || (n < degree + 1)) return result;
+    return evalPolynomial(fit.scaled, (x - fit.xshift) / fit.xscale);
+}
 
-    const int p = degree + 1;
-    float_mat A(n, p);
-    for (int i = 0; i < n; ++i) {
-        double xpow = 1.0;
-        for (int j = 0; j < p; ++j) {
-            A[i][j] = xpow;
-            xpow *= x[i];
+StreamingPolynomialFit::StreamingPolynomialFit(int degree) :
+    nparams((degree < 0) ? 1 : degree + 1), r(nparams * nparams, 0.0), qty(nparams, 0.0),
+    norm(nparams, 0.0), row(nparams, 0.0)
+{
+}
+
+// Rotate the weighted row [sqrt(w) t^k | sqrt(w) y] into R and Q^T y, one Givens
+// rotation per column. What is left of y is the point's share of the residual.
+void StreamingPolynomialFit::add(double x, double y, double weight)
+{
+    if (!(weight > 0.0) || !std::isfinite(weight)) return;
+
+    // the first point sets the shift; points at it do not depend on the scale,
+    // so the scale is set by the first point elsewhere and grows when needed
+    if (npoints == 0) shift = x;
+    const double dx = std::fabs(x - shift);
+    if (std::isfinite(dx) && (dx > span)) rescale(dx);
+
+    const double t     = (span > 0.0) ? (x - shift) / span : 0.0;
+    const double scale = std::sqrt(weight);
+    double tpow        = scale;
+    for (int j = 0; j < nparams; ++j) {
+        row[j] = tpow;
+        norm[j] += tpow * tpow;
+        tpow *= t;
+    }
+    double b = scale * y;
+
+    for (int k = 0; k < nparams; ++k) {
+        if (row[k] == 0.0) continue;
+        double *rk       = r.data() + (static_cast<std::size_t>(k) * nparams);
+        const double rho = std::hypot(rk[k], row[k]);
+        const double c   = rk[k] / rho;
+        const double s   = row[k] / rho;
+        rk[k]            = rho;
+        for (int j = k + 1; j < nparams; ++j) {
+            const double tmp = (c * rk[j]) + (s * row[j]);
+            row[j]           = (c * row[j]) - (s * rk[j]);
+            rk[j]            = tmp;
         }
+        const double tmp = (c * qty[k]) + (s * b);
+        b                = (c * b) - (s * qty[k]);
+        qty[k]           = tmp;
     }
 
-    result.coeffs = solveNormalEquations(A, y);
+    sumsq += b * b;
+    sumw += weight;
+    ++npoints;
+}
 
-    double sumsq = 0.0;
-    for (int i = 0; i < n; ++i) {
-        const double resid = y[i] - evalPolynomial(result.coeffs, x[i]);
-        sumsq += resid * resid;
+void StreamingPolynomialFit::add(const std::vector<double> &x, const std::vector<double> &y)
+{
+    const std::size_t n = (x.size() < y.size()) ? x.size() : y.size();
+    for (std::size_t i = 0; i < n; ++i)
+        add(x[i], y[i]);
+}
+
+void StreamingPolynomialFit::clear()
+{
+    std::fill(r.begin(), r.end(), 0.0);
+    std::fill(qty.begin(), qty.end(), 0.0);
+    std::fill(norm.begin(), norm.end(), 0.0);
+    shift   = 0.0;
+    span    = 0.0;
+    sumsq   = 0.0;
+    sumw    = 0.0;
+    npoints = 0;
+}
+
+// Grow the scale to the next power of two of at least dx. Column j of the design
+// matrix, and so of R, is multiplied by (old / new)^j, which is exact for powers
+// of two; R stays triangular and Q^T y does not change.
+void StreamingPolynomialFit::rescale(double dx)
+{
+    const double next = std::ldexp(1.0, std::ilogb(dx) + 1);
+    if (!std::isfinite(next)) return;
+    if (span > 0.0) {
+        const double factor = span / next;
+        double fj           = 1.0;
+        for (int j = 0; j < nparams; ++j) {
+            for (int k = 0; k <= j; ++k)
+                r[(static_cast<std::size_t>(k) * nparams) + j] *= fj;
+            norm[j] *= fj * fj;
+            fj *= factor;
+        }
     }
-    result.rms = std::sqrt(sumsq / static_cast<double>(n));
-    result.ok  = true;
+    span = next;
+}
+
+// Back substitution R b = Q^T y for the coefficients b in t = (x - shift) / span.
+// R keeps the norm of every design-matrix column, so a diagonal element that is
+// tiny compared to that norm means the column depends on the previous ones, i.e.
+// too few distinct abscissa values; with the abscissa shifted and scaled to
+// |t| <= 1, this does not happen for merely large or closely spaced values.
+// The coefficients are also expanded into powers of x; that form loses accuracy
+// by cancellation for a high degree far from x = 0.
+PolynomialFit StreamingPolynomialFit::fit() const
+{
+    constexpr double TOL = 64.0 * std::numeric_limits<double>::epsilon();
+
+    PolynomialFit result;
+    if (npoints < static_cast<std::size_t>(nparams)) return result;
+
+    std::vector<double> b(nparams);
+    for (int k = nparams - 1; k >= 0; --k) {
+        const double *rk = r.data() + (static_cast<std::size_t>(k) * nparams);
+        if (!(std::fabs(rk[k]) > TOL * std::sqrt(norm[k]))) return result;
+        double sum = qty[k];
+        for (int j = k + 1; j < nparams; ++j)
+            sum -= rk[j] * b[j];
+        b[k] = sum / rk[k];
+    }
+
+    // sum_k b_k ((x - shift) / span)^k by Horner's scheme on polynomials in x
+    std::vector<double> coeffs(nparams, 0.0);
+    const double inv = (span > 0.0) ? 1.0 / span : 0.0;
+    for (int k = nparams - 1; k >= 0; --k) {
+        // coeffs *= (x - shift) * inv, then add b_k
+        for (int j = nparams - 1; j >= 0; --j) {
+            const double lower = (j > 0) ? coeffs[j - 1] : 0.0;
+            coeffs[j]          = (lower - shift * coeffs[j]) * inv;
+        }
+        coeffs[0] += b[k];
+    }
+
+    result.coeffs = std::move(coeffs);
+    result.scaled = std::move(b);
+    result.xshift = shift;
+    result.xscale = (span > 0.0) ? span : 1.0;
+    result.rms    = std::sqrt(sumsq / sumw);
+    result.ok     = true;
     return result;
 }
 
+// One pass with the streaming fit, so the memory stays O(degree^2) instead of
+// holding the whole design matrix.
+PolynomialFit polynomialFit(const std::vector<double> &x, const std::vector<double> &y, int degree)
+{
+    if ((x.size() != y.size()) || (degree < 0)) return {};
+
+    StreamingPolynomialFit stream(degree);
+    stream.add(x, y);
+    return stream.fit();
+}
+
 double evalBirchMurnaghan(const EosFit &fit, double v)
 {
     const double u = std::pow(v, -2.0 / 3.0);
@@ -99,7 +224,7 @@ EosFit birchMurnaghanFit(const std::vector<double> &v, const std::vector<double>
         A[i][3]        = u * u * u;
     }
 
-    const std::vector<double> co = solveNormalEquations(A, e);
+    const std::vector<double> co = solveLeastSquares(A, e);
     result.a                     = co[0];
     result.b                     = co[1];
     result.c                     = co[2];
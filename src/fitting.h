@@ -13,9 +13,10 @@
 #define FITTING_H
 
 // Linear-in-parameters least-squares curve fits, built on the (Qt-free)
-// leastsquares LU solver. Pure functions on std::vector<double> so they can
+// leastsquares QR solver. Pure functions on std::vector<double> so they can
 // be unit-tested without a GUI and reused by the chart post-processing dialog.
 
+#include <cstddef>
 #include <vector>
 
 /**
@@ -23,8 +24,11 @@
  */
 struct PolynomialFit {
     std::vector<double> coeffs; ///< coefficients c0..cn, i.e. y = sum_k c_k x^k
-    double rms = 0.0;           ///< root-mean-square residual
-    bool ok    = false;         ///< true if the fit succeeded
+    std::vector<double> scaled; ///< coefficients b0..bn of y = sum_k b_k t^k
+    double xshift = 0.0;        ///< shift of t = (x - xshift) / xscale
+    double xscale = 1.0;        ///< scale of t = (x - xshift) / xscale
+    double rms    = 0.0;        ///< root-mean-square residual
+    bool ok       = false;      ///< true if the fit succeeded
 };
 
 /**
@@ -37,6 +41,74 @@ struct PolynomialFit {
  */
 PolynomialFit polynomialFit(const std::vector<double> &x, const std::vector<double> &y, int degree);
 
+/**
+ * @brief Least-squares polynomial fit that takes its data one point at a time
+ *
+ * Keeps only the triangular factor R of a QR factorization of the (weighted)
+ * design matrix, together with Q^T y and the residual sum of squares, which
+ * every new point updates with Givens rotations.  The design matrix uses
+ * powers of the abscissa shifted by the first value and scaled by the spread
+ * of the values, so that large offsets, such as the steps of a continued run,
+ * do not make it ill-conditioned.  Adding a point and refitting
+ * both take O(degree^2) time and memory independent of the number of points,
+ * so a trend over a growing data set can be updated as new values arrive
+ * without revisiting the old ones.  Like polynomialFit() it never forms the
+ * ill-conditioned normal equations.
+ */
+class StreamingPolynomialFit {
+public:
+    /**
+     * @brief Empty fit
+     * @param degree Polynomial degree (clamped to >= 0)
+     */
+    explicit StreamingPolynomialFit(int degree);
+
+    /** @brief Polynomial degree */
+    int degree() const { return nparams - 1; }
+
+    /** @brief Number of points added */
+    std::size_t count() const { return npoints; }
+
+    /**
+     * @brief Add a data point
+     * @param x      Abscissa
+     * @param y      Ordinate
+     * @param weight Weight of the point's squared residual (> 0; others are ignored)
+     */
+    void add(double x, double y, double weight = 1.0);
+
+    /**
+     * @brief Add data points with unit weight
+     * @param x Abscissa values
+     * @param y Ordinate values; extra values of the longer vector are ignored
+     */
+    void add(const std::vector<double> &x, const std::vector<double> &y);
+
+    /** @brief Remove all points, keeping the degree */
+    void clear();
+
+    /**
+     * @brief Solve for the coefficients of the points added so far
+     * @return Fit result with the weighted root-mean-square residual; ok is
+     *         false if there are fewer than degree+1 distinct abscissa values
+     */
+    PolynomialFit fit() const;
+
+private:
+    void rescale(double dx);
+
+    int nparams;               ///< number of coefficients, degree + 1
+    std::vector<double> r;     ///< upper triangle of R, row-major nparams x nparams
+    std::vector<double> qty;   ///< first nparams elements of Q^T y
+    std::vector<double> norm;  ///< squared norms of the design-matrix columns
+    std::vector<double> row;   ///< scratch row of the design matrix
+    double shift        = 0.0; ///< abscissa of the first point
+    double span         = 0.0; ///< power of two >= max |x - shift| (0: not set yet)
+    double sumsq        = 0.0; ///< weighted residual sum of squares
+    double sumw         = 0.0; ///< sum of the weights
+    std::size_t npoints = 0;   ///< number of points added
+};
+
 /**
  * @brief Evaluate a polynomial at a point
  * @param coeffs Coefficients c0..cn (y = sum_k c_k x^k)
@@ -45,6 +117,17 @@ PolynomialFit polynomialFit(const std::vector<double> &x, const std::vector<doub
  */
 double evalPolynomial(const std::vector<double> &coeffs, double x);
 
+/**
+ * @brief Evaluate a fitted polynomial at a point
+ * @param fit Fit result
+ * @param x   Evaluation point
+ * @return Polynomial value
+ *
+ * Uses the shifted and scaled form, which stays accurate where the plain
+ * coefficients cancel, e.g. for a high degree far from x = 0.
+ */
+double evalPolynomialFit(const PolynomialFit &fit, double x);
+
 /**
  * @brief Result of a 4-parameter Birch-Murnaghan equation-of-state fit
  *
@@ -30,6 +30,7 @@
 #include "slideshow.h"
 #include "stdcapture.h"
 #include "syntaxcheck.h"
+#include "thermoparser.h"
 #include "tutorialwizard.h"
 #include "urldownloader.h"
 
@@ -70,6 +71,7 @@
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <iterator>
 #include <limits>
 #include <string>
 #include <utility>
@@ -683,9 +685,9 @@ void LammpsGui::setupAccelerators(QSettings &settings)
 
 LammpsGui::LammpsGui(QWidget *parent, const QString &filename, int width, int height) :
     QMainWindow(parent), textEdit(nullptr), menubar(nullptr), highlighter(nullptr),
-    capturer(new StdCapture), status(nullptr), cpuuse(nullptr), lastCpuBucket(-1),
-    logwindow(nullptr), imagewindow(nullptr), chartwindow(nullptr), slideshow(nullptr),
-    logupdater(nullptr), dirstatus(nullptr), progress(nullptr), prefdialog(nullptr),
+    capturer(new StdCapture), thermo(new ThermoParser), status(nullptr), cpuuse(nullptr),
+    lastCpuBucket(-1), logwindow(nullptr), imagewindow(nullptr), chartwindow(nullptr),
+    slideshow(nullptr), logupdater(nullptr), dirstatus(nullptr), progress(nullptr), prefdialog(nullptr),
     lammpsstatus(nullptr), varwindow(nullptr), wizard(nullptr), runner(nullptr), runCounter(0),
     extendSteps(Cfg::EXTEND_STEPS_DEFAULT), nthreads(1), mainx(width), mainy(height)
 {
@@ -800,6 +802,7 @@ LammpsGui::~LammpsGui()
 {
     delete highlighter;
     delete capturer;
+    delete thermo;
     delete status;
     delete cpuuse;
     delete logwindow;
@@ -1185,7 +1188,7 @@ void LammpsGui::viewFile(const QString &fileName)
                 file.errorString());
     } else {
         file.close();
-        auto *viewer = new FileViewer(fileName, this);
+        auto *viewer = createFileViewer(fileName, this);
         viewer->show();
     }
 }
@@ -1518,15 +1521,33 @@ void LammpsGui::logUpdate()
 {
     progress->setValue(updateRunStatus());
 
+    bool drained = true;
     if (logwindow) {
-        const auto text = capturer->getChunk();
+        // drain the capture pipe instead of reading a single chunk per update, so
+        // the output (and with it LAMMPS, which blocks on a full pipe) does not
+        // fall behind; the number of reads is bounded to keep the GUI responsive
+        std::string text;
+        drained = false;
+        for (int i = 0; i < Cfg::MAX_CAPTURE_READS; ++i) {
+            const auto chunk = capturer->getChunk();
+            if (chunk.empty()) {
+                drained = true;
+                break;
+            }
+            text += chunk;
+        }
         if (!text.empty()) {
+            thermo->feed(text);
             logwindow->moveCursor(QTextCursor::End);
             logwindow->insertPlainText(text.c_str());
             logwindow->moveCursor(QTextCursor::End);
         }
     }
 
+    // every thermo row printed since the last update is appended to the charts
+    auto rows = thermo->takeRows();
+    if (chartwindow && !dryRunActive) updateChartRows(std::move(rows));
+
     // get timestep
     int step = 0;
     if (lammps.extractSetting("bigint") == 4)
@@ -1534,9 +1555,14 @@ void LammpsGui::logUpdate()
     else
         step = static_cast<int>(lammps.lastThermoAs<int64_t>("step", 0));
 
-    // extract cached thermo data when LAMMPS is executing a minimize or run command;
-    // never during a dry run, where a kept chart window belongs to a previous run
-    if (chartwindow && !dryRunActive && lammps.isRunning()) {
+    // extract cached thermo data when LAMMPS is executing a minimize or run command,
+    // unless the thermo output is read from the captured screen output. This samples
+    // only the most recent row and is a fallback for thermo output the parser does
+    // not recognize (e.g. the multi-line format); it must wait while the parser still
+    // lags behind the output.  Never during a dry run, where a kept chart window
+    // belongs to a previous run.
+    if (chartwindow && !dryRunActive && drained && !thermo->hasSeenBlock() &&
+        lammps.isRunning()) {
         // thermo data is not yet valid during setup
         if (lammps.lastThermoAs<int>("setup", 0)) return;
 
@@ -1623,7 +1649,7 @@ int LammpsGui::updateRunStatus()
     return completed;
 }
 
-void LammpsGui::updateChartData(int step, int ncols)
+void LammpsGui::setupCharts(int step, const QStringList &keywords)
 {
     // check if the column assignment has changed
     // if yes, delete charts and start over
@@ -1631,8 +1657,8 @@ void LammpsGui::updateChartData(int step, int ncols)
         int count     = 0;
         bool do_reset = false;
         if (step < chartwindow->getStep()) do_reset = true;
-        for (int i = 0, idx = 0; i < ncols; ++i) {
-            QString label = lammps.lastThermoString("keyword", i);
+        int idx = 0;
+        for (const auto &label : keywords) {
             // no need to store the timestep column
             if (label == "Step") continue;
             if (!chartwindow->hasTitle(label, idx)) {
@@ -1647,13 +1673,20 @@ void LammpsGui::updateChartData(int step, int ncols)
     }
 
     if (chartwindow->numCharts() == 0) {
-        for (int i = 0; i < ncols; ++i) {
-            QString label = lammps.lastThermoString("keyword", i);
+        for (int i = 0; i < keywords.size(); ++i) {
             // no need to store the timestep column
-            if (label == "Step") continue;
-            chartwindow->addChart(label, i);
+            if (keywords[i] == "Step") continue;
+            chartwindow->addChart(keywords[i], i);
         }
     }
+}
+
+void LammpsGui::updateChartData(int step, int ncols)
+{
+    QStringList keywords;
+    for (int i = 0; i < ncols; ++i)
+        keywords << lammps.lastThermoString("keyword", i);
+    setupCharts(step, keywords);
 
     for (int i = 0; i < ncols; ++i) {
         const int datatype = lammps.lastThermoAs<int>("type", i);
@@ -1661,6 +1694,30 @@ void LammpsGui::updateChartData(int step, int ncols)
     }
 }
 
+void LammpsGui::updateChartRows(std::vector<ThermoRow> rows)
+{
+    // rows of one thermo block share their keyword list; hand the rows over to
+    // the chart window in batches of consecutive rows from the same block
+    auto first = rows.begin();
+    while (first != rows.end()) {
+        auto last = first;
+        while ((last != rows.end()) && (last->keywords == first->keywords))
+            ++last;
+
+        QStringList keywords;
+        for (const auto &word : *first->keywords)
+            keywords << QString::fromStdString(word);
+        setupCharts(static_cast<int>(first->step), keywords);
+        if ((first == rows.begin()) && (last == rows.end())) {
+            chartwindow->addRows(rows);
+        } else {
+            chartwindow->addRows(std::vector<ThermoRow>(std::make_move_iterator(first),
+                                                        std::make_move_iterator(last)));
+        }
+        first = last;
+    }
+}
+
 void LammpsGui::updateSlideShow()
 {
     // update list of available image file names
@@ -1722,6 +1779,9 @@ void LammpsGui::warnHighBufferUsage()
 void LammpsGui::finalizeChartData()
 {
     if (chartwindow) {
+        // thermo rows still queued from the output captured at the end of the run
+        updateChartRows(thermo->takeRows());
+
         int step = 0;
         if (lammps.extractSetting("bigint") == 4)
             step = lammps.lastThermoAs<int>("step", 0);
@@ -1760,6 +1820,8 @@ void LammpsGui::runDone()
 
     if (logwindow) {
         auto log = capturer->getCapture();
+        thermo->feed(log);
+        thermo->finish();
         logwindow->insertPlainText(log.c_str());
         logwindow->moveCursor(QTextCursor::End);
     }
@@ -2048,6 +2110,7 @@ void LammpsGui::doRun(bool use_buffer, bool dryrun)
     startLammps();
     if (!lammps.isOpen()) return;
     capturer->beginCapture();
+    thermo->reset();
 
     ++runCounter;
 
@@ -2146,11 +2209,15 @@ void LammpsGui::extendRun()
     status->repaint();
 
     capturer->beginCapture();
+    thermo->reset();
 
     // append to the windows of the extended run; create them only when missing
     // (e.g. when extending the state of an inspected restart file)
     if (!logwindow) createLogWindow(settings);
-    if (!chartwindow) createChartWindow(settings);
+    if (!chartwindow)
+        createChartWindow(settings);
+    else
+        chartwindow->setRangeEnabled(false); // live display until finalizeChartData()
 
     logwindow->moveCursor(QTextCursor::End);
     logwindow->insertPlainText(
@@ -2172,8 +2239,11 @@ void LammpsGui::plotDataFile()
                                                     QDir::currentPath(), Cfg::FILTER_DATA);
     if (fileName.isEmpty()) return;
 
+    // following continues after the bytes present before loading
+    const qint64 offset = QFileInfo(fileName).size();
+    PlotFormat format   = PlotFormat::Whitespace;
     QString error;
-    PlotData data = loadPlotData(fileName, &error);
+    PlotData data = loadPlotData(fileName, &error, &format);
     if (data.isEmpty()) {
         critical(this, "Plot Data File",
                  "Could not read data from file:", error.isEmpty() ? fileName : error);
@@ -2197,6 +2267,7 @@ void LammpsGui::plotDataFile()
     win->setWindowIcon(QIcon(Cfg::MAIN_ICON));
     win->setMinimumSize(Cfg::MINIMUM_WIDTH, Cfg::MINIMUM_HEIGHT);
     win->loadData(plotData, dialog.xColumn(), ycols);
+    win->setFollowSource(format, data.columnCount(), offset);
     win->show();
 }
 
@@ -51,6 +51,8 @@ class LogWindow;
 class Preferences;
 class SlideShow;
 class StdCapture;
+class ThermoParser;
+struct ThermoRow;
 class TutorialWizard;
 class URLDownloader;
 
@@ -407,6 +409,19 @@ private:
     /** @brief Append the cached thermo columns for the current step to the charts */
     void updateChartData(int step, int ncols);
 
+    /** @brief Append thermo rows extracted from the captured output to the charts */
+    void updateChartRows(std::vector<ThermoRow> rows);
+
+    /**
+     * @brief Make the charts match a set of thermo keywords
+     * @param step     Step of the first new data point
+     * @param keywords Thermo column names
+     *
+     * Resets the charts when the keywords changed or the step went backwards,
+     * then creates one chart per column (except "Step") if none exist.
+     */
+    void setupCharts(int step, const QStringList &keywords);
+
     /** @brief Append any newly rendered dump image to the slideshow */
     void updateSlideShow();
 
@@ -517,6 +532,7 @@ private:
     bool dryRunActive = false; ///< current run is an input check dry run
     Highlighter *highlighter;  ///< Syntax highlighter for LAMMPS input
     StdCapture *capturer;      ///< Captures stdout/stderr from LAMMPS
+    ThermoParser *thermo;      ///< Extracts every thermo row from the captured output
     QLabel *status;            ///< Status bar label for general status
     QLabel *cpuuse;            ///< Status bar label for CPU usage
     int lastCpuBucket;         ///< Last applied cpuuse color bucket (-1 = none yet)
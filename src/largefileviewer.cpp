@@ -0,0 +1,430 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "largefileviewer.h"
+
+#include "constants.h"
+#include "helpers.h"
+#include "lammpsgui.h"
+#include "lineindex.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QEvent>
+#include <QFontMetrics>
+#include <QIcon>
+#include <QInputDialog>
+#include <QKeyEvent>
+#include <QKeySequence>
+#include <QLineEdit>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QShortcut>
+#include <QTimer>
+
+#include <algorithm>
+#include <climits>
+#include <string_view>
+
+namespace {
+
+// interval at which the progress of the index and search threads is checked
+constexpr int POLL_MSEC = 200;
+
+// at most this many bytes of a line are shown, so a huge single line stays fast to paint
+constexpr std::size_t MAX_LINE_BYTES = 65536;
+
+constexpr int TAB_WIDTH = 8;
+
+// decode the shown part of a line and replace tabs with spaces up to the next tab stop
+QString displayText(std::string_view bytes)
+{
+    bytes = bytes.substr(0, MAX_LINE_BYTES);
+    const QString text = QString::fromUtf8(bytes.data(), static_cast<qsizetype>(bytes.size()));
+    if (!text.contains('\t')) return text;
+
+    QString expanded;
+    expanded.reserve(text.size() + TAB_WIDTH);
+    for (const QChar c : text) {
+        if (c == '\t')
+            expanded += QString(TAB_WIDTH - (expanded.size() % TAB_WIDTH), ' ');
+        else
+            expanded += c;
+    }
+    return expanded;
+}
+
+} // namespace
+
+LargeFileViewer::LargeFileViewer(const QString &_filename, LammpsGui *_lammpsgui,
+                                 const QString &title, QWidget *parent) :
+    QAbstractScrollArea(parent), fileName(_filename), lammpsgui(_lammpsgui), file(_filename),
+    mapped(nullptr), poll(new QTimer(this)), searchResult(LineIndex::npos), caseSensitive(false),
+    matchOffset(LineIndex::npos), pendingMatch(LineIndex::npos), currentLine(0), widestLine(0)
+{
+    auto *action = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_Q), this);
+    connect(action, &QShortcut::activated, this, &LargeFileViewer::quit);
+    action = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_Slash), this);
+    connect(action, &QShortcut::activated, this, &LargeFileViewer::stopRun);
+    action = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_G), this);
+    connect(action, &QShortcut::activated, this, &LargeFileViewer::gotoLine);
+    action = new QShortcut(QKeySequence::Find, this);
+    connect(action, &QShortcut::activated, this, &LargeFileViewer::find);
+    action = new QShortcut(QKeySequence::FindNext, this);
+    connect(action, &QShortcut::activated, this, &LargeFileViewer::findNext);
+    action = new QShortcut(QKeySequence::Copy, this);
+    connect(action, &QShortcut::activated, this, &LargeFileViewer::copyLine);
+
+    installEventFilter(this);
+
+    // map the file instead of reading it; an empty file cannot be mapped and needs no mapping
+    std::string_view text;
+    if (!file.open(QIODevice::ReadOnly)) {
+        message = QString("Could not open file %1: %2").arg(fileName, file.errorString());
+    } else if (file.size() > 0) {
+        mapped = file.map(0, file.size());
+        if (mapped)
+            text = std::string_view(reinterpret_cast<const char *>(mapped),
+                                    static_cast<std::size_t>(file.size()));
+        else
+            message = QString("Could not map file %1: %2").arg(fileName, file.errorString());
+    }
+    index   = std::make_unique<LineIndex>(text);
+    indexer = std::thread(&LineIndex::build, index.get());
+
+    setFont(monoFontFromSettings());
+    verticalScrollBar()->setSingleStep(1);
+    horizontalScrollBar()->setSingleStep(1);
+    setFocusPolicy(Qt::StrongFocus);
+    setMinimumSize(800, 500);
+    setWindowIcon(QIcon(Cfg::MAIN_ICON));
+    baseTitle = title.isEmpty() ? ("LAMMPS-GUI - Viewer - " + fileName) : title;
+    setWindowTitle(baseTitle);
+
+    connect(poll, &QTimer::timeout, this, &LargeFileViewer::updateState);
+    poll->start(POLL_MSEC);
+
+    applyWindowFlags(this);
+}
+
+LargeFileViewer::~LargeFileViewer()
+{
+    stopSearch();
+    index->cancel();
+    indexer.join();
+    if (mapped) file.unmap(mapped);
+}
+
+/* -------------------------------------------------------------------- */
+
+void LargeFileViewer::quit()
+{
+    if (lammpsgui) lammpsgui->quit();
+}
+
+void LargeFileViewer::stopRun()
+{
+    if (lammpsgui) lammpsgui->stopRun();
+}
+
+/* -------------------------------------------------------------------- */
+
+void LargeFileViewer::gotoLine()
+{
+    const std::size_t count = index->lineCount();
+    if (count == 0) return;
+
+    // lines that are not indexed yet cannot be reached
+    const int last      = static_cast<int>(std::min<std::size_t>(count, INT_MAX));
+    const int current   = static_cast<int>(std::min<std::size_t>(currentLine + 1, last));
+    const QString label = index->finished()
+        ? QString("Line number:")
+        : QString("Line number (%1 lines indexed so far):").arg(count);
+
+    bool ok        = false;
+    const int line = QInputDialog::getInt(this, "Go to Line", label, current, 1, last, 1, &ok);
+    if (ok) setCurrentLine(static_cast<std::size_t>(line) - 1);
+}
+
+void LargeFileViewer::find()
+{
+    bool ok            = false;
+    const QString text = QInputDialog::getText(this, "Find", "Find text:", QLineEdit::Normal,
+                                               QString::fromUtf8(searchText), &ok);
+    if (!ok || text.isEmpty()) return;
+
+    // like "smart case" in many editors: only a search text with capitals matches case
+    searchText    = text.toUtf8();
+    caseSensitive = text != text.toLower();
+    startSearch(index->lineStart(currentLine));
+}
+
+void LargeFileViewer::findNext()
+{
+    if (searchText.isEmpty()) {
+        find();
+        return;
+    }
+    const std::size_t from = (matchOffset != LineIndex::npos) ? matchOffset + 1
+                                                              : index->lineStart(currentLine);
+    startSearch(from);
+}
+
+void LargeFileViewer::copyLine()
+{
+    if (currentLine >= index->lineCount()) return;
+    const std::string_view line = index->line(currentLine);
+    QGuiApplication::clipboard()->setText(
+        QString::fromUtf8(line.data(), static_cast<qsizetype>(line.size())));
+}
+
+/* -------------------------------------------------------------------- */
+
+// search on a background thread from an offset, continuing at the start of the file
+void LargeFileViewer::startSearch(std::size_t from)
+{
+    stopSearch();
+    searchStop = false;
+    searchDone = false;
+    searcher   = std::thread([this, from, needle = searchText.toStdString(), cs = caseSensitive] {
+        std::size_t found = index->find(needle, from, cs, &searchStop);
+        if ((found == LineIndex::npos) && (from > 0) && !searchStop)
+            found = index->find(needle, 0, cs, &searchStop);
+        searchResult = found;
+        searchDone   = true;
+    });
+    poll->start(POLL_MSEC);
+}
+
+void LargeFileViewer::stopSearch()
+{
+    if (!searcher.joinable()) return;
+    searchStop = true;
+    searcher.join();
+}
+
+/* -------------------------------------------------------------------- */
+
+void LargeFileViewer::updateState()
+{
+    updateScrollBars();
+    viewport()->update();
+
+    if (searcher.joinable() && searchDone) {
+        searcher.join();
+        if (searchResult == LineIndex::npos)
+            information(this, "LAMMPS-GUI - Find",
+                        "Text \"" + QString::fromUtf8(searchText) + "\" not found");
+        else
+            pendingMatch = searchResult;
+    }
+
+    // a match can only be shown once its line is indexed
+    if (pendingMatch != LineIndex::npos) {
+        const std::size_t line = index->lineAt(pendingMatch);
+        if (line < index->lineCount()) {
+            matchOffset  = pendingMatch;
+            pendingMatch = LineIndex::npos;
+            setCurrentLine(line);
+        }
+    }
+
+    // show the progress of the index in the title
+    QString status;
+    const std::size_t count = index->lineCount();
+    if (!index->finished() && (count > 0))
+        status = QString(" (indexing: %1%)").arg(100 * index->lineStart(count - 1) / index->size());
+    else if (searcher.joinable() || (pendingMatch != LineIndex::npos))
+        status = " (searching...)";
+    setWindowTitle(baseTitle + status);
+
+    if (index->finished() && !searcher.joinable() && (pendingMatch == LineIndex::npos))
+        poll->stop();
+}
+
+void LargeFileViewer::updateScrollBars()
+{
+    // the scroll bars count lines and characters
+    const std::size_t count = index->lineCount();
+    const int lines         = static_cast<int>(std::min<std::size_t>(count, INT_MAX));
+    const int columns       = std::max(1, (viewport()->width() - gutterWidth()) /
+                                              std::max(1, fontMetrics().horizontalAdvance('0')));
+    verticalScrollBar()->setRange(0, std::max(0, lines - visibleLines()));
+    verticalScrollBar()->setPageStep(visibleLines());
+    horizontalScrollBar()->setRange(0, std::max(0, widestLine - columns + 1));
+    horizontalScrollBar()->setPageStep(columns);
+}
+
+int LargeFileViewer::visibleLines() const
+{
+    return std::max(1, viewport()->height() / fontMetrics().lineSpacing());
+}
+
+int LargeFileViewer::gutterWidth() const
+{
+    int digits = 1;
+    for (std::size_t max = std::max<std::size_t>(index->lineCount(), 1); max >= 10; max /= 10)
+        ++digits;
+    return fontMetrics().horizontalAdvance('0') * (digits + 2);
+}
+
+void LargeFileViewer::setCurrentLine(std::size_t line)
+{
+    const std::size_t count = index->lineCount();
+    if (count == 0) return;
+    currentLine = std::min(line, count - 1);
+
+    // scroll only if the line is not visible
+    const auto first = static_cast<std::size_t>(verticalScrollBar()->value());
+    const auto shown = static_cast<std::size_t>(visibleLines());
+    if (currentLine < first)
+        verticalScrollBar()->setValue(static_cast<int>(currentLine));
+    else if (currentLine >= first + shown)
+        verticalScrollBar()->setValue(static_cast<int>(currentLine - shown + 1));
+    viewport()->update();
+}
+
+/* -------------------------------------------------------------------- */
+
+// paint only the visible lines, decoding them from the mapped file
+void LargeFileViewer::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(viewport());
+    painter.fillRect(event->rect(), palette().color(QPalette::Base));
+    const QFontMetrics metrics = fontMetrics();
+    const int charWidth        = metrics.horizontalAdvance('0');
+    const int lineHeight       = metrics.lineSpacing();
+
+    if (!message.isEmpty()) {
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(viewport()->rect().adjusted(charWidth, lineHeight, -charWidth, 0),
+                         Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap, message);
+        return;
+    }
+
+    const int gutter        = gutterWidth();
+    const int width         = viewport()->width();
+    const int height        = viewport()->height();
+    const int firstColumn   = horizontalScrollBar()->value();
+    const std::size_t count = index->lineCount();
+    const char *base        = reinterpret_cast<const char *>(mapped);
+    const int matchLength   = QString::fromUtf8(searchText).size();
+    int widest              = widestLine;
+
+    painter.fillRect(0, 0, gutter, height, palette().color(QPalette::Dark));
+    int top = 0;
+    for (auto n = static_cast<std::size_t>(verticalScrollBar()->value());
+         (n < count) && (top < height); ++n, top += lineHeight) {
+        const std::string_view bytes = index->line(n);
+        const QString text           = displayText(bytes);
+        widest                       = std::max(widest, static_cast<int>(text.size()));
+
+        if (n == currentLine)
+            painter.fillRect(gutter, top, width - gutter, lineHeight,
+                             palette().color(QPalette::AlternateBase));
+        painter.setPen(palette().color(QPalette::WindowText));
+        painter.drawText(0, top, gutter - charWidth, lineHeight, Qt::AlignRight,
+                         QString::number(n + 1));
+
+        painter.setClipRect(gutter, top, width - gutter, lineHeight);
+        const int left = gutter + (charWidth / 2) - (firstColumn * charWidth);
+        if (base && (matchOffset != LineIndex::npos)) {
+            const auto start = static_cast<std::size_t>(bytes.data() - base);
+            if ((matchOffset >= start) && (matchOffset < start + bytes.size())) {
+                const int column = displayText(bytes.substr(0, matchOffset - start)).size();
+                painter.fillRect(left + (column * charWidth), top, matchLength * charWidth,
+                                 lineHeight, palette().color(QPalette::Highlight));
+            }
+        }
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(left, top + metrics.ascent(), text);
+        painter.setClipping(false);
+    }
+
+    // adjust the horizontal scroll range after painting, not while
+    if (widest > widestLine) {
+        widestLine = widest;
+        QTimer::singleShot(0, this, &LargeFileViewer::updateScrollBars);
+    }
+}
+
+void LargeFileViewer::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void LargeFileViewer::keyPressEvent(QKeyEvent *event)
+{
+    const std::size_t page = static_cast<std::size_t>(visibleLines());
+    switch (event->key()) {
+        case Qt::Key_Up:
+            if (currentLine > 0) setCurrentLine(currentLine - 1);
+            break;
+        case Qt::Key_Down:
+            setCurrentLine(currentLine + 1);
+            break;
+        case Qt::Key_PageUp:
+            setCurrentLine((currentLine > page) ? currentLine - page : 0);
+            break;
+        case Qt::Key_PageDown:
+            setCurrentLine(currentLine + page);
+            break;
+        case Qt::Key_Home:
+            setCurrentLine(0);
+            break;
+        case Qt::Key_End:
+            setCurrentLine(index->lineCount());
+            break;
+        case Qt::Key_Left:
+            horizontalScrollBar()->setValue(horizontalScrollBar()->value() - 1);
+            break;
+        case Qt::Key_Right:
+            horizontalScrollBar()->setValue(horizontalScrollBar()->value() + 1);
+            break;
+        default:
+            QAbstractScrollArea::keyPressEvent(event);
+    }
+}
+
+void LargeFileViewer::mousePressEvent(QMouseEvent *event)
+{
+    const auto row = static_cast<std::size_t>(event->position().y()) /
+                     static_cast<std::size_t>(fontMetrics().lineSpacing());
+    const std::size_t line = static_cast<std::size_t>(verticalScrollBar()->value()) + row;
+    if (line < index->lineCount()) setCurrentLine(line);
+}
+
+// event filter to handle "Ambiguous shortcut override" issues
+bool LargeFileViewer::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::ShortcutOverride) {
+        auto *keyEvent = dynamic_cast<QKeyEvent *>(event);
+        if (!keyEvent) return QAbstractScrollArea::eventFilter(watched, event);
+        if (keyEvent->modifiers().testFlag(Qt::ControlModifier) && keyEvent->key() == '/') {
+            stopRun();
+            event->accept();
+            return true;
+        }
+        if (keyEvent->modifiers().testFlag(Qt::ControlModifier) && keyEvent->key() == 'W') {
+            close();
+            event->accept();
+            return true;
+        }
+    }
+    return QAbstractScrollArea::eventFilter(watched, event);
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
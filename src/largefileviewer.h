@@ -0,0 +1,123 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LARGEFILEVIEWER_H
+#define LARGEFILEVIEWER_H
+
+#include <QAbstractScrollArea>
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+class LammpsGui;
+class LineIndex;
+class QTimer;
+
+/**
+ * @brief Read-only viewer for text files too large to load into a text widget
+ *
+ * Instead of reading the file into a document, LargeFileViewer maps it into
+ * memory and indexes its lines on a background thread, while only the lines
+ * in the visible part of the window are decoded and painted.  The file can be
+ * scrolled while the index is built, and the memory used does not grow with
+ * the size of the file beyond the (shared, reclaimable) mapped pages and a
+ * small sparse line index.  Searching also runs on a background thread over
+ * the mapped bytes.  It has the same shortcuts as FileViewer, plus Ctrl+G to
+ * go to a line, Ctrl+F and F3 to find text, and Ctrl+C to copy the current line.
+ */
+class LargeFileViewer : public QAbstractScrollArea {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor
+     * @param filename Path to the (uncompressed) file to display
+     * @param lammpsgui Pointer to LammpsGui for sending signals
+     * @param title Window title (defaults to filename if empty)
+     * @param parent Parent widget
+     */
+    explicit LargeFileViewer(const QString &filename, LammpsGui *lammpsgui,
+                             const QString &title = "", QWidget *parent = nullptr);
+
+    /**
+     * @brief Destructor; stops the background threads and unmaps the file
+     */
+    ~LargeFileViewer() override;
+
+    LargeFileViewer()                                   = delete;
+    LargeFileViewer(const LargeFileViewer &)            = delete;
+    LargeFileViewer(LargeFileViewer &&)                 = delete;
+    LargeFileViewer &operator=(const LargeFileViewer &) = delete;
+    LargeFileViewer &operator=(LargeFileViewer &&)      = delete;
+
+private slots:
+    void quit();        ///< Close the viewer window
+    void stopRun();     ///< Stop the running simulation
+    void gotoLine();    ///< Ask for a line number and show that line
+    void find();        ///< Ask for a text and find its next occurrence
+    void findNext();    ///< Find the next occurrence of the last searched text
+    void copyLine();    ///< Copy the current line to the clipboard
+    void updateState(); ///< Poll the progress of the index and search threads
+
+protected:
+    /**
+     * @brief Event filter for keyboard shortcuts
+     * @param watched Object being watched
+     * @param event Event to filter
+     * @return true if event handled, false otherwise
+     */
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    void startSearch(std::size_t from);
+    void stopSearch();
+    void setCurrentLine(std::size_t line);
+    void updateScrollBars();
+    int visibleLines() const;
+    int gutterWidth() const;
+
+    QString fileName;                 ///< Path to the displayed file
+    QString baseTitle;                ///< Window title without the progress note
+    QString message;                  ///< Error message shown instead of the file contents
+    LammpsGui *lammpsgui;             ///< Main widget pointer for receiving signals
+    QFile file;                       ///< The mapped file
+    uchar *mapped;                    ///< Start of the mapped file contents
+    std::unique_ptr<LineIndex> index; ///< Line index of the mapped file contents
+    std::thread indexer;              ///< Builds the line index
+    QTimer *poll;                     ///< Triggers updateState() while a thread is busy
+
+    std::thread searcher;                  ///< Runs the current search
+    std::atomic<bool> searchStop{false};   ///< Tells the search thread to give up
+    std::atomic<bool> searchDone{false};   ///< The search thread has set searchResult
+    std::atomic<std::size_t> searchResult; ///< Offset of the match found by the search thread
+    QByteArray searchText;                 ///< UTF-8 text of the last search
+    bool caseSensitive;                    ///< Whether the last search matched case
+    std::size_t matchOffset;               ///< Offset of the highlighted match, or npos
+    std::size_t pendingMatch;              ///< Match in lines that are not indexed yet, or npos
+
+    std::size_t currentLine; ///< Highlighted line, whose text is copied by copyLine()
+    int widestLine;          ///< Widest painted line in characters, for horizontal scrolling
+};
+
+#endif
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -17,18 +17,25 @@
 
 // constructor with sizes
 float_mat::float_mat(const std::size_t rows, const std::size_t cols, const double defval) :
-    std::vector<float_vect>(rows)
+    m_rows(rows), m_cols(cols), m_data(rows * cols, defval)
 {
-    for (std::size_t i = 0; i < rows; ++i) {
-        (*this)[i].resize(cols, defval);
-    }
 }
 
-// copy constructor for matrix: the base vector's element-wise copy does it all
+// copy constructor for matrix: copying the element block does it all
 float_mat::float_mat(const float_mat &m) = default;
 
 // constructor from a vector: a matrix with that vector as its single row
-float_mat::float_mat(const float_vect &v) : std::vector<float_vect>(1, v) {}
+float_mat::float_mat(const float_vect &v) : m_rows(1), m_cols(v.size()), m_data(v) {}
+
+void float_mat::fill(const double value)
+{
+    std::fill(m_data.begin(), m_data.end(), value);
+}
+
+void float_mat::swap_rows(const std::size_t i, const std::size_t j)
+{
+    if (i != j) std::swap_ranges((*this)[i], (*this)[i] + m_cols, (*this)[j]);
+}
 
 //////////////////////
 // Helper functions //
@@ -36,6 +43,17 @@ float_mat::float_mat(const float_vect &v) : std::vector<float_vect>(1, v) {}
 
 namespace {
 
+// block size (in elements) of the cache-blocked matrix products: three
+// 64x64 blocks of doubles fit into a typical L2 cache
+constexpr std::size_t BLOCK = 64;
+
+//! fill a solution with NaN to flag a system that could not be solved.
+float_mat &not_solvable(float_mat &x)
+{
+    x.fill(std::numeric_limits<double>::quiet_NaN());
+    return x;
+}
+
 //! permute() orders the rows of A to match the integers in the index array.
 void permute(float_mat &A, int_vect &idx)
 {
@@ -52,7 +70,7 @@ void permute(float_mat &A, int_vect &idx)
             // search only the remaining indices
             for (std::size_t k = j + 1; k < A.nr_rows(); ++k) {
                 if (i[k] == idx[j]) {
-                    std::swap(A[j], A[k]); // swap the rows and
+                    A.swap_rows(j, k);     // swap the rows and
                     i[k] = i[j];           // the elements of
                     i[j] = idx[j];         // the ordered index.
                     break;                 // next j
@@ -227,11 +245,7 @@ float_mat lin_solve(const float_mat &A, const float_mat &a)
     // a singular matrix cannot be solved; return NaNs explicitly instead of
     // dividing by zero pivots below (callers already guard against non-finite
     // results, e.g. the Levenberg-Marquardt step check)
-    if (lu_factorize(B, idx) == 0) {
-        for (auto &row : b)
-            std::fill(row.begin(), row.end(), std::numeric_limits<double>::quiet_NaN());
-        return b;
-    }
+    if (lu_factorize(B, idx) == 0) return std::move(not_solvable(b));
     permute(b, idx);    // sort the inhomogeneity to match the lu-decomp
     lu_forwsubst(B, b); // solve the forward problem
     lu_backsubst(B, b); // solve the backward problem
@@ -241,7 +255,7 @@ float_mat lin_solve(const float_mat &A, const float_mat &a)
 //! Returns the inverse of a matrix using LU-decomposition.
 float_mat invert(const float_mat &A)
 {
-    const std::size_t n = A.size();
+    const std::size_t n = A.nr_rows();
     float_mat E(n, n, 0.0);
     const float_mat &B(A);
 
@@ -252,30 +266,211 @@ float_mat invert(const float_mat &A)
     return lin_solve(B, E);
 }
 
-//! returns the transposed matrix.
-float_mat transpose(const float_mat &a)
+/*! \brief Solve a symmetric positive definite system of linear equations.
+ * Factorizes A = L*L^T (Cholesky) and solves by forward and backward
+ * substitution.  Only the lower triangle of A is used. */
+float_mat cholesky_solve(const float_mat &A, const float_mat &a)
+{
+    const std::size_t n = A.nr_rows();
+    const std::size_t q = a.nr_cols();
+    float_mat L(A);
+    float_mat x(a);
+
+    // factorize in place, row by row: the inner products run along rows
+    for (std::size_t j = 0; j < n; ++j) {
+        const double *Lj = L[j];
+        double d         = Lj[j];
+        for (std::size_t k = 0; k < j; ++k)
+            d -= Lj[k] * Lj[k];
+        if (!(d > 0.0)) return std::move(not_solvable(x)); // not positive definite
+        d       = std::sqrt(d);
+        L[j][j] = d;
+        for (std::size_t i = j + 1; i < n; ++i) {
+            double *Li = L[i];
+            double sum = Li[j];
+            for (std::size_t k = 0; k < j; ++k)
+                sum -= Li[k] * Lj[k];
+            Li[j] = sum / d;
+        }
+    }
+
+    // forward substitution L*y = a
+    for (std::size_t r = 0; r < n; ++r) {
+        double *xr = x[r];
+        for (std::size_t c = 0; c < r; ++c) {
+            const double l   = L[r][c];
+            const double *xc = x[c];
+            for (std::size_t k = 0; k < q; ++k)
+                xr[k] -= l * xc[k];
+        }
+        for (std::size_t k = 0; k < q; ++k)
+            xr[k] /= L[r][r];
+    }
+
+    // backward substitution L^T*x = y
+    for (std::size_t r = n; r-- > 0;) {
+        double *xr = x[r];
+        for (std::size_t c = r + 1; c < n; ++c) {
+            const double l   = L[c][r];
+            const double *xc = x[c];
+            for (std::size_t k = 0; k < q; ++k)
+                xr[k] -= l * xc[k];
+        }
+        for (std::size_t k = 0; k < q; ++k)
+            xr[k] /= L[r][r];
+    }
+    return x;
+}
+
+/*! \brief Least-squares solution of an overdetermined system.
+ * Reduces A to upper triangular form R with Householder reflections that are
+ * applied to b as well, then solves R*x = (Q^T b) by backward substitution.
+ * The reflections are applied row by row so all inner loops have unit
+ * stride. */
+float_mat qr_solve(const float_mat &A, const float_mat &b)
 {
-    float_mat res(a.nr_cols(), a.nr_rows());
+    const std::size_t m = A.nr_rows();
+    const std::size_t n = A.nr_cols();
+    const std::size_t q = b.nr_cols();
+    float_mat x(n, q, 0.0);
+    if (m < n) return std::move(not_solvable(x));
+
+    float_mat R(A);
+    float_mat y(b);
+    float_vect v(m);  // Householder vector (entries k..m-1)
+    float_vect wr(n); // v^T R for the remaining columns
+    float_vect wy(q); // v^T y
+
+    for (std::size_t k = 0; k < n; ++k) {
+        double norm = 0.0;
+        for (std::size_t i = k; i < m; ++i)
+            norm += R[i][k] * R[i][k];
+        norm = std::sqrt(norm);
+        if (!(norm > 0.0)) return std::move(not_solvable(x)); // rank deficient
+
+        // reflect column k onto alpha*e_k; the sign avoids cancellation
+        const double alpha = (R[k][k] > 0.0) ? -norm : norm;
+        for (std::size_t i = k; i < m; ++i)
+            v[i] = R[i][k];
+        v[k] -= alpha;
+        const double vnorm2 = 2.0 * norm * (norm + std::fabs(R[k][k])); // = v^T v
+
+        std::fill(wr.begin() + k, wr.end(), 0.0);
+        std::fill(wy.begin(), wy.end(), 0.0);
+        for (std::size_t i = k; i < m; ++i) {
+            const double vi  = v[i];
+            const double *Ri = R[i];
+            const double *yi = y[i];
+            for (std::size_t j = k; j < n; ++j)
+                wr[j] += vi * Ri[j];
+            for (std::size_t j = 0; j < q; ++j)
+                wy[j] += vi * yi[j];
+        }
+        for (std::size_t i = k; i < m; ++i) {
+            const double f = 2.0 * v[i] / vnorm2;
+            double *Ri     = R[i];
+            double *yi     = y[i];
+            for (std::size_t j = k; j < n; ++j)
+                Ri[j] -= f * wr[j];
+            for (std::size_t j = 0; j < q; ++j)
+                yi[j] -= f * wy[j];
+        }
+    }
+
+    // backward substitution with the upper triangle R
+    for (std::size_t r = n; r-- > 0;) {
+        double *xr = x[r];
+        for (std::size_t k = 0; k < q; ++k)
+            xr[k] = y[r][k];
+        for (std::size_t c = r + 1; c < n; ++c) {
+            const double rc  = R[r][c];
+            const double *xc = x[c];
+            for (std::size_t k = 0; k < q; ++k)
+                xr[k] -= rc * xc[k];
+        }
+        for (std::size_t k = 0; k < q; ++k)
+            xr[k] /= R[r][r];
+    }
+    return x;
+}
 
-    for (std::size_t i = 0; i < a.nr_rows(); ++i) {
-        for (std::size_t j = 0; j < a.nr_cols(); ++j) {
-            res[j][i] = a[i][j];
+//! returns the transposed matrix, copied in cache-sized tiles.
+float_mat transpose(const float_mat &a)
+{
+    const std::size_t rows = a.nr_rows();
+    const std::size_t cols = a.nr_cols();
+    float_mat res(cols, rows);
+
+    for (std::size_t ii = 0; ii < rows; ii += BLOCK) {
+        const std::size_t iend = std::min(ii + BLOCK, rows);
+        for (std::size_t jj = 0; jj < cols; jj += BLOCK) {
+            const std::size_t jend = std::min(jj + BLOCK, cols);
+            for (std::size_t i = ii; i < iend; ++i) {
+                const double *ai = a[i];
+                for (std::size_t j = jj; j < jend; ++j)
+                    res[j][i] = ai[j];
+            }
         }
     }
     return res;
 }
 
-//! matrix multiplication.
+/*! \brief matrix multiplication.
+ * Cache-blocked; the innermost loop runs along rows of b and of the result.
+ * Each element still sums its products in order of increasing k. */
 float_mat operator*(const float_mat &a, const float_mat &b)
 {
-    float_mat res(a.nr_rows(), b.nr_cols());
-    for (std::size_t i = 0; i < a.nr_rows(); ++i) {
-        for (std::size_t j = 0; j < b.nr_cols(); ++j) {
-            double sum(0.0);
-            for (std::size_t k = 0; k < a.nr_cols(); ++k) {
-                sum += a[i][k] * b[k][j];
+    const std::size_t n = a.nr_rows();
+    const std::size_t m = a.nr_cols();
+    const std::size_t p = b.nr_cols();
+    float_mat res(n, p, 0.0);
+
+    for (std::size_t ii = 0; ii < n; ii += BLOCK) {
+        const std::size_t iend = std::min(ii + BLOCK, n);
+        for (std::size_t kk = 0; kk < m; kk += BLOCK) {
+            const std::size_t kend = std::min(kk + BLOCK, m);
+            for (std::size_t jj = 0; jj < p; jj += BLOCK) {
+                const std::size_t jend = std::min(jj + BLOCK, p);
+                for (std::size_t i = ii; i < iend; ++i) {
+                    const double *ai = a[i];
+                    double *ri       = res[i];
+                    for (std::size_t k = kk; k < kend; ++k) {
+                        const double aik = ai[k];
+                        const double *bk = b[k];
+                        for (std::size_t j = jj; j < jend; ++j)
+                            ri[j] += aik * bk[j];
+                    }
+                }
+            }
+        }
+    }
+    return res;
+}
+
+/*! \brief product of a transposed matrix with a matrix.
+ * Streams once through the rows of a and b per block of result columns, so
+ * tall matrices (many data points, few parameters) are read sequentially. */
+float_mat transpose_mult(const float_mat &a, const float_mat &b)
+{
+    const std::size_t m = a.nr_rows();
+    const std::size_t n = a.nr_cols();
+    const std::size_t p = b.nr_cols();
+    float_mat res(n, p, 0.0);
+
+    for (std::size_t jj = 0; jj < n; jj += BLOCK) {
+        const std::size_t jend = std::min(jj + BLOCK, n);
+        for (std::size_t kk = 0; kk < p; kk += BLOCK) {
+            const std::size_t kend = std::min(kk + BLOCK, p);
+            for (std::size_t i = 0; i < m; ++i) {
+                const double *ai = a[i];
+                const double *bi = b[i];
+                for (std::size_t j = jj; j < jend; ++j) {
+                    const double aij = ai[j];
+                    double *rj       = res[j];
+                    for (std::size_t k = kk; k < kend; ++k)
+                        rj[k] += aij * bi[k];
+                }
             }
-            res[i][j] = sum;
         }
     }
     return res;
@@ -291,60 +486,103 @@ float_mat operator*(const float_mat &a, const float_mat &b)
  * used. */
 float_vect sg_smooth(const float_vect &v, const std::size_t width, const int deg)
 {
-    float_vect res(v.size(), 0.0);
-    const std::size_t window = (2 * (std::size_t)width) + 1;
-    const int endidx         = v.size() - 1;
+    SGSmoother smoother(width, deg);
+    smoother.update(v.data(), v.size());
+    return smoother.values();
+}
 
-    // guard against inputs shorter than the smoothing window: the unsigned
-    // v.size() - window loop bounds below would underflow and run away
-    if (v.size() < window) return res;
+//! set up the coefficients of the savitzky golay filter once.
+SGSmoother::SGSmoother(const std::size_t width, const int deg) :
+    m_width(width), m_deg(deg), m_border(width, (2 * width) + 1),
+    m_borderLen(width)
+{
+    const std::size_t window = (2 * width) + 1;
 
     // do a regular sliding window average
     if (deg == 0) {
-        // handle border cases first because we need different coefficients
+        // border outputs average over the first (last) i+1 points only
         for (std::size_t i = 0; i < width; ++i) {
-            const double scale = 1.0 / double(i + 1);
-            const float_vect c1(width, scale);
-            for (std::size_t j = 0; j <= i; ++j) {
-                res[i] += c1[j] * v[j];
-                res[endidx - i] += c1[j] * v[endidx - j];
-            }
-        }
-
-        // now loop over rest of data. reusing the "symmetric" coefficients.
-        const double scale = 1.0 / double(window);
-        const float_vect c2(window, scale);
-        for (std::size_t i = 0; i <= (v.size() - window); ++i) {
-            for (std::size_t j = 0; j < window; ++j) {
-                res[i + width] += c2[j] * v[i + j];
-            }
+            m_borderLen[i] = static_cast<int>(i + 1);
+            std::fill(m_border[i], m_border[i] + window, 1.0 / double(i + 1));
         }
-        return res;
+        m_center.assign(window, 1.0 / double(window));
+        return;
     }
 
-    // handle border cases first because we need different coefficients
+    // border outputs need different coefficients
     for (std::size_t i = 0; i < width; ++i) {
         float_vect b1(window, 0.0);
         b1[i] = 1.0;
-
         const float_vect c1(sg_coeff(b1, deg));
-        for (std::size_t j = 0; j < window; ++j) {
-            res[i] += c1[j] * v[j];
-            res[endidx - i] += c1[j] * v[endidx - j];
-        }
+        std::copy(c1.begin(), c1.end(), m_border[i]);
+        m_borderLen[i] = static_cast<int>(window);
     }
 
-    // now loop over rest of data. reusing the "symmetric" coefficients.
+    // the "symmetric" coefficients are used for the rest of the data
     float_vect b2(window, 0.0);
     b2[width] = 1.0;
-    const float_vect c2(sg_coeff(b2, deg));
+    m_center  = sg_coeff(b2, deg);
+}
+
+void SGSmoother::reset()
+{
+    m_res.clear();
+}
+
+std::size_t SGSmoother::inputStart(const std::size_t n) const
+{
+    // the same outputs as in update() are recomputed: those from width before
+    // the old end, whose windows reach back another width samples, and the
+    // border outputs at the new end, which read the last window samples
+    const std::size_t window = (2 * m_width) + 1;
+    const std::size_t old    = m_res.size();
+    if ((n < window) || (n < old) || (old < window)) return 0;
+    return std::min(old - (2 * m_width), n - window);
+}
 
-    for (std::size_t i = 0; i <= (v.size() - window); ++i) {
-        for (std::size_t j = 0; j < window; ++j) {
-            res[i + width] += c2[j] * v[i + j];
+std::size_t SGSmoother::update(const double *v, const std::size_t n, const std::size_t start)
+{
+    const std::size_t window = (2 * m_width) + 1;
+    const std::size_t old    = m_res.size();
+    if (n < old) m_res.clear();
+
+    // the whole series is too short for the smoothing window
+    if (n < window) {
+        m_res.assign(n, 0.0);
+        return 0;
+    }
+
+    // the last width outputs were computed with the border coefficients
+    // and every output whose window reached past the old end changes
+    const std::size_t first = (m_res.size() < window) ? 0 : m_res.size() - m_width;
+    m_res.resize(n);
+
+    if (first == 0) {
+        for (std::size_t i = 0; i < m_width; ++i) {
+            double sum = 0.0;
+            for (int j = 0; j < m_borderLen[i]; ++j)
+                sum += m_border[i][j] * v[j - start];
+            m_res[i] = sum;
         }
     }
-    return res;
+
+    const std::size_t last = n - m_width; // first border output at the end
+    for (std::size_t i = std::max(first, m_width); i < last; ++i) {
+        const double *in = v + (i - m_width - start);
+        double sum       = 0.0;
+        for (std::size_t j = 0; j < window; ++j)
+            sum += m_center[j] * in[j];
+        m_res[i] = sum;
+    }
+
+    const std::size_t endidx = n - 1;
+    for (std::size_t i = 0; i < m_width; ++i) {
+        double sum = 0.0;
+        for (int j = 0; j < m_borderLen[i]; ++j)
+            sum += m_border[i][j] * v[endidx - j - start];
+        m_res[endidx - i] = sum;
+    }
+    return first;
 }
 
 // Local Variables:
@@ -14,7 +14,7 @@
 
 // Small, self-contained (Qt-free) linear-algebra and least-squares toolkit.
 // Originally the file-local Savitzky-Golay support inside chartviewer.cpp; it
-// is factored out here so the dense LU solver can be reused for polynomial and
+// is factored out here so the dense solvers can be reused for polynomial and
 // equation-of-state fits and exercised directly by the unit tests.
 
 #include <cstddef>
@@ -27,14 +27,16 @@ using float_vect = std::vector<double>;
 using int_vect = std::vector<int>;
 
 /**
- * @brief Simple dense matrix of doubles backed by a vector of rows
+ * @brief Dense matrix of doubles in one contiguous row-major block
  *
- * Elements are indexed [row][column] with 0-based indices (C style). Because
- * the storage is row-major, iterating over rows is cheaper than over columns.
- * Used as the working type for the LU solver, matrix inverse, and the
- * Savitzky-Golay coefficient generation.
+ * Elements are indexed [row][column] with 0-based indices (C style):
+ * operator[] returns a pointer to the start of a row.  All elements live in
+ * a single allocation, so walking along a row is a unit-stride memory access
+ * that the compiler can vectorize.  Used as the working type for the LU,
+ * Cholesky, and QR solvers, the matrix inverse, and the Savitzky-Golay
+ * coefficient generation.
  */
-class float_mat : public std::vector<float_vect> {
+class float_mat {
 
 public:
     // disable selected default constructors and assignment operators
@@ -60,9 +62,29 @@ public:
     float_mat(const float_vect &v);
 
     /** @brief Number of rows */
-    std::size_t nr_rows() const { return size(); };
-    /** @brief Number of columns (size of the first row) */
-    std::size_t nr_cols() const { return front().size(); };
+    std::size_t nr_rows() const { return m_rows; };
+    /** @brief Number of columns */
+    std::size_t nr_cols() const { return m_cols; };
+
+    /** @brief Pointer to the first element of row @p i */
+    double *operator[](std::size_t i) { return m_data.data() + (i * m_cols); }
+    /** @brief Pointer to the first element of row @p i */
+    const double *operator[](std::size_t i) const { return m_data.data() + (i * m_cols); }
+
+    /** @brief All elements, row after row */
+    double *data() { return m_data.data(); }
+    /** @brief All elements, row after row */
+    const double *data() const { return m_data.data(); }
+
+    /** @brief Set every element to @p value */
+    void fill(double value);
+    /** @brief Exchange the contents of rows @p i and @p j */
+    void swap_rows(std::size_t i, std::size_t j);
+
+private:
+    std::size_t m_rows; ///< number of rows
+    std::size_t m_cols; ///< number of columns
+    float_vect m_data;  ///< elements in row-major order
 };
 
 /**
@@ -80,6 +102,17 @@ float_mat transpose(const float_mat &a);
  */
 float_mat operator*(const float_mat &a, const float_mat &b);
 
+/**
+ * @brief Product of a transposed matrix with a matrix, A^T * B
+ * @param a Left operand, used transposed
+ * @param b Right operand (must have as many rows as @p a)
+ * @return Product matrix with @p a.nr_cols() rows and @p b.nr_cols() columns
+ *
+ * Same result as transpose(a) * b without building the transposed copy;
+ * with b == a this forms the normal-equation matrix of a least-squares fit.
+ */
+float_mat transpose_mult(const float_mat &a, const float_mat &b);
+
 /**
  * @brief Solve the linear system A*X = a via in-place LU decomposition
  * @param A Coefficient matrix
@@ -90,6 +123,29 @@ float_mat operator*(const float_mat &a, const float_mat &b);
  */
 float_mat lin_solve(const float_mat &A, const float_mat &a);
 
+/**
+ * @brief Solve a symmetric positive definite system A*X = a via Cholesky decomposition
+ * @param A Symmetric positive definite coefficient matrix (only the lower triangle is read)
+ * @param a Right-hand side(s); each column is an independent system
+ * @return Solution matrix X with the same shape as @p a, or all NaN if
+ *         @p A is not positive definite
+ */
+float_mat cholesky_solve(const float_mat &A, const float_mat &a);
+
+/**
+ * @brief Least-squares solution of an overdetermined system via Householder QR
+ * @param A Design matrix with at least as many rows as columns
+ * @param b Right-hand side(s) with as many rows as @p A; each column is an
+ *          independent problem
+ * @return Matrix X with @p A.nr_cols() rows minimizing |A*X - b|, or all NaN
+ *         if @p A does not have full column rank
+ *
+ * Works on @p A directly instead of forming the normal equations A^T A,
+ * whose condition number is the square of that of @p A; this matters for
+ * high-order polynomial fits.
+ */
+float_mat qr_solve(const float_mat &A, const float_mat &b);
+
 /**
  * @brief Invert a square matrix using LU decomposition
  * @param A Square matrix to invert
@@ -109,6 +165,66 @@ float_mat invert(const float_mat &A);
  */
 float_vect sg_smooth(const float_vect &v, std::size_t width, int deg);
 
+/**
+ * @brief Savitzky-Golay filter for a growing data series
+ *
+ * Produces the same output as sg_smooth(), but computes the filter
+ * coefficients for its (width, degree) pair only once, at construction, and
+ * when samples are appended recomputes only the outputs that change: those
+ * whose window now reaches past the previous end of the data, and the
+ * border outputs at the new end.  The cost of an update is thus
+ * O(width) per appended sample instead of O(N * width) for the whole series.
+ */
+class SGSmoother {
+public:
+    /**
+     * @brief Constructor -- computes the filter coefficients
+     * @param width Half-window size; the filter window spans 2*width+1 points
+     * @param deg   Polynomial degree fitted in each window (0 = moving average)
+     */
+    SGSmoother(std::size_t width, int deg);
+
+    /** @brief Half-window size */
+    std::size_t width() const { return m_width; }
+    /** @brief Polynomial degree */
+    int degree() const { return m_deg; }
+
+    /**
+     * @brief Smooth a series that has grown since the previous call
+     * @param v     Input samples from index @p start on; the first values
+     *              smoothed by the previous call must be unchanged
+     * @param n     Number of samples of the whole series
+     * @param start Index of the sample at @p v[0]; at most inputStart(n)
+     * @return Index of the first smoothed value that changed
+     *
+     * Fewer samples than in the previous call start over.  As with
+     * sg_smooth(), a series shorter than the filter window smooths to zeros.
+     */
+    std::size_t update(const double *v, std::size_t n, std::size_t start = 0);
+
+    /**
+     * @brief First sample that the next update() of a series reads
+     * @param n Number of samples that will be passed to update()
+     * @return Index of the first input sample needed; samples before it
+     *         need not be passed, e.g. when they are costly to decode
+     */
+    std::size_t inputStart(std::size_t n) const;
+
+    /** @brief Forget all samples, keeping the coefficients */
+    void reset();
+
+    /** @brief Smoothed values of the samples passed to the last update() */
+    const float_vect &values() const { return m_res; }
+
+private:
+    std::size_t m_width;  ///< half-window size
+    int m_deg;            ///< polynomial degree
+    float_vect m_center;  ///< coefficients for a window centered on the output
+    float_mat m_border;   ///< coefficients for the i-th output from either end
+    int_vect m_borderLen; ///< number of samples used by each border output
+    float_vect m_res;     ///< smoothed values
+};
+
 #endif
 
 // Local Variables:
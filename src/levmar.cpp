@@ -14,11 +14,18 @@
 #include "leastsquares.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <functional>
+#include <thread>
 #include <utility>
 
 namespace {
 
+// rows per block of levmarFitParallel(); fixed, so that the sums do not depend
+// on the number of threads
+constexpr int ROW_BLOCK = 1024;
+
 // sum of squared residuals (the cost being minimized)
 double sum_squares(const std::vector<double> &r)
 {
@@ -28,14 +35,21 @@ double sum_squares(const std::vector<double> &r)
     return s;
 }
 
-} // namespace
+// normal equations J^T J delta = -J^T r and the cost r^T r at one parameter vector
+struct NormalEquations {
+    explicit NormalEquations(int n) : JtJ(n * n, 0.0), Jtr(n, 0.0) {}
+    std::vector<double> JtJ; ///< n x n, row-major
+    std::vector<double> Jtr; ///< n
+    double cost = 0.0;       ///< sum of squared residuals
+};
 
-LevmarResult levmarFit(int numResiduals, int numParams, const std::vector<double> &initial,
-                       const LevmarModel &model, int maxIterations, double tolerance)
-{
-    const int m = numResiduals;
-    const int n = numParams;
+// fills the normal equations at a parameter vector; false if the model failed
+using Assemble = std::function<bool(const std::vector<double> &params, NormalEquations &eq)>;
 
+// the Levenberg-Marquardt iteration, independent of how the normal equations are built
+LevmarResult solve(int m, int n, const std::vector<double> &initial, const Assemble &assemble,
+                   int maxIterations, double tolerance)
+{
     LevmarResult res;
     if (n <= 0 || m < n || static_cast<int>(initial.size()) != n) {
         res.message = "invalid problem dimensions";
@@ -43,14 +57,11 @@ LevmarResult levmarFit(int numResiduals, int numParams, const std::vector<double
     }
 
     std::vector<double> params = initial;
-    std::vector<double> r(m, 0.0);
-    std::vector<std::vector<double>> jac(m, std::vector<double>(n, 0.0));
-
-    if (!model(params, r, jac)) {
+    NormalEquations eq(n);
+    if (!assemble(params, eq)) {
         res.message = "initial model evaluation failed";
         return res;
     }
-    double cost = sum_squares(r);
 
     double lambda                = 1.0e-3;
     constexpr double LAMBDA_UP   = 10.0;
@@ -62,23 +73,8 @@ LevmarResult levmarFit(int numResiduals, int numParams, const std::vector<double
 
     int iter       = 0;
     bool converged = false;
+    NormalEquations trialEq(n);
     for (; iter < maxIterations; ++iter) {
-        // normal-equation building blocks: JtJ (n x n) and Jtr (n)
-        float_mat JtJ(n, n, 0.0);
-        std::vector<double> Jtr(n, 0.0);
-        for (int j = 0; j < n; ++j) {
-            for (int k = 0; k < n; ++k) {
-                double s = 0.0;
-                for (int i = 0; i < m; ++i)
-                    s += jac[i][j] * jac[i][k];
-                JtJ[j][k] = s;
-            }
-            double s = 0.0;
-            for (int i = 0; i < m; ++i)
-                s += jac[i][j] * r[i];
-            Jtr[j] = s;
-        }
-
         bool accepted = false;
         for (int tries = 0; tries < 30 && lambda <= LAMBDA_MAX; ++tries) {
             // damped system (JtJ + lambda*diag(JtJ)) delta = -Jtr
@@ -86,11 +82,11 @@ LevmarResult levmarFit(int numResiduals, int numParams, const std::vector<double
             float_mat b(n, 1, 0.0);
             for (int j = 0; j < n; ++j) {
                 for (int k = 0; k < n; ++k)
-                    A[j][k] = JtJ[j][k];
-                A[j][j] += lambda * std::max(JtJ[j][j], DIAG_FLOOR);
-                b[j][0] = -Jtr[j];
+                    A[j][k] = eq.JtJ[(j * n) + k];
+                A[j][j] += lambda * std::max(eq.JtJ[(j * n) + j], DIAG_FLOOR);
+                b[j][0] = -eq.Jtr[j];
             }
-            const float_mat delta = lin_solve(A, b);
+            const float_mat delta = cholesky_solve(A, b); // A is symmetric positive definite
 
             // a singular/ill-conditioned solve can yield non-finite steps; treat
             // those like a rejected step and increase the damping
@@ -101,23 +97,14 @@ LevmarResult levmarFit(int numResiduals, int numParams, const std::vector<double
                 if (!std::isfinite(delta[j][0])) finite = false;
             }
 
-            if (finite) {
-                std::vector<double> rtrial(m, 0.0);
-                std::vector<std::vector<double>> jtrial(m, std::vector<double>(n, 0.0));
-                if (model(trial, rtrial, jtrial)) {
-                    const double trialCost = sum_squares(rtrial);
-                    if (trialCost < cost) {
-                        const double rel = (cost - trialCost) / (cost > 0.0 ? cost : 1.0);
-                        params           = std::move(trial);
-                        r                = std::move(rtrial);
-                        jac              = std::move(jtrial);
-                        cost             = trialCost;
-                        lambda *= LAMBDA_DOWN;
-                        accepted = true;
-                        if (rel < tolerance) converged = true;
-                        break;
-                    }
-                }
+            if (finite && assemble(trial, trialEq) && (trialEq.cost < eq.cost)) {
+                const double rel = (eq.cost - trialEq.cost) / (eq.cost > 0.0 ? eq.cost : 1.0);
+                params           = std::move(trial);
+                std::swap(eq, trialEq);
+                lambda *= LAMBDA_DOWN;
+                accepted = true;
+                if (rel < tolerance) converged = true;
+                break;
             }
             lambda *= LAMBDA_UP;
         }
@@ -134,12 +121,112 @@ LevmarResult levmarFit(int numResiduals, int numParams, const std::vector<double
     if (iter >= maxIterations) res.message = "reached maximum iterations";
 
     res.params     = std::move(params);
-    res.rms        = std::sqrt(cost / static_cast<double>(m));
+    res.rms        = std::sqrt(eq.cost / static_cast<double>(m));
     res.iterations = iter;
     res.ok         = true;
     return res;
 }
 
+} // namespace
+
+LevmarResult levmarFit(int numResiduals, int numParams, const std::vector<double> &initial,
+                       const LevmarModel &model, int maxIterations, double tolerance)
+{
+    const int m = std::max(numResiduals, 0);
+    const int n = std::max(numParams, 0);
+
+    std::vector<double> r(m, 0.0);
+    std::vector<std::vector<double>> jac(m, std::vector<double>(n, 0.0));
+    const Assemble assemble = [&](const std::vector<double> &params, NormalEquations &eq) {
+        if (!model(params, r, jac)) return false;
+        for (int j = 0; j < n; ++j) {
+            for (int k = j; k < n; ++k) {
+                double s = 0.0;
+                for (int i = 0; i < m; ++i)
+                    s += jac[i][j] * jac[i][k];
+                eq.JtJ[(j * n) + k] = s;
+                eq.JtJ[(k * n) + j] = s;
+            }
+            double s = 0.0;
+            for (int i = 0; i < m; ++i)
+                s += jac[i][j] * r[i];
+            eq.Jtr[j] = s;
+        }
+        eq.cost = sum_squares(r);
+        return true;
+    };
+    return solve(numResiduals, numParams, initial, assemble, maxIterations, tolerance);
+}
+
+LevmarResult levmarFitParallel(int numResiduals, int numParams, const std::vector<double> &initial,
+                               const LevmarRowModel &model, int numThreads, int maxIterations,
+                               double tolerance)
+{
+    const int m       = std::max(numResiduals, 0);
+    const int n       = std::max(numParams, 0);
+    const int nblocks = (m + ROW_BLOCK - 1) / ROW_BLOCK;
+    if (numThreads <= 0) numThreads = static_cast<int>(std::thread::hardware_concurrency());
+    numThreads = std::max(1, std::min(numThreads, nblocks));
+
+    // per block: the upper triangle of J^T J, J^T r, and r^T r
+    const std::size_t stride = (static_cast<std::size_t>(n) * n) + n + 1;
+    std::vector<double> sums(stride * nblocks);
+
+    const Assemble assemble = [&](const std::vector<double> &params, NormalEquations &eq) {
+        std::atomic<int> next{0};
+        std::atomic<bool> failed{false};
+        auto work = [&]() {
+            std::vector<double> r(ROW_BLOCK);
+            std::vector<double> jac(static_cast<std::size_t>(ROW_BLOCK) * n);
+            for (int b = next++; (b < nblocks) && !failed; b = next++) {
+                const int first = b * ROW_BLOCK;
+                const int count = std::min(ROW_BLOCK, m - first);
+                if (!model(params, first, count, r.data(), jac.data())) {
+                    failed = true;
+                    return;
+                }
+                double *JtJ = sums.data() + (stride * b);
+                double *Jtr = JtJ + (n * n);
+                std::fill(JtJ, JtJ + stride, 0.0);
+                for (int i = 0; i < count; ++i) {
+                    const double *row = jac.data() + (static_cast<std::size_t>(i) * n);
+                    for (int j = 0; j < n; ++j) {
+                        for (int k = j; k < n; ++k)
+                            JtJ[(j * n) + k] += row[j] * row[k];
+                        Jtr[j] += row[j] * r[i];
+                    }
+                    Jtr[n] += r[i] * r[i];
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        for (int t = 1; t < numThreads; ++t)
+            threads.emplace_back(work);
+        work();
+        for (auto &t : threads)
+            t.join();
+        if (failed) return false;
+
+        // add the blocks in order, whichever thread computed them
+        std::vector<double> total(stride, 0.0);
+        for (int b = 0; b < nblocks; ++b) {
+            const double *sum = sums.data() + (stride * b);
+            for (std::size_t i = 0; i < stride; ++i)
+                total[i] += sum[i];
+        }
+        for (int j = 0; j < n; ++j) {
+            for (int k = j; k < n; ++k) {
+                eq.JtJ[(j * n) + k] = total[(j * n) + k];
+                eq.JtJ[(k * n) + j] = total[(j * n) + k];
+            }
+            eq.Jtr[j] = total[(n * n) + j];
+        }
+        eq.cost = total[(n * n) + n];
+        return true;
+    };
+    return solve(numResiduals, numParams, initial, assemble, maxIterations, tolerance);
+}
+
 // Local Variables:
 // c-basic-offset: 4
 // End:
@@ -17,7 +17,8 @@
 // and the (analytic) Jacobian, so the core is independent of how the model is
 // expressed; the chart post-processing dialog drives it with LeptonMini
 // expressions and their symbolic derivatives. The damped normal equations are
-// solved with the shared leastsquares LU solver.
+// solved with the shared leastsquares Cholesky solver. For large fits the
+// normal equations can be assembled in parallel from blocks of data points.
 
 #include <functional>
 #include <string>
@@ -47,6 +48,18 @@ using LevmarModel =
     std::function<bool(const std::vector<double> &params, std::vector<double> &residuals,
                        std::vector<std::vector<double>> &jacobian)>;
 
+/**
+ * @brief Callback evaluating the residuals and Jacobian rows of a range of data points
+ *
+ * Like LevmarModel, but only for the @p count data points starting at
+ * @p first: it must fill @p residuals with @p count values and @p jacobian
+ * with @p count rows of n values, row after row. It is called from several
+ * threads at once for different ranges, so it must not modify shared state
+ * or throw. Returning false signals an evaluation failure as for LevmarModel.
+ */
+using LevmarRowModel = std::function<bool(const std::vector<double> &params, int first, int count,
+                                          double *residuals, double *jacobian)>;
+
 /**
  * @brief Levenberg-Marquardt nonlinear least-squares minimization
  * @param numResiduals  Number of data points m (must be >= numParams)
@@ -62,6 +75,28 @@ LevmarResult levmarFit(int numResiduals, int numParams, const std::vector<double
                        const LevmarModel &model, int maxIterations = 200,
                        double tolerance = 1.0e-12);
 
+/**
+ * @brief Levenberg-Marquardt minimization with the normal equations built in parallel
+ *
+ * The data points are split into blocks of a fixed number of rows. The
+ * threads evaluate the blocks and reduce each one to its sums of J^T J,
+ * J^T r, and r^T r, which are then added in block order, so the result does
+ * not depend on the number of threads. The Jacobian is never stored as a
+ * whole.
+ *
+ * @param numResiduals  Number of data points m (must be >= numParams)
+ * @param numParams     Number of free parameters n (> 0)
+ * @param initial       Initial parameter guess (length numParams)
+ * @param model         Thread-safe residual/Jacobian callback for a range of rows
+ * @param numThreads    Number of threads; 0 uses one per core
+ * @param maxIterations Maximum number of outer iterations
+ * @param tolerance     Relative cost-change convergence threshold
+ * @return Fit result as for levmarFit()
+ */
+LevmarResult levmarFitParallel(int numResiduals, int numParams, const std::vector<double> &initial,
+                               const LevmarRowModel &model, int numThreads = 0,
+                               int maxIterations = 200, double tolerance = 1.0e-12);
+
 #endif
 
 // Local Variables:
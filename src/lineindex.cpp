@@ -0,0 +1,168 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "lineindex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <string>
+
+namespace {
+
+// bytes scanned between publishing new lines and checking for cancel()
+constexpr std::size_t SCAN_BLOCK = 4 * 1024 * 1024;
+
+// bytes searched between checks of the stop flag
+constexpr std::size_t SEARCH_BLOCK = 16 * 1024 * 1024;
+
+char lower(char c)
+{
+    return ((c >= 'A') && (c <= 'Z')) ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+} // namespace
+
+/* -------------------------------------------------------------------- */
+
+void LineIndex::build()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        checkpoints.assign(1, 0);
+    }
+    count = 0;
+    done  = false;
+
+    // the new lines of each block are published at once, to keep locking rare
+    std::size_t lines = 0;
+    std::vector<std::size_t> found;
+    const char *base = text.data();
+    for (std::size_t pos = 0; (pos < text.size()) && !stopped;) {
+        const std::size_t end = std::min(text.size(), pos + SCAN_BLOCK);
+        while (pos < end) {
+            const void *nl = std::memchr(base + pos, '\n', end - pos);
+            if (!nl) break;
+            pos = static_cast<std::size_t>(static_cast<const char *>(nl) - base) + 1;
+            ++lines;
+            if ((lines % STRIDE) == 0) found.push_back(pos);
+        }
+        pos = end;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            checkpoints.insert(checkpoints.end(), found.begin(), found.end());
+        }
+        found.clear();
+        count = lines;
+    }
+    if (stopped) return;
+
+    // a last line without a newline
+    if (!text.empty() && (text.back() != '\n')) count = lines + 1;
+    done = true;
+}
+
+/* -------------------------------------------------------------------- */
+
+std::size_t LineIndex::nextLine(std::size_t pos) const
+{
+    const std::size_t nl = text.find('\n', pos);
+    return (nl == std::string_view::npos) ? text.size() : nl + 1;
+}
+
+/* -------------------------------------------------------------------- */
+
+std::size_t LineIndex::lineStart(std::size_t n) const
+{
+    if (n >= count) return text.size();
+    std::size_t pos = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pos = checkpoints[n / STRIDE];
+    }
+    for (std::size_t i = n % STRIDE; i > 0; --i)
+        pos = nextLine(pos);
+    return pos;
+}
+
+/* -------------------------------------------------------------------- */
+
+std::string_view LineIndex::line(std::size_t n) const
+{
+    if (n >= count) return {};
+    const std::size_t start = lineStart(n);
+    std::size_t end         = text.find('\n', start);
+    if (end == std::string_view::npos) end = text.size();
+    if ((end > start) && (text[end - 1] == '\r')) --end;
+    return text.substr(start, end - start);
+}
+
+/* -------------------------------------------------------------------- */
+
+std::size_t LineIndex::lineAt(std::size_t offset) const
+{
+    const std::size_t lines = count;
+    std::size_t n           = 0;
+    std::size_t pos         = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // the last checkpoint at or before the offset, among the indexed lines
+        const std::size_t usable = std::min(checkpoints.size(), (lines / STRIDE) + 1);
+        const auto begin         = checkpoints.begin();
+        const auto it            = std::upper_bound(begin, begin + usable, offset);
+        if (it == begin) return lines;
+        n   = static_cast<std::size_t>(it - begin - 1) * STRIDE;
+        pos = *(it - 1);
+    }
+    while (n < lines) {
+        const std::size_t next = nextLine(pos);
+        if ((offset < next) || (next >= text.size())) return n;
+        pos = next;
+        ++n;
+    }
+    return lines;
+}
+
+/* -------------------------------------------------------------------- */
+
+std::size_t LineIndex::find(std::string_view needle, std::size_t from, bool caseSensitive,
+                            const std::atomic<bool> *stop) const
+{
+    if (needle.empty() || (from >= text.size())) return npos;
+
+    // without case, the needle is lowered once and compared to the lowered text
+    std::string lowered;
+    if (!caseSensitive) {
+        lowered.assign(needle);
+        std::transform(lowered.begin(), lowered.end(), lowered.begin(), lower);
+        needle = lowered;
+    }
+    const std::boyer_moore_horspool_searcher<const char *> exact(needle.data(),
+                                                                 needle.data() + needle.size());
+    auto isMatch = [](char a, char b) { return lower(a) == b; };
+
+    // the text is searched in blocks that overlap by the length of the needle
+    for (std::size_t pos = from; pos < text.size(); pos += SEARCH_BLOCK) {
+        if (stop && *stop) return npos;
+        const std::size_t end = std::min(text.size(), pos + SEARCH_BLOCK + needle.size() - 1);
+        const char *first     = text.data() + pos;
+        const char *last      = text.data() + end;
+        const char *it        = caseSensitive
+                   ? std::search(first, last, exact)
+                   : std::search(first, last, needle.begin(), needle.end(), isMatch);
+        if (it != last) return static_cast<std::size_t>(it - text.data());
+    }
+    return npos;
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
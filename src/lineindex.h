@@ -0,0 +1,118 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LINEINDEX_H
+#define LINEINDEX_H
+
+// Small, self-contained (Qt-free) index of the lines of a large text, e.g. a
+// memory-mapped file, for viewers that show only a window of lines at a time.
+// Instead of the offset of every line, only the offset of every STRIDE-th line
+// is stored, and a line in between is found by skipping the few newlines
+// after its checkpoint.  That keeps the index small (8 bytes per STRIDE
+// lines) while any line is found in constant time.  The index is built in one
+// pass, usually on a background thread, and can be used while it grows.
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Sparse index of the line starts of a text
+ *
+ * build() may run on one thread while the other functions are called from
+ * another; lines are available as soon as they were indexed.  A line ends at
+ * a newline ("\n", with a preceding "\r" removed); a last line without a
+ * newline is added when build() reaches the end of the text.
+ */
+class LineIndex {
+public:
+    /// Number of lines per stored line offset
+    static constexpr std::size_t STRIDE = 128;
+
+    /**
+     * @brief Constructor
+     * @param _text Text to index; must stay valid for the lifetime of the index
+     */
+    explicit LineIndex(std::string_view _text) : text(_text) {}
+
+    /**
+     * @brief Index the lines of the text
+     *
+     * Returns when the whole text is indexed or after cancel() was called.
+     */
+    void build();
+
+    /** @brief Make a running build() return early */
+    void cancel() { stopped = true; }
+
+    /** @brief Whether build() has indexed the whole text */
+    bool finished() const { return done; }
+
+    /** @brief Number of lines indexed so far */
+    std::size_t lineCount() const { return count; }
+
+    /** @brief Size of the text in bytes */
+    std::size_t size() const { return text.size(); }
+
+    /**
+     * @brief Text of a line
+     * @param n 0-based line number, less than lineCount()
+     * @return Bytes of the line without the line end (empty if @p n is out of range)
+     */
+    std::string_view line(std::size_t n) const;
+
+    /**
+     * @brief Byte offset of the start of a line
+     * @param n 0-based line number, less than lineCount()
+     * @return Offset of the first byte of the line (size() if @p n is out of range)
+     */
+    std::size_t lineStart(std::size_t n) const;
+
+    /**
+     * @brief Line containing a byte
+     * @param offset Byte offset in the text
+     * @return 0-based line number; lineCount() if the line is not indexed yet
+     */
+    std::size_t lineAt(std::size_t offset) const;
+
+    /**
+     * @brief Find the next occurrence of a string
+     * @param needle        Bytes to find (UTF-8); must not be empty
+     * @param from          Offset at which the search starts
+     * @param caseSensitive false to compare ASCII letters ignoring case
+     * @param stop          Optional flag that ends the search early when set
+     * @return Offset of the first occurrence at or after @p from; npos if there is none
+     */
+    std::size_t find(std::string_view needle, std::size_t from, bool caseSensitive,
+                     const std::atomic<bool> *stop = nullptr) const;
+
+    /// Returned by find() if there is no match
+    static constexpr std::size_t npos = std::string_view::npos;
+
+private:
+    // offset of the start of the line after the one starting at pos
+    std::size_t nextLine(std::size_t pos) const;
+
+    std::string_view text;                ///< Indexed text
+    mutable std::mutex mutex;             ///< Guards checkpoints while build() appends to it
+    std::vector<std::size_t> checkpoints; ///< Offset of line 0, STRIDE, 2*STRIDE, ...
+    std::atomic<std::size_t> count{0};    ///< Number of indexed lines
+    std::atomic<bool> done{false};        ///< build() reached the end of the text
+    std::atomic<bool> stopped{false};     ///< cancel() was called
+};
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -9,11 +9,13 @@
 // This software is distributed under the GNU General Public License version 2 or later.
 ////////////////////////////////////////////////////////////////////////////////////////
 
+#include "chartbatch.h"
 #include "chartviewer.h"
 #include "constants.h"
 #include "fileviewer.h"
 #include "helpers.h"
 #include "lammpsgui.h"
+#include "plotcache.h"
 #include "plotdata.h"
 #include "plotdatadialog.h"
 #include "slideshow.h"
@@ -21,6 +23,7 @@
 #include <QApplication>
 #include <QCommandLineOption>
 #include <QCommandLineParser>
+#include <QDir>
 #include <QFileInfo>
 #include <QFont>
 #include <QIcon>
@@ -31,6 +34,9 @@
 #include <QStyleFactory>
 #include <QtGlobal>
 
+#include <cstdio>
+#include <cstring>
+
 #if defined(Q_OS_WIN32)
 #include <cstdio>
 #include <io.h>
@@ -77,6 +83,16 @@ int main(int argc, char *argv[])
     // disable processor affinity for threads by default
     qputenv("OMP_PROC_BIND", "false");
 
+    // batch rendering never shows a window: unless a platform plugin was chosen
+    // explicitly, use the offscreen one so it also runs without a display
+    for (int i = 1; i < argc; ++i) {
+        if ((std::strcmp(argv[i], "-b") == 0) || (std::strcmp(argv[i], "--batch") == 0)) {
+            if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+                qputenv("QT_QPA_PLATFORM", "offscreen");
+            break;
+        }
+    }
+
     QApplication app(argc, argv);
     QCoreApplication::setOrganizationName("The LAMMPS Developers");
     QCoreApplication::setOrganizationDomain("lammps.org");
@@ -108,9 +124,21 @@ int main(int argc, char *argv[])
          {{"y", "height"}, "Override LAMMPS-GUI editor window height", "height"},
          {{"s", "style"}, "Set LAMMPS-GUI's visual style (default: Fusion)", "style", "Fusion"},
          {{"c", "chart"}, "Open FILE directly in the chart/plot viewer", "file"},
+         {{"f", "follow"}, "With -c: follow FILE and plot the data appended to it"},
          {{"i", "image"}, "Open FILE in the snapshot viewer (may be given multiple times)", "file"},
-         {{"t", "text"}, "Open FILE in the text file viewer", "file"}});
-    parser.addPositionalArgument("file", "The LAMMPS input file to open (optional).");
+         {{"t", "text"}, "Open FILE in the text file viewer", "file"},
+         {{"b", "batch"}, "Render the data files given as arguments to images without a window"},
+         {"xcol", "Batch mode: x column name or 1-based index (default: first)", "column"},
+         {"ycols", "Batch mode: comma-separated y columns (default: all others)", "columns"},
+         {"format", "Batch mode: image format, png or svg", "format", "png"},
+         {"outdir", "Batch mode: output folder (default: next to each data file)", "dir"},
+         {"size", "Batch mode: image size in pixels", "WxH", "800x600"},
+         {"smooth", "Batch mode: Savitzky-Golay smoothing window and order", "window[,order]"},
+         {"plot", "Batch mode with smoothing: smooth or both", "data", "both"},
+         {"draw", "Batch mode: lines, points, or both", "mode", "lines"},
+         {"jobs", "Batch mode: number of parallel jobs (default: all cores)", "n"}});
+    parser.addPositionalArgument("file", "The LAMMPS input file to open (optional), or the data "
+                                         "files or patterns to render in batch mode.");
     parser.process(app);
 
 #if defined(LAMMPS_GUI_USE_PLUGIN)
@@ -127,6 +155,10 @@ int main(int argc, char *argv[])
     }
 #endif
 
+    // parsed plot data files are cached for all modes that load them
+    PlotCache::setLimit(
+        QSettings().value(Keys::PLOTCACHE, Cfg::PLOT_CACHE_DEFAULT).toLongLong() * 1024 * 1024);
+
     int width  = parser.value("width").toInt();
     int height = parser.value("height").toInt();
 
@@ -155,11 +187,65 @@ int main(int argc, char *argv[])
     QIcon::setThemeSearchPaths(QStringList() << ":/icons");
     QIcon::setThemeName("lammpsgui");
 
+    // -b/--batch: render data files to image files without any window
+    if (parser.isSet("batch")) {
+        auto fail = [](const QString &msg) {
+            std::fprintf(stderr, "ERROR: %s\n", msg.toLocal8Bit().constData());
+            return 1;
+        };
+        ChartBatchOptions opts;
+        opts.files = expandFileArguments(parser.positionalArguments());
+        if (opts.files.isEmpty()) return fail("No data files given for batch rendering");
+        opts.xcol   = parser.value("xcol");
+        opts.ycols  = parser.value("ycols").split(',', Qt::SkipEmptyParts);
+        opts.format = parser.value("format").toLower();
+        if ((opts.format != "png") && (opts.format != "svg"))
+            return fail("Unsupported batch image format: " + opts.format);
+        opts.outdir = parser.value("outdir");
+        if (!opts.outdir.isEmpty() && !QDir().mkpath(opts.outdir))
+            return fail("Cannot create output folder: " + opts.outdir);
+        const QStringList size = parser.value("size").split('x');
+        if (size.size() == 2) {
+            opts.width  = size[0].toInt();
+            opts.height = size[1].toInt();
+        }
+        if ((opts.width < Cfg::MINIMUM_WIDTH) || (opts.height < Cfg::MINIMUM_HEIGHT))
+            return fail(QString("Image size must be at least %1x%2")
+                            .arg(Cfg::MINIMUM_WIDTH)
+                            .arg(Cfg::MINIMUM_HEIGHT));
+        if (parser.isSet("smooth")) {
+            const QStringList sg = parser.value("smooth").split(',');
+            opts.smoothWindow    = sg[0].toInt();
+            if (sg.size() > 1) opts.smoothOrder = sg[1].toInt();
+            if ((opts.smoothWindow < Cfg::SMOOTH_WINDOW_MIN) ||
+                (opts.smoothWindow > Cfg::SMOOTH_WINDOW_MAX) ||
+                (opts.smoothOrder < Cfg::SMOOTH_ORDER_MIN) ||
+                (opts.smoothOrder > Cfg::SMOOTH_ORDER_MAX))
+                return fail(QString("Smoothing window must be %1 to %2 and order %3 to %4")
+                                .arg(Cfg::SMOOTH_WINDOW_MIN)
+                                .arg(Cfg::SMOOTH_WINDOW_MAX)
+                                .arg(Cfg::SMOOTH_ORDER_MIN)
+                                .arg(Cfg::SMOOTH_ORDER_MAX));
+        }
+        opts.showRaw       = (parser.value("plot") != "smooth");
+        const QString draw = parser.value("draw");
+        if (draw == "points")
+            opts.mode = ChartDisplayMode::Points;
+        else if (draw == "both")
+            opts.mode = ChartDisplayMode::LinesAndPoints;
+        opts.jobs = parser.value("jobs").toInt();
+        chartDefaultColors(opts.rawColor, opts.smoothColor);
+        return (runChartBatch(opts) > 0) ? 1 : 0;
+    }
+
     // -c/--chart: open a data file directly in a standalone chart window
     if (parser.isSet("chart")) {
         const QString fileName = parser.value("chart");
+        // following continues after the bytes present before loading
+        const qint64 offset = QFileInfo(fileName).size();
+        PlotFormat format   = PlotFormat::Whitespace;
         QString error;
-        PlotData data = loadPlotData(fileName, &error);
+        PlotData data = loadPlotData(fileName, &error, &format);
         if (data.isEmpty()) {
             critical(nullptr, "Plot Data File",
                      "Could not read data from file:", error.isEmpty() ? fileName : error);
@@ -177,6 +263,8 @@ int main(int argc, char *argv[])
         win->setWindowIcon(QIcon(Cfg::MAIN_ICON));
         win->setMinimumSize(Cfg::MINIMUM_WIDTH, Cfg::MINIMUM_HEIGHT);
         win->loadData(plotData, xcol, ycols);
+        win->setFollowSource(format, data.columnCount(), offset);
+        if (parser.isSet("follow")) win->setFollow(true);
         win->show();
         return app.exec();
     }
@@ -226,7 +314,7 @@ int main(int argc, char *argv[])
                      "\"" + QFileInfo(fileName).fileName() + "\" appears to be a binary file.");
             return 1;
         }
-        auto *viewer = new FileViewer(fileName, nullptr);
+        auto *viewer = createFileViewer(fileName, nullptr);
         viewer->setAttribute(Qt::WA_DeleteOnClose);
         viewer->show();
         return app.exec();
@@ -0,0 +1,201 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "packedcolumn.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// largest magnitude up to which a double holds every integer exactly (2^53)
+constexpr double MAX_EXACT = 9007199254740992.0;
+
+// largest offset from the base of a Delta block
+constexpr double MAX_OFFSET = std::numeric_limits<std::int32_t>::max();
+
+// out-of-range values become infinite instead of undefined
+float toFloat(double value)
+{
+    constexpr double FLOAT_MAX = std::numeric_limits<float>::max();
+    if (value > FLOAT_MAX) return std::numeric_limits<float>::infinity();
+    if (value < -FLOAT_MAX) return -std::numeric_limits<float>::infinity();
+    return static_cast<float>(value);
+}
+
+// whether a Delta column can hold the value
+bool isExactInteger(double value)
+{
+    return (std::fabs(value) <= MAX_EXACT) && (value == std::trunc(value));
+}
+
+} // namespace
+
+/* -------------------------------------------------------------------- */
+
+void PackedColumn::setPacking(ColumnPacking packing)
+{
+    if (packing == mode) return;
+
+    std::vector<double> values(size());
+    decode(0, values.size(), values.data());
+    clear();
+    full.shrink_to_fit();
+    single.shrink_to_fit();
+    blocks.shrink_to_fit();
+    offsets.shrink_to_fit();
+    mode = packing;
+
+    if (mode == ColumnPacking::Double) {
+        full = std::move(values);
+    } else if (mode == ColumnPacking::Float) {
+        single.reserve(values.size());
+        for (double v : values)
+            single.push_back(toFloat(v));
+    } else {
+        for (double v : values) {
+            if (!appendDelta(v)) {
+                clear();
+                mode = ColumnPacking::Double;
+                full = std::move(values);
+                return;
+            }
+        }
+        offsets.shrink_to_fit();
+    }
+}
+
+/* -------------------------------------------------------------------- */
+
+void PackedColumn::decode(std::size_t first, std::size_t n, double *out) const
+{
+    if (mode == ColumnPacking::Double) {
+        std::copy(full.begin() + first, full.begin() + first + n, out);
+    } else if (mode == ColumnPacking::Float) {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = static_cast<double>(single[first + i]);
+    } else {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = at(first + i);
+    }
+}
+
+/* -------------------------------------------------------------------- */
+
+void PackedColumn::append(double value)
+{
+    if (mode == ColumnPacking::Double) {
+        full.push_back(value);
+    } else if (mode == ColumnPacking::Float) {
+        single.push_back(toFloat(value));
+    } else if (!appendDelta(value)) {
+        unpack();
+        full.push_back(value);
+    }
+}
+
+/* -------------------------------------------------------------------- */
+
+void PackedColumn::set(std::size_t i, double value)
+{
+    if (mode == ColumnPacking::Double) {
+        full[i] = value;
+        return;
+    }
+    if (mode == ColumnPacking::Float) {
+        single[i] = toFloat(value);
+        return;
+    }
+
+    // only the offsets of the open block can change in place; the block base and
+    // the closed blocks, which may be uniform, stay as they are
+    const std::size_t k = i % BLOCK;
+    Block &b            = blocks.back();
+    if (((i / BLOCK) == (blocks.size() - 1)) && (k > 0) && isExactInteger(value) &&
+        (std::fabs(value - b.base) <= MAX_OFFSET)) {
+        offsets[b.first + k] = static_cast<std::int32_t>(value - b.base);
+        return;
+    }
+    unpack();
+    full[i] = value;
+}
+
+/* -------------------------------------------------------------------- */
+
+void PackedColumn::clear()
+{
+    full.clear();
+    single.clear();
+    blocks.clear();
+    offsets.clear();
+    count = 0;
+}
+
+/* -------------------------------------------------------------------- */
+
+std::size_t PackedColumn::bytes() const
+{
+    return (full.capacity() * sizeof(double)) + (single.capacity() * sizeof(float)) +
+        (blocks.capacity() * sizeof(Block)) + (offsets.capacity() * sizeof(std::int32_t));
+}
+
+/* -------------------------------------------------------------------- */
+
+// Append to a Delta column; false (and nothing changes) if the value does not fit.
+bool PackedColumn::appendDelta(double value)
+{
+    if (!isExactInteger(value)) return false;
+
+    if ((count % BLOCK) == 0) {
+        if (!blocks.empty()) closeBlock();
+        blocks.push_back({value, 0, offsets.size()});
+        offsets.push_back(0);
+        ++count;
+        return true;
+    }
+
+    const double offset = value - blocks.back().base;
+    if (std::fabs(offset) > MAX_OFFSET) return false;
+    offsets.push_back(static_cast<std::int32_t>(offset));
+    ++count;
+    return true;
+}
+
+// A full block of evenly spaced values keeps only its spacing.  Its offsets
+// are the last ones, so dropping them leaves the other blocks' offsets in place.
+void PackedColumn::closeBlock()
+{
+    Block &b                  = blocks.back();
+    const std::int64_t stride = offsets[b.first + 1];
+    for (std::size_t k = 2; k < BLOCK; ++k)
+        if (offsets[b.first + k] != stride * static_cast<std::int64_t>(k)) return;
+    offsets.resize(b.first);
+    b.stride = stride;
+    b.first  = UNIFORM;
+}
+
+// Switch to Double, e.g. when a value does not fit the Delta encoding.
+void PackedColumn::unpack()
+{
+    std::vector<double> values(size());
+    decode(0, values.size(), values.data());
+    clear();
+    single.shrink_to_fit();
+    blocks.shrink_to_fit();
+    offsets.shrink_to_fit();
+    mode = ColumnPacking::Double;
+    full = std::move(values);
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
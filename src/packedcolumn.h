@@ -0,0 +1,148 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef PACKEDCOLUMN_H
+#define PACKEDCOLUMN_H
+
+// Small, self-contained (Qt-free) storage of one numeric column with an
+// optional compact encoding, so that very long chart series need less memory.
+// Values can be kept in single precision, and integer columns such as time
+// steps as 32-bit offsets from the first value of each block of BLOCK values.
+// A block whose values are evenly spaced, as are the steps of thermo output,
+// shrinks to its first value and the spacing.  Every value can be read in
+// constant time, so readers convert on the fly instead of expanding the column.
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/** @brief Encoding of the values of a PackedColumn */
+enum class ColumnPacking {
+    Double, ///< full (double) precision
+    Float,  ///< single precision, half the size
+    Delta,  ///< integers as offsets within blocks of values; exact
+};
+
+/**
+ * @brief One column of numbers in a selectable encoding
+ *
+ * A Delta column holds only integers that fit into a double exactly and are
+ * spread by less than 2^31 within a block.  Storing any other value
+ * switches the column to Double, so no value is ever changed by the Delta
+ * encoding; packing() reports the encoding in use.
+ */
+class PackedColumn {
+public:
+    /// Number of values per block of a Delta column
+    static constexpr std::size_t BLOCK = 256;
+
+    PackedColumn() = default;
+
+    /**
+     * @brief Column in full precision
+     * @param values Values of the column
+     */
+    explicit PackedColumn(std::vector<double> values) : full(std::move(values)) {}
+
+    /** @brief Encoding of the values */
+    ColumnPacking packing() const { return mode; }
+
+    /**
+     * @brief Convert the column to another encoding
+     * @param packing New encoding; Float loses precision, Delta falls back to
+     *                Double if the values are not suitable
+     */
+    void setPacking(ColumnPacking packing);
+
+    /** @brief Number of values */
+    std::size_t size() const
+    {
+        if (mode == ColumnPacking::Double) return full.size();
+        if (mode == ColumnPacking::Float) return single.size();
+        return count;
+    }
+
+    /** @brief Whether the column has no values */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Value at an index
+     * @param i Index, less than size()
+     * @return The value, converted to double
+     */
+    double at(std::size_t i) const
+    {
+        if (mode == ColumnPacking::Double) return full[i];
+        if (mode == ColumnPacking::Float) return static_cast<double>(single[i]);
+        const Block &b      = blocks[i / BLOCK];
+        const std::size_t k = i % BLOCK;
+        if (b.first == UNIFORM) return b.base + static_cast<double>(b.stride * std::int64_t(k));
+        return b.base + offsets[b.first + k];
+    }
+
+    /**
+     * @brief Values of a column in full precision
+     * @return The values; empty unless packing() is ColumnPacking::Double
+     */
+    const std::vector<double> &values() const { return full; }
+
+    /**
+     * @brief Copy a range of values as doubles
+     * @param first First index
+     * @param n     Number of values; first + n must not exceed size()
+     * @param out   Destination for n values
+     */
+    void decode(std::size_t first, std::size_t n, double *out) const;
+
+    /** @brief Append a value */
+    void append(double value);
+
+    /**
+     * @brief Overwrite a value
+     * @param i     Index, less than size()
+     * @param value New value
+     */
+    void set(std::size_t i, double value);
+
+    /** @brief Remove all values, keeping the encoding */
+    void clear();
+
+    /** @brief Bytes of memory held by the values */
+    std::size_t bytes() const;
+
+private:
+    /// Block of a Delta column: its first value and either a constant spacing
+    /// (first == UNIFORM) or the position of its offsets in `offsets`
+    struct Block {
+        double base;         ///< first value of the block
+        std::int64_t stride; ///< spacing of the values of a uniform block
+        std::size_t first;   ///< index of the block's first offset, or UNIFORM
+    };
+    static constexpr std::size_t UNIFORM = static_cast<std::size_t>(-1);
+
+    bool appendDelta(double value);
+    void closeBlock();
+    void unpack();
+
+    ColumnPacking mode = ColumnPacking::Double; ///< Encoding in use
+    std::vector<double> full;                   ///< Double values
+    std::vector<float> single;                  ///< Float values
+    std::vector<Block> blocks;                  ///< Delta blocks; only the last one is open
+    std::vector<std::int32_t> offsets;          ///< Delta offsets from the base of their block
+    std::size_t count = 0;                      ///< Number of Delta values
+};
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,199 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "plotcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <mutex>
+#include <utility>
+
+namespace PlotCache {
+
+namespace {
+
+// files smaller than this parse in a few milliseconds and are not cached
+constexpr qint64 MIN_SOURCE_SIZE = 1024 * 1024;
+
+// header, strings, and padding of an entry, estimated generously
+constexpr qint64 ENTRY_OVERHEAD = 4096;
+
+const QString ENTRY_PATTERN = QStringLiteral("*.lgpd");
+
+// the configuration and all changes of the cache folder are serialized
+std::mutex cacheMutex;
+qint64 cacheLimit = 0;
+QString cacheDir;
+
+QString currentDirectory()
+{
+    if (!cacheDir.isEmpty()) return cacheDir;
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/plotdata";
+}
+
+// the entry of a file is named by a hash of its absolute path
+QString entryPath(const QString &dir, const QString &path)
+{
+    const QByteArray hash =
+        QCryptographicHash::hash(path.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return dir + '/' + QString::fromLatin1(hash) + ".lgpd";
+}
+
+// Remove the least recently used entries until the total size is within the limit.
+void evict(const QString &dir, qint64 maxBytes)
+{
+    QDir folder(dir);
+    // oldest first: entries are touched when they are used
+    const QFileInfoList entries =
+        folder.entryInfoList({ENTRY_PATTERN}, QDir::Files, QDir::Time | QDir::Reversed);
+    qint64 total = 0;
+    for (const auto &entry : entries)
+        total += entry.size();
+    for (const auto &entry : entries) {
+        if (total <= maxBytes) break;
+        if (QFile::remove(entry.absoluteFilePath())) total -= entry.size();
+    }
+}
+
+} // namespace
+
+/* -------------------------------------------------------------------- */
+
+void setLimit(qint64 bytes)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cacheLimit = qMax<qint64>(bytes, 0);
+}
+
+/* -------------------------------------------------------------------- */
+
+qint64 limit()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return cacheLimit;
+}
+
+/* -------------------------------------------------------------------- */
+
+void setDirectory(const QString &dir)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cacheDir = dir;
+}
+
+/* -------------------------------------------------------------------- */
+
+QString directory()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return currentDirectory();
+}
+
+/* -------------------------------------------------------------------- */
+
+PlotSource describe(const QString &filename)
+{
+    const QFileInfo info(filename);
+    PlotSource source;
+    source.path = info.absoluteFilePath();
+    if (info.isFile()) {
+        source.size  = info.size();
+        source.mtime = info.lastModified().toMSecsSinceEpoch();
+    }
+    return source;
+}
+
+/* -------------------------------------------------------------------- */
+
+bool load(const PlotSource &source, PlotData &data, PlotFormat *format)
+{
+    QString dir;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (cacheLimit <= 0) return false;
+        dir = currentDirectory();
+    }
+    if (source.size < MIN_SOURCE_SIZE) return false;
+
+    QFile entry(entryPath(dir, source.path));
+    if (!entry.open(QIODevice::ReadOnly) || (entry.size() <= 0)) return false;
+    const qint64 size = entry.size();
+    const uchar *mapped = entry.map(0, size);
+    if (!mapped) return false;
+    const char *bytes = reinterpret_cast<const char *>(mapped);
+
+    // the entry must be for this path and this version of the file
+    PlotSource cached;
+    if (!plotBinarySource(bytes, size, &cached) || (cached.path != source.path) ||
+        (cached.size != source.size) || (cached.mtime != source.mtime) ||
+        (cached.format == PlotFormat::Binary))
+        return false;
+    PlotData result = parsePlotBinary(bytes, size);
+    if (result.isEmpty()) return false;
+
+    // mark the entry as recently used
+    entry.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    data = std::move(result);
+    if (format) *format = cached.format;
+    return true;
+}
+
+/* -------------------------------------------------------------------- */
+
+bool store(const PlotSource &source, const PlotData &data)
+{
+    if (data.isEmpty() || (source.size < MIN_SOURCE_SIZE) || (source.format == PlotFormat::Binary))
+        return false;
+    const qint64 bytes = ENTRY_OVERHEAD + (static_cast<qint64>(data.columnCount()) *
+                                           data.rowCount() * static_cast<qint64>(sizeof(double)));
+
+    // make room first, so the new entry is not the one that is removed; only the
+    // settings and the eviction need the lock, not the (slow) write of the entry
+    QString dir;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if ((cacheLimit <= 0) || (bytes > cacheLimit)) return false;
+        dir = currentDirectory();
+        if (!QDir().mkpath(dir)) return false;
+        evict(dir, cacheLimit - bytes);
+    }
+
+    // written to a temporary file and renamed, so readers never see a partial entry
+    QSaveFile out(entryPath(dir, source.path));
+    if (!out.open(QIODevice::WriteOnly)) return false;
+    if (!writePlotBinary(data, out, source)) {
+        out.cancelWriting();
+        return false;
+    }
+    return out.commit();
+}
+
+/* -------------------------------------------------------------------- */
+
+void clear()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    QDir folder(currentDirectory());
+    for (const auto &entry : folder.entryInfoList({ENTRY_PATTERN}, QDir::Files))
+        QFile::remove(entry.absoluteFilePath());
+}
+
+} // namespace PlotCache
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
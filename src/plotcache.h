@@ -0,0 +1,90 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef PLOTCACHE_H
+#define PLOTCACHE_H
+
+// On-disk cache of parsed plot data files.  Reading the numbers of a large
+// text file back in binary form is much faster than parsing the text again,
+// so loadPlotData() stores what it parsed as binary plot data (see
+// writePlotBinary()) and, when the same unchanged file is opened again, maps
+// the cache entry into memory instead of parsing the file.  Entries are keyed
+// by the absolute path of the file and validated against its size and
+// modification time.  When the cache grows beyond its size limit, the least
+// recently used entries are removed.  The cache is disabled until a limit is
+// set; the GUI sets it from the Keys::PLOTCACHE preference.  All functions may
+// be called from any thread.
+
+#include "plotdata.h"
+
+#include <QString>
+
+namespace PlotCache {
+
+/**
+ * @brief Set the size limit of the cache
+ * @param bytes Total size of all entries in bytes; 0 disables the cache
+ *
+ * Entries beyond a smaller limit are removed with the next stored entry.
+ */
+void setLimit(qint64 bytes);
+
+/** @brief Size limit of the cache in bytes (0: disabled) */
+qint64 limit();
+
+/**
+ * @brief Set the folder of the cache entries
+ * @param dir Folder path; empty for the default, a "plotdata" folder in the
+ *            application's cache location
+ */
+void setDirectory(const QString &dir);
+
+/** @brief Folder of the cache entries */
+QString directory();
+
+/**
+ * @brief Describe a data file as a cache key
+ * @param filename Path to the data file
+ * @return Absolute path, size, and modification time of the file (size -1 if
+ *         it does not exist)
+ */
+PlotSource describe(const QString &filename);
+
+/**
+ * @brief Look up the parsed data of a file
+ * @param source Description of the file from describe(), taken before it is read
+ * @param data   Set to the cached data on success
+ * @param format Optional out-parameter set to the format the file was parsed as
+ * @return true if an entry for the unchanged file was found
+ */
+bool load(const PlotSource &source, PlotData &data, PlotFormat *format = nullptr);
+
+/**
+ * @brief Add the parsed data of a file to the cache
+ * @param source Description of the file from describe(), with the format it was parsed as
+ * @param data   Parsed data
+ * @return true if an entry was written
+ *
+ * Small files, which parse quickly anyway, and data larger than the size
+ * limit are not cached.
+ */
+bool store(const PlotSource &source, const PlotData &data);
+
+/** @brief Remove all cache entries */
+void clear();
+
+} // namespace PlotCache
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -11,15 +11,32 @@
 
 #include "plotdata.h"
 
+#include "decompress.h"
+#include "plotcache.h"
+#include "plotparse.h"
+#include "thermoparser.h"
+
+#include <QBuffer>
+#include <QByteArray>
 #include <QFile>
 #include <QFileInfo>
+#include <QIODevice>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
 #include <QJsonValue>
-#include <QRegularExpression>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 void PlotData::setColumnNames(const QStringList &columnNames)
 {
@@ -37,14 +54,22 @@ bool PlotData::appendRow(const std::vector<double> &row)
 {
     if (static_cast<int>(row.size()) != columnCount()) return false;
     for (int c = 0; c < columnCount(); ++c)
-        cols[c].push_back(row[c]);
+        cols[c].append(row[c]);
     return true;
 }
 
 void PlotData::addColumn(const QString &name, std::vector<double> data)
 {
     names << name;
-    cols.push_back(std::move(data));
+    cols.emplace_back(std::move(data));
+}
+
+std::size_t PlotData::memoryUsage() const
+{
+    std::size_t bytes = 0;
+    for (const auto &c : cols)
+        bytes += c.bytes();
+    return bytes;
 }
 
 /* -------------------------------------------------------------------- */
@@ -72,27 +97,6 @@ QString bracketContents(const QString &s)
     return s.mid(a + 1, b - a - 1);
 }
 
-// Heuristic: does the text look like YAML tabular data?  We accept either the
-// LAMMPS thermo format (has a "keywords:" line) or a generic sequence of maps
-// (has a "- {key: value, ...}" line with at least one colon inside the braces).
-bool looksLikeYaml(const QString &text)
-{
-    const QStringList lines = text.split('\n');
-    for (const QString &line : lines) {
-        const QString t = line.trimmed();
-        if (t.startsWith("keywords:")) return true;
-        if (t.startsWith("- {") && t.endsWith('}') && t.contains(':')) return true;
-    }
-    return false;
-}
-
-// Heuristic: does the text start like a JSON document?
-bool looksLikeJson(const QString &text)
-{
-    const QString t = text.trimmed();
-    return t.startsWith('[') || t.startsWith('{');
-}
-
 // Convert a list of string tokens to a numeric row. Returns false (and leaves
 // @p row in an unspecified state) on the first token that is not a number. When
 // @p skipEmpty is true, empty tokens are ignored rather than treated as errors
@@ -126,103 +130,56 @@ QStringList genericColumnNames(int ncol)
 
 /* -------------------------------------------------------------------- */
 
-PlotData parsePlotCsv(const QString &text, QString *error)
+namespace {
+
+// Move the columns of a byte-level parser into a PlotData.
+PlotData fromColumns(PlotParse::Columns &&parsed)
 {
     PlotData out;
-    const QStringList lines = text.split('\n');
-    QStringList names;
-    int ncol        = -1;
-    bool headerDone = false;
-    std::vector<std::vector<double>> rows;
-
-    for (const QString &raw : lines) {
-        const QString line = raw.trimmed();
-        if (line.isEmpty()) continue;
-        QStringList toks = line.split(',');
-        for (QString &t : toks)
-            t = t.trimmed();
-
-        if (!headerDone) {
-            headerDone      = true;
-            bool allNumeric = !toks.isEmpty();
-            for (const QString &t : toks) {
-                bool ok = false;
-                t.toDouble(&ok);
-                if (!ok) {
-                    allNumeric = false;
-                    break;
-                }
-            }
-            if (!allNumeric) {
-                names = toks;
-                ncol  = toks.size();
-                continue; // header consumed
-            }
-            // a fully numeric first line means there is no header
-            ncol  = toks.size();
-            names = genericColumnNames(ncol);
-            // fall through to parse this line as data
-        }
-
-        if (toks.size() != ncol) continue; // skip ragged lines
-        std::vector<double> row;
-        if (tokensToRow(toks, row)) rows.push_back(std::move(row));
+    const int ncol          = static_cast<int>(parsed.columns.size());
+    const QStringList names = genericColumnNames(ncol);
+    for (int c = 0; c < ncol; ++c) {
+        const QString name = parsed.names.empty() ? names[c]
+                                                  : QString::fromStdString(parsed.names[c]);
+        out.addColumn(name, std::move(parsed.columns[c]));
     }
-
-    if ((ncol <= 0) || rows.empty()) {
-        if (error) *error = QStringLiteral("no CSV data found");
-        return out;
-    }
-    out.setColumnNames(names);
-    for (auto &r : rows)
-        out.appendRow(r);
     return out;
 }
 
-/* -------------------------------------------------------------------- */
+} // namespace
 
-PlotData parsePlotWhitespace(const QString &text, QString *error)
+PlotData parsePlotCsv(const char *data, qsizetype size, QString *error, int threads)
 {
-    PlotData out;
-    const QStringList lines = text.split('\n');
-    static const QRegularExpression ws("\\s+");
-    QString lastComment;
-    QStringList names;
-    int ncol = -1;
-    std::vector<std::vector<double>> rows;
-
-    for (const QString &raw : lines) {
-        const QString line = raw.trimmed();
-        if (line.isEmpty()) continue;
-        if (line.startsWith('#')) {
-            lastComment = line.mid(1).trimmed();
-            continue;
-        }
+    PlotParse::Columns parsed;
+    if (!PlotParse::parseCsv({data, static_cast<std::size_t>(size)}, parsed, threads)) {
+        if (error) *error = QStringLiteral("no CSV data found");
+        return {};
+    }
+    return fromColumns(std::move(parsed));
+}
 
-        const QStringList toks = line.split(ws, Qt::SkipEmptyParts);
-        std::vector<double> row;
-        if (!tokensToRow(toks, row)) continue; // skip non-numeric lines (e.g. text headers)
+PlotData parsePlotCsv(const QString &text, QString *error)
+{
+    const QByteArray bytes = text.toUtf8();
+    return parsePlotCsv(bytes.constData(), bytes.size(), error);
+}
 
-        if (ncol < 0) {
-            ncol                    = static_cast<int>(row.size());
-            const QStringList ctoks = lastComment.split(ws, Qt::SkipEmptyParts);
-            if (ctoks.size() == ncol)
-                names = ctoks;
-            else
-                names = genericColumnNames(ncol);
-        }
-        if (static_cast<int>(row.size()) != ncol) continue; // skip ragged
-        rows.push_back(std::move(row));
-    }
+/* -------------------------------------------------------------------- */
 
-    if ((ncol <= 0) || rows.empty()) {
+PlotData parsePlotWhitespace(const char *data, qsizetype size, QString *error, int threads)
+{
+    PlotParse::Columns parsed;
+    if (!PlotParse::parseWhitespace({data, static_cast<std::size_t>(size)}, parsed, threads)) {
         if (error) *error = QStringLiteral("no whitespace-separated data found");
-        return out;
+        return {};
     }
-    out.setColumnNames(names);
-    for (auto &r : rows)
-        out.appendRow(r);
-    return out;
+    return fromColumns(std::move(parsed));
+}
+
+PlotData parsePlotWhitespace(const QString &text, QString *error)
+{
+    const QByteArray bytes = text.toUtf8();
+    return parsePlotWhitespace(bytes.constData(), bytes.size(), error);
 }
 
 /* -------------------------------------------------------------------- */
@@ -392,98 +349,769 @@ PlotData parsePlotJson(const QByteArray &bytes, QString *error)
 
 /* -------------------------------------------------------------------- */
 
-PlotData loadPlotData(const QString &filename, QString *error)
+namespace {
+
+// log text fed to the thermo parser at a time; bounds the memory of queued rows
+constexpr std::size_t LOG_CHUNK = 1024 * 1024;
+
+// Collects the thermo rows of log text, fed in arbitrary chunks, into one
+// table per thermo block.  A block is identified by its keywords.
+class LogRuns {
+public:
+    void feed(std::string_view text)
+    {
+        for (std::size_t pos = 0; pos < text.size(); pos += LOG_CHUNK) {
+            parser.feed(text.substr(pos, LOG_CHUNK));
+            collect();
+        }
+    }
+
+    std::vector<PlotData> finish()
+    {
+        parser.finish();
+        collect();
+        finishRun();
+        return std::move(runs);
+    }
+
+private:
+    void collect()
+    {
+        for (auto &row : parser.takeRows()) {
+            if (row.keywords != keywords) {
+                finishRun();
+                keywords = row.keywords;
+                columns.assign(keywords->size(), {});
+            }
+            for (std::size_t c = 0; c < columns.size(); ++c)
+                columns[c].push_back(row.values[c]);
+        }
+    }
+
+    void finishRun()
+    {
+        if (!keywords || columns.empty() || columns.front().empty()) return;
+        PlotData run;
+        for (std::size_t c = 0; c < columns.size(); ++c)
+            run.addColumn(QString::fromStdString((*keywords)[c]), std::move(columns[c]));
+        runs.push_back(std::move(run));
+        columns.clear();
+    }
+
+    ThermoParser parser;
+    std::shared_ptr<const std::vector<std::string>> keywords;
+    std::vector<std::vector<double>> columns; // of the current block
+    std::vector<PlotData> runs;
+};
+
+// Combine the tables of the thermo blocks of a log as described for parsePlotLog().
+PlotData mergeRuns(std::vector<PlotData> runs, QString *error)
+{
+    if (runs.empty()) {
+        if (error) *error = QStringLiteral("no thermo output found in LAMMPS log file");
+        return {};
+    }
+    if (runs.size() == 1) return std::move(runs.front());
+
+    // the union of the keywords of all runs, in the order they first appear
+    QStringList names;
+    std::size_t nrows = 0;
+    for (const auto &run : runs) {
+        for (const QString &name : run.columnNames())
+            if (!names.contains(name)) names << name;
+        nrows += static_cast<std::size_t>(run.rowCount());
+    }
+
+    PlotData out;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (const QString &name : names) {
+        std::vector<double> column;
+        column.reserve(nrows);
+        for (const auto &run : runs) {
+            const int c = static_cast<int>(run.columnNames().indexOf(name));
+            if (c >= 0)
+                column.insert(column.end(), run.column(c).begin(), run.column(c).end());
+            else
+                column.insert(column.end(), static_cast<std::size_t>(run.rowCount()), nan);
+        }
+        out.addColumn(name, std::move(column));
+    }
+    std::vector<double> index;
+    index.reserve(nrows);
+    for (std::size_t r = 0; r < runs.size(); ++r)
+        index.insert(index.end(), static_cast<std::size_t>(runs[r].rowCount()),
+                     static_cast<double>(r + 1));
+    out.addColumn(QStringLiteral("Run"), std::move(index));
+    return out;
+}
+
+} // namespace
+
+std::vector<PlotData> parsePlotLogRuns(const char *data, qsizetype size)
+{
+    LogRuns runs;
+    runs.feed({data, static_cast<std::size_t>(size)});
+    return runs.finish();
+}
+
+PlotData parsePlotLog(const char *data, qsizetype size, QString *error)
+{
+    return mergeRuns(parsePlotLogRuns(data, size), error);
+}
+
+PlotData parsePlotLog(const QString &text, QString *error)
+{
+    const QByteArray bytes = text.toUtf8();
+    return parsePlotLog(bytes.constData(), bytes.size(), error);
+}
+
+/* -------------------------------------------------------------------- */
+
+namespace {
+
+// Header of the binary plot data format.  It is followed by the strings block
+// (the source path, then the column names; each a 32-bit length and the UTF-8
+// bytes, zero-padded to a multiple of 8 bytes in total) and then the columns,
+// each as nrow doubles.  All numbers are in the byte order of the writing host.
+struct BinaryHeader {
+    char magic[8];         // "LGPDATA" and the format version
+    std::uint32_t order;   // BINARY_ORDER as stored by the writer
+    std::uint32_t format;  // PlotFormat of the source
+    std::uint64_t ncol;    // number of columns
+    std::uint64_t nrow;    // number of rows
+    std::int64_t srcSize;  // size of the source in bytes
+    std::int64_t srcMtime; // modification time of the source in ms since the epoch
+    std::uint64_t strings; // size of the strings block in bytes
+    std::uint64_t unused;  // reserved, zero
+};
+static_assert(sizeof(BinaryHeader) == 64, "binary plot data header must be 64 bytes");
+
+constexpr char BINARY_MAGIC[8]       = {'L', 'G', 'P', 'D', 'A', 'T', 'A', '\x01'};
+constexpr std::uint32_t BINARY_ORDER = 0x01020304U;
+
+// Validate the header and strings block; set the header, the source, and the names.
+bool readBinaryHeader(const char *data, qsizetype size, BinaryHeader &header, PlotSource *source,
+                      QStringList *names)
+{
+    if ((size < static_cast<qsizetype>(sizeof(BinaryHeader))) || !data) return false;
+    std::memcpy(&header, data, sizeof(BinaryHeader));
+    if ((std::memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) ||
+        (header.order != BINARY_ORDER) ||
+        (header.format > static_cast<std::uint32_t>(PlotFormat::Log)))
+        return false;
+    const auto avail = static_cast<std::uint64_t>(size) - sizeof(BinaryHeader);
+    if ((header.strings > avail) || (header.strings % sizeof(double)) ||
+        (header.ncol > header.strings / sizeof(std::uint32_t)) ||
+        (header.nrow > static_cast<std::uint64_t>(std::numeric_limits<int>::max())))
+        return false;
+
+    const char *pos = data + sizeof(BinaryHeader);
+    const char *end = pos + header.strings;
+    auto nextString = [&](QString &str) {
+        std::uint32_t len = 0;
+        if (end - pos < static_cast<std::ptrdiff_t>(sizeof(len))) return false;
+        std::memcpy(&len, pos, sizeof(len));
+        pos += sizeof(len);
+        if (len > static_cast<std::uint64_t>(end - pos)) return false;
+        str = QString::fromUtf8(pos, static_cast<qsizetype>(len));
+        pos += len;
+        return true;
+    };
+    QString path;
+    if (!nextString(path)) return false;
+    QStringList list;
+    for (std::uint64_t c = 0; c < header.ncol; ++c) {
+        QString name;
+        if (!nextString(name)) return false;
+        list << name;
+    }
+    if (source) {
+        source->path   = path;
+        source->size   = header.srcSize;
+        source->mtime  = header.srcMtime;
+        source->format = static_cast<PlotFormat>(header.format);
+    }
+    if (names) *names = list;
+    return true;
+}
+
+} // namespace
+
+bool plotBinarySource(const char *data, qsizetype size, PlotSource *source)
+{
+    BinaryHeader header{};
+    return readBinaryHeader(data, size, header, source, nullptr);
+}
+
+PlotData parsePlotBinary(const char *data, qsizetype size, QString *error, PlotSource *source)
+{
+    BinaryHeader header{};
+    QStringList names;
+    if (!readBinaryHeader(data, size, header, source, &names)) {
+        if (error) *error = QStringLiteral("not a binary plot data file");
+        return {};
+    }
+    const std::uint64_t avail =
+        static_cast<std::uint64_t>(size) - sizeof(BinaryHeader) - header.strings;
+    if ((header.ncol > 0) && (header.nrow > avail / sizeof(double) / header.ncol)) {
+        if (error) *error = QStringLiteral("binary plot data file is truncated");
+        return {};
+    }
+
+    PlotData out;
+    const char *pos = data + sizeof(BinaryHeader) + header.strings;
+    for (int c = 0; c < names.size(); ++c) {
+        std::vector<double> column(header.nrow);
+        if (header.nrow > 0) std::memcpy(column.data(), pos, header.nrow * sizeof(double));
+        pos += header.nrow * sizeof(double);
+        out.addColumn(names[c], std::move(column));
+    }
+    if (out.isEmpty() && error) *error = QStringLiteral("no data found in binary plot data file");
+    return out;
+}
+
+/* -------------------------------------------------------------------- */
+
+namespace {
+
+// Format of the contents of a data file.  Binary plot data is recognized by
+// its header; otherwise an explicit, known extension wins, else the format is
+// detected from the content: a LAMMPS log has thermo blocks (in one-line or
+// YAML format), a .dat may embed a YAML thermo block, or the file may
+// actually be JSON.  The extension of a compressed file is that of the name
+// without the compression extension.
+PlotFormat detectFormat(const QString &filename, const char *data, qsizetype size)
+{
+    const std::string_view text(data, static_cast<std::size_t>(size));
+    const QString suffix = QFileInfo(Decompress::uncompressedName(filename)).suffix().toLower();
+    if (plotBinarySource(data, size)) return PlotFormat::Binary;
+    if (suffix == "csv") return PlotFormat::Csv;
+    if (suffix == "json") return PlotFormat::Json;
+    if ((suffix == "yaml") || (suffix == "yml")) return PlotFormat::Yaml;
+    if (PlotParse::looksLikeLog(text)) return PlotFormat::Log;
+    if (PlotParse::looksLikeYaml(text)) return PlotFormat::Yaml;
+    if (PlotParse::looksLikeJson(text)) return PlotFormat::Json;
+    return PlotFormat::Whitespace;
+}
+
+// The contents of an open file.  The plain-text formats are parsed straight
+// from the memory-mapped file; it is read into buffer instead if it cannot be
+// mapped (e.g. empty files or pipes).
+std::string_view fileBytes(QFile &f, QByteArray &buffer)
+{
+    uchar *mapped = (f.size() > 0) ? f.map(0, f.size()) : nullptr;
+    if (mapped)
+        return {reinterpret_cast<const char *>(mapped), static_cast<std::size_t>(f.size())};
+    buffer = f.readAll();
+    return {buffer.constData(), static_cast<std::size_t>(buffer.size())};
+}
+
+// decompressed bytes collected before the format of a compressed file is detected
+constexpr qsizetype SNIFF_SIZE = 1024 * 1024;
+
+// Parse CSV or whitespace-separated data while it is decompressed.  The
+// whole-text parser reads the start, up to the first data row, which sets the
+// column names and count; the remaining lines go through a TailParser, which
+// accepts the same rows.
+PlotData streamTable(Decompress::Reader &in, QByteArray &head, bool more, bool csv,
+                     QString *error)
+{
+    PlotParse::Columns parsed;
+    QByteArray chunk;
+    qsizetype cut = 0;
+    while (true) {
+        cut = more ? head.lastIndexOf('\n') + 1 : head.size();
+        const std::string_view text(head.constData(), static_cast<std::size_t>(cut));
+        if (csv ? PlotParse::parseCsv(text, parsed) : PlotParse::parseWhitespace(text, parsed))
+            break;
+        if (!more) {
+            if (error)
+                *error = csv ? QStringLiteral("no CSV data found")
+                             : QStringLiteral("no whitespace-separated data found");
+            return {};
+        }
+        more = in.next(chunk);
+        if (more) head += chunk;
+    }
+
+    const std::size_t ncol = parsed.columns.size();
+    PlotParse::TailParser tail(csv, ncol);
+    std::vector<double> rows;
+    auto feed = [&](std::string_view bytes) {
+        rows.clear();
+        const std::size_t nrows = tail.feed(bytes, rows);
+        for (std::size_t c = 0; c < ncol; ++c) {
+            std::vector<double> &column = parsed.columns[c];
+            for (std::size_t r = 0; r < nrows; ++r)
+                column.push_back(rows[(r * ncol) + c]);
+        }
+    };
+    feed(std::string_view(head.constData(), static_cast<std::size_t>(head.size())).substr(cut));
+    head.clear();
+    while (in.next(chunk))
+        feed({chunk.constData(), static_cast<std::size_t>(chunk.size())});
+    if (tail.pending() > 0) feed("\n"); // a last line without a newline
+    return fromColumns(std::move(parsed));
+}
+
+// Read a compressed data file.  CSV, whitespace-separated, and log files are
+// parsed chunk by chunk while the next chunk is decompressed; the other
+// formats are parsed once all data is decompressed.
+PlotData loadCompressed(const QString &filename, QString *error, PlotFormat &detected)
+{
+    Decompress::Reader in(filename);
+    QByteArray head;
+    QByteArray chunk;
+    bool more = true;
+    while (more && (head.size() < SNIFF_SIZE)) {
+        more = in.next(chunk);
+        if (more) head += chunk;
+    }
+    detected = detectFormat(filename, head.constData(), head.size());
+
+    PlotData result;
+    switch (detected) {
+        case PlotFormat::Csv:
+        case PlotFormat::Whitespace:
+            result = streamTable(in, head, more, detected == PlotFormat::Csv, error);
+            break;
+        case PlotFormat::Log: {
+            LogRuns runs;
+            runs.feed({head.constData(), static_cast<std::size_t>(head.size())});
+            head.clear();
+            while (more && in.next(chunk))
+                runs.feed({chunk.constData(), static_cast<std::size_t>(chunk.size())});
+            result = mergeRuns(runs.finish(), error);
+            break;
+        }
+        default:
+            while (more && in.next(chunk))
+                head += chunk;
+            if (in.errorString().isEmpty()) {
+                if (detected == PlotFormat::Yaml)
+                    result = parsePlotYaml(QString::fromUtf8(head), error);
+                else if (detected == PlotFormat::Json)
+                    result = parsePlotJson(head, error);
+                else
+                    result = parsePlotBinary(head.constData(), head.size(), error);
+            }
+            break;
+    }
+
+    // a failed decompression is reported instead of what was parsed before it failed
+    if (!in.errorString().isEmpty()) {
+        if (error) *error = in.errorString();
+        return {};
+    }
+    return result;
+}
+
+} // namespace
+
+PlotData loadPlotData(const QString &filename, QString *error, PlotFormat *format, int threads)
 {
     QFile f(filename);
     if (!f.open(QIODevice::ReadOnly)) {
         if (error) *error = QStringLiteral("cannot open file: %1").arg(filename);
         return {};
     }
-    const QByteArray bytes = f.readAll();
-    f.close();
 
-    const QString text = QString::fromUtf8(bytes);
+    // an unchanged file that was parsed before is read back from the cache
+    PlotSource source = PlotCache::describe(filename);
+    PlotData cached;
+    if (PlotCache::load(source, cached, format)) return cached;
+
+    // compressed files are parsed while an external program decompresses them
+    if (Decompress::isCompressed(filename)) {
+        f.close();
+        PlotFormat detected = PlotFormat::Whitespace;
+        PlotData result     = loadCompressed(filename, error, detected);
+        if (format) *format = detected;
+        source.format = detected;
+        PlotCache::store(source, result);
+        return result;
+    }
+
+    QByteArray buffer;
+    const std::string_view bytes = fileBytes(f, buffer);
+    const char *data             = bytes.data();
+    const auto size              = static_cast<qsizetype>(bytes.size());
 
-    // an explicit, known extension wins
-    const QString suffix = QFileInfo(filename).suffix().toLower();
-    if (suffix == "csv") return parsePlotCsv(text, error);
-    if (suffix == "json") return parsePlotJson(bytes, error);
-    if ((suffix == "yaml") || (suffix == "yml")) return parsePlotYaml(text, error);
+    const PlotFormat detected = detectFormat(filename, data, size);
+    if (format) *format = detected;
 
-    // otherwise detect the format from the content: a LAMMPS .log/.dat may
-    // embed a YAML thermo block (interleaved with other log output), or the
-    // file may actually be JSON
-    if (looksLikeYaml(text)) return parsePlotYaml(text, error);
-    if (looksLikeJson(text)) return parsePlotJson(bytes, error);
-    return parsePlotWhitespace(text, error);
+    PlotData result;
+    switch (detected) {
+        case PlotFormat::Csv:
+            result = parsePlotCsv(data, size, error, threads);
+            break;
+        case PlotFormat::Yaml:
+            result = parsePlotYaml(QString::fromUtf8(data, size), error);
+            break;
+        case PlotFormat::Json:
+            result = parsePlotJson(QByteArray::fromRawData(data, size), error);
+            break;
+        case PlotFormat::Log:
+            result = parsePlotLog(data, size, error);
+            break;
+        case PlotFormat::Binary:
+            return parsePlotBinary(data, size, error);
+        case PlotFormat::Whitespace:
+        default:
+            result = parsePlotWhitespace(data, size, error, threads);
+            break;
+    }
+    source.format = detected;
+    PlotCache::store(source, result);
+    return result;
 }
 
 /* -------------------------------------------------------------------- */
 
 namespace {
-// 8 significant digits, matching the historical export precision
-QString fmt(double v)
+
+// The columns of data in the given order; an index may appear more than once.
+PlotData selectColumns(const PlotData &data, const QList<int> &columns)
 {
-    return QString::number(v, 'g', 8);
+    PlotData out;
+    for (int c : columns)
+        out.addColumn(data.columnName(c), data.column(c));
+    return out;
 }
+
+// Check the column indices chosen for a file with ncol columns.
+bool validColumns(const QList<int> &columns, int ncol, QString *error)
+{
+    for (int c : columns) {
+        if ((c < 0) || (c >= ncol)) {
+            if (error) *error = QStringLiteral("no column %1 in file").arg(c + 1);
+            return false;
+        }
+    }
+    return true;
+}
+
 } // namespace
 
-QString writePlotCsv(const PlotData &data)
+PlotData loadPlotColumns(const QString &filename,
+                         const std::function<QList<int>(const QStringList &)> &select,
+                         QString *error, PlotFormat *format, int threads)
+{
+    QFile f(filename);
+    if (!f.open(QIODevice::ReadOnly)) {
+        if (error) *error = QStringLiteral("cannot open file: %1").arg(filename);
+        return {};
+    }
+
+    QByteArray buffer;
+    std::string_view text;
+    PlotFormat detected   = PlotFormat::Whitespace;
+    const bool compressed = Decompress::isCompressed(filename);
+    if (!compressed) {
+        text     = fileBytes(f, buffer);
+        detected = detectFormat(filename, text.data(), static_cast<qsizetype>(text.size()));
+    }
+
+    // compressed files and the other formats are loaded completely, then the columns are picked
+    if (compressed || ((detected != PlotFormat::Csv) && (detected != PlotFormat::Whitespace))) {
+        f.close();
+        const PlotData data = loadPlotData(filename, error, format, threads);
+        if (data.isEmpty()) return {};
+        const QList<int> columns = select(data.columnNames());
+        if (columns.isEmpty() || !validColumns(columns, data.columnCount(), error)) return {};
+        return selectColumns(data, columns);
+    }
+    if (format) *format = detected;
+
+    // CSV and whitespace-separated files: only the header is read before the
+    // columns are chosen, then only those columns are parsed
+    const bool csv = (detected == PlotFormat::Csv);
+    std::vector<std::string> header;
+    const int ncol    = static_cast<int>(PlotParse::readHeader(text, csv, header));
+    QStringList names = genericColumnNames(ncol);
+    if (!header.empty())
+        for (int c = 0; c < ncol; ++c)
+            names[c] = QString::fromStdString(header[c]);
+    const QList<int> columns = (ncol > 0) ? select(names) : QList<int>();
+    if ((ncol > 0) && (columns.isEmpty() || !validColumns(columns, ncol, error))) return {};
+
+    // each column is parsed once, even if it is chosen more than once
+    PlotParse::Selection unique;
+    std::vector<int> uses;
+    QList<int> positions;
+    for (int c : columns) {
+        const auto it = std::find(unique.begin(), unique.end(), static_cast<std::size_t>(c));
+        positions << static_cast<int>(it - unique.begin());
+        if (it == unique.end()) {
+            unique.push_back(static_cast<std::size_t>(c));
+            uses.push_back(0);
+        }
+        ++uses[positions.back()];
+    }
+    PlotParse::Columns parsed;
+    if ((ncol == 0) || !(csv ? PlotParse::parseCsv(text, parsed, threads, unique)
+                             : PlotParse::parseWhitespace(text, parsed, threads, unique))) {
+        if (error)
+            *error = csv ? QStringLiteral("no CSV data found")
+                         : QStringLiteral("no whitespace-separated data found");
+        return {};
+    }
+
+    PlotData out;
+    for (int i = 0; i < columns.size(); ++i) {
+        const int p = positions[i];
+        if (--uses[p] == 0)
+            out.addColumn(names[columns[i]], std::move(parsed.columns[p]));
+        else
+            out.addColumn(names[columns[i]], parsed.columns[p]);
+    }
+    return out;
+}
+
+PlotData loadPlotColumns(const QString &filename, const QList<int> &columns, QString *error,
+                         PlotFormat *format, int threads)
 {
-    QString out;
+    return loadPlotColumns(
+        filename, [&columns](const QStringList &) { return columns; }, error, format, threads);
+}
+
+/* -------------------------------------------------------------------- */
+
+QStringList plotDataColumns(const QString &filename, QString *error, PlotFormat *format)
+{
+    // nothing is chosen, so only the header of CSV and whitespace-separated files is read
+    QStringList names;
+    loadPlotColumns(
+        filename,
+        [&names](const QStringList &fileNames) {
+            names = fileNames;
+            return QList<int>();
+        },
+        error, format);
+    return names;
+}
+
+/* -------------------------------------------------------------------- */
+
+namespace {
+// Buffered text output of the streaming writers.  Numbers are formatted
+// straight into the buffer with 8 significant digits (the historical export
+// precision), so no string is created per value and memory use does not
+// depend on the size of the data.
+class TextSink {
+public:
+    explicit TextSink(QIODevice &device) : out(device), buffer(BUFSIZE) {}
+
+    void put(char c)
+    {
+        if (used == BUFSIZE) flush();
+        buffer[used++] = c;
+    }
+
+    void put(const char *text)
+    {
+        while (*text)
+            put(*text++);
+    }
+
+    void put(const QString &text)
+    {
+        const QByteArray utf8 = text.toUtf8();
+        for (char c : utf8)
+            put(c);
+    }
+
+    void number(double v)
+    {
+        if (std::isnan(v)) {
+            put("nan");
+            return;
+        }
+        if (std::isinf(v)) {
+            put((v < 0.0) ? "-inf" : "inf");
+            return;
+        }
+#if defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611L)
+        // "-1.2345678e-308" is the longest result
+        if (BUFSIZE - used < 32) flush();
+        const auto result = std::to_chars(buffer.data() + used, buffer.data() + BUFSIZE, v,
+                                          std::chars_format::general, 8);
+        used              = static_cast<std::size_t>(result.ptr - buffer.data());
+#else
+        // without floating-point to_chars: Qt's locale-independent formatting
+        const QByteArray text = QByteArray::number(v, 'g', 8);
+        for (char c : text)
+            put(c);
+#endif
+    }
+
+    /// Write what is left in the buffer; false if any write failed
+    bool finish()
+    {
+        flush();
+        return good;
+    }
+
+private:
+    static constexpr std::size_t BUFSIZE = 65536;
+
+    void flush()
+    {
+        if (good && (used > 0))
+            good = out.write(buffer.data(), static_cast<qint64>(used)) ==
+                static_cast<qint64>(used);
+        used = 0;
+    }
+
+    QIODevice &out;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+    bool good        = true;
+};
+
+// the text of a streaming writer as a string
+template <typename Writer>
+QString writeToString(Writer write)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    write(buffer);
+    return QString::fromUtf8(buffer.data());
+}
+} // namespace
+
+bool writePlotCsv(const PlotData &data, QIODevice &out)
+{
+    TextSink sink(out);
     for (int c = 0; c < data.columnCount(); ++c) {
-        if (c) out += ',';
-        out += data.columnName(c);
+        if (c) sink.put(',');
+        sink.put(data.columnName(c));
     }
-    out += '\n';
+    sink.put('\n');
     for (int r = 0; r < data.rowCount(); ++r) {
         for (int c = 0; c < data.columnCount(); ++c) {
-            if (c) out += ',';
-            out += fmt(data.column(c)[r]);
+            if (c) sink.put(',');
+            sink.number(data.value(r, c));
         }
-        out += '\n';
+        sink.put('\n');
     }
-    return out;
+    return sink.finish();
 }
 
-QString writePlotDat(const PlotData &data, const QString &source)
+QString writePlotCsv(const PlotData &data)
 {
-    QString out;
-    if (!source.isEmpty()) out += "# data from " + source + '\n';
-    out += '#';
-    for (int c = 0; c < data.columnCount(); ++c)
-        out += ' ' + data.columnName(c);
-    out += '\n';
+    return writeToString([&data](QIODevice &out) { return writePlotCsv(data, out); });
+}
+
+bool writePlotDat(const PlotData &data, QIODevice &out, const QString &source)
+{
+    TextSink sink(out);
+    if (!source.isEmpty()) {
+        sink.put("# data from ");
+        sink.put(source);
+        sink.put('\n');
+    }
+    sink.put('#');
+    for (int c = 0; c < data.columnCount(); ++c) {
+        sink.put(' ');
+        sink.put(data.columnName(c));
+    }
+    sink.put('\n');
     for (int r = 0; r < data.rowCount(); ++r) {
         for (int c = 0; c < data.columnCount(); ++c) {
-            if (c) out += ' ';
-            out += fmt(data.column(c)[r]);
+            if (c) sink.put(' ');
+            sink.number(data.value(r, c));
         }
-        out += '\n';
+        sink.put('\n');
     }
-    return out;
+    return sink.finish();
 }
 
-QString writePlotYaml(const PlotData &data)
+QString writePlotDat(const PlotData &data, const QString &source)
 {
-    QString out = "---\n";
-    out += "keywords: [";
+    return writeToString([&](QIODevice &out) { return writePlotDat(data, out, source); });
+}
+
+bool writePlotYaml(const PlotData &data, QIODevice &out)
+{
+    TextSink sink(out);
+    sink.put("---\nkeywords: [");
     for (int c = 0; c < data.columnCount(); ++c) {
-        if (c) out += ", ";
-        out += '\'' + data.columnName(c) + '\'';
+        if (c) sink.put(", ");
+        sink.put('\'');
+        sink.put(data.columnName(c));
+        sink.put('\'');
     }
-    out += "]\n";
-    out += "data:\n";
+    sink.put("]\ndata:\n");
     for (int r = 0; r < data.rowCount(); ++r) {
-        out += "  - [";
+        sink.put("  - [");
         for (int c = 0; c < data.columnCount(); ++c) {
-            if (c) out += ", ";
-            out += fmt(data.column(c)[r]);
+            if (c) sink.put(", ");
+            sink.number(data.value(r, c));
         }
-        out += "]\n";
+        sink.put("]\n");
     }
-    out += "...\n";
-    return out;
+    sink.put("...\n");
+    return sink.finish();
+}
+
+QString writePlotYaml(const PlotData &data)
+{
+    return writeToString([&data](QIODevice &out) { return writePlotYaml(data, out); });
+}
+
+/* -------------------------------------------------------------------- */
+
+bool writePlotBinary(const PlotData &data, QIODevice &out, const PlotSource &source)
+{
+    const int nrow = data.rowCount();
+    for (int c = 0; c < data.columnCount(); ++c)
+        if (static_cast<int>(data.packedColumn(c).size()) != nrow) return false;
+
+    QByteArray strings;
+    auto addString = [&](const QString &str) {
+        const QByteArray utf8   = str.toUtf8();
+        const std::uint32_t len = static_cast<std::uint32_t>(utf8.size());
+        strings.append(reinterpret_cast<const char *>(&len), sizeof(len));
+        strings.append(utf8);
+    };
+    addString(source.path);
+    for (const QString &name : data.columnNames())
+        addString(name);
+    while (strings.size() % sizeof(double))
+        strings.append('\0');
+
+    BinaryHeader header{};
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.order    = BINARY_ORDER;
+    header.format   = static_cast<std::uint32_t>(source.format);
+    header.ncol     = static_cast<std::uint64_t>(data.columnCount());
+    header.nrow     = static_cast<std::uint64_t>(nrow);
+    header.srcSize  = source.size;
+    header.srcMtime = source.mtime;
+    header.strings  = static_cast<std::uint64_t>(strings.size());
+
+    bool good = (out.write(reinterpret_cast<const char *>(&header), sizeof(header)) ==
+                 static_cast<qint64>(sizeof(header))) &&
+        (out.write(strings) == strings.size());
+    // packed columns are expanded to doubles a chunk at a time
+    constexpr std::size_t CHUNK = 65536;
+    std::vector<double> chunk;
+    for (int c = 0; good && (c < data.columnCount()); ++c) {
+        const PackedColumn &col = data.packedColumn(c);
+        if (col.packing() == ColumnPacking::Double) {
+            const auto bytes = static_cast<qint64>(nrow * sizeof(double));
+            good = out.write(reinterpret_cast<const char *>(col.values().data()), bytes) == bytes;
+            continue;
+        }
+        for (std::size_t first = 0; good && (first < col.size()); first += CHUNK) {
+            chunk.resize(std::min(CHUNK, col.size() - first));
+            col.decode(first, chunk.size(), chunk.data());
+            const auto bytes = static_cast<qint64>(chunk.size() * sizeof(double));
+            good = out.write(reinterpret_cast<const char *>(chunk.data()), bytes) == bytes;
+        }
+    }
+    return good;
 }
 
 // Local Variables:
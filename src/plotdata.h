@@ -15,19 +15,29 @@
 // Column-oriented numeric data model and file parsers used to plot data from
 // external structured files (whitespace/.dat, CSV, LAMMPS YAML, JSON). The
 // numeric payload is stored as std::vector<double> so it can be fed directly
-// to the leastsquares toolkit for the polynomial / EOS fits.
+// to the leastsquares toolkit for the polynomial / EOS fits.  Columns of very
+// long tables, such as the data of a chart window, can be packed into a
+// compact encoding instead (see packedcolumn.h).
+
+#include "packedcolumn.h"
 
 #include <QByteArray>
+#include <QList>
 #include <QString>
 #include <QStringList>
+#include <functional>
 #include <vector>
 
+class QIODevice;
+
 /**
  * @brief Column-oriented table of named numeric columns
  *
  * Holds a set of equally long columns of doubles, each with a name. It is
  * the GUI-free data model shared by the file parsers and the chart window
- * when plotting external data.
+ * when plotting external data.  A column can be packed into single precision
+ * or, for integers such as steps, into integer offsets (see setPacking());
+ * value() reads every column, column() only the ones in full precision.
  */
 class PlotData {
 public:
@@ -57,10 +67,53 @@ public:
 
     /**
      * @brief Read access to a column's values
-     * @param c Column index
+     * @param c Column index of a column with ColumnPacking::Double
      * @return Reference to the column data
+     *
+     * A packed column has no vector of doubles; read it with value() or
+     * packedColumn().decode() instead.  Asserts in debug builds.
      */
-    const std::vector<double> &column(int c) const { return cols[c]; }
+    const std::vector<double> &column(int c) const
+    {
+        Q_ASSERT(packing(c) == ColumnPacking::Double);
+        return cols[c].values();
+    }
+
+    /**
+     * @brief Read a single value of any column
+     * @param r Row index
+     * @param c Column index
+     * @return The value, converted to double for a packed column
+     */
+    double value(int r, int c) const { return cols[c].at(static_cast<std::size_t>(r)); }
+
+    /**
+     * @brief Storage of a column, for readers of packed columns
+     * @param c Column index
+     * @return The column
+     */
+    const PackedColumn &packedColumn(int c) const { return cols[c]; }
+
+    /**
+     * @brief Encoding of a column
+     * @param c Column index
+     * @return ColumnPacking::Double unless the column was packed with setPacking()
+     */
+    ColumnPacking packing(int c) const { return cols[c].packing(); }
+
+    /**
+     * @brief Convert a column to another encoding
+     * @param c       Column index
+     * @param packing New encoding; ColumnPacking::Float rounds the values, and a
+     *                column that is not suitable for ColumnPacking::Delta keeps
+     *                (or falls back to) full precision
+     *
+     * Values added later are stored in the same encoding.
+     */
+    void setPacking(int c, ColumnPacking packing) { cols[c].setPacking(packing); }
+
+    /** @brief Bytes of memory held by the values of all columns */
+    std::size_t memoryUsage() const;
 
     /**
      * @brief Reset the table to a fresh set of (empty) named columns
@@ -75,6 +128,21 @@ public:
      */
     void renameColumns(const QStringList &newNames);
 
+    /**
+     * @brief Rename a single column in place
+     * @param c    Column index
+     * @param name New name
+     */
+    void renameColumn(int c, const QString &name) { names[c] = name; }
+
+    /**
+     * @brief Overwrite a single value
+     * @param r     Row index
+     * @param c     Column index
+     * @param value New value
+     */
+    void setValue(int r, int c, double value) { cols[c].set(static_cast<std::size_t>(r), value); }
+
     /**
      * @brief Append one row of values, one per column
      * @param row Values to append (size must equal columnCount())
@@ -92,8 +160,8 @@ public:
     void addColumn(const QString &name, std::vector<double> data);
 
 private:
-    QStringList names;                     ///< per-column names
-    std::vector<std::vector<double>> cols; ///< column-major numeric payload
+    QStringList names;              ///< per-column names
+    std::vector<PackedColumn> cols; ///< column-major numeric payload
 };
 
 /**
@@ -108,6 +176,19 @@ private:
  */
 PlotData parsePlotCsv(const QString &text, QString *error = nullptr);
 
+/**
+ * @brief Parse comma-separated values from UTF-8 bytes into a PlotData
+ * @param data  File contents, e.g. a memory-mapped file
+ * @param size  Number of bytes
+ * @param error   Optional out-parameter set to a message on failure
+ * @param threads Number of threads (0: one per core, for large inputs only)
+ * @return Parsed table (empty on failure), the same as from the QString overload
+ *
+ * Parses the bytes in place (see plotparse.h); large inputs are parsed on all cores.
+ */
+PlotData parsePlotCsv(const char *data, qsizetype size, QString *error = nullptr,
+                      int threads = 0);
+
 /**
  * @brief Parse whitespace-separated columns (gnuplot / LAMMPS `.dat`) into a PlotData
  * @param text  File contents
@@ -119,6 +200,19 @@ PlotData parsePlotCsv(const QString &text, QString *error = nullptr);
  */
 PlotData parsePlotWhitespace(const QString &text, QString *error = nullptr);
 
+/**
+ * @brief Parse whitespace-separated columns from UTF-8 bytes into a PlotData
+ * @param data  File contents, e.g. a memory-mapped file
+ * @param size  Number of bytes
+ * @param error   Optional out-parameter set to a message on failure
+ * @param threads Number of threads (0: one per core, for large inputs only)
+ * @return Parsed table (empty on failure), the same as from the QString overload
+ *
+ * Parses the bytes in place (see plotparse.h); large inputs are parsed on all cores.
+ */
+PlotData parsePlotWhitespace(const char *data, qsizetype size, QString *error = nullptr,
+                             int threads = 0);
+
 /**
  * @brief Parse YAML (LAMMPS thermo `keywords:`+`data:` or a sequence of maps) into a PlotData
  * @param text  File contents
@@ -139,14 +233,166 @@ PlotData parsePlotYaml(const QString &text, QString *error = nullptr);
  */
 PlotData parsePlotJson(const QByteArray &bytes, QString *error = nullptr);
 
+/**
+ * @brief File formats read by loadPlotData()
+ *
+ * The values are stored in binary plot data files, so new formats are appended.
+ */
+enum class PlotFormat {
+    Whitespace, ///< whitespace-separated columns
+    Csv,        ///< comma-separated values
+    Yaml,       ///< YAML thermo data or a sequence of maps
+    Json,       ///< JSON array of rows or object of columns
+    Binary,     ///< binary columns written by writePlotBinary()
+    Log,        ///< thermo output in a LAMMPS log file
+};
+
+/**
+ * @brief Origin of the data in a binary plot data file
+ *
+ * The plot data cache records the parsed file to validate a cache entry
+ * against it; exported files have no source.
+ */
+struct PlotSource {
+    QString path;                           ///< Absolute path of the parsed file (empty: none)
+    qint64 size       = -1;                 ///< Size of the parsed file in bytes
+    qint64 mtime      = 0;                  ///< Its modification time in ms since the epoch
+    PlotFormat format = PlotFormat::Binary; ///< Format it was parsed as
+};
+
+/**
+ * @brief Parse the thermo output of a LAMMPS log file, one table per thermo block
+ * @param data File contents, e.g. a memory-mapped file
+ * @param size Number of bytes
+ * @return One table per run or minimization with thermo output, in file order
+ *
+ * Both the default one-line thermo format and the YAML format are read (see
+ * ThermoParser); blocks without a "Step" column or in the multi-line format
+ * are skipped.  The text is processed in a single pass in chunks, so no copy
+ * of the file is made.
+ */
+std::vector<PlotData> parsePlotLogRuns(const char *data, qsizetype size);
+
+/**
+ * @brief Parse the thermo output of a LAMMPS log file into one PlotData
+ * @param data  File contents, e.g. a memory-mapped file
+ * @param size  Number of bytes
+ * @param error Optional out-parameter set to a message on failure
+ * @return Parsed table (empty on failure)
+ *
+ * The thermo blocks of parsePlotLogRuns() are concatenated.  The columns are
+ * the union of their keywords in the order they first appear, with NaN for
+ * the rows of blocks without that keyword.  With more than one block, a final
+ * "Run" column holds the 1-based index of the block of each row.
+ */
+PlotData parsePlotLog(const char *data, qsizetype size, QString *error = nullptr);
+
+/**
+ * @brief Parse the thermo output of a LAMMPS log file into one PlotData
+ * @param text  File contents
+ * @param error Optional out-parameter set to a message on failure
+ * @return Parsed table (empty on failure), the same as from the byte overload
+ */
+PlotData parsePlotLog(const QString &text, QString *error = nullptr);
+
+/**
+ * @brief Parse a binary plot data file
+ * @param data   File contents, e.g. a memory-mapped file
+ * @param size   Number of bytes
+ * @param error  Optional out-parameter set to a message on failure
+ * @param source Optional out-parameter set to the recorded origin of the data
+ * @return Table (empty on failure)
+ *
+ * The columns are stored as raw doubles, so this is a copy of each column
+ * rather than a parse.
+ */
+PlotData parsePlotBinary(const char *data, qsizetype size, QString *error = nullptr,
+                         PlotSource *source = nullptr);
+
+/**
+ * @brief Read the header of a binary plot data file
+ * @param data   File contents, at least the header and the column names
+ * @param size   Number of bytes
+ * @param source Optional out-parameter set to the recorded origin of the data
+ * @return true if the bytes start with a valid header of this host's byte order
+ */
+bool plotBinarySource(const char *data, qsizetype size, PlotSource *source = nullptr);
+
 /**
  * @brief Load a file into a PlotData, choosing the parser by file extension or content
- * @param filename Path to the data file (.csv, .yaml/.yml, .json; else the
- *                 whitespace format, with a content-sniffing fallback to YAML/JSON)
+ * @param filename Path to the data file (binary plot data, recognized by its
+ *                 header; .csv, .yaml/.yml, .json; else the whitespace format,
+ *                 with a content-sniffing fallback to LAMMPS logs, YAML, and JSON)
  * @param error    Optional out-parameter set to a message on failure
+ * @param format   Optional out-parameter set to the format the file was parsed as
+ * @param threads  Number of threads for parsing CSV and whitespace-separated
+ *                 files (0: one per core, for large files only); callers that
+ *                 already load several files in parallel pass 1
  * @return Parsed table (empty on failure)
+ *
+ * The file is memory-mapped, so CSV and whitespace-separated files are parsed
+ * without reading them into a string first.  Files compressed with gzip,
+ * bzip2, zstd, xz, or lz4 (by extension, e.g. thermo.csv.zst; see
+ * decompress.h) are decompressed by the external program while they are
+ * parsed: CSV, whitespace-separated, and log data chunk by chunk, the other
+ * formats once all data is read.  Text files are looked up in and added to the
+ * plot data cache (see plotcache.h), so reopening an unchanged large file
+ * skips the parse.
+ */
+PlotData loadPlotData(const QString &filename, QString *error = nullptr,
+                      PlotFormat *format = nullptr, int threads = 0);
+
+/**
+ * @brief Load only the columns of a data file that are chosen from its column names
+ * @param filename Path to the data file, as for loadPlotData()
+ * @param select   Called once with the column names of the file (generic names
+ *                 if it has none); returns the indices of the columns to load,
+ *                 in the order of the result.  An index may appear more than
+ *                 once.  Loading stops if the list is empty.
+ * @param error    Optional out-parameter set to a message on failure
+ * @param format   Optional out-parameter set to the format the file was parsed as
+ * @param threads  Number of parser threads, as for loadPlotData()
+ * @return Table of the chosen columns (empty on failure or if none were chosen)
+ *
+ * For uncompressed CSV and whitespace-separated files, only the lines up to
+ * the first data line are read before @p select is called, and then only the
+ * chosen columns are converted and stored, so the time and memory grow with
+ * the number of chosen columns rather than with the width of the file.  Rows
+ * are kept or skipped by their number of fields and the chosen fields, so a
+ * non-numeric field in another column does not skip a row.  These loads do
+ * not use the plot data cache.  Other files are loaded with loadPlotData()
+ * and the chosen columns copied from the result.
  */
-PlotData loadPlotData(const QString &filename, QString *error = nullptr);
+PlotData loadPlotColumns(const QString &filename,
+                         const std::function<QList<int>(const QStringList &)> &select,
+                         QString *error = nullptr, PlotFormat *format = nullptr,
+                         int threads = 0);
+
+/**
+ * @brief Load some columns of a data file
+ * @param filename Path to the data file, as for loadPlotData()
+ * @param columns  Indices of the columns to load, in the order of the result
+ * @param error    Optional out-parameter set to a message on failure
+ * @param format   Optional out-parameter set to the format the file was parsed as
+ * @param threads  Number of parser threads, as for loadPlotData()
+ * @return Table of the columns (empty on failure)
+ */
+PlotData loadPlotColumns(const QString &filename, const QList<int> &columns,
+                         QString *error = nullptr, PlotFormat *format = nullptr,
+                         int threads = 0);
+
+/**
+ * @brief Column names of a data file
+ * @param filename Path to the data file, as for loadPlotData()
+ * @param error    Optional out-parameter set to a message on failure
+ * @param format   Optional out-parameter set to the format of the file
+ * @return Column names (empty on failure)
+ *
+ * Only the header of uncompressed CSV and whitespace-separated files is read;
+ * other files are parsed completely.
+ */
+QStringList plotDataColumns(const QString &filename, QString *error = nullptr,
+                            PlotFormat *format = nullptr);
 
 /**
  * @brief Format a PlotData as comma-separated values
@@ -174,6 +420,47 @@ QString writePlotDat(const PlotData &data, const QString &source = QString());
  */
 QString writePlotYaml(const PlotData &data);
 
+/**
+ * @brief Stream a PlotData as comma-separated values
+ * @param data Table to write
+ * @param out  Device open for writing
+ * @return false if writing failed
+ *
+ * Writes the same text as writePlotCsv(const PlotData &) through a small
+ * buffer, so exporting a table of any size takes no extra memory.
+ */
+bool writePlotCsv(const PlotData &data, QIODevice &out);
+
+/**
+ * @brief Stream a PlotData as whitespace-separated columns (gnuplot style)
+ * @param data   Table to write
+ * @param out    Device open for writing
+ * @param source Optional description placed in the leading comment line
+ * @return false if writing failed; the text is that of writePlotDat(data, source)
+ */
+bool writePlotDat(const PlotData &data, QIODevice &out, const QString &source = QString());
+
+/**
+ * @brief Stream a PlotData as a LAMMPS-style thermo YAML document
+ * @param data Table to write
+ * @param out  Device open for writing
+ * @return false if writing failed; the text is that of writePlotYaml(data)
+ */
+bool writePlotYaml(const PlotData &data, QIODevice &out);
+
+/**
+ * @brief Write a PlotData as binary plot data
+ * @param data   Table to write
+ * @param out    Device open for writing
+ * @param source Origin of the data (recorded by the plot data cache)
+ * @return false if writing failed
+ *
+ * The file has a header, the column names, and each column as raw doubles in
+ * the host's byte order; it round-trips exactly through parsePlotBinary() and
+ * is loaded by mapping it into memory, so it is the fastest format to reopen.
+ */
+bool writePlotBinary(const PlotData &data, QIODevice &out, const PlotSource &source = {});
+
 #endif
 
 // Local Variables:
@@ -33,9 +33,8 @@
 #include <QVBoxLayout>
 
 #include <cctype>
-#include <exception>
-#include <map>
 #include <string>
+#include <vector>
 
 // Sanitize a column name to a valid LeptonMini variable identifier.
 // Replaces anything that is not alphanumeric or '_' with '_', and
@@ -172,37 +171,35 @@ void PlotDataDialog::computeColumn()
     const int ncol = workingData.columnCount();
     const int nrow = workingData.rowCount();
 
-    // map "<sanitized column name>_first" to the column's first-row value for LeptonMini
-    std::map<std::string, double> constants;
+    // bind the columns and the row index as arrays, and "<sanitized column name>_first"
+    // to the column's first-row value; a later name wins, so "row" hides a column of that name
+    QStringList arrays, scalars;
+    std::vector<const double *> columns;
+    std::vector<double> firsts;
     for (int c = 0; c < ncol; ++c) {
-        const std::string var = sanitizeVarName(workingData.columnName(c));
-        if (nrow > 0) constants[var + "_first"] = workingData.column(c).front();
+        const QString var = QString::fromStdString(sanitizeVarName(workingData.columnName(c)));
+        arrays << var;
+        columns.push_back(workingData.column(c).data());
+        if (nrow > 0) {
+            scalars << var + "_first";
+            firsts.push_back(workingData.column(c).front());
+        }
     }
+    std::vector<double> rows(static_cast<std::size_t>(nrow));
+    for (int r = 0; r < nrow; ++r)
+        rows[r] = static_cast<double>(r);
+    arrays << QStringLiteral("row");
+    columns.push_back(rows.data());
 
     CompiledExpression program(expr);
-    if (!program.isValid()) {
+    if (!program.bind(arrays, scalars)) {
         warning(this, "Compute Column",
                 QString("Could not evaluate the expression:\n%1").arg(program.error()));
         return;
     }
 
-    std::vector<double> result;
-    result.reserve(static_cast<std::size_t>(nrow));
-
-    try {
-        std::map<std::string, double> vars = std::move(constants);
-        vars["row"]                        = 0.0;
-        for (int r = 0; r < nrow; ++r) {
-            for (int c = 0; c < ncol; ++c)
-                vars[sanitizeVarName(workingData.columnName(c))] = workingData.column(c)[r];
-            vars["row"] = static_cast<double>(r);
-            result.push_back(program.evaluate(vars));
-        }
-    } catch (const std::exception &e) {
-        warning(this, "Compute Column",
-                QString("Could not evaluate the expression:\n%1").arg(e.what()));
-        return;
-    }
+    std::vector<double> result(static_cast<std::size_t>(nrow));
+    program.evaluateBatch(nrow, columns.data(), firsts.data(), result.data());
 
     workingData.addColumn(colName, std::move(result));
     appendColumnRow(colName, true);
@@ -0,0 +1,172 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "plotdecimate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// column group markers of LineEnvelope besides the column index
+constexpr int LEFT = -1; // left of the visible range
+constexpr int NONE = -2; // no group started
+constexpr int GAP  = -3; // a run of samples with non-finite coordinates
+
+// pixel cell of a value in [min, min + n/scale], or -1 if outside
+int cellOf(double v, double min, double scale, int n)
+{
+    const double pos = (v - min) * scale;
+    if (!(pos >= 0.0) || (pos > n)) return -1;
+    return std::min(n - 1, static_cast<int>(pos));
+}
+
+} // namespace
+
+namespace PlotDecimate {
+
+void LineEnvelope::reset(double xmin, double xmax, int columns)
+{
+    m_columns    = std::max(1, columns);
+    m_xmin       = xmin;
+    m_scale      = m_columns / (xmax - xmin);
+    m_valid      = true;
+    m_done       = false;
+    m_groupStart = 0;
+    m_groupOut   = 0;
+    m_col        = NONE;
+    m_prevX      = -std::numeric_limits<double>::infinity();
+    m_groupPrevX = m_prevX;
+    m_out.clear();
+}
+
+void LineEnvelope::flush()
+{
+    if (m_col == LEFT) {
+        m_out.push_back(m_last);
+    } else if (m_col >= 0) {
+        std::size_t keep[4] = {m_first, m_imin, m_imax, m_last};
+        std::sort(keep, keep + 4);
+        m_out.insert(m_out.end(), keep, std::unique(keep, keep + 4));
+    }
+}
+
+bool LineEnvelope::update(const Samples &samples)
+{
+    if (!m_valid) return false;
+    if (m_done) return true;
+
+    // the last group may have grown or changed: drop its output and scan it again
+    m_out.resize(m_groupOut);
+    m_col   = NONE;
+    m_prevX = m_groupPrevX;
+
+    for (std::size_t i = m_groupStart; i < samples.count; ++i) {
+        const double x = samples.xAt(i);
+        const double y = samples.yAt(i);
+        if (!std::isfinite(x) || !std::isfinite(y)) {
+            // the gap belongs to the preceding group, so a gap at the end that
+            // gets filled later is scanned again together with that group
+            if (m_col == GAP) continue;
+            flush();
+            m_col = GAP;
+            m_out.push_back(i);
+            continue;
+        }
+        if (x < m_prevX) {
+            m_valid = false;
+            m_out.clear();
+            return false;
+        }
+
+        int col = m_columns; // right of the visible range
+        if (x < m_xmin)
+            col = LEFT;
+        else if (x <= m_xmin + m_columns / m_scale)
+            col = std::min(m_columns - 1, static_cast<int>((x - m_xmin) * m_scale));
+
+        if (col != m_col) {
+            flush();
+            if (col == m_columns) {
+                // the first sample beyond the range ends the visible part of the line
+                m_out.push_back(i);
+                m_groupOut = m_out.size();
+                m_done     = true;
+                return true;
+            }
+            m_col        = col;
+            m_groupStart = i;
+            m_groupOut   = m_out.size();
+            m_groupPrevX = m_prevX;
+            m_first = m_last = m_imin = m_imax = i;
+            m_ymin = m_ymax = y;
+        } else {
+            m_last = i;
+            if (y < m_ymin) {
+                m_ymin = y;
+                m_imin = i;
+            }
+            if (y > m_ymax) {
+                m_ymax = y;
+                m_imax = i;
+            }
+        }
+        m_prevX = x;
+    }
+    flush();
+    return true;
+}
+
+void MarkerThinning::reset(double xmin, double xmax, double ymin, double ymax, int width,
+                           int height)
+{
+    m_width    = std::max(1, width);
+    m_height   = std::max(1, height);
+    m_xmin     = xmin;
+    m_xscale   = m_width / (xmax - xmin);
+    m_ymin     = ymin;
+    m_yscale   = m_height / (ymax - ymin);
+    m_scanned  = 0;
+    m_lastCell = 0;
+    m_used.assign(static_cast<std::size_t>(m_width) * m_height, false);
+    m_out.clear();
+}
+
+void MarkerThinning::update(const Samples &samples)
+{
+    // the last sample may have changed: forget it and scan it again
+    if (m_scanned > 0) {
+        --m_scanned;
+        if (!m_out.empty() && (m_out.back() == m_scanned)) {
+            m_out.pop_back();
+            m_used[m_lastCell] = false;
+        }
+    }
+
+    for (std::size_t i = m_scanned; i < samples.count; ++i) {
+        const int cx = cellOf(samples.xAt(i), m_xmin, m_xscale, m_width);
+        const int cy = cellOf(samples.yAt(i), m_ymin, m_yscale, m_height);
+        if ((cx < 0) || (cy < 0)) continue;
+        const std::size_t cell = static_cast<std::size_t>(cy) * m_width + cx;
+        if (m_used[cell]) continue;
+        m_used[cell] = true;
+        m_lastCell   = cell;
+        m_out.push_back(i);
+    }
+    m_scanned = samples.count;
+}
+
+} // namespace PlotDecimate
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,153 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef PLOTDECIMATE_H
+#define PLOTDECIMATE_H
+
+// Small, self-contained (Qt-free) level-of-detail reduction for drawing long
+// data series.  A series with many more points than the plot has pixel columns
+// is reduced to the few points that actually determine what is drawn, so the
+// rendering cost depends on the plot size rather than on the data size while
+// the picture stays the same; in particular single-point spikes are kept.
+// Both reducers are incremental: when points are only appended, just the new
+// points are scanned.
+
+#include "packedcolumn.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace PlotDecimate {
+
+/**
+ * @brief Read-only view of (x, y) samples stored with a common stride
+ *
+ * Covers both separate x and y arrays (stride 1) and interleaved storage such
+ * as an array of points (stride 2, y = x + 1).  Columns in a compact encoding
+ * are read through packedX and packedY instead, converting each value as it is
+ * read, so they need not be expanded for drawing.
+ */
+struct Samples {
+    const double *x             = nullptr; ///< first x value
+    const double *y             = nullptr; ///< first y value
+    std::size_t stride          = 1;       ///< distance between consecutive values, in doubles
+    std::size_t count           = 0;       ///< number of samples
+    const PackedColumn *packedX = nullptr; ///< x values, used instead of x if set
+    const PackedColumn *packedY = nullptr; ///< y values, used instead of y if set
+    /** @brief X value of sample i */
+    double xAt(std::size_t i) const { return packedX ? packedX->at(i) : x[i * stride]; }
+    /** @brief Y value of sample i */
+    double yAt(std::size_t i) const { return packedY ? packedY->at(i) : y[i * stride]; }
+};
+
+/**
+ * @brief Min/max envelope of a line series with non-decreasing x values
+ *
+ * The visible x range is divided into pixel columns.  Of the consecutive
+ * samples falling into one column only the first, the last, and the ones with
+ * the smallest and largest y value are kept, in their original order.  Drawn
+ * as a polyline these produce the same pixels as the full series: the vertical
+ * extent of each column and the connections to the neighboring columns are
+ * preserved.  Of the samples left of the range only the last one is kept, of
+ * those right of it only the first one, so lines entering and leaving the plot
+ * are still drawn.  A sample with a non-finite coordinate is kept as well
+ * (it marks a gap in the line) and starts a new group.
+ */
+class LineEnvelope {
+public:
+    /**
+     * @brief Start over for a new visible range
+     * @param xmin    Left end of the visible x range
+     * @param xmax    Right end of the visible x range (must be > xmin)
+     * @param columns Number of pixel columns across the range (clamped to >= 1)
+     */
+    void reset(double xmin, double xmax, int columns);
+
+    /**
+     * @brief Bring the envelope up to date with the samples
+     * @param samples All samples of the series; the ones processed by earlier
+     *                calls must be unchanged, except for those in the last pixel
+     *                column, which are always scanned again
+     * @return false if the x values decrease, i.e. the envelope is not
+     *         applicable and the full series must be drawn
+     */
+    bool update(const Samples &samples);
+
+    /** @brief Indices of the samples to draw, in ascending order */
+    const std::vector<std::size_t> &indices() const { return m_out; }
+
+private:
+    /** @brief Append the kept samples of the current column group */
+    void flush();
+
+    double m_xmin = 0.0, m_scale = 1.0; ///< maps x to a column
+    int m_columns = 1;                  ///< number of pixel columns
+    bool m_valid  = true;               ///< false once decreasing x was found
+    bool m_done   = false;              ///< true once a sample right of the range was kept
+    std::size_t m_groupStart = 0;       ///< first sample of the current group
+    std::size_t m_groupOut   = 0;       ///< size of m_out before the current group
+    std::vector<std::size_t> m_out;     ///< kept samples
+
+    // current group: column index, or -1 = left of range, -2 = none, -3 = gap
+    int m_col = -2;
+    std::size_t m_first = 0, m_last = 0, m_imin = 0, m_imax = 0;
+    double m_ymin = 0.0, m_ymax = 0.0;
+    double m_prevX      = 0.0; ///< x of the previous finite sample
+    double m_groupPrevX = 0.0; ///< m_prevX when the current group started
+};
+
+/**
+ * @brief Thinning of a marker series to one marker per occupied pixel
+ *
+ * Markers are drawn at least a pixel wide, so of several samples that map to
+ * the same pixel only the first one needs to be drawn.  Samples outside the
+ * visible area or with a non-finite coordinate are dropped.  Works for any
+ * order of the samples.
+ */
+class MarkerThinning {
+public:
+    /**
+     * @brief Start over for a new visible area
+     * @param xmin,xmax Visible x range (xmax > xmin)
+     * @param ymin,ymax Visible y range (ymax > ymin)
+     * @param width     Pixel columns across the x range (clamped to >= 1)
+     * @param height    Pixel rows across the y range (clamped to >= 1)
+     */
+    void reset(double xmin, double xmax, double ymin, double ymax, int width, int height);
+
+    /**
+     * @brief Bring the selection up to date with the samples
+     * @param samples All samples of the series; the ones processed by earlier
+     *                calls must be unchanged, except for the last one, which is
+     *                scanned again
+     */
+    void update(const Samples &samples);
+
+    /** @brief Indices of the samples to draw, in ascending order */
+    const std::vector<std::size_t> &indices() const { return m_out; }
+
+private:
+    double m_xmin = 0.0, m_xscale = 1.0; ///< maps x to a pixel column
+    double m_ymin = 0.0, m_yscale = 1.0; ///< maps y to a pixel row
+    int m_width = 1, m_height = 1;       ///< pixel grid size
+    std::size_t m_scanned  = 0;          ///< number of samples processed so far
+    std::size_t m_lastCell = 0;          ///< pixel of the most recently kept sample
+    std::vector<bool> m_used;            ///< occupied pixels
+    std::vector<std::size_t> m_out;      ///< kept samples
+};
+
+} // namespace PlotDecimate
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
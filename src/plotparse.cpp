@@ -0,0 +1,430 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "plotparse.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace PlotParse {
+
+namespace {
+
+// inputs smaller than this per thread are not worth splitting
+constexpr std::size_t MIN_CHUNK = 4 * 1024 * 1024;
+
+bool isSpace(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r') || (c == '\v') || (c == '\f');
+}
+
+std::string_view trimmed(std::string_view s)
+{
+    std::size_t a = 0;
+    std::size_t b = s.size();
+    while ((a < b) && isSpace(s[a]))
+        ++a;
+    while ((b > a) && isSpace(s[b - 1]))
+        --b;
+    return s.substr(a, b - a);
+}
+
+// Split off the first line (without the newline) and advance the text past it.
+std::string_view nextLine(std::string_view &text)
+{
+    const std::size_t nl = text.find('\n');
+    if (nl == std::string_view::npos) {
+        const std::string_view line = text;
+        text                        = {};
+        return line;
+    }
+    const std::string_view line = text.substr(0, nl);
+    text.remove_prefix(nl + 1);
+    return line;
+}
+
+// Visit the fields of a line: comma-separated (and trimmed) or whitespace-separated.
+template <typename Func> void forEachField(std::string_view line, bool csv, Func &&func)
+{
+    if (csv) {
+        while (true) {
+            const std::size_t comma = line.find(',');
+            if (!func(trimmed(line.substr(0, comma)))) return;
+            if (comma == std::string_view::npos) return;
+            line.remove_prefix(comma + 1);
+        }
+    }
+    std::size_t i = 0;
+    while (i < line.size()) {
+        while ((i < line.size()) && isSpace(line[i]))
+            ++i;
+        if (i == line.size()) return;
+        const std::size_t start = i;
+        while ((i < line.size()) && !isSpace(line[i]))
+            ++i;
+        if (!func(line.substr(start, i - start))) return;
+    }
+}
+
+// Parse one data line into row; false if it is blank, a comment, or not a row of ncol numbers.
+// With a slot map, field n is stored in row[slot[n]] and fields with a negative
+// slot are counted but not converted.
+bool parseRow(std::string_view line, bool csv, std::size_t ncol, const int *slot, double *row)
+{
+    line = trimmed(line);
+    if (line.empty() || (!csv && (line.front() == '#'))) return false;
+    std::size_t n = 0;
+    bool good     = true;
+    forEachField(line, csv, [&](std::string_view field) {
+        if (n >= ncol)
+            good = false;
+        else if (!slot)
+            good = toNumber(field, row[n]);
+        else if (slot[n] >= 0)
+            good = toNumber(field, row[slot[n]]);
+        ++n;
+        return good;
+    });
+    return good && (n == ncol);
+}
+
+// Map the fields of a line to the output columns: slot[n] is the output
+// column of field n or -1.  Empty if all fields are kept in order; false if
+// the selection has an index out of range or twice.
+bool slotMap(const Selection &select, std::size_t ncol, std::vector<int> &slot)
+{
+    slot.clear();
+    if (select.empty()) return true;
+    slot.assign(ncol, -1);
+    for (std::size_t i = 0; i < select.size(); ++i) {
+        if ((select[i] >= ncol) || (slot[select[i]] >= 0)) return false;
+        slot[select[i]] = static_cast<int>(i);
+    }
+    return true;
+}
+
+// Parse the data lines in text into columns, in parallel for large inputs.
+// Only the fields with a slot are stored, unless the slot map is empty.
+void parseBody(std::string_view text, bool csv, std::size_t ncol, const std::vector<int> &slot,
+               int threads, std::vector<std::vector<double>> &columns)
+{
+    const int *slots = slot.empty() ? nullptr : slot.data();
+    std::size_t nout = ncol;
+    if (slots) nout = std::count_if(slot.begin(), slot.end(), [](int s) { return s >= 0; });
+
+    std::size_t nchunks = 1;
+    if (threads > 0) {
+        nchunks = static_cast<std::size_t>(threads);
+    } else {
+        nchunks = std::max(1U, std::thread::hardware_concurrency());
+        nchunks = std::min(nchunks, std::max<std::size_t>(1, text.size() / MIN_CHUNK));
+    }
+
+    // chunk boundaries are moved forward to the start of the next line
+    std::vector<std::string_view> chunks;
+    std::size_t start = 0;
+    for (std::size_t i = 1; i <= nchunks; ++i) {
+        std::size_t end = (i == nchunks) ? text.size() : (text.size() * i) / nchunks;
+        if (end < text.size()) {
+            end = text.find('\n', std::max(end, start));
+            end = (end == std::string_view::npos) ? text.size() : end + 1;
+        }
+        if (end > start) chunks.push_back(text.substr(start, end - start));
+        start = std::max(start, end);
+    }
+
+    // each chunk is parsed into a row-major block, then copied to its place in the columns
+    std::vector<std::vector<double>> blocks(chunks.size());
+    auto parseChunk = [&](std::size_t c) {
+        std::string_view rest = chunks[c];
+        std::vector<double> &block = blocks[c];
+        std::vector<double> row(nout);
+        while (!rest.empty()) {
+            if (parseRow(nextLine(rest), csv, ncol, slots, row.data()))
+                block.insert(block.end(), row.begin(), row.end());
+        }
+    };
+    std::vector<std::size_t> offsets(chunks.size() + 1, 0);
+    auto copyChunk = [&](std::size_t c) {
+        const std::vector<double> &block = blocks[c];
+        const std::size_t nrows          = block.size() / nout;
+        for (std::size_t col = 0; col < nout; ++col) {
+            double *dest = columns[col].data() + offsets[c];
+            for (std::size_t r = 0; r < nrows; ++r)
+                dest[r] = block[(r * nout) + col];
+        }
+        std::vector<double>().swap(blocks[c]);
+    };
+    auto inParallel = [&](auto &&func) {
+        std::vector<std::thread> workers;
+        for (std::size_t c = 1; c < chunks.size(); ++c)
+            workers.emplace_back(func, c);
+        if (!chunks.empty()) func(0);
+        for (auto &w : workers)
+            w.join();
+    };
+
+    inParallel(parseChunk);
+    for (std::size_t c = 0; c < chunks.size(); ++c)
+        offsets[c + 1] = offsets[c] + (blocks[c].size() / nout);
+    columns.assign(nout, std::vector<double>(offsets.back()));
+    inParallel(copyChunk);
+}
+
+// The line containing position pos of text, trimmed.
+std::string_view lineAt(std::string_view text, std::size_t pos)
+{
+    const std::size_t nl    = text.rfind('\n', pos);
+    const std::size_t begin = (nl == std::string_view::npos) ? 0 : nl + 1;
+    return trimmed(text.substr(begin, text.find('\n', pos) - begin));
+}
+
+std::string_view withoutBom(std::string_view text)
+{
+    if ((text.size() >= 3) && (std::memcmp(text.data(), "\xEF\xBB\xBF", 3) == 0))
+        text.remove_prefix(3);
+    return text;
+}
+
+// Column layout of a file, found before its data is parsed.
+struct Layout {
+    std::vector<std::string> names; // column names; empty if there are none
+    std::size_t ncol = 0;           // number of fields of a data line
+    std::string_view body;          // the text from the first possible data line on
+};
+
+// Find the header and the number of columns.  CSV: the first non-empty line
+// is the header unless it is all numbers; whitespace: the first all-numeric
+// line sets the number of columns and is named by the last comment before it.
+bool findLayout(std::string_view text, bool csv, Layout &layout)
+{
+    std::string_view rest = withoutBom(text);
+    std::string_view lastComment;
+    std::vector<double> row;
+    while (!rest.empty()) {
+        const std::string_view before = rest;
+        const std::string_view line   = trimmed(nextLine(rest));
+        if (line.empty()) continue;
+        if (!csv && (line.front() == '#')) {
+            lastComment = trimmed(line.substr(1));
+            continue;
+        }
+
+        std::vector<std::string> fields;
+        bool allNumeric = true;
+        forEachField(line, csv, [&](std::string_view field) {
+            double v = 0.0;
+            if (!toNumber(field, v)) allNumeric = false;
+            fields.emplace_back(field);
+            return csv || allNumeric;
+        });
+        if (csv) {
+            layout.ncol = fields.size();
+            if (!allNumeric) layout.names = std::move(fields);
+            layout.body = allNumeric ? before : rest;
+            return true;
+        }
+        if (!allNumeric) continue; // skip non-numeric lines (e.g. text headers)
+
+        forEachField(lastComment, false, [&](std::string_view field) {
+            layout.names.emplace_back(field);
+            return true;
+        });
+        if (layout.names.size() != fields.size()) layout.names.clear();
+        layout.ncol = fields.size();
+        layout.body = before;
+        return true;
+    }
+    return false;
+}
+
+// The names of the selected columns, or all names for an empty selection.
+std::vector<std::string> selectedNames(std::vector<std::string> names, const Selection &select)
+{
+    if (select.empty() || names.empty()) return names;
+    std::vector<std::string> selected;
+    selected.reserve(select.size());
+    for (std::size_t i : select)
+        selected.push_back(std::move(names[i]));
+    return selected;
+}
+
+} // namespace
+
+/* -------------------------------------------------------------------- */
+
+bool toNumber(std::string_view token, double &value)
+{
+    const char *first = token.data();
+    const char *last  = token.data() + token.size();
+    if ((first != last) && (*first == '+')) {
+        ++first;
+        if ((first != last) && ((*first == '+') || (*first == '-'))) return false;
+    }
+    if (first == last) return false;
+#if defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611L)
+    const auto result = std::from_chars(first, last, value);
+    return (result.ec == std::errc()) && (result.ptr == last);
+#else
+    // without floating-point from_chars: strtod on a terminated copy of the token,
+    // with the decimal point of the C library's current locale
+    const char point = *std::localeconv()->decimal_point;
+    std::string copy(first, last);
+    if (point != '.') {
+        if (copy.find(point) != std::string::npos) return false;
+        std::replace(copy.begin(), copy.end(), '.', point);
+    }
+    char *end      = nullptr;
+    errno          = 0;
+    const double v = std::strtod(copy.c_str(), &end);
+    if ((errno == ERANGE) || (end != copy.c_str() + copy.size())) return false;
+    value = v;
+    return true;
+#endif
+}
+
+/* -------------------------------------------------------------------- */
+
+bool parseCsv(std::string_view text, Columns &out, int threads, const Selection &select)
+{
+    out = Columns();
+    Layout layout;
+    std::vector<int> slot;
+    if (!findLayout(text, true, layout) || !slotMap(select, layout.ncol, slot)) return false;
+    parseBody(layout.body, true, layout.ncol, slot, threads, out.columns);
+    if (out.columns.empty() || out.columns.front().empty()) {
+        out = Columns();
+        return false;
+    }
+    out.names = selectedNames(std::move(layout.names), select);
+    return true;
+}
+
+/* -------------------------------------------------------------------- */
+
+bool parseWhitespace(std::string_view text, Columns &out, int threads, const Selection &select)
+{
+    out = Columns();
+    Layout layout;
+    std::vector<int> slot;
+    if (!findLayout(text, false, layout) || !slotMap(select, layout.ncol, slot)) return false;
+    parseBody(layout.body, false, layout.ncol, slot, threads, out.columns);
+    out.names = selectedNames(std::move(layout.names), select);
+    return true;
+}
+
+/* -------------------------------------------------------------------- */
+
+std::size_t readHeader(std::string_view text, bool csv, std::vector<std::string> &names)
+{
+    Layout layout;
+    if (!findLayout(text, csv, layout)) layout = Layout();
+    names = std::move(layout.names);
+    return layout.ncol;
+}
+
+/* -------------------------------------------------------------------- */
+
+void TailParser::reset(bool midLine)
+{
+    partial.clear();
+    skipFirst = midLine;
+}
+
+/* -------------------------------------------------------------------- */
+
+std::size_t TailParser::feed(std::string_view bytes, std::vector<double> &rows)
+{
+    if (ncol == 0) return 0;
+    if (skipFirst) {
+        const std::size_t nl = bytes.find('\n');
+        if (nl == std::string_view::npos) return 0;
+        bytes.remove_prefix(nl + 1);
+        skipFirst = false;
+    }
+
+    const std::size_t before = rows.size();
+    std::vector<double> row(ncol);
+    // complete the buffered line first
+    if (!partial.empty()) {
+        const std::size_t nl = bytes.find('\n');
+        if (nl == std::string_view::npos) {
+            partial.append(bytes);
+            return 0;
+        }
+        partial.append(bytes.substr(0, nl));
+        bytes.remove_prefix(nl + 1);
+        if (parseRow(partial, csv, ncol, nullptr, row.data()))
+            rows.insert(rows.end(), row.begin(), row.end());
+        partial.clear();
+    }
+
+    const std::size_t last = bytes.rfind('\n');
+    std::string_view lines = bytes.substr(0, (last == std::string_view::npos) ? 0 : last + 1);
+    partial.assign(bytes.substr(lines.size()));
+    while (!lines.empty()) {
+        if (parseRow(nextLine(lines), csv, ncol, nullptr, row.data()))
+            rows.insert(rows.end(), row.begin(), row.end());
+    }
+    return (rows.size() - before) / ncol;
+}
+
+/* -------------------------------------------------------------------- */
+
+bool looksLikeYaml(std::string_view text)
+{
+    for (std::size_t pos = text.find("keywords:"); pos != std::string_view::npos;
+         pos             = text.find("keywords:", pos + 1)) {
+        if (lineAt(text, pos).substr(0, 9) == "keywords:") return true;
+    }
+    for (std::size_t pos = text.find("- {"); pos != std::string_view::npos;
+         pos             = text.find("- {", pos + 1)) {
+        const std::string_view line = lineAt(text, pos);
+        if ((line.substr(0, 3) == "- {") && (line.back() == '}') &&
+            (line.find(':') != std::string_view::npos))
+            return true;
+    }
+    return false;
+}
+
+/* -------------------------------------------------------------------- */
+
+bool looksLikeLog(std::string_view text)
+{
+    for (const char *marker : {"Per MPI rank memory allocation", "Memory usage per processor"}) {
+        for (std::size_t pos = text.find(marker); pos != std::string_view::npos;
+             pos             = text.find(marker, pos + 1)) {
+            if ((pos == 0) || (text[pos - 1] == '\n')) return true;
+        }
+    }
+    return false;
+}
+
+/* -------------------------------------------------------------------- */
+
+bool looksLikeJson(std::string_view text)
+{
+    const std::string_view t = trimmed(withoutBom(text));
+    return !t.empty() && ((t.front() == '[') || (t.front() == '{'));
+}
+
+} // namespace PlotParse
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
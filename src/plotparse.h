@@ -0,0 +1,172 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef PLOTPARSE_H
+#define PLOTPARSE_H
+
+// Small, self-contained (Qt-free) parsers for the plain-text plot data formats
+// (CSV and whitespace-separated columns).  They work directly on the bytes of
+// the file, e.g. a memory-mapped file, without converting it to UTF-16 or
+// allocating per line or per number.  Once the header is found, the data lines
+// are independent of each other, so large inputs are split into line-aligned
+// chunks that are parsed in parallel.  The rules for headers, comments, and
+// skipped lines are those of parsePlotCsv() and parsePlotWhitespace().  A
+// selection of columns can be parsed from files with many columns.  The
+// TailParser parses data appended to a file that is still being written.
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PlotParse {
+
+/**
+ * @brief Column-major result of a parser
+ */
+struct Columns {
+    std::vector<std::string> names;           ///< Column names (UTF-8); empty if there are none
+    std::vector<std::vector<double>> columns; ///< One vector of values per column
+};
+
+/**
+ * @brief Indices of the columns to parse, in the order they are stored; empty for all
+ *
+ * Only the selected fields of a line are converted to numbers, so parse time
+ * and memory grow with the number of selected columns rather than with the
+ * width of the file.  The indices must be distinct and less than the number
+ * of columns of the file (see readHeader()).
+ */
+using Selection = std::vector<std::size_t>;
+
+/**
+ * @brief Convert a complete token to a number
+ * @param token Text of the number, without surrounding whitespace
+ * @param value Set to the number on success
+ * @return true if the whole token is a number
+ *
+ * Accepts the formats of std::from_chars (decimal and scientific notation,
+ * "inf", "nan") with an optional leading "+".  Values out of the range of a
+ * double are rejected.
+ */
+bool toNumber(std::string_view token, double &value);
+
+/**
+ * @brief Parse comma-separated values
+ * @param text    File contents
+ * @param out     Set to the parsed columns
+ * @param threads Number of threads (0: one per core, for large inputs only)
+ * @param select  Columns to parse (default: all)
+ * @return false if no data was found or the selection is invalid
+ *
+ * The first non-empty line is the header unless all its fields are numbers,
+ * in which case @c out.names stays empty and the line is data.  Lines with a
+ * different number of fields than the first line, or with (selected) fields
+ * that are not numbers, are skipped.
+ */
+bool parseCsv(std::string_view text, Columns &out, int threads = 0, const Selection &select = {});
+
+/**
+ * @brief Parse whitespace-separated columns
+ * @param text    File contents
+ * @param out     Set to the parsed columns
+ * @param threads Number of threads (0: one per core, for large inputs only)
+ * @param select  Columns to parse (default: all)
+ * @return false if no data was found or the selection is invalid
+ *
+ * Lines starting with "#" are comments.  The fields of the last comment before
+ * the first data line are the column names if their number matches the data;
+ * otherwise @c out.names stays empty.  Lines that are not all numbers (in the
+ * selected fields) or have a different number of fields than the first data
+ * line are skipped.
+ */
+bool parseWhitespace(std::string_view text, Columns &out, int threads = 0,
+                     const Selection &select = {});
+
+/**
+ * @brief Read the column layout of a file without parsing its data
+ * @param text  File contents; only the lines up to the first data line are read
+ * @param csv   true for comma-separated values, false for whitespace-separated columns
+ * @param names Set to the column names as found by parseCsv() or parseWhitespace()
+ * @return Number of columns; 0 if there is no header or data line
+ */
+std::size_t readHeader(std::string_view text, bool csv, std::vector<std::string> &names);
+
+/**
+ * @brief Incremental parser for the data lines appended to a growing file
+ *
+ * Bytes are fed as they are read from the end of the file.  Only complete
+ * lines are parsed; an incomplete last line is kept until the rest of it
+ * arrives.  Lines that are not a row of the expected number of numbers
+ * (headers, comments, ragged lines) are skipped as by the whole-file parsers.
+ */
+class TailParser {
+public:
+    /**
+     * @brief Constructor
+     * @param _csv  true for comma-separated values, false for whitespace-separated columns
+     * @param _ncol Number of columns of the file
+     */
+    TailParser(bool _csv, std::size_t _ncol) : csv(_csv), ncol(_ncol), skipFirst(false) {}
+
+    /**
+     * @brief Forget buffered bytes and start over
+     * @param midLine true if the next bytes may start in the middle of a line,
+     *                which is then skipped up to and including its newline
+     */
+    void reset(bool midLine = false);
+
+    /**
+     * @brief Parse newly appended bytes
+     * @param bytes Bytes following those of the previous call
+     * @param rows  Parsed rows are appended row-major, ncol values each
+     * @return Number of rows appended
+     */
+    std::size_t feed(std::string_view bytes, std::vector<double> &rows);
+
+    /// Number of buffered bytes of the incomplete last line
+    std::size_t pending() const { return partial.size(); }
+
+private:
+    bool csv;            ///< Comma-separated (true) or whitespace-separated (false) fields
+    std::size_t ncol;    ///< Number of values per row
+    bool skipFirst;      ///< Skip the bytes up to the first newline
+    std::string partial; ///< Incomplete last line
+};
+
+/**
+ * @brief Whether the text contains YAML tabular data
+ * @param text File contents
+ * @return true for a LAMMPS thermo "keywords:" line or a "- {key: value, ...}" line
+ */
+bool looksLikeYaml(std::string_view text);
+
+/**
+ * @brief Whether the text is a LAMMPS log file with thermo output
+ * @param text File contents
+ * @return true if a line starts with the memory usage message printed before
+ *         the thermo output of a run or minimization
+ */
+bool looksLikeLog(std::string_view text);
+
+/**
+ * @brief Whether the text starts like a JSON document
+ * @param text File contents
+ * @return true if the first non-blank character is "[" or "{"
+ */
+bool looksLikeJson(std::string_view text);
+
+} // namespace PlotParse
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,541 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "plotrenderer.h"
+
+#include "plotaxismath.h"
+
+#include <QFont>
+#include <QFontMetricsF>
+#include <QPaintDevice>
+#include <QPainter>
+#include <QPen>
+#include <QPolygonF>
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace {
+
+// layout constants (logical pixels)
+constexpr double OUTER      = 10.0; ///< outer padding around the whole chart
+constexpr double TITLE_GAP  = 8.0;  ///< gap between an axis title and the adjacent labels/plot
+constexpr double TITLE_VPAD = 12.0; ///< padding above and below the chart title
+constexpr double LABEL_GAP  = 5.0;  ///< gap between tick labels and the axis
+constexpr double TICK_LEN   = 5.0;  ///< length of axis tick marks
+
+// legend box layout (logical pixels)
+constexpr double LEGEND_INSET  = 8.0;  ///< inset from the top-left plot corner
+constexpr double LEGEND_PAD    = 5.0;  ///< padding inside the legend box
+constexpr double LEGEND_SWATCH = 20.0; ///< width of a legend color swatch
+constexpr double LEGEND_GAP    = 6.0;  ///< gap between swatch and label text
+
+// level-of-detail reduction is used for series with more than this many
+// points per pixel column of the plot area
+constexpr int LOD_MIN_DENSITY = 4;
+
+// gridline / frame colors
+const QColor MAJOR_GRID(160, 160, 160);
+const QColor MINOR_GRID(208, 208, 208);
+const QColor FRAME_COLOR(80, 80, 80);
+
+// Ensure a strictly positive span so coordinate mapping never divides by zero.
+void ensureSpan(double &min, double &max)
+{
+    if (!(max > min)) {
+        const double mid = 0.5 * (min + max);
+        min              = mid - 0.5;
+        max              = mid + 0.5;
+    }
+}
+
+QString labelText(double value, const QString &format)
+{
+    return QString::fromStdString(PlotAxisMath::formatAxisLabel(value, format.toStdString()));
+}
+
+// Pick a tick-label format: keep an explicit integer format when ticks are at
+// least 1 apart (e.g. integer time steps); otherwise derive the number of
+// decimals from the tick spacing so closely spaced ticks do not collapse to
+// identical labels.
+QString effectiveFormat(const QString &fmt, double interval)
+{
+    const bool integerFmt = fmt.contains('d') || fmt.contains('i');
+    if (integerFmt && interval >= 1.0) return fmt;
+    return QStringLiteral("%.%1f").arg(PlotAxisMath::tickDecimals(interval));
+}
+
+// raw access to the coordinates of a series for the level-of-detail reducers
+PlotDecimate::Samples samplesOf(const PlotSeries *s)
+{
+    PlotDecimate::Samples samples;
+    samples.count = s->count();
+    if (s->isView()) {
+        // packed columns are read value by value; the others directly
+        const PackedColumn &xs = s->table->packedColumn(s->xcol);
+        const PackedColumn &ys = s->table->packedColumn(s->ycol);
+        if (xs.packing() == ColumnPacking::Double)
+            samples.x = xs.values().data();
+        else
+            samples.packedX = &xs;
+        if (ys.packing() == ColumnPacking::Double)
+            samples.y = ys.values().data();
+        else
+            samples.packedY = &ys;
+    } else {
+        static_assert(std::is_same<qreal, double>::value && (sizeof(QPointF) == 2 * sizeof(double)),
+                      "QPointF must hold two doubles");
+        const auto *xy = reinterpret_cast<const double *>(s->points.constData());
+        samples.x      = xy;
+        samples.y      = xy + 1;
+        samples.stride = 2;
+    }
+    return samples;
+}
+
+} // namespace
+
+void PlotRenderer::setXRange(double min, double max)
+{
+    m_xaxis.min = min;
+    m_xaxis.max = max;
+}
+
+void PlotRenderer::setYRange(double min, double max)
+{
+    m_yaxis.min = min;
+    m_yaxis.max = max;
+}
+
+void PlotRenderer::setGrid(bool major, bool minor)
+{
+    m_xaxis.gridVisible = m_yaxis.gridVisible = major;
+    m_xaxis.minorGridVisible = m_yaxis.minorGridVisible = minor;
+}
+
+void PlotRenderer::setRefLabelStyle(double pointSize, double distance, bool boxed)
+{
+    m_refLabelSize  = pointSize;
+    m_refLabelDist  = distance;
+    m_refLabelBoxed = boxed;
+}
+
+bool PlotRenderer::addSeries(const PlotSeries *series)
+{
+    if (!series || m_series.contains(series)) return false;
+    m_series.append(series);
+    return true;
+}
+
+bool PlotRenderer::removeSeries(const PlotSeries *series)
+{
+    m_lod.remove(series);
+    return m_series.removeAll(series) > 0;
+}
+
+bool PlotRenderer::clearSeries()
+{
+    m_lod.clear();
+    if (m_series.isEmpty()) return false;
+    m_series.clear();
+    return true;
+}
+
+const std::vector<std::size_t> *PlotRenderer::lodIndices(const PlotSeries *s, double xmin,
+                                                          double xmax, double ymin, double ymax,
+                                                          int width, int height) const
+{
+    const int npoints = s->count();
+    if (npoints <= LOD_MIN_DENSITY * width) {
+        m_lod.remove(s);
+        return nullptr;
+    }
+
+    // start over unless points were only appended within the same view
+    const bool line = (s->type == PlotSeriesType::Line);
+    LodCache &cache = m_lod[s];
+    if ((cache.revision != s->revision) || (npoints < cache.count) || (cache.xmin != xmin) ||
+        (cache.xmax != xmax) || (cache.width != width) ||
+        (!line && ((cache.ymin != ymin) || (cache.ymax != ymax) || (cache.height != height)))) {
+        cache.revision = s->revision;
+        cache.xmin     = xmin;
+        cache.xmax     = xmax;
+        cache.ymin     = ymin;
+        cache.ymax     = ymax;
+        cache.width    = width;
+        cache.height   = height;
+        if (line)
+            cache.line.reset(xmin, xmax, width);
+        else
+            cache.markers.reset(xmin, xmax, ymin, ymax, width, height);
+    }
+    cache.count = npoints;
+
+    // lines with decreasing x (e.g. a parametric curve) cannot be reduced
+    if (line) return cache.line.update(samplesOf(s)) ? &cache.line.indices() : nullptr;
+    cache.markers.update(samplesOf(s));
+    return &cache.markers.indices();
+}
+
+void PlotRenderer::render(QPainter &p, const QRectF &target) const
+{
+    const QFont baseFont = p.font();
+    const Frame f        = drawBackground(p, target);
+    if (f.plot.isEmpty()) return; // too small to draw
+
+    // series and annotations (clipped to the plot area)
+    p.save();
+    p.setFont(baseFont);
+    p.setClipRect(f.plot);
+    for (const PlotSeries *s : m_series) {
+        if (!s || !s->visible || s->isEmpty()) continue;
+        drawSeries(p, f, s, 0);
+    }
+    drawOverlays(p, f);
+    p.restore();
+}
+
+PlotRenderer::Frame PlotRenderer::drawBackground(QPainter &p, const QRectF &target) const
+{
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setRenderHint(QPainter::TextAntialiasing, true);
+    p.fillRect(target, Qt::white);
+
+    const QFontMetricsF fm(p.font());
+    const double labelH = fm.height();
+
+    // bold font for the axis titles
+    QFont axisTitleFont = p.font();
+    axisTitleFont.setBold(true);
+    const QFontMetricsF fmAT(axisTitleFont);
+    const double axisTitleH = fmAT.height();
+
+    // the chart title is bold and a step larger than the axis labels/titles
+    QFont chartTitleFont = axisTitleFont;
+    if (chartTitleFont.pointSizeF() > 0.0)
+        chartTitleFont.setPointSizeF(chartTitleFont.pointSizeF() * 1.25);
+    else if (chartTitleFont.pixelSize() > 0)
+        chartTitleFont.setPixelSize(static_cast<int>(chartTitleFont.pixelSize() * 1.25));
+    const QFontMetricsF fmCT(chartTitleFont);
+    const double chartTitleH = fmCT.height();
+
+    // axis ranges (guarded against a zero span)
+    double xmin = m_xaxis.min, xmax = m_xaxis.max;
+    double ymin = m_yaxis.min, ymax = m_yaxis.max;
+    ensureSpan(xmin, xmax);
+    ensureSpan(ymin, ymax);
+
+    // major tick values for both axes
+    const double xMajor              = PlotAxisMath::niceTickInterval(xmax - xmin);
+    const double yMajor              = PlotAxisMath::niceTickInterval(ymax - ymin);
+    const std::vector<double> xticks = PlotAxisMath::tickValues(xmin, xmax, xMajor);
+    const std::vector<double> yticks = PlotAxisMath::tickValues(ymin, ymax, yMajor);
+
+    // tick label formats chosen from the spacing so adjacent ticks stay distinct
+    const QString xfmt = effectiveFormat(m_xaxis.labelFormat, xMajor);
+    const QString yfmt = effectiveFormat(m_yaxis.labelFormat, yMajor);
+
+    // widest Y tick label drives the left margin
+    double maxYLabelW = 0.0;
+    for (double v : yticks)
+        maxYLabelW = std::max(maxYLabelW, fm.horizontalAdvance(labelText(v, yfmt)));
+
+    // margins
+    const bool hasTitle  = !m_title.isEmpty();
+    const bool hasXTitle = !m_xaxis.title.isEmpty();
+    const bool hasYTitle = !m_yaxis.title.isEmpty();
+
+    const double leftMargin =
+        OUTER + (hasYTitle ? axisTitleH + TITLE_GAP : 0.0) + maxYLabelW + LABEL_GAP + TICK_LEN;
+    const double bottomMargin =
+        OUTER + (hasXTitle ? axisTitleH + TITLE_GAP : 0.0) + labelH + LABEL_GAP + TICK_LEN;
+    const double topMargin = hasTitle ? (TITLE_VPAD + chartTitleH + TITLE_VPAD)
+                                      : (OUTER + 0.5 * labelH);
+    // leave room so the last X tick label is not clipped at the right edge
+    double lastXLabelW = 0.0;
+    if (!xticks.empty()) lastXLabelW = fm.horizontalAdvance(labelText(xticks.back(), xfmt));
+    const double rightMargin = OUTER + 0.5 * lastXLabelW;
+
+    QRectF plot(target.left() + leftMargin, target.top() + topMargin,
+                target.width() - leftMargin - rightMargin,
+                target.height() - topMargin - bottomMargin);
+    Frame f;
+    if (plot.width() <= 1.0 || plot.height() <= 1.0) return f; // too small to draw
+    f.plot = plot;
+    f.xmin = xmin;
+    f.xmax = xmax;
+    f.ymin = ymin;
+    f.ymax = ymax;
+
+    // coordinate mapping
+    auto mapX = [&f](double vx) { return f.mapX(vx); };
+    auto mapY = [&f](double vy) { return f.mapY(vy); };
+
+    // gridlines: dashed minor (lighter) first, then solid major (darker)
+    auto drawVLines = [&](const std::vector<double> &vals, const QPen &pen) {
+        p.setPen(pen);
+        for (double v : vals) {
+            const double x = mapX(v);
+            if (x < plot.left() - 0.5 || x > plot.right() + 0.5) continue;
+            p.drawLine(QPointF(x, plot.top()), QPointF(x, plot.bottom()));
+        }
+    };
+    auto drawHLines = [&](const std::vector<double> &vals, const QPen &pen) {
+        p.setPen(pen);
+        for (double v : vals) {
+            const double y = mapY(v);
+            if (y < plot.top() - 0.5 || y > plot.bottom() + 0.5) continue;
+            p.drawLine(QPointF(plot.left(), y), QPointF(plot.right(), y));
+        }
+    };
+
+    QPen majorPen(MAJOR_GRID);
+    majorPen.setWidth(0); // cosmetic 1px, solid
+    QPen minorPen(MINOR_GRID);
+    minorPen.setWidth(0);
+    minorPen.setStyle(Qt::DashLine);
+
+    const int xsub = std::max(0, m_xaxis.subTicks);
+    const int ysub = std::max(0, m_yaxis.subTicks);
+    if (m_xaxis.minorGridVisible && xsub > 0)
+        drawVLines(PlotAxisMath::tickValues(xmin, xmax, xMajor / (xsub + 1)), minorPen);
+    if (m_yaxis.minorGridVisible && ysub > 0)
+        drawHLines(PlotAxisMath::tickValues(ymin, ymax, yMajor / (ysub + 1)), minorPen);
+    if (m_xaxis.gridVisible) drawVLines(xticks, majorPen);
+    if (m_yaxis.gridVisible) drawHLines(yticks, majorPen);
+
+    // plot frame
+    {
+        QPen pen(FRAME_COLOR);
+        pen.setWidth(0);
+        p.setPen(pen);
+        p.setBrush(Qt::NoBrush);
+        p.drawRect(plot);
+    }
+
+    // ticks and tick labels
+    p.setPen(Qt::black);
+    for (double v : xticks) {
+        const double x = mapX(v);
+        if (x < plot.left() - 0.5 || x > plot.right() + 0.5) continue;
+        p.drawLine(QPointF(x, plot.bottom()), QPointF(x, plot.bottom() + TICK_LEN));
+        const QString lbl = labelText(v, xfmt);
+        const double w    = fm.horizontalAdvance(lbl);
+        p.drawText(QPointF(x - 0.5 * w, plot.bottom() + TICK_LEN + LABEL_GAP + fm.ascent()), lbl);
+    }
+    for (double v : yticks) {
+        const double y = mapY(v);
+        if (y < plot.top() - 0.5 || y > plot.bottom() + 0.5) continue;
+        p.drawLine(QPointF(plot.left() - TICK_LEN, y), QPointF(plot.left(), y));
+        const QString lbl = labelText(v, yfmt);
+        const double w    = fm.horizontalAdvance(lbl);
+        p.drawText(QPointF(plot.left() - TICK_LEN - LABEL_GAP - w,
+                           y + 0.5 * fm.ascent() - 0.5 * fm.descent()),
+                   lbl);
+    }
+
+    // axis titles: bold, base size
+    p.setPen(Qt::black);
+    p.setFont(axisTitleFont);
+    if (hasXTitle) {
+        const double w = fmAT.horizontalAdvance(m_xaxis.title);
+        p.drawText(QPointF(plot.center().x() - 0.5 * w, target.bottom() - OUTER - fmAT.descent()),
+                   m_xaxis.title);
+    }
+    if (hasYTitle) {
+        p.save();
+        const double w = fmAT.horizontalAdvance(m_yaxis.title);
+        p.translate(target.left() + OUTER + fmAT.ascent(), plot.center().y() + 0.5 * w);
+        p.rotate(-90.0);
+        p.drawText(QPointF(0.0, 0.0), m_yaxis.title);
+        p.restore();
+    }
+    // chart title: bold, a step larger, with extra padding above and below
+    if (hasTitle) {
+        p.setFont(chartTitleFont);
+        const double w = fmCT.horizontalAdvance(m_title);
+        p.drawText(QPointF(plot.center().x() - 0.5 * w, target.top() + TITLE_VPAD + fmCT.ascent()),
+                   m_title);
+    }
+    return f;
+}
+
+int PlotRenderer::drawSeries(QPainter &p, const Frame &f, const PlotSeries *s, int first) const
+{
+    // a whole long series is drawn from its level-of-detail reduction, computed at
+    // the device pixel resolution, which yields the same picture; appended points
+    // are few and drawn as they are
+    const double dpr  = p.device() ? p.device()->devicePixelRatioF() : 1.0;
+    const int lodW    = static_cast<int>(std::ceil(f.plot.width() * dpr));
+    const int lodH    = static_cast<int>(std::ceil(f.plot.height() * dpr));
+    const auto *lod   = (first == 0) ? lodIndices(s, f.xmin, f.xmax, f.ymin, f.ymax, lodW, lodH)
+                                     : nullptr;
+    const int npoints = lod ? static_cast<int>(lod->size()) : s->count();
+    auto index        = [lod](int i) { return lod ? static_cast<int>((*lod)[i]) : i; };
+
+    // points with a non-finite coordinate (e.g. not yet filled table cells) are
+    // skipped; they split a line into separate segments
+    if (s->type == PlotSeriesType::Line) {
+        QPen pen(s->color, s->width, s->style, Qt::RoundCap, Qt::RoundJoin);
+        p.setPen(pen);
+        p.setBrush(Qt::NoBrush);
+        QPolygonF poly;
+        poly.reserve(npoints - first);
+        for (int i = first; i < npoints; ++i) {
+            const double vx = s->x(index(i));
+            const double vy = s->y(index(i));
+            if (!std::isfinite(vx) || !std::isfinite(vy)) {
+                if (!poly.isEmpty()) p.drawPolyline(poly);
+                poly.clear();
+                continue;
+            }
+            poly << QPointF(f.mapX(vx), f.mapY(vy));
+        }
+        if (!poly.isEmpty()) p.drawPolyline(poly);
+    } else {
+        const double r = 0.5 * s->markerSize;
+        p.setPen(Qt::NoPen);
+        p.setBrush(s->color);
+        for (int i = first; i < npoints; ++i) {
+            const double vx = s->x(index(i));
+            const double vy = s->y(index(i));
+            if (std::isfinite(vx) && std::isfinite(vy))
+                p.drawEllipse(QPointF(f.mapX(vx), f.mapY(vy)), r, r);
+        }
+    }
+
+    // trailing points that are not finite yet may be filled in later
+    int last = s->count();
+    while ((last > first) && (!std::isfinite(s->x(last - 1)) || !std::isfinite(s->y(last - 1))))
+        --last;
+    return last;
+}
+
+void PlotRenderer::drawOverlays(QPainter &p, const Frame &f) const
+{
+    const QRectF &plot   = f.plot;
+    const QFont baseFont = p.font();
+    const QFontMetricsF fm(baseFont);
+    const double labelH = fm.height();
+    auto mapX           = [&f](double vx) { return f.mapX(vx); };
+    auto mapY           = [&f](double vy) { return f.mapY(vy); };
+
+    // reference-line labels: each line's RefAnchor positions the label along the
+    // line (top/center/bottom for vertical, left/center/right for horizontal); the
+    // window-wide style sets the font size, the perpendicular gap from the line,
+    // and an optional framed opaque background for readability over plot lines.
+    QFont refFont = baseFont;
+    if (m_refLabelSize > 0.0) refFont.setPointSizeF(m_refLabelSize);
+    const QFontMetricsF fmRef(refFont);
+    p.setFont(refFont);
+    for (const PlotSeries *s : m_series) {
+        if (!s || !s->visible || !s->isReference || s->refLabel.isEmpty()) continue;
+        if (s->count() < 2) continue;
+        const QString lbl   = s->refLabel;
+        const double tw     = fmRef.horizontalAdvance(lbl);
+        const bool vertical = s->x(0) == s->x(s->count() - 1);
+        double tx = 0.0, ty = 0.0; // text baseline origin
+        if (vertical) {
+            const double px = mapX(s->x(0));
+            if (px < plot.left() - 0.5 || px > plot.right() + 0.5) continue;
+            tx = px + m_refLabelDist;
+            if (tx + tw > plot.right()) tx = px - m_refLabelDist - tw; // flip near right edge
+            if (s->refAnchor == RefAnchor::Start)
+                ty = plot.top() + fmRef.ascent() + 2.0;
+            else if (s->refAnchor == RefAnchor::End)
+                ty = plot.bottom() - fmRef.descent() - 2.0;
+            else
+                ty = plot.center().y() + 0.5 * (fmRef.ascent() - fmRef.descent());
+        } else {
+            const double py = mapY(s->y(0));
+            if (py < plot.top() - 0.5 || py > plot.bottom() + 0.5) continue;
+            if (s->refAnchor == RefAnchor::Start)
+                tx = plot.left() + 2.0;
+            else if (s->refAnchor == RefAnchor::End)
+                tx = plot.right() - tw - 2.0;
+            else
+                tx = plot.center().x() - 0.5 * tw;
+            ty = py - m_refLabelDist;
+            if (ty - fmRef.ascent() < plot.top()) ty = py + fmRef.ascent() + m_refLabelDist; // flip
+        }
+        if (m_refLabelBoxed) {
+            const QRectF box(tx - 2.0, ty - fmRef.ascent() - 1.0, tw + 4.0, fmRef.height() + 2.0);
+            p.setPen(QPen(s->color, 0));
+            p.setBrush(QColor(255, 255, 255)); // opaque white for readability
+            p.drawRect(box);
+        }
+        p.setPen(s->color);
+        p.drawText(QPointF(tx, ty), lbl);
+    }
+
+    // optional legend in a chosen plot corner: one row per visible, named data
+    // series (raw / processed / fit / overlays). Reference lines and the unnamed
+    // marker-only mirror series are excluded; duplicate names (e.g. a line and its
+    // scatter twin in "Both" mode) collapse to a single row.
+    if (m_legendPos != LegendPos::Off) {
+        struct LegendEntry {
+            QString name;
+            QColor color;
+            bool line;
+        };
+        QList<LegendEntry> entries;
+        QList<QString> seen;
+        for (const PlotSeries *s : m_series) {
+            if (!s || !s->visible || s->isReference || s->name.isEmpty()) continue;
+            if (seen.contains(s->name)) continue;
+            seen.append(s->name);
+            entries.append({s->name, s->color, s->type == PlotSeriesType::Line});
+        }
+        if (!entries.isEmpty()) {
+            p.setFont(baseFont);
+            double maxTextW = 0.0;
+            for (const auto &e : entries)
+                maxTextW = std::max(maxTextW, fm.horizontalAdvance(e.name));
+            const double boxW = LEGEND_PAD + LEGEND_SWATCH + LEGEND_GAP + maxTextW + LEGEND_PAD;
+            const double boxH = LEGEND_PAD + entries.size() * labelH + LEGEND_PAD;
+            const bool right =
+                (m_legendPos == LegendPos::TopRight || m_legendPos == LegendPos::BottomRight);
+            const bool bottom =
+                (m_legendPos == LegendPos::BottomLeft || m_legendPos == LegendPos::BottomRight);
+            const double bx = right ? (plot.right() - LEGEND_INSET - boxW)
+                                    : (plot.left() + LEGEND_INSET);
+            const double by = bottom ? (plot.bottom() - LEGEND_INSET - boxH)
+                                     : (plot.top() + LEGEND_INSET);
+            QPen border(FRAME_COLOR);
+            border.setWidth(0);
+            p.setPen(border);
+            p.setBrush(QColor(255, 255, 255, 230)); // slightly translucent over the grid
+            p.drawRect(QRectF(bx, by, boxW, boxH));
+            double y = by + LEGEND_PAD;
+            for (const auto &e : entries) {
+                const double cy = y + 0.5 * labelH;
+                if (e.line) {
+                    p.setPen(QPen(e.color, 2.0));
+                    p.drawLine(QPointF(bx + LEGEND_PAD, cy),
+                               QPointF(bx + LEGEND_PAD + LEGEND_SWATCH, cy));
+                } else {
+                    p.setPen(Qt::NoPen);
+                    p.setBrush(e.color);
+                    p.drawEllipse(QPointF(bx + LEGEND_PAD + 0.5 * LEGEND_SWATCH, cy), 3.5, 3.5);
+                }
+                p.setPen(Qt::black);
+                p.drawText(QPointF(bx + LEGEND_PAD + LEGEND_SWATCH + LEGEND_GAP, y + fm.ascent()),
+                           e.name);
+                y += labelH;
+            }
+        }
+    }
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
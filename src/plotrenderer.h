@@ -0,0 +1,200 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef PLOTRENDERER_H
+#define PLOTRENDERER_H
+
+// Chart state and QPainter drawing code of the 2D line / scatter charts, without
+// any QWidget: linear axes with nice-number major ticks, minor subticks, major /
+// minor gridlines, printf-style tick labels, axis and chart titles, a legend,
+// and multiple line / scatter series including labeled reference lines.
+// PlotWidget shows a PlotRenderer on screen; since a PlotRenderer is a plain
+// object, one can also be created and painted into a QImage or an SVG
+// generator in any thread, e.g. by the batch rendering workers.
+// Series with far more points than the plot has pixels are drawn from a cached
+// level-of-detail reduction (see plotdecimate.h) that looks the same.
+
+#include "plotdecimate.h"
+#include "plotseries.h"
+
+#include <QHash>
+#include <QList>
+#include <QRectF>
+#include <QString>
+
+#include <vector>
+
+class QPainter;
+
+/** @brief Legend placement: off, or one of the four plot corners */
+enum class LegendPos { Off, TopLeft, TopRight, BottomLeft, BottomRight };
+
+/**
+ * @brief Chart state and QPainter renderer for the neutral chart model
+ *
+ * Series objects are referenced, not owned: the caller owns each PlotSeries and
+ * registers / unregisters it here.  A PlotRenderer is not a QObject and uses no
+ * widget state, so separate instances can be used in parallel threads.
+ */
+class PlotRenderer {
+public:
+    /** @brief Plot area and displayed ranges of one rendering */
+    struct Frame {
+        QRectF plot;                   ///< plot area in logical pixels (empty: too small)
+        double xmin = 0.0, xmax = 1.0; ///< displayed X range (non-zero span)
+        double ymin = 0.0, ymax = 1.0; ///< displayed Y range (non-zero span)
+        /** @brief Map an X value to a painter coordinate */
+        double mapX(double vx) const
+        {
+            return plot.left() + (vx - xmin) / (xmax - xmin) * plot.width();
+        }
+        /** @brief Map a Y value to a painter coordinate */
+        double mapY(double vy) const
+        {
+            return plot.bottom() - (vy - ymin) / (ymax - ymin) * plot.height();
+        }
+    };
+
+    /** @brief Set the chart title (drawn centered at the top) */
+    void setTitle(const QString &title) { m_title = title; }
+    /** @brief Get the chart title */
+    QString title() const { return m_title; }
+
+    /** @brief Set the X-axis title */
+    void setXTitle(const QString &title) { m_xaxis.title = title; }
+    /** @brief Get the X-axis title */
+    QString xTitle() const { return m_xaxis.title; }
+    /** @brief Set the Y-axis title */
+    void setYTitle(const QString &title) { m_yaxis.title = title; }
+    /** @brief Get the Y-axis title */
+    QString yTitle() const { return m_yaxis.title; }
+
+    /** @brief X-axis configuration */
+    const PlotAxis &xAxis() const { return m_xaxis; }
+    /** @brief Y-axis configuration */
+    const PlotAxis &yAxis() const { return m_yaxis; }
+
+    /** @brief Set the displayed X-axis range */
+    void setXRange(double min, double max);
+    /** @brief Set the displayed Y-axis range */
+    void setYRange(double min, double max);
+
+    /** @brief Set the printf-style tick label format of the X-axis */
+    void setXLabelFormat(const QString &fmt) { m_xaxis.labelFormat = fmt; }
+
+    /** @brief Toggle major and minor gridline visibility on both axes */
+    void setGrid(bool major, bool minor);
+
+    /**
+     * @brief Place a legend in one of the plot corners (or turn it off)
+     *
+     * The legend lists each visible, named data series (raw / processed / fit /
+     * overlays); reference lines and unnamed marker-only mirrors are excluded.
+     */
+    void setLegendPos(LegendPos pos) { m_legendPos = pos; }
+    /** @brief Legend placement */
+    LegendPos legendPos() const { return m_legendPos; }
+
+    /**
+     * @brief Style applied to all reference-line labels
+     * @param pointSize Label font point size (<= 0 keeps the default size)
+     * @param distance  Perpendicular gap between the label and its line, in px
+     * @param boxed     Draw a frame + opaque background behind each label
+     *
+     * The per-line label position along the line comes from each reference
+     * series' RefAnchor; this sets the window-wide font/offset/box appearance.
+     */
+    void setRefLabelStyle(double pointSize, double distance, bool boxed);
+
+    /**
+     * @brief Register a series for drawing (non-owning)
+     * @param series Series owned by the caller
+     * @return true if it was added, false if it is null or already present
+     */
+    bool addSeries(const PlotSeries *series);
+    /**
+     * @brief Remove a previously registered series (does not delete it)
+     * @return true if it was registered
+     */
+    bool removeSeries(const PlotSeries *series);
+    /** @brief Whether a series is currently registered */
+    bool hasSeries(const PlotSeries *series) const { return m_series.contains(series); }
+    /**
+     * @brief Unregister all series (does not delete them)
+     * @return true if any series was registered
+     */
+    bool clearSeries();
+    /** @brief Registered series, in drawing order */
+    const QList<const PlotSeries *> &series() const { return m_series; }
+
+    /**
+     * @brief Paint the complete chart
+     * @param p      Painter on any paint device (a widget, a QImage, an SVG generator)
+     * @param target Area to fill, in the painter's logical coordinates
+     *
+     * Text is drawn in the painter's font.
+     */
+    void render(QPainter &p, const QRectF &target) const;
+
+    /** @brief Paint background, gridlines, frame, ticks and titles; returns the layout */
+    Frame drawBackground(QPainter &p, const QRectF &target) const;
+    /**
+     * @brief Paint the points of a series starting at a given index
+     * @param first Index of the first point to paint; 0 paints the whole series
+     *              (from its level-of-detail reduction if it is long)
+     * @return Number of points up to and including the last finite one
+     */
+    int drawSeries(QPainter &p, const Frame &f, const PlotSeries *s, int first) const;
+    /** @brief Paint the reference-line labels and the legend */
+    void drawOverlays(QPainter &p, const Frame &f) const;
+
+private:
+    /**
+     * @brief Level-of-detail reduction of a long series for the current view
+     * @param s      Series to draw
+     * @param xmin,xmax,ymin,ymax Displayed axis ranges
+     * @param width,height        Plot area size in device pixels
+     * @return Indices of the points to draw, or nullptr if all points must be drawn
+     *
+     * The reduction is cached per series; it is rebuilt when the series data is
+     * replaced or the view changes and extended when points are appended.
+     */
+    const std::vector<std::size_t> *lodIndices(const PlotSeries *s, double xmin, double xmax,
+                                               double ymin, double ymax, int width,
+                                               int height) const;
+
+    /** @brief Cached level-of-detail reduction of one series */
+    struct LodCache {
+        unsigned int revision = 0;            ///< series revision it was built for
+        int count             = 0;            ///< number of points processed
+        double xmin = 0.0, xmax = 0.0;        ///< x range it was built for
+        double ymin = 0.0, ymax = 0.0;        ///< y range it was built for (markers only)
+        int width = 0, height = 0;            ///< plot size it was built for
+        PlotDecimate::LineEnvelope line;      ///< reduction of a Line series
+        PlotDecimate::MarkerThinning markers; ///< reduction of a Scatter series
+    };
+
+    PlotAxis m_xaxis;                       ///< X-axis configuration
+    PlotAxis m_yaxis;                       ///< Y-axis configuration
+    QString m_title;                        ///< chart title
+    QList<const PlotSeries *> m_series;     ///< registered series (not owned)
+    LegendPos m_legendPos = LegendPos::Off; ///< legend placement (corner, or off)
+    double m_refLabelSize = 0.0;            ///< reference-label font point size (0 = default)
+    double m_refLabelDist = 4.0;            ///< reference-label gap from its line (px)
+    bool m_refLabelBoxed  = false;          ///< frame + opaque background behind ref labels
+    mutable QHash<const PlotSeries *, LodCache> m_lod; ///< per-series level-of-detail cache
+};
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -13,9 +13,11 @@
 #define PLOTSERIES_H
 
 // Neutral value types describing what to draw on a chart.
-// They depend only on Qt value types (QtCore / QtGui).
+// They depend only on Qt value types (QtCore / QtGui) and the PlotData table.
 // PlotWidget consumes these directly.
 
+#include "plotdata.h"
+
 #include <QColor>
 #include <QList>
 #include <QPointF>
@@ -36,10 +38,20 @@ enum class RefAnchor { Start, Center, End };
  * @brief One data series in the neutral chart model
  *
  * Carries the points plus the minimal styling the native renderer needs.
+ * The points are either stored in the series itself, or the series is a view
+ * of two columns of a PlotData table owned elsewhere (see setView()), so that
+ * many series can share one x column without copying it.  Readers should use
+ * count(), x(), y(), and at(), which work for both kinds of storage.  Data must
+ * only be changed through append(), replace(), edit(), or setView(), or by appending
+ * rows to the viewed table, so that renderers caching a reduced copy of the
+ * points (see PlotWidget) can tell appended points from replaced ones.
  */
 struct PlotSeries {
     PlotSeriesType type = PlotSeriesType::Line; ///< line vs. scatter rendering
-    QList<QPointF> points;                      ///< data points in axis coordinates
+    QList<QPointF> points;                      ///< data points in axis coordinates (owned storage)
+    const PlotData *table = nullptr;            ///< viewed table (not owned), or nullptr
+    int xcol              = 0;                  ///< x column of the viewed table
+    int ycol              = 0;                  ///< y column of the viewed table
     QColor color       = Qt::black;             ///< line / marker color
     qreal width        = 1.0;                   ///< line width (Line series)
     Qt::PenStyle style = Qt::SolidLine;         ///< line style, e.g. dashed reference lines
@@ -48,18 +60,57 @@ struct PlotSeries {
     bool visible     = true;                    ///< whether the series is drawn
     bool isReference = false;                   ///< draw as a labeled reference line
     QString refLabel;                           ///< text drawn next to a reference line
-    RefAnchor refAnchor = RefAnchor::Start;     ///< where the label sits along the line
+    RefAnchor refAnchor   = RefAnchor::Start;   ///< where the label sits along the line
+    unsigned int revision = 0;                  ///< bumped when the data is replaced
 
     // convenience accessors for the chart code, so callers need not poke the
     // points list directly
-    /** @brief Append one (x, y) point */
+    /** @brief Append one (x, y) point (owned storage only) */
     void append(double x, double y) { points.append(QPointF(x, y)); }
-    /** @brief Replace all points */
-    void replace(const QList<QPointF> &p) { points = p; }
+    /** @brief Replace all points, ending any view */
+    void replace(const QList<QPointF> &p)
+    {
+        table  = nullptr;
+        points = p;
+        ++revision;
+    }
+    /**
+     * @brief Write access to the owned points, ending any view
+     *
+     * Counts as replacing the data, so it must be called again for every change.
+     */
+    QList<QPointF> &edit()
+    {
+        table = nullptr;
+        ++revision;
+        return points;
+    }
+    /**
+     * @brief Turn the series into a view of two columns of a table
+     * @param data Table holding the data; must outlive the view
+     * @param xc   Column with the x values
+     * @param yc   Column with the y values
+     */
+    void setView(const PlotData *data, int xc, int yc)
+    {
+        points.clear();
+        table = data;
+        xcol  = xc;
+        ycol  = yc;
+        ++revision;
+    }
+    /** @brief Whether the series is a view of a table */
+    bool isView() const { return table != nullptr; }
     /** @brief Number of points */
-    int count() const { return static_cast<int>(points.size()); }
+    int count() const { return table ? table->rowCount() : static_cast<int>(points.size()); }
+    /** @brief Whether the series has no points */
+    bool isEmpty() const { return count() == 0; }
+    /** @brief X value of point i */
+    double x(int i) const { return table ? table->value(i, xcol) : points.at(i).x(); }
+    /** @brief Y value of point i */
+    double y(int i) const { return table ? table->value(i, ycol) : points.at(i).y(); }
     /** @brief Point at index i */
-    QPointF at(int i) const { return points.at(i); }
+    QPointF at(int i) const { return table ? QPointF(x(i), y(i)) : points.at(i); }
     /** @brief Set visibility */
     void setVisible(bool v) { visible = v; }
     /** @brief Whether the series is visible */
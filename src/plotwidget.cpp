@@ -11,65 +11,11 @@
 
 #include "plotwidget.h"
 
-#include "plotaxismath.h"
-
-#include <QFont>
-#include <QFontMetricsF>
 #include <QPaintEvent>
 #include <QPainter>
-#include <QPen>
-#include <QPolygonF>
-#include <QRectF>
 
 #include <algorithm>
-
-namespace {
-
-// layout constants (logical pixels)
-constexpr double OUTER      = 10.0; ///< outer padding around the whole chart
-constexpr double TITLE_GAP  = 8.0;  ///< gap between an axis title and the adjacent labels/plot
-constexpr double TITLE_VPAD = 12.0; ///< padding above and below the chart title
-constexpr double LABEL_GAP  = 5.0;  ///< gap between tick labels and the axis
-constexpr double TICK_LEN   = 5.0;  ///< length of axis tick marks
-
-// legend box layout (logical pixels)
-constexpr double LEGEND_INSET  = 8.0;  ///< inset from the top-left plot corner
-constexpr double LEGEND_PAD    = 5.0;  ///< padding inside the legend box
-constexpr double LEGEND_SWATCH = 20.0; ///< width of a legend color swatch
-constexpr double LEGEND_GAP    = 6.0;  ///< gap between swatch and label text
-
-// gridline / frame colors
-const QColor MAJOR_GRID(160, 160, 160);
-const QColor MINOR_GRID(208, 208, 208);
-const QColor FRAME_COLOR(80, 80, 80);
-
-// Ensure a strictly positive span so coordinate mapping never divides by zero.
-void ensureSpan(double &min, double &max)
-{
-    if (!(max > min)) {
-        const double mid = 0.5 * (min + max);
-        min              = mid - 0.5;
-        max              = mid + 0.5;
-    }
-}
-
-QString labelText(double value, const QString &format)
-{
-    return QString::fromStdString(PlotAxisMath::formatAxisLabel(value, format.toStdString()));
-}
-
-// Pick a tick-label format: keep an explicit integer format when ticks are at
-// least 1 apart (e.g. integer time steps); otherwise derive the number of
-// decimals from the tick spacing so closely spaced ticks do not collapse to
-// identical labels.
-QString effectiveFormat(const QString &fmt, double interval)
-{
-    const bool integerFmt = fmt.contains('d') || fmt.contains('i');
-    if (integerFmt && interval >= 1.0) return fmt;
-    return QStringLiteral("%.%1f").arg(PlotAxisMath::tickDecimals(interval));
-}
-
-} // namespace
+#include <cmath>
 
 PlotWidget::PlotWidget(QWidget *parent) : QWidget(parent)
 {
@@ -79,403 +25,200 @@ PlotWidget::PlotWidget(QWidget *parent) : QWidget(parent)
 
 void PlotWidget::setTitle(const QString &title)
 {
-    m_title = title;
+    m_chart.setTitle(title);
+    m_cacheValid = false;
     update();
 }
 
 void PlotWidget::setXTitle(const QString &title)
 {
-    m_xaxis.title = title;
+    m_chart.setXTitle(title);
+    m_cacheValid = false;
     update();
 }
 
 QString PlotWidget::xTitle() const
 {
-    return m_xaxis.title;
+    return m_chart.xTitle();
 }
 
 void PlotWidget::setYTitle(const QString &title)
 {
-    m_yaxis.title = title;
+    m_chart.setYTitle(title);
+    m_cacheValid = false;
     update();
 }
 
 QString PlotWidget::yTitle() const
 {
-    return m_yaxis.title;
+    return m_chart.yTitle();
 }
 
 void PlotWidget::setXRange(double min, double max)
 {
-    m_xaxis.min = min;
-    m_xaxis.max = max;
+    if ((m_chart.xAxis().min != min) || (m_chart.xAxis().max != max)) m_cacheValid = false;
+    m_chart.setXRange(min, max);
     update();
 }
 
 void PlotWidget::setYRange(double min, double max)
 {
-    m_yaxis.min = min;
-    m_yaxis.max = max;
+    if ((m_chart.yAxis().min != min) || (m_chart.yAxis().max != max)) m_cacheValid = false;
+    m_chart.setYRange(min, max);
     update();
 }
 
 void PlotWidget::setXLabelFormat(const QString &fmt)
 {
-    m_xaxis.labelFormat = fmt;
+    m_chart.setXLabelFormat(fmt);
+    m_cacheValid = false;
     update();
 }
 
 void PlotWidget::setGrid(bool major, bool minor)
 {
-    m_xaxis.gridVisible = m_yaxis.gridVisible = major;
-    m_xaxis.minorGridVisible = m_yaxis.minorGridVisible = minor;
+    m_chart.setGrid(major, minor);
+    m_cacheValid = false;
     update();
 }
 
 void PlotWidget::setLegendPos(LegendPos pos)
 {
-    if (m_legendPos != pos) {
-        m_legendPos = pos;
+    if (m_chart.legendPos() != pos) {
+        m_chart.setLegendPos(pos);
         update();
     }
 }
 
 void PlotWidget::setRefLabelStyle(double pointSize, double distance, bool boxed)
 {
-    m_refLabelSize  = pointSize;
-    m_refLabelDist  = distance;
-    m_refLabelBoxed = boxed;
+    m_chart.setRefLabelStyle(pointSize, distance, boxed);
     update();
 }
 
 void PlotWidget::addSeries(const PlotSeries *series)
 {
-    if (series && !m_series.contains(series)) {
-        m_series.append(series);
+    if (m_chart.addSeries(series)) {
+        m_cacheValid = false;
         update();
     }
 }
 
 void PlotWidget::removeSeries(const PlotSeries *series)
 {
-    if (m_series.removeAll(series) > 0) update();
+    if (m_chart.removeSeries(series)) {
+        m_cacheValid = false;
+        update();
+    }
 }
 
 bool PlotWidget::hasSeries(const PlotSeries *series) const
 {
-    return m_series.contains(series);
+    return m_chart.hasSeries(series);
 }
 
 void PlotWidget::clearSeries()
 {
-    if (!m_series.isEmpty()) {
-        m_series.clear();
+    if (m_chart.clearSeries()) {
+        m_cacheValid = false;
         update();
     }
 }
 
-void PlotWidget::paintEvent(QPaintEvent *)
-{
-    QPainter p(this);
-    doRender(p, QRectF(rect()));
-}
-
-QSize PlotWidget::sizeHint() const
+void PlotWidget::setIncremental(bool enable)
 {
-    return {400, 300};
+    if (m_incremental == enable) return;
+    m_incremental = enable;
+    m_cacheValid  = false;
+    m_drawn.clear();
+    if (!enable) m_cache = QPixmap();
+    update();
 }
 
-void PlotWidget::doRender(QPainter &p, const QRectF &target) const
+void PlotWidget::paintEvent(QPaintEvent *)
 {
+    QPainter p(this);
+    if (!m_incremental) {
+        m_chart.render(p, QRectF(rect()));
+        return;
+    }
+    updateCache();
+    p.drawPixmap(0, 0, m_cache);
+    if (m_cacheFrame.plot.isEmpty()) return;
     p.setRenderHint(QPainter::Antialiasing, true);
     p.setRenderHint(QPainter::TextAntialiasing, true);
-    p.fillRect(target, Qt::white);
-
-    const QFont baseFont = p.font();
-    const QFontMetricsF fm(p.font());
-    const double labelH = fm.height();
-
-    // bold font for the axis titles
-    QFont axisTitleFont = p.font();
-    axisTitleFont.setBold(true);
-    const QFontMetricsF fmAT(axisTitleFont);
-    const double axisTitleH = fmAT.height();
-
-    // the chart title is bold and a step larger than the axis labels/titles
-    QFont chartTitleFont = axisTitleFont;
-    if (chartTitleFont.pointSizeF() > 0.0)
-        chartTitleFont.setPointSizeF(chartTitleFont.pointSizeF() * 1.25);
-    else if (chartTitleFont.pixelSize() > 0)
-        chartTitleFont.setPixelSize(static_cast<int>(chartTitleFont.pixelSize() * 1.25));
-    const QFontMetricsF fmCT(chartTitleFont);
-    const double chartTitleH = fmCT.height();
-
-    // axis ranges (guarded against a zero span)
-    double xmin = m_xaxis.min, xmax = m_xaxis.max;
-    double ymin = m_yaxis.min, ymax = m_yaxis.max;
-    ensureSpan(xmin, xmax);
-    ensureSpan(ymin, ymax);
-
-    // major tick values for both axes
-    const double xMajor              = PlotAxisMath::niceTickInterval(xmax - xmin);
-    const double yMajor              = PlotAxisMath::niceTickInterval(ymax - ymin);
-    const std::vector<double> xticks = PlotAxisMath::tickValues(xmin, xmax, xMajor);
-    const std::vector<double> yticks = PlotAxisMath::tickValues(ymin, ymax, yMajor);
-
-    // tick label formats chosen from the spacing so adjacent ticks stay distinct
-    const QString xfmt = effectiveFormat(m_xaxis.labelFormat, xMajor);
-    const QString yfmt = effectiveFormat(m_yaxis.labelFormat, yMajor);
-
-    // widest Y tick label drives the left margin
-    double maxYLabelW = 0.0;
-    for (double v : yticks)
-        maxYLabelW = std::max(maxYLabelW, fm.horizontalAdvance(labelText(v, yfmt)));
-
-    // margins
-    const bool hasTitle  = !m_title.isEmpty();
-    const bool hasXTitle = !m_xaxis.title.isEmpty();
-    const bool hasYTitle = !m_yaxis.title.isEmpty();
-
-    const double leftMargin =
-        OUTER + (hasYTitle ? axisTitleH + TITLE_GAP : 0.0) + maxYLabelW + LABEL_GAP + TICK_LEN;
-    const double bottomMargin =
-        OUTER + (hasXTitle ? axisTitleH + TITLE_GAP : 0.0) + labelH + LABEL_GAP + TICK_LEN;
-    const double topMargin = hasTitle ? (TITLE_VPAD + chartTitleH + TITLE_VPAD)
-                                      : (OUTER + 0.5 * labelH);
-    // leave room so the last X tick label is not clipped at the right edge
-    double lastXLabelW = 0.0;
-    if (!xticks.empty()) lastXLabelW = fm.horizontalAdvance(labelText(xticks.back(), xfmt));
-    const double rightMargin = OUTER + 0.5 * lastXLabelW;
-
-    QRectF plot(target.left() + leftMargin, target.top() + topMargin,
-                target.width() - leftMargin - rightMargin,
-                target.height() - topMargin - bottomMargin);
-    if (plot.width() <= 1.0 || plot.height() <= 1.0) return; // too small to draw
-
-    // coordinate mapping
-    auto mapX = [&](double vx) {
-        return plot.left() + (vx - xmin) / (xmax - xmin) * plot.width();
-    };
-    auto mapY = [&](double vy) {
-        return plot.bottom() - (vy - ymin) / (ymax - ymin) * plot.height();
-    };
-
-    // gridlines: dashed minor (lighter) first, then solid major (darker)
-    auto drawVLines = [&](const std::vector<double> &vals, const QPen &pen) {
-        p.setPen(pen);
-        for (double v : vals) {
-            const double x = mapX(v);
-            if (x < plot.left() - 0.5 || x > plot.right() + 0.5) continue;
-            p.drawLine(QPointF(x, plot.top()), QPointF(x, plot.bottom()));
-        }
-    };
-    auto drawHLines = [&](const std::vector<double> &vals, const QPen &pen) {
-        p.setPen(pen);
-        for (double v : vals) {
-            const double y = mapY(v);
-            if (y < plot.top() - 0.5 || y > plot.bottom() + 0.5) continue;
-            p.drawLine(QPointF(plot.left(), y), QPointF(plot.right(), y));
-        }
-    };
-
-    QPen majorPen(MAJOR_GRID);
-    majorPen.setWidth(0); // cosmetic 1px, solid
-    QPen minorPen(MINOR_GRID);
-    minorPen.setWidth(0);
-    minorPen.setStyle(Qt::DashLine);
-
-    const int xsub = std::max(0, m_xaxis.subTicks);
-    const int ysub = std::max(0, m_yaxis.subTicks);
-    if (m_xaxis.minorGridVisible && xsub > 0)
-        drawVLines(PlotAxisMath::tickValues(xmin, xmax, xMajor / (xsub + 1)), minorPen);
-    if (m_yaxis.minorGridVisible && ysub > 0)
-        drawHLines(PlotAxisMath::tickValues(ymin, ymax, yMajor / (ysub + 1)), minorPen);
-    if (m_xaxis.gridVisible) drawVLines(xticks, majorPen);
-    if (m_yaxis.gridVisible) drawHLines(yticks, majorPen);
-
-    // plot frame
-    {
-        QPen pen(FRAME_COLOR);
-        pen.setWidth(0);
-        p.setPen(pen);
-        p.setBrush(Qt::NoBrush);
-        p.drawRect(plot);
-    }
-
-    // ticks and tick labels
-    p.setPen(Qt::black);
-    for (double v : xticks) {
-        const double x = mapX(v);
-        if (x < plot.left() - 0.5 || x > plot.right() + 0.5) continue;
-        p.drawLine(QPointF(x, plot.bottom()), QPointF(x, plot.bottom() + TICK_LEN));
-        const QString lbl = labelText(v, xfmt);
-        const double w    = fm.horizontalAdvance(lbl);
-        p.drawText(QPointF(x - 0.5 * w, plot.bottom() + TICK_LEN + LABEL_GAP + fm.ascent()), lbl);
-    }
-    for (double v : yticks) {
-        const double y = mapY(v);
-        if (y < plot.top() - 0.5 || y > plot.bottom() + 0.5) continue;
-        p.drawLine(QPointF(plot.left() - TICK_LEN, y), QPointF(plot.left(), y));
-        const QString lbl = labelText(v, yfmt);
-        const double w    = fm.horizontalAdvance(lbl);
-        p.drawText(QPointF(plot.left() - TICK_LEN - LABEL_GAP - w,
-                           y + 0.5 * fm.ascent() - 0.5 * fm.descent()),
-                   lbl);
-    }
+    p.setClipRect(m_cacheFrame.plot);
+    m_chart.drawOverlays(p, m_cacheFrame);
+}
 
-    // axis titles: bold, base size
-    p.setPen(Qt::black);
-    p.setFont(axisTitleFont);
-    if (hasXTitle) {
-        const double w = fmAT.horizontalAdvance(m_xaxis.title);
-        p.drawText(QPointF(plot.center().x() - 0.5 * w, target.bottom() - OUTER - fmAT.descent()),
-                   m_xaxis.title);
-    }
-    if (hasYTitle) {
-        p.save();
-        const double w = fmAT.horizontalAdvance(m_yaxis.title);
-        p.translate(target.left() + OUTER + fmAT.ascent(), plot.center().y() + 0.5 * w);
-        p.rotate(-90.0);
-        p.drawText(QPointF(0.0, 0.0), m_yaxis.title);
-        p.restore();
-    }
-    // chart title: bold, a step larger, with extra padding above and below
-    if (hasTitle) {
-        p.setFont(chartTitleFont);
-        const double w = fmCT.horizontalAdvance(m_title);
-        p.drawText(QPointF(plot.center().x() - 0.5 * w, target.top() + TITLE_VPAD + fmCT.ascent()),
-                   m_title);
+bool PlotWidget::canAppend() const
+{
+    const QList<const PlotSeries *> &series = m_chart.series();
+    if (!m_cacheValid || (m_drawn.size() != series.size())) return false;
+    for (int i = 0; i < series.size(); ++i) {
+        const PlotSeries *s  = series[i];
+        const DrawnSeries &d = m_drawn[i];
+        if ((d.series != s) || (d.revision != s->revision) || (d.type != s->type) ||
+            (d.visible != s->visible) || (d.color != s->color) || (d.width != s->width) ||
+            (d.style != s->style) || (d.markerSize != s->markerSize) || (s->count() < d.drawn))
+            return false;
     }
-
-    // series (clipped to the plot area)
-    p.save();
-    p.setClipRect(plot);
-    for (const PlotSeries *s : m_series) {
-        if (!s || !s->visible || s->points.isEmpty()) continue;
-        if (s->type == PlotSeriesType::Line) {
-            QPolygonF poly;
-            poly.reserve(s->points.size());
-            for (const QPointF &pt : s->points)
-                poly << QPointF(mapX(pt.x()), mapY(pt.y()));
-            QPen pen(s->color, s->width, s->style, Qt::RoundCap, Qt::RoundJoin);
-            p.setPen(pen);
-            p.setBrush(Qt::NoBrush);
-            p.drawPolyline(poly);
-        } else {
-            const double r = 0.5 * s->markerSize;
-            p.setPen(Qt::NoPen);
-            p.setBrush(s->color);
-            for (const QPointF &pt : s->points)
-                p.drawEllipse(QPointF(mapX(pt.x()), mapY(pt.y())), r, r);
+    return true;
+}
+
+void PlotWidget::updateCache()
+{
+    const double dpr = devicePixelRatioF();
+    const QSize pixels(static_cast<int>(std::ceil(width() * dpr)),
+                       static_cast<int>(std::ceil(height() * dpr)));
+    if ((m_cache.size() != pixels) || (m_cache.devicePixelRatioF() != dpr)) m_cacheValid = false;
+
+    if (canAppend()) {
+        // stroke only what was appended since the last paint
+        if (m_cacheFrame.plot.isEmpty()) return;
+        QPainter p(&m_cache);
+        p.setRenderHint(QPainter::Antialiasing, true);
+        p.setClipRect(m_cacheFrame.plot);
+        for (int i = 0; i < m_chart.series().size(); ++i) {
+            const PlotSeries *s = m_chart.series()[i];
+            DrawnSeries &d      = m_drawn[i];
+            if (!s->visible || (s->count() == d.drawn)) continue;
+            // a line continues from its last painted point
+            const bool line = (s->type == PlotSeriesType::Line);
+            const int first = line ? std::max(0, d.drawn - 1) : d.drawn;
+            d.drawn         = std::max(d.drawn, m_chart.drawSeries(p, m_cacheFrame, s, first));
         }
+        return;
     }
 
-    // reference-line labels: each line's RefAnchor positions the label along the
-    // line (top/center/bottom for vertical, left/center/right for horizontal); the
-    // window-wide style sets the font size, the perpendicular gap from the line,
-    // and an optional framed opaque background for readability over plot lines.
-    QFont refFont = baseFont;
-    if (m_refLabelSize > 0.0) refFont.setPointSizeF(m_refLabelSize);
-    const QFontMetricsF fmRef(refFont);
-    p.setFont(refFont);
-    for (const PlotSeries *s : m_series) {
-        if (!s || !s->visible || !s->isReference || s->refLabel.isEmpty()) continue;
-        if (s->points.size() < 2) continue;
-        const QString lbl   = s->refLabel;
-        const double tw     = fmRef.horizontalAdvance(lbl);
-        const bool vertical = s->points.first().x() == s->points.last().x();
-        double tx = 0.0, ty = 0.0; // text baseline origin
-        if (vertical) {
-            const double px = mapX(s->points.first().x());
-            if (px < plot.left() - 0.5 || px > plot.right() + 0.5) continue;
-            tx = px + m_refLabelDist;
-            if (tx + tw > plot.right()) tx = px - m_refLabelDist - tw; // flip near right edge
-            if (s->refAnchor == RefAnchor::Start)
-                ty = plot.top() + fmRef.ascent() + 2.0;
-            else if (s->refAnchor == RefAnchor::End)
-                ty = plot.bottom() - fmRef.descent() - 2.0;
-            else
-                ty = plot.center().y() + 0.5 * (fmRef.ascent() - fmRef.descent());
-        } else {
-            const double py = mapY(s->points.first().y());
-            if (py < plot.top() - 0.5 || py > plot.bottom() + 0.5) continue;
-            if (s->refAnchor == RefAnchor::Start)
-                tx = plot.left() + 2.0;
-            else if (s->refAnchor == RefAnchor::End)
-                tx = plot.right() - tw - 2.0;
-            else
-                tx = plot.center().x() - 0.5 * tw;
-            ty = py - m_refLabelDist;
-            if (ty - fmRef.ascent() < plot.top()) ty = py + fmRef.ascent() + m_refLabelDist; // flip
-        }
-        if (m_refLabelBoxed) {
-            const QRectF box(tx - 2.0, ty - fmRef.ascent() - 1.0, tw + 4.0, fmRef.height() + 2.0);
-            p.setPen(QPen(s->color, 0));
-            p.setBrush(QColor(255, 255, 255)); // opaque white for readability
-            p.drawRect(box);
-        }
-        p.setPen(s->color);
-        p.drawText(QPointF(tx, ty), lbl);
+    // full redraw
+    if (m_cache.size() != pixels) m_cache = QPixmap(pixels);
+    m_cache.setDevicePixelRatio(dpr);
+    m_drawn.clear();
+    QPainter p(&m_cache);
+    p.setFont(font());
+    m_cacheFrame = m_chart.drawBackground(p, QRectF(rect()));
+    m_cacheValid = true;
+    if (m_cacheFrame.plot.isEmpty()) return; // too small to draw; canAppend() fails
+    p.setClipRect(m_cacheFrame.plot);
+    for (const PlotSeries *s : m_chart.series()) {
+        DrawnSeries d;
+        d.series     = s;
+        d.revision   = s->revision;
+        d.type       = s->type;
+        d.visible    = s->visible;
+        d.color      = s->color;
+        d.width      = s->width;
+        d.style      = s->style;
+        d.markerSize = s->markerSize;
+        if (s->visible && !s->isEmpty()) d.drawn = m_chart.drawSeries(p, m_cacheFrame, s, 0);
+        m_drawn.append(d);
     }
+}
 
-    // optional legend in a chosen plot corner: one row per visible, named data
-    // series (raw / processed / fit / overlays). Reference lines and the unnamed
-    // marker-only mirror series are excluded; duplicate names (e.g. a line and its
-    // scatter twin in "Both" mode) collapse to a single row.
-    if (m_legendPos != LegendPos::Off) {
-        struct LegendEntry {
-            QString name;
-            QColor color;
-            bool line;
-        };
-        QList<LegendEntry> entries;
-        QList<QString> seen;
-        for (const PlotSeries *s : m_series) {
-            if (!s || !s->visible || s->isReference || s->name.isEmpty()) continue;
-            if (seen.contains(s->name)) continue;
-            seen.append(s->name);
-            entries.append({s->name, s->color, s->type == PlotSeriesType::Line});
-        }
-        if (!entries.isEmpty()) {
-            p.setFont(baseFont);
-            double maxTextW = 0.0;
-            for (const auto &e : entries)
-                maxTextW = std::max(maxTextW, fm.horizontalAdvance(e.name));
-            const double boxW = LEGEND_PAD + LEGEND_SWATCH + LEGEND_GAP + maxTextW + LEGEND_PAD;
-            const double boxH = LEGEND_PAD + entries.size() * labelH + LEGEND_PAD;
-            const bool right =
-                (m_legendPos == LegendPos::TopRight || m_legendPos == LegendPos::BottomRight);
-            const bool bottom =
-                (m_legendPos == LegendPos::BottomLeft || m_legendPos == LegendPos::BottomRight);
-            const double bx = right ? (plot.right() - LEGEND_INSET - boxW)
-                                    : (plot.left() + LEGEND_INSET);
-            const double by = bottom ? (plot.bottom() - LEGEND_INSET - boxH)
-                                     : (plot.top() + LEGEND_INSET);
-            QPen border(FRAME_COLOR);
-            border.setWidth(0);
-            p.setPen(border);
-            p.setBrush(QColor(255, 255, 255, 230)); // slightly translucent over the grid
-            p.drawRect(QRectF(bx, by, boxW, boxH));
-            double y = by + LEGEND_PAD;
-            for (const auto &e : entries) {
-                const double cy = y + 0.5 * labelH;
-                if (e.line) {
-                    p.setPen(QPen(e.color, 2.0));
-                    p.drawLine(QPointF(bx + LEGEND_PAD, cy),
-                               QPointF(bx + LEGEND_PAD + LEGEND_SWATCH, cy));
-                } else {
-                    p.setPen(Qt::NoPen);
-                    p.setBrush(e.color);
-                    p.drawEllipse(QPointF(bx + LEGEND_PAD + 0.5 * LEGEND_SWATCH, cy), 3.5, 3.5);
-                }
-                p.setPen(Qt::black);
-                p.drawText(QPointF(bx + LEGEND_PAD + LEGEND_SWATCH + LEGEND_GAP, y + fm.ascent()),
-                           e.name);
-                y += labelH;
-            }
-        }
-    }
-    p.restore();
+QSize PlotWidget::sizeHint() const
+{
+    return {400, 300};
 }
 
 // Local Variables:
@@ -12,30 +12,31 @@
 #ifndef PLOTWIDGET_H
 #define PLOTWIDGET_H
 
-// Lightweight 2D line / scatter chart drawn directly with QPainter, with
+// Lightweight 2D line / scatter chart widget drawn directly with QPainter, with
 // no dependency on any Qt charts module.  It consumes the neutral PlotSeries / PlotAxis
-// model and reproduces the subset of chart features that LAMMPS-GUI actually uses:
-// linear axes with nice-number major ticks, minor subticks, major / minor gridlines,
-// printf-style tick labels, axis and chart titles, and multiple line / scatter
-// series including dashed reference lines. Zoom is programmatic (setXRange / setYRange);
-// there is no in-widget mouse interaction (the chart window drives ranges externally).
-
+// model; the chart state and the drawing code live in PlotRenderer (see
+// plotrenderer.h), which this widget shows on screen.  Zoom is programmatic
+// (setXRange / setYRange); there is no in-widget mouse interaction (the chart
+// window drives ranges externally).
+// In incremental mode (used during live runs) the axes and series are kept in
+// an offscreen pixmap and updates that only append points stroke just the new
+// segments.
+
+#include "plotrenderer.h"
 #include "plotseries.h"
 
 #include <QList>
+#include <QPixmap>
+#include <QRectF>
 #include <QSize>
 #include <QString>
 #include <QWidget>
 
 class QPainter;
 class QPaintEvent;
-class QRectF;
-
-/** @brief Legend placement: off, or one of the four plot corners */
-enum class LegendPos { Off, TopLeft, TopRight, BottomLeft, BottomRight };
 
 /**
- * @brief QPainter-based renderer for the neutral chart model
+ * @brief Widget showing a PlotRenderer chart
  *
  * Series objects are referenced, not owned: the caller owns each PlotSeries and
  * registers / unregisters it here, then calls update() after changing its data or style.
@@ -102,6 +103,34 @@ public:
     /** @brief Unregister all series (does not delete them) */
     void clearSeries();
 
+    /**
+     * @brief Toggle incremental painting
+     *
+     * When enabled, the axes, gridlines, titles and series are painted into an
+     * offscreen pixmap that is reused by later paint events: if the ranges, the
+     * size, the registered series and their style are unchanged and series data
+     * was only appended, just the new segments and markers are stroked into it.
+     * Anything else triggers a full redraw.  Reference-line labels and the legend
+     * are drawn on top of the pixmap in every paint event.  Until the next full
+     * redraw, appended segments may cover series registered after them.
+     */
+    void setIncremental(bool enable);
+    /** @brief Whether incremental painting is enabled */
+    bool isIncremental() const { return m_incremental; }
+
+    /**
+     * @brief Paint the complete chart
+     * @param p      Painter on any paint device (the widget, a QImage, an SVG generator)
+     * @param target Area to fill, in the painter's logical coordinates
+     *
+     * Must be called from the GUI thread; use a PlotRenderer to paint charts
+     * in other threads.
+     */
+    void doRender(QPainter &p, const QRectF &target) const { m_chart.render(p, target); }
+
+    /** @brief Chart state and renderer shown by the widget */
+    const PlotRenderer &renderer() const { return m_chart; }
+
 protected:
     /** @brief Paint the chart onto the widget */
     void paintEvent(QPaintEvent *event) override;
@@ -109,17 +138,32 @@ protected:
     QSize sizeHint() const override;
 
 private:
-    /** @brief Painting routine used by paintEvent() */
-    void doRender(QPainter &p, const QRectF &target) const;
-
-    PlotAxis m_xaxis;                       ///< X-axis configuration
-    PlotAxis m_yaxis;                       ///< Y-axis configuration
-    QString m_title;                        ///< chart title
-    QList<const PlotSeries *> m_series;     ///< registered series (not owned)
-    LegendPos m_legendPos = LegendPos::Off; ///< legend placement (corner, or off)
-    double m_refLabelSize = 0.0;            ///< reference-label font point size (0 = default)
-    double m_refLabelDist = 4.0;            ///< reference-label gap from its line (px)
-    bool m_refLabelBoxed  = false;          ///< frame + opaque background behind ref labels
+    using Frame = PlotRenderer::Frame;
+
+    /** @brief Style and progress of a series as last painted into the pixmap */
+    struct DrawnSeries {
+        const PlotSeries *series = nullptr;              ///< registered series
+        unsigned int revision    = 0;                    ///< series revision when painted
+        PlotSeriesType type      = PlotSeriesType::Line; ///< line vs. scatter
+        bool visible             = true;                 ///< visibility when painted
+        QColor color;                                    ///< line / marker color
+        qreal width        = 1.0;                        ///< line width
+        Qt::PenStyle style = Qt::SolidLine;              ///< line style
+        qreal markerSize   = 8.0;                        ///< marker diameter
+        int drawn          = 0; ///< points painted, up to the last finite one
+    };
+
+    /** @brief Whether the pixmap can be brought up to date by painting appended points */
+    bool canAppend() const;
+    /** @brief Bring the offscreen pixmap up to date (incremental mode) */
+    void updateCache();
+
+    PlotRenderer m_chart;       ///< chart state and drawing code
+    bool m_incremental = false; ///< paint through the offscreen pixmap
+    bool m_cacheValid  = false; ///< pixmap matches the widget state
+    QPixmap m_cache;            ///< background + series (incremental mode)
+    Frame m_cacheFrame;         ///< layout of the pixmap
+    QList<DrawnSeries> m_drawn; ///< series as painted into the pixmap
 };
 
 #endif
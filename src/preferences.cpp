@@ -17,6 +17,7 @@
 #include "lammpsgui.h"
 #include "lammpswrapper.h"
 #include "logwindow.h"
+#include "plotcache.h"
 #include "qaddon.h"
 #include "tutorialwizard.h"
 #include "urldownloader.h"
@@ -212,6 +213,11 @@ void Preferences::accept()
     if (spin) settings->setValue(Keys::UPDFREQ, spin->value());
     spin = tabWidget->findChild<QSpinBox *>("updchart");
     if (spin) settings->setValue(Keys::UPDCHART, spin->value());
+    spin = tabWidget->findChild<QSpinBox *>("plotcache");
+    if (spin) {
+        settings->setValue(Keys::PLOTCACHE, spin->value());
+        PlotCache::setLimit(static_cast<qint64>(spin->value()) * 1024 * 1024);
+    }
 
     field = tabWidget->findChild<QLineEdit *>("proxyval");
     if (field) settings->setValue(Keys::HTTPS_PROXY, field->text());
@@ -340,6 +346,16 @@ GeneralTab::GeneralTab(QSettings *_settings, LammpsWrapper *_lammps, LammpsGui *
     chartval->setValue(settings->value(Keys::UPDCHART, Cfg::CHART_UPDATE_INTERVAL_DEFAULT).toInt());
     chartval->setObjectName("updchart");
 
+    auto *cachelabel = new QLabel("Plot data cache size (MB):");
+    auto *cacheval   = new QSpinBox;
+    cacheval->setRange(Cfg::PLOT_CACHE_MIN, Cfg::PLOT_CACHE_MAX);
+    cacheval->setStepType(QAbstractSpinBox::AdaptiveDecimalStepType);
+    cacheval->setValue(settings->value(Keys::PLOTCACHE, Cfg::PLOT_CACHE_DEFAULT).toInt());
+    cacheval->setObjectName("plotcache");
+    cacheval->setToolTip("Parsed data files larger than 1 MB are cached in binary form, so\n"
+                         "reopening an unchanged file does not parse it again.\n"
+                         "Set to 0 to disable the cache.");
+
     int nrow = 0;
     layout->addWidget(new QHline, nrow++, 0, 1, 2);
     layout->addWidget(echo, nrow, 0);
@@ -362,6 +378,8 @@ GeneralTab::GeneralTab(QSettings *_settings, LammpsWrapper *_lammps, LammpsGui *
     layout->addWidget(freqval, nrow++, 1);
     layout->addWidget(chartlabel, nrow, 0);
     layout->addWidget(chartval, nrow++, 1);
+    layout->addWidget(cachelabel, nrow, 0);
+    layout->addWidget(cacheval, nrow++, 1);
     layout->addWidget(new QHline, nrow++, 0, 1, 2);
 
     auto *proxylabel = new QLabel("HTTPS proxy setting (empty for no proxy):");
@@ -0,0 +1,228 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#include "thermoparser.h"
+
+#include <cstdlib>
+#include <utility>
+
+namespace {
+
+constexpr char WHITESPACE[] = " \t\r\n";
+
+// split a line into whitespace-separated words
+std::vector<std::string> splitWords(const std::string &line)
+{
+    std::vector<std::string> words;
+    std::size_t pos = line.find_first_not_of(WHITESPACE);
+    while (pos != std::string::npos) {
+        const std::size_t end = line.find_first_of(WHITESPACE, pos);
+        words.emplace_back(line.substr(pos, end - pos));
+        pos = line.find_first_not_of(WHITESPACE, end);
+    }
+    return words;
+}
+
+// strip leading and trailing whitespace and the given extra characters
+std::string trimmed(const std::string &text, const char *extra = "")
+{
+    const std::string chars = std::string(WHITESPACE) + extra;
+    const std::size_t first = text.find_first_not_of(chars);
+    if (first == std::string::npos) return {};
+    const std::size_t last = text.find_last_not_of(chars);
+    return text.substr(first, last - first + 1);
+}
+
+bool startsWith(const std::string &text, const char *prefix)
+{
+    return text.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+}
+
+// convert a complete word to a number; fails on trailing garbage
+bool toNumber(const std::string &word, double &value)
+{
+    if (word.empty()) return false;
+    char *end = nullptr;
+    value     = std::strtod(word.c_str(), &end);
+    return (end != word.c_str()) && (*end == '\0');
+}
+
+// the elements of a YAML flow sequence "[a, b, c, ]" (trailing comma allowed)
+std::vector<std::string> flowSequence(const std::string &text)
+{
+    std::vector<std::string> items;
+    const std::size_t open  = text.find('[');
+    const std::size_t close = text.rfind(']');
+    if ((open == std::string::npos) || (close == std::string::npos) || (close < open)) return items;
+    const std::string body = text.substr(open + 1, close - open - 1);
+    std::size_t pos        = 0;
+    while (pos <= body.size()) {
+        std::size_t comma = body.find(',', pos);
+        if (comma == std::string::npos) comma = body.size();
+        const std::string item = trimmed(body.substr(pos, comma - pos), "'\"");
+        if (!item.empty()) items.push_back(item);
+        pos = comma + 1;
+    }
+    return items;
+}
+
+} // namespace
+
+ThermoParser::ThermoParser() : m_state(State::Idle), m_blocks(0), m_stepCol(-1) {}
+
+void ThermoParser::reset()
+{
+    m_state   = State::Idle;
+    m_blocks  = 0;
+    m_stepCol = -1;
+    m_partial.clear();
+    m_keywords.reset();
+    m_rows.clear();
+}
+
+void ThermoParser::feed(std::string_view text)
+{
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        const std::size_t eol = text.find('\n', pos);
+        if (eol == std::string_view::npos) {
+            m_partial.append(text.substr(pos));
+            return;
+        }
+        if (m_partial.empty()) {
+            // reuse the line buffer: no allocation per line
+            m_line.assign(text.substr(pos, eol - pos));
+            parseLine(m_line);
+        } else {
+            m_partial.append(text.substr(pos, eol - pos));
+            parseLine(m_partial);
+            m_partial.clear();
+        }
+        pos = eol + 1;
+    }
+}
+
+void ThermoParser::finish()
+{
+    if (!m_partial.empty()) {
+        const std::string line = std::move(m_partial);
+        m_partial.clear();
+        parseLine(line);
+    }
+}
+
+std::vector<ThermoRow> ThermoParser::takeRows()
+{
+    std::vector<ThermoRow> rows;
+    rows.swap(m_rows);
+    return rows;
+}
+
+void ThermoParser::startBlock(std::vector<std::string> keywords, State state)
+{
+    m_stepCol = -1;
+    for (std::size_t i = 0; i < keywords.size(); ++i) {
+        if (keywords[i] == "Step") {
+            m_stepCol = static_cast<int>(i);
+            break;
+        }
+    }
+    // without a step column there is nothing to plot the rows against
+    if (m_stepCol < 0) {
+        m_state = State::Idle;
+        return;
+    }
+    m_keywords = std::make_shared<const std::vector<std::string>>(std::move(keywords));
+    m_state    = state;
+    ++m_blocks;
+}
+
+void ThermoParser::parseLine(const std::string &line)
+{
+    // the memory usage line announces the thermo header of a run or minimize,
+    // the loop time line ends the block; both take precedence in any state
+    if (startsWith(line, "Per MPI rank memory allocation") ||
+        startsWith(line, "Memory usage per processor")) {
+        m_state = State::Header;
+        return;
+    }
+    if (startsWith(line, "Loop time of")) {
+        m_state = State::Idle;
+        return;
+    }
+
+    switch (m_state) {
+        case State::Idle:
+            break;
+
+        case State::Header: {
+            const std::string text = trimmed(line);
+            // skip empty lines and the YAML document start
+            if (text.empty() || (text == "---")) break;
+            if (startsWith(text, "keywords:")) {
+                startBlock(flowSequence(text), State::Yaml);
+                break;
+            }
+            // a multi-line format block starts with "------------ Step ..."
+            if (startsWith(text, "---")) {
+                m_state = State::Idle;
+                break;
+            }
+            // one-line format: the header must not contain any numbers
+            auto words = splitWords(text);
+            double value;
+            for (const auto &w : words) {
+                if (toNumber(w, value)) {
+                    m_state = State::Idle;
+                    return;
+                }
+            }
+            startBlock(std::move(words), State::Columns);
+            break;
+        }
+
+        case State::Columns: {
+            const auto words = splitWords(line);
+            if (words.size() != m_keywords->size()) break;
+            ThermoRow row;
+            row.values.resize(words.size());
+            for (std::size_t i = 0; i < words.size(); ++i)
+                if (!toNumber(words[i], row.values[i])) return; // not a thermo row
+            row.keywords = m_keywords;
+            row.step     = row.values[m_stepCol];
+            m_rows.push_back(std::move(row));
+            break;
+        }
+
+        case State::Yaml: {
+            const std::string text = trimmed(line);
+            if (text == "...") {
+                m_state = State::Idle;
+                break;
+            }
+            if (!startsWith(text, "- [")) break; // "data:" or unrelated output
+            const auto items = flowSequence(text);
+            if (items.size() != m_keywords->size()) break;
+            ThermoRow row;
+            row.values.resize(items.size());
+            for (std::size_t i = 0; i < items.size(); ++i)
+                if (!toNumber(items[i], row.values[i])) return;
+            row.keywords = m_keywords;
+            row.step     = row.values[m_stepCol];
+            m_rows.push_back(std::move(row));
+            break;
+        }
+    }
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,114 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef THERMOPARSER_H
+#define THERMOPARSER_H
+
+// Small, self-contained (Qt-free) streaming parser that picks the thermo rows
+// out of captured LAMMPS screen output.  Unlike sampling the library's cached
+// "last thermo" data on a timer, every row that LAMMPS prints is recovered, no
+// matter how many were written between two GUI updates.
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief One row of thermo output
+ */
+struct ThermoRow {
+    /// Column names of the thermo block this row belongs to (shared by all its rows)
+    std::shared_ptr<const std::vector<std::string>> keywords;
+    double step = 0.0;          ///< Value of the "Step" column
+    std::vector<double> values; ///< All column values in keyword order (including the step)
+};
+
+/**
+ * @brief Incremental extractor of thermo rows from LAMMPS screen output
+ *
+ * Text is fed in arbitrary chunks (e.g. as read from the stdout capture pipe);
+ * incomplete trailing lines are kept until the rest arrives.  A thermo block
+ * starts after the "Per MPI rank memory allocation" line of a run or minimize
+ * command and ends with the "Loop time of" line.  Both the default one-line
+ * format (a header line with the keywords followed by numeric rows) and the
+ * YAML format (@c thermo_modify @c line @c yaml) are recognized; lines that
+ * are not thermo rows, e.g. warnings printed during the run, are skipped.
+ * Blocks without a "Step" column or in the multi-line format are ignored.
+ *
+ * Recognized rows are queued until they are collected with takeRows().
+ */
+class ThermoParser {
+public:
+    ThermoParser();
+
+    /**
+     * @brief Discard all state: pending text, the current block, and queued rows
+     */
+    void reset();
+
+    /**
+     * @brief Process a chunk of captured output
+     * @param text Output text; need not end on a line boundary
+     */
+    void feed(std::string_view text);
+
+    /**
+     * @brief Process any pending incomplete line as if it were terminated
+     *
+     * Call this once the output is complete, i.e. after the capture ended.
+     */
+    void finish();
+
+    /**
+     * @brief Whether the parser is currently inside a recognized thermo block
+     * @return true between a recognized block header and the end of the block
+     */
+    bool isTracking() const { return m_state != State::Idle && m_state != State::Header; }
+
+    /**
+     * @brief Whether any thermo block was recognized since the last reset()
+     * @return true if at least one block header was found
+     */
+    bool hasSeenBlock() const { return m_blocks > 0; }
+
+    /** @brief Whether rows are queued for takeRows() */
+    bool hasRows() const { return !m_rows.empty(); }
+
+    /**
+     * @brief Hand over all queued rows, in output order, and clear the queue
+     * @return Queued rows
+     */
+    std::vector<ThermoRow> takeRows();
+
+private:
+    /// Parser state, driven by the marker lines of the LAMMPS output
+    enum class State { Idle, Header, Columns, Yaml };
+
+    /** @brief Process one complete line of output (without the newline) */
+    void parseLine(const std::string &line);
+    /** @brief Begin a block with the given column names, unless it has no "Step" column */
+    void startBlock(std::vector<std::string> keywords, State state);
+
+    State m_state;                 ///< Current parser state
+    int m_blocks;                  ///< Number of recognized thermo blocks
+    int m_stepCol;                 ///< Index of the "Step" column in the current block
+    std::string m_partial;         ///< Incomplete last line of the fed text
+    std::string m_line;            ///< Buffer of the line being parsed
+    std::vector<ThermoRow> m_rows; ///< Rows not yet collected
+    std::shared_ptr<const std::vector<std::string>> m_keywords; ///< Current block's keywords
+};
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,216 @@
+// -*- c++ -*- /////////////////////////////////////////////////////////////////////////
+// LAMMPS-GUI - A Graphical Tool to Learn and Explore the LAMMPS MD Simulation Software
+//
+// Copyright (c) 2023, 2024, 2025, 2026  Axel Kohlmeyer
+//
+// Documentation: https://lammps-gui.lammps.org/
+// Contact: akohlmey@gmail.com
+//
+// This software is distributed under the GNU General Public License version 2 or later.
+////////////////////////////////////////////////////////////////////////////////////////
+
+// Throughput and latency benchmarks for the chart data path: appending points
+// to a chart column, smoothing, the data range query, and rendering a frame,
+// each with synthetic series of 10^3 to 10^7 points.  Besides the per-
+// iteration time the results carry "ns_per_point" or "ms_per_frame" counters;
+// use --benchmark_format=json (or csv) for machine-readable output.
+
+#include "chartcolumn.h"
+#include "constants.h"
+#include "plotdata.h"
+
+#include <QApplication>
+#include <QCoreApplication>
+#include <QPixmap>
+#include <QTime>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+// appended per iteration by the benchmarks that grow a chart
+constexpr int CHUNK = 100;
+
+// time per point in ns: an inverted rate counter is seconds per counted unit
+benchmark::Counter nsPerPoint(double points)
+{
+    return benchmark::Counter(points * 1.0e-9,
+                              benchmark::Counter::kIsIterationInvariantRate |
+                                  benchmark::Counter::kInvert);
+}
+
+// time per frame in ms
+benchmark::Counter msPerFrame()
+{
+    return benchmark::Counter(1.0e-3, benchmark::Counter::kIsIterationInvariantRate |
+                                          benchmark::Counter::kInvert);
+}
+
+// A chart as set up by ChartWindow: a shared data store, one column viewing it,
+// and the view bound to that column.  Data is appended the way
+// ChartWindow::addData() does it.
+struct Chart {
+    PlotData store;
+    ChartColumn col;
+    std::mt19937 rng{12345};
+    std::normal_distribution<double> noise{0.0, 2.0};
+    ChartViewer viewer; // destroyed first: it refers to the column
+
+    Chart(int npoints, bool smooth)
+    {
+        store.addColumn("Step", {});
+        store.addColumn("PotEng", {});
+        col.index  = 1;
+        col.series = std::make_unique<PlotSeries>();
+        col.series->setView(&store, 0, 1);
+        col.series->name = "PotEng";
+        col.yTitle       = "PotEng";
+        col.stats        = RunningStats(Cfg::CHART_STATS_WINDOW);
+        col.lastUpdate   = QTime::currentTime();
+        setColumnSmoothFlags(col, true, smooth, Cfg::SMOOTH_WINDOW_DEFAULT,
+                             Cfg::SMOOTH_ORDER_DEFAULT);
+        append(npoints, false);
+        viewer.setAttribute(Qt::WA_DontShowOnScreen);
+        viewer.resize(Cfg::CHART_DEFAULT_WIDTH, Cfg::CHART_DEFAULT_HEIGHT);
+        viewer.show();
+        viewer.setColumn(&col);
+    }
+
+    // a noisy, slowly relaxing signal, like a potential energy during equilibration
+    void append(int count, bool live)
+    {
+        std::vector<double> row(2);
+        for (int i = 0; i < count; ++i) {
+            const double step = store.rowCount();
+            row[0]            = step;
+            row[1]            = -1000.0 - (50.0 * std::exp(-step * 1.0e-4)) + noise(rng);
+            store.appendRow(row);
+            extendColumnBounds(col, row[0], row[1]);
+            if (live) viewer.updateLive();
+        }
+    }
+};
+
+// Appending to a live chart: data store, cached bounds, running statistics,
+// and the throttled redraw of a smoothed chart.
+void BM_AddPoint(benchmark::State &state)
+{
+    const auto npoints = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto chart = std::make_unique<Chart>(0, true);
+        chart->viewer.setLive(true);
+        state.ResumeTiming();
+        chart->append(npoints, true);
+        state.PauseTiming();
+        chart.reset();
+        state.ResumeTiming();
+    }
+    state.counters["ns_per_point"] = nsPerPoint(npoints);
+}
+
+// Smoothing a whole column from scratch (e.g. after the window size changed).
+void BM_SmoothFull(benchmark::State &state)
+{
+    const auto npoints = static_cast<int>(state.range(0));
+    Chart chart(npoints, true);
+    for (auto _ : state) {
+        chart.col.smoother.reset();
+        chart.viewer.updateSmooth();
+    }
+    state.counters["ns_per_point"] = nsPerPoint(npoints);
+}
+
+// Smoothing after points were appended: only the tail is recomputed.
+void BM_SmoothAppend(benchmark::State &state)
+{
+    const auto npoints = static_cast<int>(state.range(0));
+    auto chart         = std::make_unique<Chart>(npoints, true);
+    for (auto _ : state) {
+        // keep the chart size near the nominal one
+        if (chart->store.rowCount() >= 2 * npoints + CHUNK) {
+            state.PauseTiming();
+            chart = std::make_unique<Chart>(npoints, true);
+            state.ResumeTiming();
+        }
+        chart->append(CHUNK, false);
+        chart->viewer.updateSmooth();
+    }
+    state.counters["ns_per_point"] = nsPerPoint(CHUNK);
+}
+
+// The data range used for zoom resets and the live axis ranges.
+void BM_GetMinMax(benchmark::State &state)
+{
+    Chart chart(static_cast<int>(state.range(0)), true);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(chart.viewer.getMinMax());
+}
+
+// Repainting a raw and a smoothed series of unchanged data.
+void BM_RenderFrame(benchmark::State &state)
+{
+    Chart chart(static_cast<int>(state.range(0)), true);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(chart.viewer.grab());
+    state.counters["ms_per_frame"] = msPerFrame();
+}
+
+// A live-run frame: append a chunk of points, re-smooth, and paint the update.
+void BM_RenderLive(benchmark::State &state)
+{
+    const auto npoints = static_cast<int>(state.range(0));
+    auto chart         = std::make_unique<Chart>(npoints, true);
+    chart->viewer.setLive(true);
+    for (auto _ : state) {
+        if (chart->store.rowCount() >= 2 * npoints + CHUNK) {
+            state.PauseTiming();
+            chart = std::make_unique<Chart>(npoints, true);
+            chart->viewer.setLive(true);
+            state.ResumeTiming();
+        }
+        chart->append(CHUNK, false);
+        chart->viewer.updateSmooth();
+        benchmark::DoNotOptimize(chart->viewer.grab());
+    }
+    state.counters["ms_per_frame"] = msPerFrame();
+}
+
+// synthetic series of 10^3 to 10^7 points
+void chartSizes(benchmark::internal::Benchmark *b)
+{
+    b->RangeMultiplier(10)->Range(1000, 10000000);
+}
+
+BENCHMARK(BM_AddPoint)->Apply(chartSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SmoothFull)->Apply(chartSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SmoothAppend)->Apply(chartSizes);
+BENCHMARK(BM_GetMinMax)->Apply(chartSizes);
+BENCHMARK(BM_RenderFrame)->Apply(chartSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RenderLive)->Apply(chartSizes)->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // render without a display, and do not pick up the user's chart preferences
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QCoreApplication::setOrganizationName("The LAMMPS Developers");
+    QCoreApplication::setApplicationName("LAMMPS-GUI Benchmark");
+    QApplication app(argc, argv);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -6,10 +6,38 @@
 #include "gtest/gtest.h"
 
 #include <cmath>
+#include <limits>
+#include <random>
 #include <vector>
 
 namespace {
 
+// AR(1) process y_i = phi y_(i-1) + noise with a known statistical
+// inefficiency g = (1 + phi) / (1 - phi); deterministic seed
+std::vector<double> ar1(std::size_t n, double phi)
+{
+    std::mt19937 gen(12345);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<double> y(n);
+    double v = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        v    = (phi * v) + noise(gen);
+        y[i] = v;
+    }
+    return y;
+}
+
+TEST(DropNonFinite, RemovesPairsWithNaNOrInf)
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> x{0.0, 1.0, nan, 3.0, 4.0, 5.0};
+    std::vector<double> y{1.0, nan, 5.0, 7.0, inf, 11.0};
+    dropNonFinite(x, y);
+    EXPECT_EQ(x, std::vector<double>({0.0, 3.0, 5.0}));
+    EXPECT_EQ(y, std::vector<double>({1.0, 7.0, 11.0}));
+}
+
 TEST(Autocorrelation, ExactSmallCase)
 {
     // y = [1,2,3], mean 2, deviations [-1,0,1], denom = 2
@@ -66,4 +94,168 @@ TEST(Autocorrelation, AlternatingIsAnticorrelated)
     EXPECT_LT(acf[3], 0.0);
 }
 
+TEST(Autocorrelation, LongLagsMatchDirectSums)
+{
+    // all lags of a long series take the FFT path; compare with the direct sums
+    const std::vector<double> y = ar1(3000, 0.5);
+    const int n                 = static_cast<int>(y.size());
+    const std::vector<double> acf = autocorrelation(y, 0);
+    ASSERT_EQ(acf.size(), y.size());
+
+    double mean = 0.0;
+    for (double v : y)
+        mean += v;
+    mean /= n;
+    double denom = 0.0;
+    for (double v : y)
+        denom += (v - mean) * (v - mean);
+    for (int k = 0; k < n; k += 7) {
+        double num = 0.0;
+        for (int i = 0; i + k < n; ++i)
+            num += (y[i] - mean) * (y[i + k] - mean);
+        EXPECT_NEAR(acf[k], num / denom, 1.0e-12) << "lag " << k;
+    }
+}
+
+TEST(BlockAverages, LevelsHalveTheBlockCount)
+{
+    const std::vector<BlockAverage> levels = blockAverages(std::vector<double>(37, 0.0));
+    // 37 -> 18 -> 9 -> 4 -> 2 blocks; a single block has no error estimate
+    ASSERT_EQ(levels.size(), 5u);
+    EXPECT_EQ(levels[0].blockSize, 1);
+    EXPECT_EQ(levels[0].blocks, 37);
+    EXPECT_EQ(levels[4].blockSize, 16);
+    EXPECT_EQ(levels[4].blocks, 2);
+    for (const auto &level : levels)
+        EXPECT_EQ(level.error, 0.0);
+    EXPECT_TRUE(blockAverages({1.0}).empty());
+}
+
+TEST(BlockAverages, FirstLevelIsNaiveStandardError)
+{
+    // y = [1,2,3,4]: sample variance 5/3, standard error sqrt(5/12)
+    const std::vector<BlockAverage> levels = blockAverages({1.0, 2.0, 3.0, 4.0});
+    ASSERT_EQ(levels.size(), 2u);
+    EXPECT_NEAR(levels[0].error, std::sqrt(5.0 / 12.0), 1.0e-12);
+    EXPECT_NEAR(levels[0].errorError, levels[0].error / std::sqrt(6.0), 1.0e-12);
+    // block means [1.5, 3.5]: standard error 1
+    EXPECT_NEAR(levels[1].error, 1.0, 1.0e-12);
+}
+
+TEST(BlockAverages, PlateauMatchesCorrelationTime)
+{
+    // for correlated data the blocked error rises above the naive one and
+    // levels off at sqrt(g) times it
+    const std::vector<double> y            = ar1(1 << 17, 0.8);
+    const std::vector<BlockAverage> levels = blockAverages(y);
+    ASSERT_GT(levels.size(), 8u);
+    const double naive   = levels[0].error;
+    const double plateau = levels[7].error; // 128-sample blocks
+    EXPECT_NEAR(plateau / naive, 3.0, 0.3); // sqrt(9)
+}
+
+TEST(CorrelationTime, WhiteNoiseIsUncorrelated)
+{
+    const CorrelationTime ct = correlationTime(ar1(20000, 0.0));
+    ASSERT_TRUE(ct.ok);
+    EXPECT_NEAR(ct.inefficiency, 1.0, 0.1);
+    EXPECT_NEAR(ct.variance, 1.0, 0.05);
+    EXPECT_NEAR(ct.error, std::sqrt(ct.inefficiency * ct.variance / 20000.0), 1.0e-12);
+}
+
+TEST(CorrelationTime, AutoregressiveInefficiency)
+{
+    // phi = 0.8: g = 9, tau = 4.5
+    const CorrelationTime ct = correlationTime(ar1(1 << 17, 0.8));
+    ASSERT_TRUE(ct.ok);
+    EXPECT_NEAR(ct.inefficiency, 9.0, 0.9);
+    EXPECT_NEAR(ct.tau, 4.5, 0.45);
+    EXPECT_GE(ct.window, 5.0 * ct.tau - 1.0);
+}
+
+TEST(CorrelationTime, DegenerateInput)
+{
+    EXPECT_FALSE(correlationTime({}).ok);
+    EXPECT_FALSE(correlationTime({2.0}).ok);
+    EXPECT_FALSE(correlationTime({2.0, 2.0, 2.0}).ok);
+}
+
+TEST(RunningStats, EmptyAndSingleSample)
+{
+    RunningStats stats(4);
+    EXPECT_EQ(stats.count(), 0u);
+    EXPECT_TRUE(std::isnan(stats.mean()));
+    EXPECT_TRUE(std::isnan(stats.min()));
+    EXPECT_TRUE(std::isnan(stats.windowMean()));
+
+    stats.add(2.5);
+    EXPECT_EQ(stats.count(), 1u);
+    EXPECT_EQ(stats.mean(), 2.5);
+    EXPECT_EQ(stats.last(), 2.5);
+    EXPECT_TRUE(std::isnan(stats.variance()));
+    EXPECT_TRUE(std::isnan(stats.windowStddev()));
+}
+
+TEST(RunningStats, MatchesTwoPassStatistics)
+{
+    const std::vector<double> y = ar1(5000, 0.5);
+    RunningStats stats(100);
+    for (double v : y)
+        stats.add(v + 1.0e6); // large offset: a naive sum of squares would lose all digits
+
+    double mean = 0.0;
+    for (double v : y)
+        mean += v;
+    mean /= static_cast<double>(y.size());
+    double m2 = 0.0;
+    for (double v : y)
+        m2 += (v - mean) * (v - mean);
+
+    EXPECT_EQ(stats.count(), y.size());
+    EXPECT_NEAR(stats.mean(), mean + 1.0e6, 1.0e-8);
+    EXPECT_NEAR(stats.variance(), m2 / static_cast<double>(y.size() - 1), 1.0e-6);
+    EXPECT_EQ(stats.last(), y.back() + 1.0e6);
+}
+
+TEST(RunningStats, WindowFollowsRecentSamples)
+{
+    RunningStats stats(3);
+    for (double v : {10.0, 20.0, 1.0, 2.0, 3.0})
+        stats.add(v);
+    EXPECT_EQ(stats.window(), 3u);
+    EXPECT_EQ(stats.windowCount(), 3u);
+    EXPECT_NEAR(stats.windowMean(), 2.0, 1.0e-12);
+    EXPECT_NEAR(stats.windowVariance(), 1.0, 1.0e-12);
+    EXPECT_EQ(stats.min(), 1.0);
+    EXPECT_EQ(stats.max(), 20.0);
+    EXPECT_NEAR(stats.mean(), 7.2, 1.0e-12);
+
+    // many windows later the sliding sums still match a direct computation
+    const std::vector<double> y = ar1(10007, 0.9);
+    stats.reset();
+    EXPECT_EQ(stats.count(), 0u);
+    EXPECT_EQ(stats.windowCount(), 0u);
+    for (double v : y)
+        stats.add(v);
+    const double wmean = (y[10004] + y[10005] + y[10006]) / 3.0;
+    double wm2         = 0.0;
+    for (std::size_t i = 10004; i < y.size(); ++i)
+        wm2 += (y[i] - wmean) * (y[i] - wmean);
+    EXPECT_NEAR(stats.windowMean(), wmean, 1.0e-12);
+    EXPECT_NEAR(stats.windowVariance(), wm2 / 2.0, 1.0e-10);
+}
+
+TEST(RunningStats, IgnoresNonFiniteSamples)
+{
+    RunningStats stats;
+    stats.add(1.0);
+    stats.add(std::nan(""));
+    stats.add(INFINITY);
+    stats.add(3.0);
+    EXPECT_EQ(stats.count(), 2u);
+    EXPECT_EQ(stats.windowCount(), 2u);
+    EXPECT_EQ(stats.mean(), 2.0);
+    EXPECT_EQ(stats.max(), 3.0);
+}
+
 } // namespace
@@ -7,6 +7,8 @@
 #include "gtest/gtest.h"
 
 #include <cmath>
+#include <map>
+#include <string>
 #include <vector>
 
 // a polynomial sampled at the endpoints and midpoint
@@ -106,6 +108,34 @@ TEST(CustomFunc, ClampsSampleCount)
     EXPECT_DOUBLE_EQ(c.points[1].x(), 1.0);
 }
 
+// batch evaluation matches per-point evaluation; names are bound once
+TEST(CustomFunc, BatchEvaluation)
+{
+    CompiledExpression expr("a*x^2 + sin(y)/a");
+    ASSERT_TRUE(expr.isValid());
+    EXPECT_FALSE(expr.bind({"x", "y"}));
+    EXPECT_FALSE(expr.error().isEmpty());
+    ASSERT_TRUE(expr.bind({"x", "y"}, {"a"}));
+    EXPECT_TRUE(expr.error().isEmpty());
+
+    const int n = 1000;
+    std::vector<double> xs(n), ys(n), result(n);
+    for (int i = 0; i < n; ++i) {
+        xs[i] = 0.01 * i;
+        ys[i] = -0.5 * i;
+    }
+    const double *arrays[] = {xs.data(), ys.data()};
+    const double a         = 3.0;
+    expr.evaluateBatch(n, arrays, &a, result.data());
+
+    std::map<std::string, double> vars = {{"a", a}};
+    for (int i = 0; i < n; ++i) {
+        vars["x"] = xs[i];
+        vars["y"] = ys[i];
+        ASSERT_DOUBLE_EQ(result[i], expr.evaluate(vars)) << "at point " << i;
+    }
+}
+
 // ---- nonlinear fitting via fitCustomCurve --------------------------------
 
 namespace {
@@ -215,3 +245,68 @@ TEST(CustomFit, RejectsTooFewPoints)
     EXPECT_FALSE(f.ok);
     EXPECT_FALSE(f.error.isEmpty());
 }
+
+// a multi-start fit escapes the local minimum a single descent from a poor guess
+// ends in, and ranks the distinct minima it found
+TEST(CustomFit, MultiStartFindsGlobalMinimum)
+{
+    std::vector<double> xs, ys;
+    makeData(xs, ys, 60, 0.0, 0.1, [](double x) {
+        return 2.0 * std::sin(3.0 * x);
+    });
+
+    const QList<FitParam> init = {{"A", 1.0}, {"w", 0.5, 0.1, 5.0}};
+    const CustomFit single     = fitCustomCurve("A*sin(w*x)", init, xs, ys, 0.0, 5.9, 20);
+    ASSERT_TRUE(single.ok) << single.error.toStdString();
+    EXPECT_GT(single.rms, 0.1);
+
+    const CustomFit f = fitCustomCurveMultiStart("A*sin(w*x)", init, xs, ys, 0.0, 5.9, 20, 32);
+    ASSERT_TRUE(f.ok) << f.error.toStdString();
+    ASSERT_EQ(f.params.size(), 2);
+    EXPECT_NEAR(f.params[0].value, 2.0, 1e-6);
+    EXPECT_NEAR(f.params[1].value, 3.0, 1e-6);
+    EXPECT_DOUBLE_EQ(f.params[1].lower, 0.1);
+    EXPECT_DOUBLE_EQ(f.params[1].upper, 5.0);
+    EXPECT_NEAR(f.rms, 0.0, 1e-8);
+    EXPECT_EQ(f.curve.size(), 21);
+
+    ASSERT_GT(f.minima.size(), 1);
+    EXPECT_EQ(f.minima[0].params[1].value, f.params[1].value);
+    EXPECT_EQ(f.minima[0].rms, f.rms);
+    int starts = 0;
+    for (int k = 0; k < f.minima.size(); ++k) {
+        starts += f.minima[k].count;
+        if (k > 0) {
+            EXPECT_LT(f.minima[k - 1].rms, f.minima[k].rms);
+        }
+    }
+    EXPECT_LE(starts, 32);
+
+    // the starting points are the same on every call
+    const CustomFit again = fitCustomCurveMultiStart("A*sin(w*x)", init, xs, ys, 0.0, 5.9, 20, 32);
+    ASSERT_TRUE(again.ok);
+    EXPECT_EQ(again.params[1].value, f.params[1].value);
+    EXPECT_EQ(again.minima.size(), f.minima.size());
+}
+
+// a multi-start fit needs a range to sample; a single start behaves like fitCustomCurve
+TEST(CustomFit, MultiStartNeedsRange)
+{
+    std::vector<double> xs, ys;
+    makeData(xs, ys, 20, 0.0, 0.2, [](double x) {
+        return 5.0 * std::exp(-0.7 * x);
+    });
+
+    const QList<FitParam> init = {{"A", 1.0}, {"k", 0.1}};
+    const CustomFit bad = fitCustomCurveMultiStart("A*exp(-k*x)", init, xs, ys, 0.0, 3.8, 50, 8);
+    EXPECT_FALSE(bad.ok);
+    EXPECT_FALSE(bad.error.isEmpty());
+
+    const CustomFit one = fitCustomCurveMultiStart("A*exp(-k*x)", init, xs, ys, 0.0, 3.8, 50, 1);
+    const CustomFit ref = fitCustomCurve("A*exp(-k*x)", init, xs, ys, 0.0, 3.8, 50);
+    ASSERT_TRUE(one.ok) << one.error.toStdString();
+    EXPECT_EQ(one.params[1].value, ref.params[1].value);
+    EXPECT_EQ(one.iterations, ref.iterations);
+    ASSERT_EQ(one.minima.size(), 1);
+    EXPECT_EQ(one.minima[0].count, 1);
+}
@@ -55,6 +55,141 @@ TEST(PolynomialFit, Eval)
     EXPECT_DOUBLE_EQ(evalPolynomial({}, 5.0), 0.0);
 }
 
+TEST(StreamingPolynomialFit, UpdatesAsPointsArrive)
+{
+    // y = 1 - 0.5x + 0.25x^2, one point at a time
+    StreamingPolynomialFit stream(2);
+    EXPECT_EQ(stream.degree(), 2);
+    for (int i = 0; i < 50; ++i) {
+        const double xi = 0.1 * i;
+        stream.add(xi, 1.0 - 0.5 * xi + 0.25 * xi * xi);
+        const PolynomialFit fit = stream.fit();
+        if (i < 2) {
+            EXPECT_FALSE(fit.ok);
+            continue;
+        }
+        ASSERT_TRUE(fit.ok) << "after " << stream.count() << " points";
+        EXPECT_NEAR(fit.coeffs[0], 1.0, 1.0e-9);
+        EXPECT_NEAR(fit.coeffs[1], -0.5, 1.0e-9);
+        EXPECT_NEAR(fit.coeffs[2], 0.25, 1.0e-9);
+        EXPECT_NEAR(fit.rms, 0.0, 1.0e-9);
+    }
+    EXPECT_EQ(stream.count(), 50u);
+
+    stream.clear();
+    EXPECT_EQ(stream.count(), 0u);
+    EXPECT_FALSE(stream.fit().ok);
+}
+
+TEST(StreamingPolynomialFit, MatchesNormalEquations)
+{
+    // scattered data: the line through the least-squares solution of
+    // [n sx; sx sxx] c = [sy; sxy]
+    std::vector<double> x, y;
+    double sx = 0.0, sxx = 0.0, sy = 0.0, sxy = 0.0;
+    for (int i = 0; i < 20; ++i) {
+        const double xi = i;
+        const double yi = 3.0 + 0.5 * xi + std::sin(1.7 * xi);
+        x.push_back(xi);
+        y.push_back(yi);
+        sx += xi;
+        sxx += xi * xi;
+        sy += yi;
+        sxy += xi * yi;
+    }
+    const double det   = 20.0 * sxx - sx * sx;
+    const double slope = (20.0 * sxy - sx * sy) / det;
+    const double icept = (sy - slope * sx) / 20.0;
+
+    StreamingPolynomialFit stream(1);
+    stream.add(x, y);
+    const PolynomialFit fit = stream.fit();
+    ASSERT_TRUE(fit.ok);
+    EXPECT_NEAR(fit.coeffs[0], icept, 1.0e-12);
+    EXPECT_NEAR(fit.coeffs[1], slope, 1.0e-12);
+
+    double sumsq = 0.0;
+    for (int i = 0; i < 20; ++i) {
+        const double resid = y[i] - evalPolynomial(fit.coeffs, x[i]);
+        sumsq += resid * resid;
+    }
+    EXPECT_NEAR(fit.rms, std::sqrt(sumsq / 20.0), 1.0e-12);
+}
+
+TEST(StreamingPolynomialFit, Weights)
+{
+    // a weight of two counts like adding the point twice; zero weights are ignored
+    StreamingPolynomialFit weighted(1), repeated(1);
+    const double xs[] = {0.0, 1.0, 2.0, 3.0};
+    const double ys[] = {0.1, 0.9, 2.2, 2.8};
+    for (int i = 0; i < 4; ++i) {
+        weighted.add(xs[i], ys[i], (i == 2) ? 2.0 : 1.0);
+        repeated.add(xs[i], ys[i]);
+        if (i == 2) repeated.add(xs[i], ys[i]);
+    }
+    weighted.add(10.0, -100.0, 0.0);
+    EXPECT_EQ(weighted.count(), 4u);
+
+    const PolynomialFit a = weighted.fit();
+    const PolynomialFit b = repeated.fit();
+    ASSERT_TRUE(a.ok);
+    ASSERT_TRUE(b.ok);
+    EXPECT_NEAR(a.coeffs[0], b.coeffs[0], 1.0e-12);
+    EXPECT_NEAR(a.coeffs[1], b.coeffs[1], 1.0e-12);
+    EXPECT_NEAR(a.rms, b.rms, 1.0e-12);
+}
+
+TEST(StreamingPolynomialFit, TooFewDistinctPointsFails)
+{
+    // many points, but only two different x values for a quadratic
+    StreamingPolynomialFit stream(2);
+    for (int i = 0; i < 10; ++i)
+        stream.add((i % 2) ? 1.0 : 2.0, i);
+    EXPECT_FALSE(stream.fit().ok);
+}
+
+TEST(StreamingPolynomialFit, ThermoSteps)
+{
+    // a quadratic trend over time steps up to 10^6
+    StreamingPolynomialFit stream(2);
+    for (int step = 0; step <= 1000000; step += 100)
+        stream.add(step, 300.0 + 1.0e-4 * step - 2.0e-11 * step * step);
+    const PolynomialFit fit = stream.fit();
+    ASSERT_TRUE(fit.ok);
+    for (double step : {0.0, 250000.0, 1000000.0})
+        EXPECT_NEAR(evalPolynomial(fit.coeffs, step),
+                    300.0 + 1.0e-4 * step - 2.0e-11 * step * step, 1.0e-8);
+    EXPECT_NEAR(fit.rms, 0.0, 1.0e-8);
+}
+
+TEST(StreamingPolynomialFit, LargeOffset)
+{
+    // high degrees over the steps of a continued run: the plain powers of x are
+    // numerically dependent there, but the shifted and scaled ones are not
+    std::vector<double> x, y;
+    for (int i = 0; i < 500; ++i) {
+        x.push_back(100000.0 + i);
+        y.push_back(300.0 + 0.002 * i + 0.5 * std::sin(0.02 * i) + 0.01 * std::sin(1.3 * i * i));
+    }
+    double previous = 1.0;
+    for (int degree = 5; degree <= 8; ++degree) {
+        const PolynomialFit fit = polynomialFit(x, y, degree);
+        ASSERT_TRUE(fit.ok) << "degree " << degree;
+        EXPECT_EQ(fit.xshift, 100000.0);
+        EXPECT_EQ(fit.xscale, 512.0);
+
+        double sumsq = 0.0;
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            const double resid = y[i] - evalPolynomialFit(fit, x[i]);
+            sumsq += resid * resid;
+        }
+        EXPECT_NEAR(fit.rms, std::sqrt(sumsq / x.size()), 1.0e-9) << "degree " << degree;
+        EXPECT_LE(fit.rms, previous) << "degree " << degree;
+        previous = fit.rms;
+    }
+    EXPECT_LT(previous, 0.01);
+}
+
 TEST(BirchMurnaghan, RecoversKnownModel)
 {
     // E(V) = a + b V^-2/3 + c V^-4/3 + d V^-2 with a=10, b=-6, c=1.5, d=1.
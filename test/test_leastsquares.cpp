@@ -115,6 +115,112 @@ TEST(LeastSquares, Invert)
     EXPECT_NEAR(id[1][1], 1.0, 1.0e-12);
 }
 
+TEST(LeastSquares, BlockedProductsMatchNaive)
+{
+    // sizes not divisible by the block size exercise the partial blocks
+    const std::size_t n = 70, m = 131, p = 67;
+    float_mat a(n, m);
+    float_mat b(m, p);
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t k = 0; k < m; ++k)
+            a[i][k] = std::sin(0.3 * static_cast<double>(i) + 0.7 * static_cast<double>(k));
+    for (std::size_t k = 0; k < m; ++k)
+        for (std::size_t j = 0; j < p; ++j)
+            b[k][j] = std::cos(0.2 * static_cast<double>(k) - 0.5 * static_cast<double>(j));
+
+    const float_mat c = a * b;
+    ASSERT_EQ(c.nr_rows(), n);
+    ASSERT_EQ(c.nr_cols(), p);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < p; ++j) {
+            double sum = 0.0;
+            for (std::size_t k = 0; k < m; ++k)
+                sum += a[i][k] * b[k][j];
+            EXPECT_DOUBLE_EQ(c[i][j], sum) << "element " << i << "," << j;
+        }
+    }
+
+    // A^T B without the transposed copy, and the transpose itself
+    const float_mat at = transpose(a);
+    ASSERT_EQ(at.nr_rows(), m);
+    ASSERT_EQ(at.nr_cols(), n);
+    EXPECT_DOUBLE_EQ(at[130][69], a[69][130]);
+    const float_mat c2 = a * at;
+    const float_mat c3 = transpose_mult(at, at);
+    ASSERT_EQ(c3.nr_rows(), n);
+    ASSERT_EQ(c3.nr_cols(), n);
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = 0; j < n; ++j)
+            EXPECT_DOUBLE_EQ(c3[i][j], c2[i][j]) << "element " << i << "," << j;
+}
+
+TEST(LeastSquares, CholeskySolve)
+{
+    // same system as LinSolveMultiColumnRhs; the matrix is symmetric positive definite
+    float_mat A(2, 2);
+    A[0][0] = 2.0;
+    A[0][1] = 1.0;
+    A[1][0] = 1.0;
+    A[1][1] = 3.0;
+    float_mat rhs(2, 2);
+    rhs[0][0] = 1.0;
+    rhs[0][1] = 0.0;
+    rhs[1][0] = 2.0;
+    rhs[1][1] = 5.0;
+
+    const float_mat x = cholesky_solve(A, rhs);
+    ASSERT_EQ(x.nr_rows(), 2u);
+    ASSERT_EQ(x.nr_cols(), 2u);
+    EXPECT_NEAR(x[0][0], 0.2, 1.0e-12);
+    EXPECT_NEAR(x[1][0], 0.6, 1.0e-12);
+    EXPECT_NEAR(x[0][1], -1.0, 1.0e-12);
+    EXPECT_NEAR(x[1][1], 2.0, 1.0e-12);
+
+    // an indefinite matrix is rejected with NaN
+    A[1][1]           = -3.0;
+    const float_mat y = cholesky_solve(A, rhs);
+    EXPECT_TRUE(std::isnan(y[0][0]));
+    EXPECT_TRUE(std::isnan(y[1][1]));
+}
+
+TEST(LeastSquares, QrSolveOverdetermined)
+{
+    // fit y = 1 + 2x - 0.5x^2 through exact samples, plus a square system
+    const std::size_t m = 50;
+    float_mat A(m, 3);
+    float_mat y(m, 1);
+    for (std::size_t i = 0; i < m; ++i) {
+        const double x = -2.0 + 0.1 * static_cast<double>(i);
+        A[i][0]        = 1.0;
+        A[i][1]        = x;
+        A[i][2]        = x * x;
+        y[i][0]        = 1.0 + 2.0 * x - 0.5 * x * x;
+    }
+    const float_mat c = qr_solve(A, y);
+    ASSERT_EQ(c.nr_rows(), 3u);
+    ASSERT_EQ(c.nr_cols(), 1u);
+    EXPECT_NEAR(c[0][0], 1.0, 1.0e-12);
+    EXPECT_NEAR(c[1][0], 2.0, 1.0e-12);
+    EXPECT_NEAR(c[2][0], -0.5, 1.0e-12);
+
+    float_mat B(2, 2);
+    B[0][0] = 2.0;
+    B[0][1] = 1.0;
+    B[1][0] = 1.0;
+    B[1][1] = 3.0;
+    float_mat rhs(2, 1);
+    rhs[0][0]         = 1.0;
+    rhs[1][0]         = 2.0;
+    const float_mat x = qr_solve(B, rhs);
+    EXPECT_NEAR(x[0][0], 0.2, 1.0e-12);
+    EXPECT_NEAR(x[1][0], 0.6, 1.0e-12);
+
+    // a zero column cannot be solved for
+    for (std::size_t i = 0; i < m; ++i)
+        A[i][1] = 0.0;
+    EXPECT_TRUE(std::isnan(qr_solve(A, y)[0][0]));
+}
+
 TEST(SavitzkyGolay, ConstantUnchangedMovingAverage)
 {
     const float_vect v(11, 5.0);
@@ -167,4 +273,80 @@ TEST(SavitzkyGolay, ReducesNoiseAroundLine)
               std::fabs(v[mid] - 3.0 * static_cast<double>(mid)));
 }
 
+TEST(SavitzkyGolay, IncrementalMatchesFullSmoothing)
+{
+    // noisy data appended in chunks of varying size, including a chunk that
+    // reaches the window size and single-sample updates
+    float_vect v(200);
+    for (std::size_t i = 0; i < v.size(); ++i)
+        v[i] = std::sin(0.1 * static_cast<double>(i)) + ((i % 3 == 0) ? 0.2 : -0.1);
+
+    for (int deg : {0, 2, 4}) {
+        SGSmoother smoother(5, deg);
+        std::size_t n = 0;
+        for (std::size_t chunk : {3, 8, 1, 1, 17, 1, 50, 119}) {
+            n += chunk;
+            const std::size_t first = smoother.update(v.data(), n);
+            const float_vect full   = sg_smooth(float_vect(v.begin(), v.begin() + n), 5, deg);
+            ASSERT_EQ(smoother.values().size(), n);
+            for (std::size_t i = 0; i < n; ++i)
+                EXPECT_DOUBLE_EQ(smoother.values()[i], full[i])
+                    << "degree " << deg << " length " << n << " index " << i;
+            // only the outputs next to the old end are recomputed
+            if (n > 11 + chunk) {
+                EXPECT_EQ(first, n - chunk - 5) << "length " << n;
+            }
+        }
+    }
+}
+
+TEST(SavitzkyGolay, IncrementalFromTail)
+{
+    // only the samples from inputStart() on are passed, as for packed columns
+    float_vect v(200);
+    for (std::size_t i = 0; i < v.size(); ++i)
+        v[i] = std::cos(0.07 * static_cast<double>(i)) + ((i % 4 == 0) ? 0.3 : -0.1);
+
+    for (int deg : {0, 2, 4}) {
+        SGSmoother smoother(5, deg);
+        std::size_t n = 0;
+        for (std::size_t chunk : {3, 8, 1, 1, 17, 1, 50, 119}) {
+            n += chunk;
+            const std::size_t start = smoother.inputStart(n);
+            const float_vect tail(v.begin() + static_cast<std::ptrdiff_t>(start),
+                                  v.begin() + static_cast<std::ptrdiff_t>(n));
+            smoother.update(tail.data(), n, start);
+            const float_vect full = sg_smooth(float_vect(v.begin(), v.begin() + n), 5, deg);
+            ASSERT_EQ(smoother.values().size(), n);
+            for (std::size_t i = 0; i < n; ++i)
+                EXPECT_DOUBLE_EQ(smoother.values()[i], full[i])
+                    << "degree " << deg << " length " << n << " index " << i;
+            // a single appended sample needs no more than two windows of input
+            if ((chunk == 1) && (n > 11)) {
+                EXPECT_LE(n - start, 2U * 11U) << "length " << n;
+            }
+        }
+    }
+}
+
+TEST(SavitzkyGolay, IncrementalRestartsOnShorterInput)
+{
+    float_vect v(40);
+    for (std::size_t i = 0; i < v.size(); ++i)
+        v[i] = static_cast<double>(i * i % 7);
+
+    SGSmoother smoother(3, 2);
+    smoother.update(v.data(), v.size());
+    EXPECT_EQ(smoother.update(v.data(), 20), 0u);
+    const float_vect full = sg_smooth(float_vect(v.begin(), v.begin() + 20), 3, 2);
+    ASSERT_EQ(smoother.values().size(), 20u);
+    for (std::size_t i = 0; i < 20; ++i)
+        EXPECT_DOUBLE_EQ(smoother.values()[i], full[i]) << "index " << i;
+
+    // too short for the window: all zeros, as with sg_smooth()
+    smoother.reset();
+    EXPECT_EQ(smoother.update(v.data(), 5), 0u);
+    EXPECT_EQ(smoother.values(), float_vect(5, 0.0));
+}
+
 } // namespace
@@ -1,5 +1,6 @@
 // Unit tests for the vendored LeptonMini expression library: parsing,
-// evaluation, optimization, symbolic differentiation, and custom functions.
+// evaluation, optimization, symbolic differentiation, custom functions, and
+// the array evaluation of ArrayProgram.
 //
 // Adapted from the LAMMPS test at unittest/utils/test_lepton.cpp. The
 // LAMMPS-specific tests (lepton_utils, ZBLFunction) and the JIT-based
@@ -17,6 +18,7 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -151,6 +153,44 @@ void testCustomFunction(const std::string &expression, const std::string &equiva
     verifySameValue(deriv3, deriv4, 2.0, -3.0);
 }
 
+// verify that an ArrayProgram gives the same values as an ExpressionProgram,
+// at more points than fit into one block
+void verifyArrayEvaluation(const LeptonMini::ExpressionProgram &program,
+                           const std::string &expression)
+{
+    LeptonMini::ArrayProgram array(program, {"x"}, {"y"});
+
+    const int n = 2 * LeptonMini::ArrayProgram::BLOCK + 17;
+    std::vector<double> x(n), result(n, -1.0);
+    for (int i = 0; i < n; ++i)
+        x[i] = -3.0 + 6.0 * i / (n - 1);
+    const double y       = 1.5;
+    const double *arrays = x.data();
+    array.evaluate(n, &arrays, &y, result.data());
+
+    std::map<std::string, double> variables;
+    variables["y"] = y;
+    for (int i = 0; i < n; ++i) {
+        variables["x"]      = x[i];
+        const double expect = program.evaluate(variables);
+        if (std::isnan(expect))
+            ASSERT_TRUE(std::isnan(result[i])) << expression << " at x = " << x[i];
+        else
+            ASSERT_EQ(expect, result[i]) << expression << " at x = " << x[i];
+    }
+}
+
+// the same, with and without optimizing the expression first
+void verifyArrayEvaluation(const std::string &expression)
+{
+    std::map<std::string, LeptonMini::CustomFunction *> functions;
+    ExampleFunction custom;
+    functions["custom"] = &custom;
+    LeptonMini::ParsedExpression parsed = LeptonMini::Parser::parse(expression, functions);
+    verifyArrayEvaluation(parsed.createProgram(), expression);
+    verifyArrayEvaluation(parsed.optimize().createProgram(), expression);
+}
+
 } // namespace
 
 TEST(Lepton, Evaluation)
@@ -289,3 +329,82 @@ TEST(Lepton, Optimize)
     EXPECT_EQ(out.str(), "1");
     out.str("");
 }
+
+TEST(Lepton, ArrayProgram)
+{
+    verifyArrayEvaluation("5");
+    verifyArrayEvaluation("y");
+    verifyArrayEvaluation("2*3+4*x");
+    verifyArrayEvaluation("2.1e-4*x*(y+1)-x/y");
+    verifyArrayEvaluation("y^-x+x^2+x^3+x^-1+x^1.8+y^(1/2)");
+    verifyArrayEvaluation("sin(x)+cos(x)+tan(x)+sec(x)+csc(x)+cot(x)");
+    verifyArrayEvaluation("asin(x/3)+acos(x/3)+atan(x)+atan2(x, y)");
+    verifyArrayEvaluation("sinh(x)+cosh(x)+tanh(x)+exp(-x*y)+log(x)+sqrt(x)");
+    verifyArrayEvaluation("erf(x)+erfc(x*y)+recip(x)+square(x-y)+cube(x)");
+    verifyArrayEvaluation("min(x, y)+max(-1, x)+abs(x-y)+floor(x)+ceil(x)");
+    verifyArrayEvaluation("delta(x)+3*delta(y-1.5)+step(x-1)+select(step(x), x, y)");
+    verifyArrayEvaluation("a+b^2;a=x-b;b=3*y");
+    verifyArrayEvaluation("custom(x, y)/2+custom(x^2, 1)");
+}
+
+TEST(Lepton, ArrayProgramVariables)
+{
+    LeptonMini::ExpressionProgram program = LeptonMini::Parser::parse("a*x+b").createProgram();
+    EXPECT_THROW(LeptonMini::ArrayProgram(program, {"x"}, {"a"}), LeptonMini::Exception);
+
+    // a name bound as both array and scalar is an array
+    LeptonMini::ArrayProgram array(program, {"x", "b"}, {"a", "b"});
+    const std::vector<double> x = {1.0, 2.0, 3.0};
+    const std::vector<double> b = {0.5, 0.25, 0.125};
+    const double *arrays[]      = {x.data(), b.data()};
+    const double scalars[]      = {2.0, 100.0};
+    std::vector<double> result(x.size());
+    array.evaluate(x.size(), arrays, scalars, result.data());
+    EXPECT_EQ(result, (std::vector<double>{2.5, 4.25, 6.125}));
+
+    // copies evaluate independently of the original
+    LeptonMini::ArrayProgram copy = array;
+    copy.evaluate(2, arrays, scalars, result.data());
+    EXPECT_EQ(result, (std::vector<double>{2.5, 4.25, 6.125}));
+}
+
+TEST(Lepton, ArrayProgramCompile)
+{
+    // operations on constants are folded, and repeated values computed once
+    LeptonMini::ArrayProgram folded(LeptonMini::Parser::parse("(2+3)*x").createProgram(), {"x"});
+    EXPECT_EQ(folded.getNumOperations(), 3);
+    LeptonMini::ArrayProgram shared(LeptonMini::Parser::parse("sin(x)*sin(x)+sin(x)").createProgram(),
+                                    {"x"});
+    EXPECT_EQ(shared.getNumOperations(), 4);
+
+    // a model and its derivatives share their common values
+    const std::vector<std::string> params = {"A", "k", "c"};
+    LeptonMini::ParsedExpression model    = LeptonMini::Parser::parse("A*exp(-k*x^2)+c*x");
+    std::vector<LeptonMini::ExpressionProgram> programs = {model.optimize().createProgram()};
+    for (const auto &p : params)
+        programs.push_back(model.differentiate(p).optimize().createProgram());
+    LeptonMini::ArrayProgram array(programs, {"x"}, params);
+    ASSERT_EQ(array.getNumOutputs(), 4);
+    int separate = 0;
+    for (const auto &p : programs)
+        separate += LeptonMini::ArrayProgram(p, {"x"}, params).getNumOperations();
+    EXPECT_LT(array.getNumOperations(), separate);
+
+    const int n = LeptonMini::ArrayProgram::BLOCK + 5;
+    std::vector<double> x(n);
+    std::vector<std::vector<double>> results(4, std::vector<double>(n));
+    for (int i = 0; i < n; ++i)
+        x[i] = 0.01 * i - 1.0;
+    const double values[] = {2.0, 0.5, -1.5};
+    const double *arrays  = x.data();
+    double *outputs[]     = {results[0].data(), results[1].data(), results[2].data(),
+                             results[3].data()};
+    array.evaluate(n, &arrays, values, outputs);
+
+    std::map<std::string, double> variables = {{"A", 2.0}, {"k", 0.5}, {"c", -1.5}};
+    for (int i = 0; i < n; ++i) {
+        variables["x"] = x[i];
+        for (int j = 0; j < 4; ++j)
+            ASSERT_EQ(results[j][i], programs[j].evaluate(variables)) << "output " << j;
+    }
+}
@@ -161,4 +161,58 @@ TEST(Levmar, ReportsInitialFailure)
     EXPECT_FALSE(r.message.empty());
 }
 
+// the parallel solver recovers the parameters, with the same result for any
+// number of threads
+TEST(Levmar, ParallelIsDeterministic)
+{
+    std::vector<double> xs, ys;
+    const double A = 3.0, k = 0.4, c = 0.2;
+    for (int i = 0; i < 5000; ++i) {
+        const double x = 0.002 * i;
+        xs.push_back(x);
+        ys.push_back(A * std::exp(-k * x) + c + 0.01 * std::sin(7.0 * i));
+    }
+    const int m = static_cast<int>(xs.size());
+
+    LevmarRowModel model = [&](const std::vector<double> &p, int first, int count, double *res,
+                               double *jac) {
+        for (int i = 0; i < count; ++i) {
+            const double x = xs[first + i];
+            const double e = std::exp(-p[1] * x);
+            res[i]         = p[0] * e + p[2] - ys[first + i];
+            jac[3 * i]     = e;
+            jac[3 * i + 1] = -p[0] * x * e;
+            jac[3 * i + 2] = 1.0;
+        }
+        return true;
+    };
+
+    const LevmarResult one = levmarFitParallel(m, 3, {1.0, 1.0, 0.0}, model, 1);
+    ASSERT_TRUE(one.ok);
+    EXPECT_NEAR(one.params[0], A, 1e-2);
+    EXPECT_NEAR(one.params[1], k, 1e-2);
+    EXPECT_NEAR(one.params[2], c, 1e-2);
+    for (int threads : {2, 3, 8}) {
+        const LevmarResult r = levmarFitParallel(m, 3, {1.0, 1.0, 0.0}, model, threads);
+        ASSERT_TRUE(r.ok);
+        EXPECT_EQ(r.params, one.params) << threads << " threads";
+        EXPECT_EQ(r.rms, one.rms) << threads << " threads";
+        EXPECT_EQ(r.iterations, one.iterations) << threads << " threads";
+    }
+}
+
+// a failing evaluation of any block is reported like a failing model
+TEST(Levmar, ParallelReportsFailure)
+{
+    LevmarRowModel model = [](const std::vector<double> &, int first, int count, double *res,
+                              double *jac) {
+        for (int i = 0; i < count; ++i)
+            res[i] = jac[i] = 1.0;
+        return first < 2048;
+    };
+    const LevmarResult r = levmarFitParallel(3000, 1, {1.0}, model, 2);
+    EXPECT_FALSE(r.ok);
+    EXPECT_FALSE(r.message.empty());
+}
+
 } // namespace
@@ -0,0 +1,142 @@
+// Unit tests for the sparse line index of the large file viewer
+// (src/lineindex.cpp), exercised without a GUI.
+
+#include "lineindex.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace {
+
+// text with the line number on each of n lines
+std::string numberedLines(std::size_t n, const char *eol = "\n")
+{
+    std::string text;
+    for (std::size_t i = 0; i < n; ++i)
+        text += "line " + std::to_string(i) + eol;
+    return text;
+}
+
+TEST(LineIndex, EmptyText)
+{
+    LineIndex index("");
+    index.build();
+    EXPECT_TRUE(index.finished());
+    EXPECT_EQ(index.lineCount(), 0U);
+    EXPECT_TRUE(index.line(0).empty());
+    EXPECT_EQ(index.lineStart(0), 0U);
+    EXPECT_EQ(index.lineAt(0), 0U);
+}
+
+TEST(LineIndex, LinesAcrossCheckpoints)
+{
+    const std::size_t n    = 5 * LineIndex::STRIDE + 17;
+    const std::string text = numberedLines(n);
+    LineIndex index(text);
+    index.build();
+    ASSERT_TRUE(index.finished());
+    ASSERT_EQ(index.lineCount(), n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::string expected = "line " + std::to_string(i);
+        ASSERT_EQ(index.line(i), expected) << "line " << i;
+        ASSERT_EQ(index.lineStart(i), text.find(expected + "\n")) << "line " << i;
+        ASSERT_EQ(index.lineAt(index.lineStart(i)), i);
+        ASSERT_EQ(index.lineAt(index.lineStart(i) + expected.size()), i);
+    }
+    EXPECT_TRUE(index.line(n).empty());
+    EXPECT_EQ(index.lineStart(n), text.size());
+}
+
+TEST(LineIndex, CrlfAndLastLineWithoutNewline)
+{
+    const std::string text = numberedLines(LineIndex::STRIDE + 1, "\r\n") + "last";
+    LineIndex index(text);
+    index.build();
+    ASSERT_EQ(index.lineCount(), LineIndex::STRIDE + 2);
+    EXPECT_EQ(index.line(0), "line 0");
+    EXPECT_EQ(index.line(LineIndex::STRIDE), "line " + std::to_string(LineIndex::STRIDE));
+    EXPECT_EQ(index.line(LineIndex::STRIDE + 1), "last");
+    EXPECT_EQ(index.lineAt(text.size() - 1), LineIndex::STRIDE + 1);
+}
+
+TEST(LineIndex, EmptyLines)
+{
+    LineIndex index("\n\nx\n\n");
+    index.build();
+    ASSERT_EQ(index.lineCount(), 4U);
+    EXPECT_TRUE(index.line(0).empty());
+    EXPECT_TRUE(index.line(1).empty());
+    EXPECT_EQ(index.line(2), "x");
+    EXPECT_TRUE(index.line(3).empty());
+    EXPECT_EQ(index.lineAt(2), 2U);
+}
+
+TEST(LineIndex, UsableWhileBuilding)
+{
+    const std::size_t n    = 200000;
+    const std::string text = numberedLines(n);
+    LineIndex index(text);
+    std::thread builder(&LineIndex::build, &index);
+    // every line reported as indexed must already be correct
+    for (int i = 0; (i < 1000) && !index.finished(); ++i) {
+        const std::size_t count = index.lineCount();
+        if (count > 0) {
+            ASSERT_EQ(index.line(count - 1), "line " + std::to_string(count - 1));
+        }
+    }
+    builder.join();
+    EXPECT_TRUE(index.finished());
+    EXPECT_EQ(index.lineCount(), n);
+}
+
+TEST(LineIndex, CancelStopsBuild)
+{
+    const std::string text = numberedLines(1000);
+    LineIndex index(text);
+    index.cancel();
+    index.build();
+    EXPECT_FALSE(index.finished());
+}
+
+TEST(LineIndexFind, CaseSensitiveAndInsensitive)
+{
+    const std::string text = "Pair Style lj/cut\npair_style LJ/CUT 2.5\n";
+    LineIndex index(text);
+    index.build();
+    EXPECT_EQ(index.find("pair", 0, true), text.find("pair"));
+    EXPECT_EQ(index.find("pair", 0, false), 0U);
+    EXPECT_EQ(index.find("PAIR", 1, false), text.find("pair"));
+    EXPECT_EQ(index.find("lj/cut", 0, true), text.find("lj/cut"));
+    EXPECT_EQ(index.find("lj/cut", 12, false), text.find("LJ/CUT"));
+    EXPECT_EQ(index.lineAt(index.find("LJ/CUT", 0, true)), 1U);
+    EXPECT_EQ(index.find("missing", 0, false), LineIndex::npos);
+    EXPECT_EQ(index.find("", 0, true), LineIndex::npos);
+    EXPECT_EQ(index.find("pair", text.size(), false), LineIndex::npos);
+}
+
+TEST(LineIndexFind, MatchAcrossSearchBlocks)
+{
+    // the search works in blocks of 16 MiB; a match straddling a block boundary must be found
+    const std::size_t boundary = 16 * 1024 * 1024;
+    std::string text(boundary + 64, 'a');
+    text.replace(boundary - 3, 6, "NEEDLE");
+    LineIndex index(text);
+    EXPECT_EQ(index.find("NEEDLE", 0, true), boundary - 3);
+    EXPECT_EQ(index.find("needle", 0, false), boundary - 3);
+    EXPECT_EQ(index.find("NEEDLE", boundary - 2, true), LineIndex::npos);
+}
+
+TEST(LineIndexFind, StopFlagEndsSearch)
+{
+    const std::string text = numberedLines(100) + "needle\n";
+    LineIndex index(text);
+    std::atomic<bool> stop{true};
+    EXPECT_EQ(index.find("needle", 0, true, &stop), LineIndex::npos);
+    stop = false;
+    EXPECT_EQ(index.find("needle", 0, true, &stop), text.find("needle"));
+}
+
+} // namespace
@@ -0,0 +1,146 @@
+// Unit tests for the compact column storage of the chart data
+// (src/packedcolumn.cpp), exercised without a GUI.
+
+#include "packedcolumn.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+// thermo-like steps: evenly spaced, with a restart at a different interval
+std::vector<double> steps(std::size_t n)
+{
+    std::vector<double> values;
+    for (std::size_t i = 0; i < n; ++i)
+        values.push_back((i < n / 2) ? 100.0 * i : 50.0 * (n / 2) + 7.0 * i);
+    return values;
+}
+
+TEST(PackedColumn, DoubleByDefault)
+{
+    PackedColumn col({1.5, 2.5});
+    EXPECT_EQ(col.packing(), ColumnPacking::Double);
+    EXPECT_EQ(col.size(), 2U);
+    col.append(3.5);
+    col.set(0, -1.0);
+    EXPECT_EQ(col.values(), (std::vector<double>{-1.0, 2.5, 3.5}));
+    EXPECT_DOUBLE_EQ(col.at(2), 3.5);
+}
+
+TEST(PackedColumn, FloatRoundsValues)
+{
+    PackedColumn col({1.0 / 3.0, -2.0e-5, 1.0e300, std::numeric_limits<double>::quiet_NaN()});
+    col.setPacking(ColumnPacking::Float);
+    ASSERT_EQ(col.packing(), ColumnPacking::Float);
+    ASSERT_EQ(col.size(), 4U);
+    EXPECT_TRUE(col.values().empty());
+    EXPECT_FLOAT_EQ(static_cast<float>(col.at(0)), 1.0f / 3.0f);
+    EXPECT_NE(col.at(0), 1.0 / 3.0);
+    EXPECT_FLOAT_EQ(static_cast<float>(col.at(1)), -2.0e-5f);
+    EXPECT_TRUE(std::isinf(col.at(2)));
+    EXPECT_TRUE(std::isnan(col.at(3)));
+    col.append(0.25);
+    col.set(1, 4.0);
+    EXPECT_DOUBLE_EQ(col.at(4), 0.25);
+    EXPECT_DOUBLE_EQ(col.at(1), 4.0);
+}
+
+TEST(PackedColumn, DeltaIsExact)
+{
+    const std::vector<double> values = steps(10 * PackedColumn::BLOCK + 3);
+    PackedColumn col(values);
+    col.setPacking(ColumnPacking::Delta);
+    ASSERT_EQ(col.packing(), ColumnPacking::Delta);
+    ASSERT_EQ(col.size(), values.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+        ASSERT_EQ(col.at(i), values[i]) << "index " << i;
+
+    std::vector<double> decoded(values.size() - 5);
+    col.decode(5, decoded.size(), decoded.data());
+    EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(), values.begin() + 5));
+}
+
+TEST(PackedColumn, DeltaAppendMatchesConversion)
+{
+    const std::vector<double> values = steps(5 * PackedColumn::BLOCK);
+    PackedColumn col;
+    col.setPacking(ColumnPacking::Delta);
+    for (double v : values)
+        col.append(v);
+    ASSERT_EQ(col.packing(), ColumnPacking::Delta);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        ASSERT_EQ(col.at(i), values[i]) << "index " << i;
+}
+
+TEST(PackedColumn, EvenlySpacedStepsAreSmall)
+{
+    const std::size_t n = 1000 * PackedColumn::BLOCK;
+    PackedColumn col;
+    col.setPacking(ColumnPacking::Delta);
+    for (std::size_t i = 0; i < n; ++i)
+        col.append(1000.0 + 10.0 * i);
+    EXPECT_EQ(col.at(n - 1), 1000.0 + 10.0 * (n - 1));
+    EXPECT_LT(col.bytes(), n * sizeof(double) / 16);
+}
+
+TEST(PackedColumn, DeltaFallsBackToDouble)
+{
+    PackedColumn col({1.0, 2.0, 3.0});
+    col.setPacking(ColumnPacking::Delta);
+    ASSERT_EQ(col.packing(), ColumnPacking::Delta);
+    col.append(3.5);
+    EXPECT_EQ(col.packing(), ColumnPacking::Double);
+    EXPECT_EQ(col.values(), (std::vector<double>{1.0, 2.0, 3.0, 3.5}));
+
+    // offsets beyond 32 bits within a block
+    PackedColumn wide({0.0, 1.0e12});
+    wide.setPacking(ColumnPacking::Delta);
+    EXPECT_EQ(wide.packing(), ColumnPacking::Double);
+    EXPECT_EQ(wide.at(1), 1.0e12);
+
+    // offsets beyond 32 bits in different blocks are fine
+    PackedColumn far;
+    far.setPacking(ColumnPacking::Delta);
+    for (std::size_t i = 0; i < 2 * PackedColumn::BLOCK; ++i)
+        far.append((i < PackedColumn::BLOCK) ? i : 1.0e12 + i);
+    EXPECT_EQ(far.packing(), ColumnPacking::Delta);
+    EXPECT_EQ(far.at(2 * PackedColumn::BLOCK - 1), 1.0e12 + 2 * PackedColumn::BLOCK - 1);
+}
+
+TEST(PackedColumn, DeltaSetValue)
+{
+    PackedColumn col;
+    col.setPacking(ColumnPacking::Delta);
+    for (std::size_t i = 0; i < PackedColumn::BLOCK + 4; ++i)
+        col.append(2.0 * i);
+
+    // the last value can change in place
+    col.set(PackedColumn::BLOCK + 3, 1000.0);
+    EXPECT_EQ(col.packing(), ColumnPacking::Delta);
+    EXPECT_EQ(col.at(PackedColumn::BLOCK + 3), 1000.0);
+
+    // an earlier block cannot
+    col.set(1, 5.0);
+    EXPECT_EQ(col.packing(), ColumnPacking::Double);
+    EXPECT_EQ(col.at(1), 5.0);
+    EXPECT_EQ(col.at(2), 4.0);
+    EXPECT_EQ(col.at(PackedColumn::BLOCK + 3), 1000.0);
+}
+
+TEST(PackedColumn, ConvertBackToDouble)
+{
+    const std::vector<double> values = steps(3 * PackedColumn::BLOCK);
+    PackedColumn col(values);
+    col.setPacking(ColumnPacking::Delta);
+    col.setPacking(ColumnPacking::Double);
+    EXPECT_EQ(col.values(), values);
+    col.clear();
+    EXPECT_TRUE(col.empty());
+    EXPECT_EQ(col.packing(), ColumnPacking::Double);
+}
+
+} // namespace
@@ -1,15 +1,27 @@
 // Unit tests for the PlotData column model and file parsers
 // (src/plotdata.cpp), exercised without a GUI.
 
+#include "analysis.h"
+#include "fitting.h"
+#include "plotcache.h"
 #include "plotdata.h"
 
 #include "gtest/gtest.h"
 
+#include <QBuffer>
 #include <QByteArray>
 #include <QDir>
+#include <QFile>
+#include <QProcess>
+#include <QStandardPaths>
 #include <QString>
+#include <QTemporaryDir>
 #include <QTemporaryFile>
 
+#include <cmath>
+#include <limits>
+#include <vector>
+
 namespace {
 
 int colIndex(const PlotData &d, const QString &name)
@@ -39,6 +51,52 @@ TEST(PlotDataModel, AppendRowAndColumn)
     EXPECT_EQ(colIndex(d, "c"), 2);
 }
 
+TEST(PlotDataModel, SetValueAndRenameColumn)
+{
+    PlotData d;
+    d.setColumnNames({"Step", "Temp"});
+    EXPECT_TRUE(d.appendRow({0.0, 1.0}));
+    EXPECT_TRUE(d.appendRow({10.0, 2.0}));
+
+    d.setValue(1, 1, 5.0);
+    EXPECT_DOUBLE_EQ(d.column(1)[1], 5.0);
+    EXPECT_DOUBLE_EQ(d.column(1)[0], 1.0);
+
+    d.renameColumn(1, "Temperature");
+    EXPECT_EQ(d.columnName(1), "Temperature");
+    EXPECT_EQ(d.columnName(0), "Step");
+}
+
+TEST(PlotDataModel, PackedColumns)
+{
+    PlotData d;
+    d.setColumnNames({"Step", "Temp"});
+    d.setPacking(0, ColumnPacking::Delta);
+    d.setPacking(1, ColumnPacking::Float);
+    const std::size_t full = 2 * 1000 * sizeof(double);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_TRUE(d.appendRow({100.0 * i, 300.0 + (0.1 * i)}));
+    d.setValue(999, 1, 0.5);
+
+    ASSERT_EQ(d.rowCount(), 1000);
+    EXPECT_EQ(d.packing(0), ColumnPacking::Delta);
+    EXPECT_EQ(d.packing(1), ColumnPacking::Float);
+    EXPECT_EQ(d.value(999, 0), 99900.0);
+    EXPECT_FLOAT_EQ(static_cast<float>(d.value(10, 1)), 301.0f);
+    EXPECT_EQ(d.value(999, 1), 0.5);
+    EXPECT_LT(d.memoryUsage(), full / 2);
+
+    // exports read the packed values
+    const PlotData back = parsePlotCsv(writePlotCsv(d));
+    ASSERT_EQ(back.rowCount(), 1000);
+    EXPECT_EQ(back.column(0)[999], 99900.0);
+    EXPECT_NEAR(back.column(1)[10], 301.0, 1.0e-4);
+
+    // unpacking restores the (rounded) values in full precision
+    d.setPacking(0, ColumnPacking::Double);
+    EXPECT_EQ(d.column(0)[500], 50000.0);
+}
+
 TEST(PlotDataCsv, WithHeader)
 {
     const QString text = "Step,Temp,Press\n0,300,1.0\n1,310,1.1\n";
@@ -199,6 +257,120 @@ TEST(LoadPlotData, DetectsYamlInLogByContent)
     EXPECT_DOUBLE_EQ(d.column(0)[1], 50.0);
 }
 
+// a classic log: two runs with different thermo_style and a minimization
+const char LOG_TEXT[] =
+    "LAMMPS (2 Aug 2023)\n"
+    "thermo_style custom step temp pe\n"
+    "Per MPI rank memory allocation (min/avg/max) = 3.1 | 3.1 | 3.1 Mbytes\n"
+    "   Step          Temp          PotEng    \n"
+    "         0   3              -6.7733681    \n"
+    "        50   1.6758903      -4.7955425    \n"
+    "WARNING: Bond/angle/dihedral extent > half of periodic box length\n"
+    "       100   1.6458363      -4.7492704    \n"
+    "Loop time of 0.1 on 1 procs for 100 steps with 4000 atoms\n"
+    "\n"
+    "thermo_style custom step temp press\n"
+    "Per MPI rank memory allocation (min/avg/max) = 3.1 | 3.1 | 3.1 Mbytes\n"
+    "   Step          Temp          Press     \n"
+    "       100   1.6458363      5.3          \n"
+    "       150   1.6         5.1          \n"
+    "Loop time of 0.05 on 1 procs for 50 steps with 4000 atoms\n"
+    "minimize 1.0e-4 1.0e-6 100 1000\n"
+    "Per MPI rank memory allocation (min/avg/max) = 4.2 | 4.2 | 4.2 Mbytes\n"
+    "   Step          Temp          Press     \n"
+    "       150   1.6         5.1          \n"
+    "       160   1.6         -0.2         \n"
+    "Loop time of 0.01 on 1 procs for 10 steps with 4000 atoms\n";
+
+TEST(PlotDataLog, OneTablePerThermoBlock)
+{
+    const std::vector<PlotData> runs = parsePlotLogRuns(LOG_TEXT, sizeof(LOG_TEXT) - 1);
+    ASSERT_EQ(runs.size(), 3U);
+    ASSERT_EQ(runs[0].columnCount(), 3);
+    ASSERT_EQ(runs[0].rowCount(), 3);
+    EXPECT_EQ(runs[0].columnName(2), "PotEng");
+    EXPECT_DOUBLE_EQ(runs[0].column(0)[2], 100.0);
+    EXPECT_DOUBLE_EQ(runs[0].column(2)[1], -4.7955425);
+    EXPECT_EQ(runs[1].columnName(2), "Press");
+    EXPECT_EQ(runs[1].rowCount(), 2);
+    ASSERT_EQ(runs[2].rowCount(), 2);
+    EXPECT_DOUBLE_EQ(runs[2].column(2)[1], -0.2);
+}
+
+TEST(PlotDataLog, MergedTableHasUnionOfColumnsAndRunIndex)
+{
+    QString err;
+    const PlotData d = parsePlotLog(QString::fromLatin1(LOG_TEXT), &err);
+    EXPECT_TRUE(err.isEmpty()) << err.toStdString();
+    ASSERT_EQ(d.columnCount(), 5);
+    EXPECT_EQ(d.columnNames(), QStringList({"Step", "Temp", "PotEng", "Press", "Run"}));
+    ASSERT_EQ(d.rowCount(), 7);
+    EXPECT_DOUBLE_EQ(d.column(2)[2], -4.7492704);
+    EXPECT_TRUE(std::isnan(d.column(2)[3]));
+    EXPECT_TRUE(std::isnan(d.column(3)[0]));
+    EXPECT_DOUBLE_EQ(d.column(3)[4], 5.1);
+    EXPECT_DOUBLE_EQ(d.column(4)[0], 1.0);
+    EXPECT_DOUBLE_EQ(d.column(4)[4], 2.0);
+    EXPECT_DOUBLE_EQ(d.column(4)[6], 3.0);
+}
+
+TEST(PlotDataLog, FitColumnMissingFromOneRun)
+{
+    // Press is only in the second and third run, so the merged column starts with NaN
+    const PlotData d = parsePlotLog(QString::fromLatin1(LOG_TEXT));
+    ASSERT_EQ(d.columnCount(), 5);
+    std::vector<double> xs = d.column(0);
+    std::vector<double> ys = d.column(3);
+    dropNonFinite(xs, ys);
+    ASSERT_EQ(xs.size(), 4U);
+    EXPECT_EQ(xs, std::vector<double>({100.0, 150.0, 150.0, 160.0}));
+    EXPECT_EQ(ys, std::vector<double>({5.3, 5.1, 5.1, -0.2}));
+
+    const PolynomialFit fit = polynomialFit(xs, ys, 1);
+    ASSERT_TRUE(fit.ok);
+    ASSERT_EQ(fit.coeffs.size(), 2U);
+    EXPECT_TRUE(std::isfinite(fit.coeffs[0]));
+    EXPECT_TRUE(std::isfinite(fit.coeffs[1]));
+    EXPECT_TRUE(std::isfinite(fit.rms));
+    EXPECT_LT(fit.coeffs[1], 0.0);
+}
+
+TEST(PlotDataLog, SingleRunHasNoRunColumn)
+{
+    const QString text = "Per MPI rank memory allocation = 2 Mbytes\n"
+                         "Step Temp\n"
+                         "0 300\n"
+                         "10 310\n"
+                         "Loop time of 1.0 on 1 procs for 10 steps with 10 atoms\n";
+    const PlotData d   = parsePlotLog(text);
+    EXPECT_EQ(d.columnNames(), QStringList({"Step", "Temp"}));
+    EXPECT_EQ(d.rowCount(), 2);
+}
+
+TEST(PlotDataLog, NoThermoOutputIsError)
+{
+    QString err;
+    const PlotData d = parsePlotLog(QStringLiteral("LAMMPS (2 Aug 2023)\nTotal wall time\n"), &err);
+    EXPECT_TRUE(d.isEmpty());
+    EXPECT_FALSE(err.isEmpty());
+}
+
+TEST(LoadPlotData, DetectsLogByContent)
+{
+    QTemporaryFile f(QDir::tempPath() + "/plotdataXXXXXX.lammps");
+    ASSERT_TRUE(f.open());
+    f.write(LOG_TEXT);
+    f.flush();
+
+    QString err;
+    PlotFormat format = PlotFormat::Whitespace;
+    const PlotData d  = loadPlotData(f.fileName(), &err, &format);
+    EXPECT_TRUE(err.isEmpty()) << err.toStdString();
+    EXPECT_EQ(format, PlotFormat::Log);
+    EXPECT_EQ(d.columnCount(), 5);
+    EXPECT_EQ(d.rowCount(), 7);
+}
+
 TEST(PlotDataJson, ArrayOfRows)
 {
     const QByteArray json = "[[0,300,1.0],[1,310,1.1]]";
@@ -313,4 +485,356 @@ TEST(PlotDataExport, YamlQuotesNamesWithFlowChars)
     EXPECT_EQ(back.columnName(1), "c_rdf[1]");
 }
 
+TEST(PlotDataExport, StreamingWritersMatchText)
+{
+    // more rows than fit into the write buffer, with special values
+    PlotData d;
+    d.setColumnNames({"Step", QString::fromUtf8("\xC3\x89nergie"), "Press"});
+    for (int i = 0; i < 20000; ++i)
+        d.appendRow({10.0 * i, -1.0 / (i + 1), (i % 1000) ? 1.0e-7 * i : std::nan("")});
+    d.setValue(1, 2, std::numeric_limits<double>::infinity());
+    d.setValue(2, 2, -std::numeric_limits<double>::infinity());
+
+    QBuffer csv, dat, yaml;
+    csv.open(QIODevice::WriteOnly);
+    dat.open(QIODevice::WriteOnly);
+    yaml.open(QIODevice::WriteOnly);
+    ASSERT_TRUE(writePlotCsv(d, csv));
+    ASSERT_TRUE(writePlotDat(d, dat, "unit-test"));
+    ASSERT_TRUE(writePlotYaml(d, yaml));
+    EXPECT_EQ(QString::fromUtf8(csv.data()), writePlotCsv(d));
+    EXPECT_EQ(QString::fromUtf8(dat.data()), writePlotDat(d, "unit-test"));
+    EXPECT_EQ(QString::fromUtf8(yaml.data()), writePlotYaml(d));
+
+    const PlotData back = parsePlotCsv(QString::fromUtf8(csv.data()));
+    ASSERT_EQ(back.rowCount(), 20000);
+    EXPECT_EQ(back.columnName(1), d.columnName(1));
+    EXPECT_EQ(back.column(0)[19999], 199990.0);
+    EXPECT_NEAR(back.column(1)[2], -1.0 / 3.0, 1.0e-8);
+    EXPECT_TRUE(std::isinf(back.column(2)[1]));
+    EXPECT_TRUE(std::isnan(back.column(2)[1000]));
+
+    // a device that does not accept the data
+    QBuffer closed;
+    EXPECT_FALSE(writePlotCsv(d, closed));
+}
+
+TEST(PlotDataExport, BinaryRoundTripIsExact)
+{
+    PlotData d;
+    d.addColumn("Step", {0.0, 1.0, 2.0});
+    d.addColumn(QString::fromUtf8("\xC3\x89nergie"),
+                {-1.0 / 3.0, std::numeric_limits<double>::quiet_NaN(), 1.0e300});
+    PlotSource source;
+    source.path   = "/data/run1.dat";
+    source.size   = 123;
+    source.mtime  = 456;
+    source.format = PlotFormat::Csv;
+    QBuffer buffer;
+    ASSERT_TRUE(buffer.open(QIODevice::WriteOnly));
+    ASSERT_TRUE(writePlotBinary(d, buffer, source));
+    const QByteArray bytes = buffer.data();
+    EXPECT_EQ(bytes.size() % 8, 0);
+
+    PlotSource back;
+    QString err;
+    const PlotData r = parsePlotBinary(bytes.constData(), bytes.size(), &err, &back);
+    EXPECT_TRUE(err.isEmpty()) << err.toStdString();
+    ASSERT_EQ(r.columnCount(), 2);
+    ASSERT_EQ(r.rowCount(), 3);
+    EXPECT_EQ(r.columnNames(), d.columnNames());
+    EXPECT_EQ(r.column(1)[0], -1.0 / 3.0);
+    EXPECT_TRUE(std::isnan(r.column(1)[1]));
+    EXPECT_EQ(r.column(1)[2], 1.0e300);
+    EXPECT_EQ(back.path, source.path);
+    EXPECT_EQ(back.size, 123);
+    EXPECT_EQ(back.mtime, 456);
+    EXPECT_EQ(back.format, PlotFormat::Csv);
+}
+
+TEST(PlotDataExport, BinaryOfPackedColumns)
+{
+    PlotData d;
+    d.setColumnNames({"Step", "PotEng"});
+    d.setPacking(0, ColumnPacking::Delta);
+    d.setPacking(1, ColumnPacking::Float);
+    for (int i = 0; i < 70000; ++i)
+        d.appendRow({10.0 * i, -1.0 / (i + 1)});
+    QBuffer buffer;
+    ASSERT_TRUE(buffer.open(QIODevice::WriteOnly));
+    ASSERT_TRUE(writePlotBinary(d, buffer));
+    const QByteArray bytes = buffer.data();
+
+    const PlotData r = parsePlotBinary(bytes.constData(), bytes.size());
+    ASSERT_EQ(r.rowCount(), 70000);
+    for (int i = 0; i < r.rowCount(); ++i) {
+        ASSERT_EQ(r.column(0)[i], d.value(i, 0));
+        ASSERT_EQ(r.column(1)[i], d.value(i, 1));
+    }
+}
+
+TEST(PlotDataExport, BinaryRejectsTruncatedAndForeignData)
+{
+    QBuffer buffer;
+    ASSERT_TRUE(buffer.open(QIODevice::WriteOnly));
+    ASSERT_TRUE(writePlotBinary(sampleTable(), buffer));
+    QByteArray bytes = buffer.data();
+    EXPECT_TRUE(plotBinarySource(bytes.constData(), bytes.size()));
+    bytes.chop(8);
+    QString err;
+    EXPECT_TRUE(parsePlotBinary(bytes.constData(), bytes.size(), &err).isEmpty());
+    EXPECT_FALSE(err.isEmpty());
+
+    const QByteArray text("Step,Temp\n0,300\n1,310\n2,320\n3,330\n4,340\n5,350\n6,360\n");
+    EXPECT_FALSE(plotBinarySource(text.constData(), text.size()));
+    EXPECT_FALSE(plotBinarySource(bytes.constData(), 16));
+}
+
+TEST(LoadPlotData, RecognizesBinaryByHeader)
+{
+    QTemporaryFile f(QDir::tempPath() + "/plotdataXXXXXX.dat");
+    ASSERT_TRUE(f.open());
+    ASSERT_TRUE(writePlotBinary(sampleTable(), f));
+    f.flush();
+
+    PlotFormat format = PlotFormat::Whitespace;
+    const PlotData d  = loadPlotData(f.fileName(), nullptr, &format);
+    EXPECT_EQ(format, PlotFormat::Binary);
+    ASSERT_EQ(d.columnCount(), 3);
+    EXPECT_EQ(d.columnName(2), "Press");
+    EXPECT_EQ(d.column(1)[1], 310.0);
+}
+
+// ---- column-projected loading ---------------------------------------------
+
+TEST(LoadPlotColumns, ParsesOnlyChosenColumns)
+{
+    QTemporaryFile f(QDir::tempPath() + "/plotdataXXXXXX.dat");
+    ASSERT_TRUE(f.open());
+    f.write("# Step c_1 c_2 c_3\n"
+            "0 1.0 2.0 3.0\n"
+            "10 1.1 junk 3.1\n" // not a number in a column that is not loaded
+            "20 1.2 2.2\n"      // ragged
+            "30 1.3 2.3 3.3\n");
+    f.flush();
+
+    int calls = 0;
+    QString err;
+    PlotFormat format = PlotFormat::Csv;
+    const PlotData d  = loadPlotColumns(
+        f.fileName(),
+        [&](const QStringList &names) {
+            ++calls;
+            EXPECT_EQ(names, QStringList({"Step", "c_1", "c_2", "c_3"}));
+            return QList<int>{0, 3, 0};
+        },
+        &err, &format);
+    EXPECT_TRUE(err.isEmpty()) << err.toStdString();
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(format, PlotFormat::Whitespace);
+    EXPECT_EQ(d.columnNames(), QStringList({"Step", "c_3", "Step"}));
+    ASSERT_EQ(d.rowCount(), 3);
+    EXPECT_DOUBLE_EQ(d.column(1)[1], 3.1);
+    EXPECT_EQ(d.column(2), d.column(0));
+
+    EXPECT_EQ(plotDataColumns(f.fileName()), QStringList({"Step", "c_1", "c_2", "c_3"}));
+    EXPECT_TRUE(loadPlotColumns(f.fileName(), QList<int>{4}, &err).isEmpty());
+    EXPECT_FALSE(err.isEmpty());
+}
+
+TEST(LoadPlotColumns, GenericNamesAndOtherFormats)
+{
+    QTemporaryFile csv(QDir::tempPath() + "/plotdataXXXXXX.csv");
+    ASSERT_TRUE(csv.open());
+    csv.write("1,2,3\n4,5,6\n");
+    csv.flush();
+    const PlotData c = loadPlotColumns(csv.fileName(), QList<int>{2});
+    EXPECT_EQ(c.columnNames(), QStringList({"column3"}));
+    EXPECT_EQ(c.column(0), (std::vector<double>{3, 6}));
+
+    // YAML is parsed completely, then the columns are picked
+    QTemporaryFile yaml(QDir::tempPath() + "/plotdataXXXXXX.yaml");
+    ASSERT_TRUE(yaml.open());
+    yaml.write("keywords: ['Step', 'Temp', 'Press']\n"
+               "data:\n"
+               "  - [0, 300, 1.0]\n"
+               "  - [10, 310, 1.1]\n");
+    yaml.flush();
+    PlotFormat format = PlotFormat::Csv;
+    const PlotData y  = loadPlotColumns(yaml.fileName(), QList<int>{2, 0}, nullptr, &format);
+    EXPECT_EQ(format, PlotFormat::Yaml);
+    EXPECT_EQ(y.columnNames(), QStringList({"Press", "Step"}));
+    EXPECT_EQ(y.rowCount(), 2);
+}
+
+// ---- compressed files -----------------------------------------------------
+
+// Write text to a file and compress it with gzip into name + ".gz".
+bool writeGzip(const QString &name, const QByteArray &text)
+{
+    QFile f(name);
+    if (!f.open(QIODevice::WriteOnly) || (f.write(text) != text.size())) return false;
+    f.close();
+    QProcess gzip;
+    gzip.start("gzip", {"-f", name});
+    return gzip.waitForFinished() && (gzip.exitStatus() == QProcess::NormalExit) &&
+        (gzip.exitCode() == 0);
+}
+
+struct PlotDataCompressed : public ::testing::Test {
+    QTemporaryDir dir;
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+        if (QStandardPaths::findExecutable("gzip").isEmpty()) GTEST_SKIP() << "gzip not found";
+    }
+};
+
+TEST_F(PlotDataCompressed, StreamedTableMatchesUncompressed)
+{
+    // several decompressed chunks, and a last line without a newline
+    QByteArray text = "# Step v_a v_b\n";
+    for (int i = 0; i < 150000; ++i)
+        text += QByteArray::number(i) + " " + QByteArray::number(0.5 * i) + " -1.25e-3\n";
+    text += "150000 75000 1";
+    const QString plain = dir.filePath("thermo.dat");
+    ASSERT_TRUE(writeGzip(plain, text));
+
+    QString err;
+    PlotFormat format = PlotFormat::Csv;
+    const PlotData d  = loadPlotData(plain + ".gz", &err, &format);
+    EXPECT_TRUE(err.isEmpty()) << err.toStdString();
+    EXPECT_EQ(format, PlotFormat::Whitespace);
+    const PlotData expected = parsePlotWhitespace(text.constData(), text.size());
+    ASSERT_EQ(d.rowCount(), 150001);
+    EXPECT_EQ(d.columnNames(), expected.columnNames());
+    for (int c = 0; c < d.columnCount(); ++c)
+        EXPECT_EQ(d.column(c), expected.column(c));
+}
+
+TEST_F(PlotDataCompressed, CsvByInnerExtensionAndLog)
+{
+    const QString csv = dir.filePath("data.csv");
+    ASSERT_TRUE(writeGzip(csv, "Step,Temp\n0,300\n10,310\n"));
+    PlotFormat format = PlotFormat::Whitespace;
+    const PlotData d  = loadPlotData(csv + ".gz", nullptr, &format);
+    EXPECT_EQ(format, PlotFormat::Csv);
+    EXPECT_EQ(d.columnNames(), QStringList({"Step", "Temp"}));
+    EXPECT_EQ(d.rowCount(), 2);
+
+    const QString log = dir.filePath("log.lammps");
+    ASSERT_TRUE(writeGzip(log, LOG_TEXT));
+    const PlotData l = loadPlotData(log + ".gz", nullptr, &format);
+    EXPECT_EQ(format, PlotFormat::Log);
+    EXPECT_EQ(l.columnCount(), 5);
+    EXPECT_EQ(l.rowCount(), 7);
+}
+
+TEST_F(PlotDataCompressed, CorruptFileIsError)
+{
+    QFile f(dir.filePath("broken.dat.gz"));
+    ASSERT_TRUE(f.open(QIODevice::WriteOnly));
+    f.write("\x1f\x8b\x08\x00 not really gzip data\n");
+    f.close();
+
+    QString err;
+    EXPECT_TRUE(loadPlotData(f.fileName(), &err).isEmpty());
+    EXPECT_FALSE(err.isEmpty());
+}
+
+// ---- binary cache of parsed files ----------------------------------------
+
+// Point the cache at a temporary folder for the lifetime of a test.
+struct PlotDataCache : public ::testing::Test {
+    QTemporaryDir dir;
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+        PlotCache::setDirectory(dir.filePath("cache"));
+        PlotCache::setLimit(64 * 1024 * 1024);
+    }
+    void TearDown() override
+    {
+        PlotCache::setLimit(0);
+        PlotCache::setDirectory(QString());
+    }
+    int entries() const
+    {
+        const QDir cache(dir.filePath("cache"));
+        return static_cast<int>(cache.entryList({"*.lgpd"}, QDir::Files).size());
+    }
+};
+
+TEST_F(PlotDataCache, ReopenUsesCacheUntilFileChanges)
+{
+    // large enough to be cached
+    const QString name = dir.filePath("big.dat");
+    QFile f(name);
+    ASSERT_TRUE(f.open(QIODevice::WriteOnly));
+    f.write("# Step v_a v_b\n");
+    for (int i = 0; i < 80000; ++i)
+        f.write(QByteArray::number(i) + " " + QByteArray::number(0.5 * i) + " -1.25e-3\n");
+    f.close();
+
+    PlotFormat format = PlotFormat::Csv;
+    const PlotData parsed = loadPlotData(name, nullptr, &format);
+    EXPECT_EQ(format, PlotFormat::Whitespace);
+    ASSERT_EQ(parsed.rowCount(), 80000);
+    EXPECT_EQ(entries(), 1);
+
+    PlotData cached;
+    format = PlotFormat::Csv;
+    ASSERT_TRUE(PlotCache::load(PlotCache::describe(name), cached, &format));
+    EXPECT_EQ(format, PlotFormat::Whitespace);
+    EXPECT_EQ(cached.columnNames(), parsed.columnNames());
+    for (int c = 0; c < parsed.columnCount(); ++c)
+        EXPECT_EQ(cached.column(c), parsed.column(c));
+
+    // a changed file does not match its entry any more
+    ASSERT_TRUE(f.open(QIODevice::Append));
+    f.write("80000 40000 0.0\n");
+    f.close();
+    EXPECT_FALSE(PlotCache::load(PlotCache::describe(name), cached));
+    EXPECT_EQ(loadPlotData(name).rowCount(), 80001);
+    EXPECT_EQ(entries(), 1);
+
+    PlotCache::clear();
+    EXPECT_EQ(entries(), 0);
+}
+
+TEST_F(PlotDataCache, SmallFilesAndDisabledCacheAreNotStored)
+{
+    PlotSource source = PlotCache::describe(dir.filePath("small.csv"));
+    source.size       = 100;
+    EXPECT_FALSE(PlotCache::store(source, sampleTable()));
+    source.size = 2 * 1024 * 1024;
+    PlotCache::setLimit(0);
+    EXPECT_FALSE(PlotCache::store(source, sampleTable()));
+    EXPECT_EQ(entries(), 0);
+}
+
+TEST_F(PlotDataCache, EvictsOldEntriesBeyondLimit)
+{
+    // 1.6 MB per entry: two fit into the limit, a third replaces one of them
+    PlotData d;
+    d.addColumn("x", std::vector<double>(100000, 1.0));
+    d.addColumn("y", std::vector<double>(100000, 2.0));
+    PlotCache::setLimit(4 * 1024 * 1024);
+    PlotSource source;
+    source.size   = 2 * 1024 * 1024;
+    source.format = PlotFormat::Whitespace;
+    for (const char *path : {"/a.dat", "/b.dat", "/c.dat"}) {
+        source.path = path;
+        EXPECT_TRUE(PlotCache::store(source, d)) << path;
+    }
+    EXPECT_EQ(entries(), 2);
+    PlotData cached;
+    EXPECT_TRUE(PlotCache::load(source, cached));
+
+    // data larger than the whole cache is not stored
+    PlotCache::setLimit(1024 * 1024);
+    source.path = "/d.dat";
+    EXPECT_FALSE(PlotCache::store(source, d));
+}
+
 } // namespace
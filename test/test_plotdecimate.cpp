@@ -0,0 +1,264 @@
+// Unit tests for the level-of-detail reduction of chart series
+// (src/plotdecimate.cpp), exercised without a GUI.
+
+#include "plotdecimate.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace PlotDecimate;
+
+namespace {
+
+const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+Samples samplesOf(const std::vector<double> &x, const std::vector<double> &y)
+{
+    Samples s;
+    s.x     = x.data();
+    s.y     = y.data();
+    s.count = std::min(x.size(), y.size());
+    return s;
+}
+
+// random walk with strictly increasing x
+void randomWalk(std::vector<double> &x, std::vector<double> &y, int n)
+{
+    std::mt19937 gen(42);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    x.resize(n);
+    y.resize(n);
+    double v = 0.0;
+    for (int i = 0; i < n; ++i) {
+        v += dist(gen);
+        x[i] = i;
+        y[i] = v;
+    }
+}
+
+// ---- LineEnvelope ------------------------------------------------------
+
+TEST(LineEnvelope, SpikeIsKept)
+{
+    std::vector<double> x(10000), y(10000, 0.0);
+    for (int i = 0; i < 10000; ++i)
+        x[i] = i;
+    y[5003] = 100.0;
+    y[7001] = -50.0;
+
+    LineEnvelope env;
+    env.reset(0.0, 9999.0, 100);
+    ASSERT_TRUE(env.update(samplesOf(x, y)));
+    const auto &idx = env.indices();
+    EXPECT_LE(idx.size(), 400u);
+    EXPECT_NE(std::find(idx.begin(), idx.end(), 5003u), idx.end());
+    EXPECT_NE(std::find(idx.begin(), idx.end(), 7001u), idx.end());
+    EXPECT_EQ(idx.front(), 0u);
+    EXPECT_EQ(idx.back(), 9999u);
+    EXPECT_TRUE(std::is_sorted(idx.begin(), idx.end()));
+}
+
+TEST(LineEnvelope, ColumnExtentsMatchFullData)
+{
+    std::vector<double> x, y;
+    randomWalk(x, y, 50000);
+    const int columns = 300;
+    LineEnvelope env;
+    env.reset(0.0, 49999.0, columns);
+    ASSERT_TRUE(env.update(samplesOf(x, y)));
+
+    const double scale = columns / 49999.0;
+    auto columnOf      = [&](double v) { return std::min(columns - 1, int(v * scale)); };
+    std::vector<double> allMin(columns, 1e300), allMax(columns, -1e300);
+    std::vector<double> keptMin(columns, 1e300), keptMax(columns, -1e300);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        const int c = columnOf(x[i]);
+        allMin[c]   = std::min(allMin[c], y[i]);
+        allMax[c]   = std::max(allMax[c], y[i]);
+    }
+    for (std::size_t i : env.indices()) {
+        const int c = columnOf(x[i]);
+        keptMin[c]  = std::min(keptMin[c], y[i]);
+        keptMax[c]  = std::max(keptMax[c], y[i]);
+    }
+    EXPECT_EQ(keptMin, allMin);
+    EXPECT_EQ(keptMax, allMax);
+    EXPECT_LE(env.indices().size(), 4u * columns);
+}
+
+TEST(LineEnvelope, IncrementalUpdatesMatchFullScan)
+{
+    std::vector<double> x, y;
+    randomWalk(x, y, 20000);
+
+    LineEnvelope full;
+    full.reset(0.0, 19999.0, 123);
+    ASSERT_TRUE(full.update(samplesOf(x, y)));
+
+    LineEnvelope grown;
+    grown.reset(0.0, 19999.0, 123);
+    for (std::size_t n = 0; n <= x.size(); n += 777) {
+        Samples s = samplesOf(x, y);
+        s.count   = n;
+        ASSERT_TRUE(grown.update(s));
+    }
+    ASSERT_TRUE(grown.update(samplesOf(x, y)));
+    EXPECT_EQ(grown.indices(), full.indices());
+}
+
+TEST(LineEnvelope, LastSampleMayChange)
+{
+    std::vector<double> x, y;
+    randomWalk(x, y, 5000);
+    const double last = y.back();
+    y.back()          = NaN; // e.g. a table cell that is not filled yet
+
+    LineEnvelope env;
+    env.reset(0.0, 4999.0, 50);
+    ASSERT_TRUE(env.update(samplesOf(x, y)));
+    EXPECT_EQ(env.indices().back(), 4999u);
+
+    y.back() = last;
+    ASSERT_TRUE(env.update(samplesOf(x, y)));
+    LineEnvelope fresh;
+    fresh.reset(0.0, 4999.0, 50);
+    ASSERT_TRUE(fresh.update(samplesOf(x, y)));
+    EXPECT_EQ(env.indices(), fresh.indices());
+}
+
+TEST(LineEnvelope, KeepsNeighborsOutsideRange)
+{
+    std::vector<double> x, y;
+    randomWalk(x, y, 1000);
+    LineEnvelope env;
+    env.reset(100.5, 200.5, 10);
+    ASSERT_TRUE(env.update(samplesOf(x, y)));
+    const auto &idx = env.indices();
+    ASSERT_GE(idx.size(), 2u);
+    EXPECT_EQ(idx.front(), 100u); // last sample left of the range
+    EXPECT_EQ(idx.back(), 201u);  // first sample right of the range
+}
+
+TEST(LineEnvelope, GapsAreKept)
+{
+    std::vector<double> x(1000), y(1000, 1.0);
+    for (int i = 0; i < 1000; ++i)
+        x[i] = i;
+    y[500] = y[501] = NaN;
+    LineEnvelope env;
+    env.reset(0.0, 999.0, 10);
+    ASSERT_TRUE(env.update(samplesOf(x, y)));
+    const auto &idx = env.indices();
+    EXPECT_NE(std::find(idx.begin(), idx.end(), 500u), idx.end());
+    EXPECT_EQ(std::find(idx.begin(), idx.end(), 501u), idx.end()); // one marker per gap
+    EXPECT_NE(std::find(idx.begin(), idx.end(), 499u), idx.end()); // ends of the segments
+    EXPECT_NE(std::find(idx.begin(), idx.end(), 502u), idx.end());
+}
+
+TEST(LineEnvelope, DecreasingXIsRejected)
+{
+    const std::vector<double> x = {0.0, 1.0, 2.0, 1.5, 3.0};
+    const std::vector<double> y = {0.0, 1.0, 0.0, 1.0, 0.0};
+    LineEnvelope env;
+    env.reset(0.0, 3.0, 2);
+    EXPECT_FALSE(env.update(samplesOf(x, y)));
+    EXPECT_TRUE(env.indices().empty());
+    EXPECT_FALSE(env.update(samplesOf(x, y))); // stays rejected until reset
+}
+
+TEST(LineEnvelope, InterleavedStorage)
+{
+    // x, y pairs as in an array of points
+    std::vector<double> xy;
+    for (int i = 0; i < 1000; ++i) {
+        xy.push_back(i);
+        xy.push_back(i == 321 ? 10.0 : 0.0);
+    }
+    Samples s;
+    s.x      = xy.data();
+    s.y      = xy.data() + 1;
+    s.stride = 2;
+    s.count  = 1000;
+    LineEnvelope env;
+    env.reset(0.0, 999.0, 20);
+    ASSERT_TRUE(env.update(s));
+    const auto &idx = env.indices();
+    EXPECT_NE(std::find(idx.begin(), idx.end(), 321u), idx.end());
+}
+
+TEST(LineEnvelope, PackedColumnsMatchDoubles)
+{
+    std::vector<double> x, y;
+    randomWalk(x, y, 20000);
+    PackedColumn px(x), py(y);
+    px.setPacking(ColumnPacking::Delta);
+    py.setPacking(ColumnPacking::Float);
+    ASSERT_EQ(px.packing(), ColumnPacking::Delta);
+
+    // the same samples as the packed columns, expanded to doubles
+    std::vector<double> fy(y.size());
+    py.decode(0, fy.size(), fy.data());
+
+    Samples packed;
+    packed.packedX = &px;
+    packed.packedY = &py;
+    packed.count   = x.size();
+    LineEnvelope env, ref;
+    env.reset(0.0, 19999.0, 300);
+    ref.reset(0.0, 19999.0, 300);
+    ASSERT_TRUE(env.update(packed));
+    ASSERT_TRUE(ref.update(samplesOf(x, fy)));
+    EXPECT_EQ(env.indices(), ref.indices());
+}
+
+// ---- MarkerThinning ----------------------------------------------------
+
+TEST(MarkerThinning, OneMarkerPerPixel)
+{
+    // 100 samples in each of 4 pixels, plus samples outside the area
+    std::vector<double> x, y;
+    for (int i = 0; i < 400; ++i) {
+        x.push_back((i % 2) + 0.001 * (i % 100));
+        y.push_back(((i / 2) % 2) + 0.001 * (i % 100));
+    }
+    x.push_back(5.0);
+    y.push_back(0.5);
+    x.push_back(NaN);
+    y.push_back(0.5);
+
+    MarkerThinning thin;
+    thin.reset(0.0, 2.0, 0.0, 2.0, 2, 2);
+    thin.update(samplesOf(x, y));
+    const std::vector<std::size_t> expected = {0, 1, 2, 3};
+    EXPECT_EQ(thin.indices(), expected);
+}
+
+TEST(MarkerThinning, IncrementalUpdatesMatchFullScan)
+{
+    std::vector<double> x, y;
+    randomWalk(x, y, 10000);
+    MarkerThinning full, grown;
+    full.reset(0.0, 9999.0, -100.0, 100.0, 200, 100);
+    grown.reset(0.0, 9999.0, -100.0, 100.0, 200, 100);
+    full.update(samplesOf(x, y));
+
+    const double last = y.back();
+    for (std::size_t n = 0; n < x.size(); n += 999) {
+        Samples s = samplesOf(x, y);
+        s.count   = n;
+        grown.update(s);
+    }
+    y.back() = NaN;
+    grown.update(samplesOf(x, y));
+    y.back() = last; // the last sample may still change
+    grown.update(samplesOf(x, y));
+    EXPECT_EQ(grown.indices(), full.indices());
+    EXPECT_LT(full.indices().size(), x.size());
+}
+
+} // namespace
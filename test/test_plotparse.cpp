@@ -0,0 +1,299 @@
+// Unit tests for the byte-level plot data parsers
+// (src/plotparse.cpp), exercised without a GUI.
+
+#include "plotparse.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace PlotParse;
+
+namespace {
+
+TEST(PlotParseNumber, AcceptsDecimalAndScientific)
+{
+    double v = 0.0;
+    EXPECT_TRUE(toNumber("42", v));
+    EXPECT_DOUBLE_EQ(v, 42.0);
+    EXPECT_TRUE(toNumber("-1.5e-3", v));
+    EXPECT_DOUBLE_EQ(v, -1.5e-3);
+    EXPECT_TRUE(toNumber("+2.", v));
+    EXPECT_DOUBLE_EQ(v, 2.0);
+    EXPECT_TRUE(toNumber(".25", v));
+    EXPECT_DOUBLE_EQ(v, 0.25);
+    EXPECT_TRUE(toNumber("-inf", v));
+    EXPECT_TRUE(std::isinf(v));
+    EXPECT_TRUE(toNumber("nan", v));
+    EXPECT_TRUE(std::isnan(v));
+}
+
+TEST(PlotParseNumber, RejectsPartialNumbers)
+{
+    double v = 0.0;
+    EXPECT_FALSE(toNumber("", v));
+    EXPECT_FALSE(toNumber("+", v));
+    EXPECT_FALSE(toNumber("+-1", v));
+    EXPECT_FALSE(toNumber("1.5x", v));
+    EXPECT_FALSE(toNumber("1,5", v));
+    EXPECT_FALSE(toNumber("0x10", v));
+    EXPECT_FALSE(toNumber("Step", v));
+    EXPECT_FALSE(toNumber("1e400", v));
+}
+
+TEST(PlotParseCsv, HeaderAndRaggedLines)
+{
+    Columns c;
+    ASSERT_TRUE(parseCsv("\xEF\xBB\xBFStep, Temp ,Press\r\n"
+                         "0,300,1.0\r\n"
+                         "\r\n"
+                         "1,310\r\n"       // too few fields
+                         "2,abc,1.2\r\n"   // not a number
+                         "3,330,1.3,\r\n"  // trailing empty field
+                         "4, 340 ,1.4",    // no final newline
+                         c));
+    ASSERT_EQ(c.names.size(), 3U);
+    EXPECT_EQ(c.names[0], "Step");
+    EXPECT_EQ(c.names[1], "Temp");
+    ASSERT_EQ(c.columns.size(), 3U);
+    ASSERT_EQ(c.columns[0].size(), 2U);
+    EXPECT_DOUBLE_EQ(c.columns[0][1], 4.0);
+    EXPECT_DOUBLE_EQ(c.columns[1][1], 340.0);
+}
+
+TEST(PlotParseCsv, NumericFirstLineIsData)
+{
+    Columns c;
+    ASSERT_TRUE(parseCsv("\n0,1,2\n3,4,5\n", c));
+    EXPECT_TRUE(c.names.empty());
+    ASSERT_EQ(c.columns.size(), 3U);
+    ASSERT_EQ(c.columns[2].size(), 2U);
+    EXPECT_DOUBLE_EQ(c.columns[2][0], 2.0);
+    EXPECT_DOUBLE_EQ(c.columns[2][1], 5.0);
+}
+
+TEST(PlotParseCsv, NoDataIsError)
+{
+    Columns c;
+    EXPECT_FALSE(parseCsv("", c));
+    EXPECT_FALSE(parseCsv("a,b,c\n", c));
+    EXPECT_TRUE(c.columns.empty());
+    EXPECT_TRUE(c.names.empty());
+}
+
+TEST(PlotParseWhitespace, NamesFromLastComment)
+{
+    Columns c;
+    ASSERT_TRUE(parseWhitespace("# Time-averaged data for fix 1\n"
+                                "# TimeStep c_temp c_press\n"
+                                "Step Temp Press\n" // text header: skipped
+                                "  0  300  1.0\n"
+                                "# a comment within the data\n"
+                                " 10  310\n" // ragged: skipped
+                                " 20\t320  1.2\n",
+                                c));
+    ASSERT_EQ(c.names.size(), 3U);
+    EXPECT_EQ(c.names[0], "TimeStep");
+    EXPECT_EQ(c.names[2], "c_press");
+    ASSERT_EQ(c.columns.size(), 3U);
+    ASSERT_EQ(c.columns[0].size(), 2U);
+    EXPECT_DOUBLE_EQ(c.columns[0][1], 20.0);
+    EXPECT_DOUBLE_EQ(c.columns[2][1], 1.2);
+}
+
+TEST(PlotParseWhitespace, MismatchedCommentGivesNoNames)
+{
+    Columns c;
+    ASSERT_TRUE(parseWhitespace("# x y z\n1 2\n3 4\n", c));
+    EXPECT_TRUE(c.names.empty());
+    ASSERT_EQ(c.columns.size(), 2U);
+    EXPECT_EQ(c.columns[1].size(), 2U);
+    EXPECT_FALSE(parseWhitespace("# only comments\n\n", c));
+}
+
+// Chunks are split at arbitrary byte positions and moved to line starts: the
+// result must not depend on the number of chunks.
+TEST(PlotParseWhitespace, ChunkedParseMatchesSerial)
+{
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> value(-1.0e3, 1.0e3);
+    std::uniform_int_distribution<int> kind(0, 19);
+    // the first data line sets the number of columns
+    std::string text = "# Step v_a v_b\n0 0.0 0.0\n";
+    int rows         = 1;
+    for (int i = 0; i < 5000; ++i) {
+        switch (kind(gen)) {
+            case 0:
+                text += "# comment\n";
+                break;
+            case 1:
+                text += "1 2\n"; // ragged
+                break;
+            case 2:
+                text += "\n";
+                break;
+            default:
+                text += std::to_string(i) + "   " + std::to_string(value(gen)) + "\t" +
+                    std::to_string(value(gen)) + "\n";
+                ++rows;
+        }
+    }
+
+    Columns serial;
+    ASSERT_TRUE(parseWhitespace(text, serial, 1));
+    ASSERT_EQ(serial.columns.size(), 3U);
+    EXPECT_EQ(serial.columns[0].size(), static_cast<std::size_t>(rows));
+    for (int threads : {2, 3, 7, 64}) {
+        Columns chunked;
+        ASSERT_TRUE(parseWhitespace(text, chunked, threads));
+        EXPECT_EQ(chunked.names, serial.names);
+        EXPECT_EQ(chunked.columns, serial.columns) << threads << " threads";
+    }
+}
+
+TEST(PlotParseCsv, ChunkedParseMatchesSerial)
+{
+    std::string text = "a,b\n";
+    for (int i = 0; i < 3000; ++i)
+        text += std::to_string(i) + ((i % 17) ? "," : ",x") + std::to_string(0.5 * i) + "\n";
+
+    Columns serial;
+    ASSERT_TRUE(parseCsv(text, serial, 1));
+    for (int threads : {2, 5, 16}) {
+        Columns chunked;
+        ASSERT_TRUE(parseCsv(text, chunked, threads));
+        EXPECT_EQ(chunked.columns, serial.columns) << threads << " threads";
+    }
+}
+
+TEST(PlotParseSelect, SelectedColumnsMatchFullParse)
+{
+    std::string text = "# Step";
+    for (int c = 1; c < 40; ++c)
+        text += " c_" + std::to_string(c);
+    text += "\n";
+    for (int i = 0; i < 2000; ++i) {
+        text += std::to_string(i);
+        for (int c = 1; c < 40; ++c)
+            text += " " + std::to_string((0.5 * i) + c);
+        text += (i % 100) ? "\n" : "\n1 2 3\n"; // with ragged lines
+    }
+
+    Columns full;
+    ASSERT_TRUE(parseWhitespace(text, full, 1));
+    const Selection select{17, 0, 39};
+    for (int threads : {1, 3}) {
+        Columns part;
+        ASSERT_TRUE(parseWhitespace(text, part, threads, select));
+        EXPECT_EQ(part.names, (std::vector<std::string>{"c_17", "Step", "c_39"}));
+        ASSERT_EQ(part.columns.size(), 3U);
+        for (std::size_t i = 0; i < select.size(); ++i)
+            EXPECT_EQ(part.columns[i], full.columns[select[i]]) << threads << " threads";
+    }
+}
+
+TEST(PlotParseSelect, CsvSelectionAndInvalidIndices)
+{
+    const std::string text = "a,b,c\n1,2,3\n4,x,6\n7,8\n";
+    Columns c;
+    ASSERT_TRUE(parseCsv(text, c, 1, {2}));
+    EXPECT_EQ(c.names, (std::vector<std::string>{"c"}));
+    // only the selected fields must be numbers, but all lines need all fields
+    EXPECT_EQ(c.columns, (std::vector<std::vector<double>>{{3, 6}}));
+    EXPECT_FALSE(parseCsv(text, c, 1, {3}));
+    EXPECT_FALSE(parseCsv(text, c, 1, {0, 0}));
+    EXPECT_TRUE(c.columns.empty());
+}
+
+TEST(PlotParseSelect, ReadHeaderStopsAtTheFirstDataLine)
+{
+    std::vector<std::string> names;
+    EXPECT_EQ(readHeader("# comment\n# Step Temp Press\n0 300 1.0\nnot parsed\n", false, names),
+              3U);
+    EXPECT_EQ(names, (std::vector<std::string>{"Step", "Temp", "Press"}));
+    EXPECT_EQ(readHeader("Step,Temp\n", true, names), 2U);
+    EXPECT_EQ(names.size(), 2U);
+    EXPECT_EQ(readHeader("1,2,3\n", true, names), 3U);
+    EXPECT_TRUE(names.empty());
+    EXPECT_EQ(readHeader("# only comments\n", false, names), 0U);
+}
+
+TEST(PlotParseTail, PartialLinesWaitForTheirNewline)
+{
+    TailParser tail(false, 3);
+    std::vector<double> rows;
+    EXPECT_EQ(tail.feed("# Step Temp Press\n0 300 1.0\n10 31", rows), 1U);
+    EXPECT_EQ(tail.pending(), 5U);
+    EXPECT_EQ(tail.feed("0 1.", rows), 0U);
+    EXPECT_EQ(tail.feed("1\n20 320\n30 330 1.3\n", rows), 2U); // "20 320" is ragged
+    EXPECT_EQ(tail.pending(), 0U);
+    const std::vector<double> expected{0, 300, 1.0, 10, 310, 1.1, 30, 330, 1.3};
+    EXPECT_EQ(rows, expected);
+}
+
+TEST(PlotParseTail, SkipsLineCutByTheStartOffset)
+{
+    TailParser tail(true, 2);
+    std::vector<double> rows;
+    tail.reset(true);
+    EXPECT_EQ(tail.feed("5,2", rows), 0U); // rest of a line that was already loaded
+    EXPECT_EQ(tail.feed("\n6,2\n", rows), 1U);
+    EXPECT_EQ(rows, (std::vector<double>{6, 2}));
+
+    // starting right after a newline: the first "line" is empty
+    rows.clear();
+    tail.reset(true);
+    EXPECT_EQ(tail.feed("\n7,3\r\n", rows), 1U);
+    EXPECT_EQ(rows, (std::vector<double>{7, 3}));
+}
+
+// Feeding a file in arbitrary pieces gives the rows of the whole-file parser.
+TEST(PlotParseTail, PiecewiseFeedMatchesWholeFile)
+{
+    std::string text = "# Step c_1 c_2\n";
+    for (int i = 0; i < 500; ++i)
+        text += std::to_string(i) + " " + std::to_string(0.25 * i) + " -" + std::to_string(i) +
+            ((i % 50) ? "\n" : "\n# restart\n");
+
+    Columns whole;
+    ASSERT_TRUE(parseWhitespace(text, whole, 1));
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<std::size_t> piece(1, 40);
+    TailParser tail(false, 3);
+    std::vector<double> rows;
+    for (std::size_t pos = 0; pos < text.size();) {
+        const std::size_t n = std::min(piece(gen), text.size() - pos);
+        tail.feed(std::string_view(text).substr(pos, n), rows);
+        pos += n;
+    }
+    ASSERT_EQ(rows.size(), 3 * whole.columns[0].size());
+    for (std::size_t r = 0; r < whole.columns[0].size(); ++r)
+        for (std::size_t c = 0; c < 3; ++c)
+            EXPECT_EQ(rows[(3 * r) + c], whole.columns[c][r]);
+}
+
+TEST(PlotParseSniff, YamlAndJson)
+{
+    EXPECT_TRUE(looksLikeYaml("LAMMPS (2 Aug 2023)\n  keywords: ['Step', 'Temp']\n"));
+    EXPECT_TRUE(looksLikeYaml("---\n- {a: 1, b: 2}\n"));
+    EXPECT_FALSE(looksLikeYaml("# keywords: none\n1 2\n"));
+    EXPECT_FALSE(looksLikeYaml("- {1, 2}\n"));
+    EXPECT_TRUE(looksLikeJson(" \n[[1,2],[3,4]]"));
+    EXPECT_TRUE(looksLikeJson("{\"a\": [1]}"));
+    EXPECT_FALSE(looksLikeJson("# [1]\n"));
+}
+
+TEST(PlotParseSniff, Log)
+{
+    EXPECT_TRUE(looksLikeLog("LAMMPS (2 Aug 2023)\nPer MPI rank memory allocation (min/avg/max) = "
+                             "3 | 3 | 3 Mbytes\n   Step   Temp\n"));
+    EXPECT_TRUE(looksLikeLog("Memory usage per processor = 2.4 Mbytes\n"));
+    EXPECT_FALSE(looksLikeLog("print 'Per MPI rank memory allocation'\n"));
+    EXPECT_FALSE(looksLikeLog("# Step Temp\n0 300\n"));
+}
+
+} // namespace
@@ -0,0 +1,161 @@
+// Unit tests for the streaming thermo output parser (src/thermoparser.cpp),
+// exercised without a GUI.
+
+#include "thermoparser.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::string ONELINE_RUN = R"(Setting up Verlet run ...
+  Unit style    : lj
+  Current step  : 0
+  Time step     : 0.005
+Per MPI rank memory allocation (min/avg/max) = 2.644 | 2.644 | 2.644 Mbytes
+   Step          Temp          E_pair         E_mol          TotEng         Press
+         0   3             -6.7733681      0             -2.2744931     -3.7033504
+        50   1.6842865     -4.8082494      0             -2.2824513      5.5666131
+WARNING: Bond/angle/dihedral extent > half of periodic box length (src/domain.cpp:1202)
+       100   1.6712577     -4.7875609      0             -2.2813008      5.6613913
+Loop time of 0.0240203 on 1 procs for 100 steps with 4000 atoms
+
+Performance: 1798643.166 tau/day, 4163.063 timesteps/s
+)";
+
+const std::string YAML_RUN = R"(Per MPI rank memory allocation (min/avg/max) = 2.644 | 2.644 | 2.644 Mbytes
+---
+keywords: ['Step', 'Temp', 'E_pair', 'c_myPress[1]', ]
+data:
+  - [0, 3, -6.77336805325924, 1.5, ]
+  - [50, 1.68428650680889, -4.80824944105012, 2.5, ]
+...
+Loop time of 0.0240203 on 1 procs for 50 steps with 4000 atoms
+)";
+
+TEST(ThermoParser, OneLineBlock)
+{
+    ThermoParser parser;
+    parser.feed(ONELINE_RUN);
+    EXPECT_TRUE(parser.hasSeenBlock());
+    EXPECT_FALSE(parser.isTracking());
+    ASSERT_TRUE(parser.hasRows());
+
+    const auto rows = parser.takeRows();
+    ASSERT_EQ(rows.size(), 3u); // the warning inside the block is skipped
+    EXPECT_FALSE(parser.hasRows());
+
+    const std::vector<std::string> keywords = {"Step", "Temp", "E_pair", "E_mol", "TotEng",
+                                               "Press"};
+    EXPECT_EQ(*rows[0].keywords, keywords);
+    EXPECT_EQ(rows[0].keywords, rows[2].keywords); // shared per block
+    EXPECT_DOUBLE_EQ(rows[0].step, 0.0);
+    EXPECT_DOUBLE_EQ(rows[1].step, 50.0);
+    EXPECT_DOUBLE_EQ(rows[2].step, 100.0);
+    ASSERT_EQ(rows[1].values.size(), 6u);
+    EXPECT_DOUBLE_EQ(rows[1].values[1], 1.6842865);
+    EXPECT_DOUBLE_EQ(rows[2].values[5], 5.6613913);
+}
+
+TEST(ThermoParser, ChunksSplitAnywhere)
+{
+    // feeding the output one character at a time must give the same rows
+    ThermoParser whole, split;
+    whole.feed(ONELINE_RUN);
+    for (char c : ONELINE_RUN)
+        split.feed(std::string(1, c));
+
+    const auto expected = whole.takeRows();
+    const auto rows     = split.takeRows();
+    ASSERT_EQ(rows.size(), expected.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_EQ(*rows[i].keywords, *expected[i].keywords);
+        EXPECT_EQ(rows[i].values, expected[i].values);
+    }
+}
+
+TEST(ThermoParser, TrackingAndFinish)
+{
+    ThermoParser parser;
+    parser.feed("Per MPI rank memory allocation (min/avg/max) = 1 | 1 | 1 Mbytes\n"
+                "   Step          Temp\n"
+                "         0   1.5\n"
+                "        10   1.25");
+    EXPECT_TRUE(parser.isTracking());
+    EXPECT_EQ(parser.takeRows().size(), 1u); // the last line is still incomplete
+
+    parser.finish();
+    const auto rows = parser.takeRows();
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_DOUBLE_EQ(rows[0].step, 10.0);
+    EXPECT_DOUBLE_EQ(rows[0].values[1], 1.25);
+}
+
+TEST(ThermoParser, YamlBlock)
+{
+    ThermoParser parser;
+    parser.feed(YAML_RUN);
+    const auto rows = parser.takeRows();
+    ASSERT_EQ(rows.size(), 2u);
+    const std::vector<std::string> keywords = {"Step", "Temp", "E_pair", "c_myPress[1]"};
+    EXPECT_EQ(*rows[0].keywords, keywords);
+    EXPECT_DOUBLE_EQ(rows[1].step, 50.0);
+    EXPECT_DOUBLE_EQ(rows[1].values[3], 2.5);
+    EXPECT_FALSE(parser.isTracking());
+}
+
+TEST(ThermoParser, ConsecutiveRunsChangeKeywords)
+{
+    ThermoParser parser;
+    parser.feed(ONELINE_RUN);
+    parser.feed(YAML_RUN);
+    const auto rows = parser.takeRows();
+    ASSERT_EQ(rows.size(), 5u);
+    EXPECT_EQ(rows[2].keywords->size(), 6u);
+    EXPECT_EQ(rows[3].keywords->size(), 4u);
+    EXPECT_NE(rows[2].keywords, rows[3].keywords);
+}
+
+TEST(ThermoParser, IgnoresOutputOutsideBlocks)
+{
+    ThermoParser parser;
+    parser.feed("variable a equal 1\n"
+                "   Step          Temp\n"
+                "         0   1.5\n"
+                "1 2\n");
+    EXPECT_FALSE(parser.hasSeenBlock());
+    EXPECT_FALSE(parser.hasRows());
+}
+
+TEST(ThermoParser, UnsupportedBlocksAreSkipped)
+{
+    ThermoParser parser;
+    // multi-line format
+    parser.feed("Per MPI rank memory allocation (min/avg/max) = 1 | 1 | 1 Mbytes\n"
+                "------------ Step              0 ----- CPU =            0 (sec) -------------\n"
+                "TotEng   =        -2.2745 KinEng   =         4.4988 Temp     =         3.0000\n"
+                "Loop time of 0.1 on 1 procs for 0 steps with 10 atoms\n");
+    // no step column
+    parser.feed("Per MPI rank memory allocation (min/avg/max) = 1 | 1 | 1 Mbytes\n"
+                "   Temp          Press\n"
+                "   1.5           2.5\n"
+                "Loop time of 0.1 on 1 procs for 0 steps with 10 atoms\n");
+    EXPECT_FALSE(parser.hasSeenBlock());
+    EXPECT_FALSE(parser.hasRows());
+}
+
+TEST(ThermoParser, Reset)
+{
+    ThermoParser parser;
+    parser.feed(ONELINE_RUN.substr(0, ONELINE_RUN.find("Loop time")));
+    EXPECT_TRUE(parser.isTracking());
+    EXPECT_TRUE(parser.hasRows());
+    parser.reset();
+    EXPECT_FALSE(parser.isTracking());
+    EXPECT_FALSE(parser.hasSeenBlock());
+    EXPECT_FALSE(parser.hasRows());
+}
+
+} // namespace
@@ -32,6 +32,7 @@
  * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
  * -------------------------------------------------------------------------- */
 
+#include "lepton_mini/ArrayProgram.h"
 #include "lepton_mini/CustomFunction.h"
 #include "lepton_mini/ExpressionProgram.h"
 #include "lepton_mini/ExpressionTreeNode.h"
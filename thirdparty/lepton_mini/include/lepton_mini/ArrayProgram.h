@@ -0,0 +1,141 @@
+#ifndef LEPTON_ARRAY_PROGRAM_H_
+#define LEPTON_ARRAY_PROGRAM_H_
+
+/* -------------------------------------------------------------------------- *
+ *                                   Lepton                                   *
+ * -------------------------------------------------------------------------- *
+ * This is part of the Lepton expression parser originating from              *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2009-2018 Stanford University and the Authors.      *
+ * Authors: Peter Eastman                                                     *
+ * Contributors: LAMMPS-GUI developers (array evaluation)                     *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+#include "ExpressionProgram.h"
+#include "Operation.h"
+#include "windowsIncludes.h"
+#include <string>
+#include <vector>
+
+namespace LeptonMini {
+
+/**
+ * An ArrayProgram evaluates one or more ExpressionPrograms at many points at once.  The variables are bound to
+ * arguments when it is created, so no names are looked up during evaluation.  The programs are compiled into a
+ * flat sequence of instructions on numbered registers, each of which holds a whole block of points.  Every
+ * instruction is applied to the block in a tight loop, instead of dispatching every Operation for every point,
+ * which lets the compiler vectorize the arithmetic.
+ *
+ * While compiling, values that appear in several places, including in different programs (e.g. a model and
+ * its derivatives), are computed only once, Operations on constants are replaced by their results, values
+ * that are the same at all points are computed once per call of evaluate() instead of once per point, and
+ * registers are reused as soon as their values are no longer needed.  None of this changes the results,
+ * which are identical to those of ExpressionProgram::evaluate().
+ *
+ * Variables are either arrays, with one value per point, or scalars with the same value at all points
+ * (e.g. the parameters of a fit).  An ArrayProgram does not change during evaluation, so one object
+ * can be used by several threads at the same time.
+ */
+
+class LEPTON_EXPORT ArrayProgram {
+public:
+    /**
+     * The number of points evaluated together.
+     */
+    static const int BLOCK = 256;
+    /**
+     * Create an ArrayProgram that evaluates a single program.
+     *
+     * @param program          the program to evaluate
+     * @param arrayVariables   the names of the variables with one value per point
+     * @param scalarVariables  the names of the variables with the same value at all points
+     *
+     * If the program uses a variable that is in neither list, an exception is thrown.  A name that is
+     * in both lists is an array variable.
+     */
+    ArrayProgram(const ExpressionProgram& program, const std::vector<std::string>& arrayVariables,
+                 const std::vector<std::string>& scalarVariables = std::vector<std::string>());
+    /**
+     * Create an ArrayProgram that evaluates several programs together, sharing the values they have in
+     * common.  Each program is one output of the ArrayProgram.
+     *
+     * @param programs         the programs to evaluate
+     * @param arrayVariables   the names of the variables with one value per point
+     * @param scalarVariables  the names of the variables with the same value at all points
+     */
+    ArrayProgram(const std::vector<ExpressionProgram>& programs, const std::vector<std::string>& arrayVariables,
+                 const std::vector<std::string>& scalarVariables = std::vector<std::string>());
+    ArrayProgram(const ArrayProgram& program);
+    ~ArrayProgram();
+    ArrayProgram& operator=(const ArrayProgram& program);
+    /**
+     * Get the number of outputs, which is the number of programs it was created from.
+     */
+    int getNumOutputs() const;
+    /**
+     * Get the number of instructions left after compiling.
+     */
+    int getNumOperations() const;
+    /**
+     * Evaluate the first output at a number of points.
+     *
+     * @param count    the number of points
+     * @param arrays   the values of the array variables: one array of count values per variable,
+     *                 in the order they were given to the constructor
+     * @param scalars  the values of the scalar variables, in the order they were given to the constructor
+     * @param result   receives the count values of the expression
+     */
+    void evaluate(int count, const double* const* arrays, const double* scalars, double* result) const;
+    /**
+     * Evaluate all outputs at a number of points.
+     *
+     * @param count    the number of points
+     * @param arrays   the values of the array variables: one array of count values per variable,
+     *                 in the order they were given to the constructor
+     * @param scalars  the values of the scalar variables, in the order they were given to the constructor
+     * @param results  one array per output, which receives its count values
+     */
+    void evaluate(int count, const double* const* arrays, const double* scalars, double* const* results) const;
+private:
+    struct Instruction {
+        Operation::Id id;
+        std::vector<int> args;  // registers of the arguments
+        int target;             // register of the result
+        int variable;           // index of an array variable, or -1-index of a scalar variable
+        double value;           // value of a CONSTANT, or the operand of an ..._CONSTANT Operation
+        Operation* custom;      // owned copy of a CUSTOM Operation, otherwise NULL
+    };
+    void compile(const std::vector<const ExpressionProgram*>& programs, const std::vector<std::string>& arrayVariables,
+                 const std::vector<std::string>& scalarVariables);
+    void execute(const Instruction& in, int start, int count, const double* const* arrays, const double* scalars,
+                 double* registers, double* args) const;
+    std::vector<Instruction> prologue;  // the values that are the same at all points, once per call
+    std::vector<Instruction> body;      // all other values, once per block of points
+    std::vector<int> outputs;           // registers of the outputs
+    int numRegisters, maxArgs;
+};
+
+} // namespace LeptonMini
+
+#endif /*LEPTON_ARRAY_PROGRAM_H_*/
@@ -0,0 +1,484 @@
+/* -------------------------------------------------------------------------- *
+ *                                   Lepton                                   *
+ * -------------------------------------------------------------------------- *
+ * This is part of the Lepton expression parser originating from              *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2009-2018 Stanford University and the Authors.      *
+ * Authors: Peter Eastman                                                     *
+ * Contributors: LAMMPS-GUI developers (array evaluation)                     *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+#include "lepton_mini/ArrayProgram.h"
+#include "lepton_mini/Exception.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+
+using namespace LeptonMini;
+using namespace std;
+
+const int ArrayProgram::BLOCK;
+
+namespace {
+
+/**
+ * A value computed by an ArrayProgram, before it is assigned a register.
+ */
+struct Value {
+    const Operation* op;    // the Operation computing it, or NULL for a folded constant
+    Operation::Id id;
+    vector<int> args;       // indices of the values of the arguments
+    int variable;
+    double value;
+    bool uniform;           // whether it is the same at all points
+};
+
+/**
+ * Values with equal keys are equal at all points.
+ */
+struct Key {
+    int id, aux;            // aux is the variable, or the index of a distinct CUSTOM Operation
+    unsigned long long bits;
+    vector<int> args;
+    bool operator<(const Key& key) const {
+        if (id != key.id)
+            return id < key.id;
+        if (aux != key.aux)
+            return aux < key.aux;
+        if (bits != key.bits)
+            return bits < key.bits;
+        return args < key.args;
+    }
+};
+
+// compare constants by their bits, so that 0 and -0 stay distinct
+unsigned long long bitsOf(double value) {
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double getOperand(const Operation& op) {
+    switch (op.getId()) {
+        case Operation::CONSTANT:
+            return dynamic_cast<const Operation::Constant&>(op).getValue();
+        case Operation::ADD_CONSTANT:
+            return dynamic_cast<const Operation::AddConstant&>(op).getValue();
+        case Operation::MULTIPLY_CONSTANT:
+            return dynamic_cast<const Operation::MultiplyConstant&>(op).getValue();
+        case Operation::POWER_CONSTANT:
+            return dynamic_cast<const Operation::PowerConstant&>(op).getValue();
+        default:
+            return 0.0;
+    }
+}
+
+// the same repeated multiplication as Operation::PowerConstant::evaluate()
+double intPower(double base, int exponent) {
+    if (exponent < 0) {
+        exponent = -exponent;
+        base = 1.0/base;
+    }
+    double result = 1.0;
+    while (exponent != 0) {
+        if ((exponent&1) == 1)
+            result *= base;
+        base *= base;
+        exponent = exponent>>1;
+    }
+    return result;
+}
+
+} // namespace
+
+ArrayProgram::ArrayProgram(const ExpressionProgram& program, const vector<string>& arrayVariables,
+                           const vector<string>& scalarVariables) : numRegisters(0), maxArgs(0) {
+    compile(vector<const ExpressionProgram*>(1, &program), arrayVariables, scalarVariables);
+}
+
+ArrayProgram::ArrayProgram(const vector<ExpressionProgram>& programs, const vector<string>& arrayVariables,
+                           const vector<string>& scalarVariables) : numRegisters(0), maxArgs(0) {
+    vector<const ExpressionProgram*> list;
+    for (int i = 0; i < (int) programs.size(); i++)
+        list.push_back(&programs[i]);
+    compile(list, arrayVariables, scalarVariables);
+}
+
+ArrayProgram::ArrayProgram(const ArrayProgram& program) : numRegisters(0), maxArgs(0) {
+    *this = program;
+}
+
+ArrayProgram::~ArrayProgram() {
+    for (int i = 0; i < (int) prologue.size(); i++)
+        delete prologue[i].custom;
+    for (int i = 0; i < (int) body.size(); i++)
+        delete body[i].custom;
+}
+
+ArrayProgram& ArrayProgram::operator=(const ArrayProgram& program) {
+    if (this == &program)
+        return *this;
+    for (int i = 0; i < (int) prologue.size(); i++)
+        delete prologue[i].custom;
+    for (int i = 0; i < (int) body.size(); i++)
+        delete body[i].custom;
+    prologue = program.prologue;
+    body = program.body;
+    for (int i = 0; i < (int) prologue.size(); i++)
+        if (prologue[i].custom != NULL)
+            prologue[i].custom = prologue[i].custom->clone();
+    for (int i = 0; i < (int) body.size(); i++)
+        if (body[i].custom != NULL)
+            body[i].custom = body[i].custom->clone();
+    outputs = program.outputs;
+    numRegisters = program.numRegisters;
+    maxArgs = program.maxArgs;
+    return *this;
+}
+
+int ArrayProgram::getNumOutputs() const {
+    return (int) outputs.size();
+}
+
+int ArrayProgram::getNumOperations() const {
+    return (int) (prologue.size()+body.size());
+}
+
+void ArrayProgram::compile(const vector<const ExpressionProgram*>& programs, const vector<string>& arrayVariables,
+                           const vector<string>& scalarVariables) {
+    // array variables take precedence over scalar variables of the same name
+    map<string, int> variables;
+    for (int i = 0; i < (int) scalarVariables.size(); i++)
+        variables[scalarVariables[i]] = -1-i;
+    for (int i = 0; i < (int) arrayVariables.size(); i++)
+        variables[arrayVariables[i]] = i;
+
+    // Run each program on a stack of values instead of numbers.  Every distinct value is created once,
+    // and an Operation whose arguments are all constants is replaced by its result.
+    vector<Value> values;
+    map<Key, int> known;
+    vector<const Operation*> customs;
+    const map<string, double> noVariables;
+    for (int p = 0; p < (int) programs.size(); p++) {
+        const ExpressionProgram& program = *programs[p];
+        vector<int> stack;
+        for (int i = 0; i < program.getNumOperations(); i++) {
+            const Operation& op = program.getOperation(i);
+            const int numArgs = op.getNumArguments();
+            Value value;
+            value.op = &op;
+            value.id = op.getId();
+            value.variable = 0;
+            value.value = getOperand(op);
+            value.uniform = true;
+            for (int j = 0; j < numArgs; j++)
+                value.args.push_back(stack[stack.size()-1-j]);
+            stack.resize(stack.size()-numArgs);
+            Key key;
+            key.aux = 0;
+            if (value.id == Operation::VARIABLE) {
+                map<string, int>::const_iterator iter = variables.find(op.getName());
+                if (iter == variables.end())
+                    throw Exception("No value specified for variable "+op.getName());
+                value.variable = iter->second;
+                value.uniform = (value.variable < 0);
+                key.aux = value.variable;
+            }
+            else if (value.id != Operation::CONSTANT) {
+                bool constant = true;
+                for (int j = 0; j < numArgs; j++) {
+                    constant = constant && (values[value.args[j]].id == Operation::CONSTANT);
+                    value.uniform = value.uniform && values[value.args[j]].uniform;
+                }
+                if (constant) {
+                    vector<double> args(numArgs);
+                    for (int j = 0; j < numArgs; j++)
+                        args[j] = values[value.args[j]].value;
+                    value.value = op.evaluate(numArgs == 0 ? NULL : &args[0], noVariables);
+                    value.op = NULL;
+                    value.id = Operation::CONSTANT;
+                    value.args.clear();
+                }
+            }
+            if (value.id == Operation::CUSTOM) {
+                key.aux = 0;
+                while (key.aux < (int) customs.size() && *customs[key.aux] != op)
+                    key.aux++;
+                if (key.aux == (int) customs.size())
+                    customs.push_back(&op);
+            }
+            key.id = value.id;
+            key.bits = bitsOf(value.value);
+            key.args = value.args;
+            if ((value.id == Operation::ADD || value.id == Operation::MULTIPLY) && key.args[0] > key.args[1])
+                swap(key.args[0], key.args[1]);
+            pair<map<Key, int>::iterator, bool> entry = known.insert(make_pair(key, (int) values.size()));
+            if (entry.second)
+                values.push_back(value);
+            stack.push_back(entry.first->second);
+        }
+        outputs.push_back(stack.back());
+    }
+
+    // drop the values that no output depends on, e.g. the arguments of folded Operations
+    vector<bool> live(values.size(), false);
+    for (int i = 0; i < (int) outputs.size(); i++)
+        live[outputs[i]] = true;
+    for (int i = (int) values.size()-1; i >= 0; i--)
+        if (live[i])
+            for (int j = 0; j < (int) values[i].args.size(); j++)
+                live[values[i].args[j]] = true;
+
+    // The values that are the same at all points keep their registers.  The other registers are
+    // released after the last use of their value, but not before the result of that use is stored,
+    // so that no instruction writes to one of its own arguments.
+    vector<int> registers(values.size(), -1);
+    vector<int> lastUse(values.size(), -1);
+    for (int i = 0; i < (int) values.size(); i++) {
+        if (!live[i])
+            continue;
+        if (values[i].uniform)
+            registers[i] = numRegisters++;
+        for (int j = 0; j < (int) values[i].args.size(); j++)
+            lastUse[values[i].args[j]] = i;
+    }
+    for (int i = 0; i < (int) outputs.size(); i++)
+        lastUse[outputs[i]] = (int) values.size();
+    vector<int> available;
+    for (int i = 0; i < (int) values.size(); i++) {
+        if (!live[i])
+            continue;
+        const Value& value = values[i];
+        if (!value.uniform) {
+            if (available.empty())
+                registers[i] = numRegisters++;
+            else {
+                registers[i] = available.back();
+                available.pop_back();
+            }
+            for (int j = 0; j < (int) value.args.size(); j++) {
+                const int arg = value.args[j];
+                if (!values[arg].uniform && lastUse[arg] == i &&
+                        find(value.args.begin(), value.args.begin()+j, arg) == value.args.begin()+j)
+                    available.push_back(registers[arg]);
+            }
+        }
+        Instruction in;
+        in.id = value.id;
+        for (int j = 0; j < (int) value.args.size(); j++)
+            in.args.push_back(registers[value.args[j]]);
+        in.target = registers[i];
+        in.variable = value.variable;
+        in.value = value.value;
+        in.custom = (value.id == Operation::CUSTOM ? value.op->clone() : NULL);
+        maxArgs = max(maxArgs, (int) in.args.size());
+        (value.uniform ? prologue : body).push_back(in);
+    }
+    for (int i = 0; i < (int) outputs.size(); i++)
+        outputs[i] = registers[outputs[i]];
+}
+
+void ArrayProgram::evaluate(int count, const double* const* arrays, const double* scalars, double* result) const {
+    vector<double*> results(outputs.size(), (double*) NULL);
+    results[0] = result;
+    // only the first output is copied out
+    ArrayProgram::evaluate(count, arrays, scalars, &results[0]);
+}
+
+void ArrayProgram::evaluate(int count, const double* const* arrays, const double* scalars, double* const* results) const {
+    if (count <= 0)
+        return;
+    vector<double> registers(numRegisters*BLOCK);
+    vector<double> args(maxArgs+1);
+
+    // the values that are the same at all points are computed once and then fill their registers
+    for (int i = 0; i < (int) prologue.size(); i++)
+        execute(prologue[i], 0, 1, arrays, scalars, &registers[0], &args[0]);
+    for (int i = 0; i < (int) prologue.size(); i++) {
+        double* r = &registers[prologue[i].target*BLOCK];
+        fill(r+1, r+BLOCK, r[0]);
+    }
+
+    for (int start = 0; start < count; start += BLOCK) {
+        const int n = min(BLOCK, count-start);
+        for (int i = 0; i < (int) body.size(); i++)
+            execute(body[i], start, n, arrays, scalars, &registers[0], &args[0]);
+        for (int i = 0; i < (int) outputs.size(); i++) {
+            if (results[i] == NULL)
+                continue;
+            const double* value = &registers[outputs[i]*BLOCK];
+            copy(value, value+n, results[i]+start);
+        }
+    }
+}
+
+void ArrayProgram::execute(const Instruction& in, int start, int n, const double* const* arrays, const double* scalars,
+                           double* registers, double* args) const {
+    double* r = registers+in.target*BLOCK;
+    const int numArgs = (int) in.args.size();
+    const double* a = (numArgs > 0 ? registers+in.args[0]*BLOCK : NULL);
+    const double* b = (numArgs > 1 ? registers+in.args[1]*BLOCK : NULL);
+    const double* c = (numArgs > 2 ? registers+in.args[2]*BLOCK : NULL);
+    const double v = in.value;
+    switch (in.id) {
+        case Operation::CONSTANT:
+            fill(r, r+n, v);
+            break;
+        case Operation::VARIABLE:
+            if (in.variable >= 0)
+                copy(arrays[in.variable]+start, arrays[in.variable]+start+n, r);
+            else
+                fill(r, r+n, scalars[-1-in.variable]);
+            break;
+        case Operation::CUSTOM: {
+            const map<string, double> noVariables;
+            for (int k = 0; k < n; k++) {
+                for (int j = 0; j < numArgs; j++)
+                    args[j] = registers[in.args[j]*BLOCK+k];
+                r[k] = in.custom->evaluate(args, noVariables);
+            }
+            break;
+        }
+        case Operation::ADD:
+            for (int k = 0; k < n; k++) r[k] = a[k]+b[k];
+            break;
+        case Operation::SUBTRACT:
+            for (int k = 0; k < n; k++) r[k] = a[k]-b[k];
+            break;
+        case Operation::MULTIPLY:
+            for (int k = 0; k < n; k++) r[k] = a[k]*b[k];
+            break;
+        case Operation::DIVIDE:
+            for (int k = 0; k < n; k++) r[k] = a[k]/b[k];
+            break;
+        case Operation::POWER:
+            for (int k = 0; k < n; k++) r[k] = pow(a[k], b[k]);
+            break;
+        case Operation::NEGATE:
+            for (int k = 0; k < n; k++) r[k] = -a[k];
+            break;
+        case Operation::SQRT:
+            for (int k = 0; k < n; k++) r[k] = sqrt(a[k]);
+            break;
+        case Operation::EXP:
+            for (int k = 0; k < n; k++) r[k] = exp(a[k]);
+            break;
+        case Operation::LOG:
+            for (int k = 0; k < n; k++) r[k] = log(a[k]);
+            break;
+        case Operation::SIN:
+            for (int k = 0; k < n; k++) r[k] = sin(a[k]);
+            break;
+        case Operation::COS:
+            for (int k = 0; k < n; k++) r[k] = cos(a[k]);
+            break;
+        case Operation::SEC:
+            for (int k = 0; k < n; k++) r[k] = 1.0/cos(a[k]);
+            break;
+        case Operation::CSC:
+            for (int k = 0; k < n; k++) r[k] = 1.0/sin(a[k]);
+            break;
+        case Operation::TAN:
+            for (int k = 0; k < n; k++) r[k] = tan(a[k]);
+            break;
+        case Operation::COT:
+            for (int k = 0; k < n; k++) r[k] = 1.0/tan(a[k]);
+            break;
+        case Operation::ASIN:
+            for (int k = 0; k < n; k++) r[k] = asin(a[k]);
+            break;
+        case Operation::ACOS:
+            for (int k = 0; k < n; k++) r[k] = acos(a[k]);
+            break;
+        case Operation::ATAN:
+            for (int k = 0; k < n; k++) r[k] = atan(a[k]);
+            break;
+        case Operation::ATAN2:
+            for (int k = 0; k < n; k++) r[k] = atan2(a[k], b[k]);
+            break;
+        case Operation::SINH:
+            for (int k = 0; k < n; k++) r[k] = sinh(a[k]);
+            break;
+        case Operation::COSH:
+            for (int k = 0; k < n; k++) r[k] = cosh(a[k]);
+            break;
+        case Operation::TANH:
+            for (int k = 0; k < n; k++) r[k] = tanh(a[k]);
+            break;
+        case Operation::ERF:
+            for (int k = 0; k < n; k++) r[k] = erf(a[k]);
+            break;
+        case Operation::ERFC:
+            for (int k = 0; k < n; k++) r[k] = erfc(a[k]);
+            break;
+        case Operation::STEP:
+            for (int k = 0; k < n; k++) r[k] = (a[k] >= 0.0 ? 1.0 : 0.0);
+            break;
+        case Operation::DELTA:
+            for (int k = 0; k < n; k++) r[k] = (a[k] == 0.0 ? 1.0 : 0.0);
+            break;
+        case Operation::SQUARE:
+            for (int k = 0; k < n; k++) r[k] = a[k]*a[k];
+            break;
+        case Operation::CUBE:
+            for (int k = 0; k < n; k++) r[k] = a[k]*a[k]*a[k];
+            break;
+        case Operation::RECIPROCAL:
+            for (int k = 0; k < n; k++) r[k] = 1.0/a[k];
+            break;
+        case Operation::ADD_CONSTANT:
+            for (int k = 0; k < n; k++) r[k] = a[k]+v;
+            break;
+        case Operation::MULTIPLY_CONSTANT:
+            for (int k = 0; k < n; k++) r[k] = a[k]*v;
+            break;
+        case Operation::POWER_CONSTANT:
+            if (v == (int) v) {
+                for (int k = 0; k < n; k++) r[k] = intPower(a[k], (int) v);
+            }
+            else {
+                for (int k = 0; k < n; k++) r[k] = pow(a[k], v);
+            }
+            break;
+        case Operation::MIN:
+            // parens around (std::min) are workaround for horrible microsoft max/min macro trouble
+            for (int k = 0; k < n; k++) r[k] = (std::min)(a[k], b[k]);
+            break;
+        case Operation::MAX:
+            for (int k = 0; k < n; k++) r[k] = (std::max)(a[k], b[k]);
+            break;
+        case Operation::ABS:
+            for (int k = 0; k < n; k++) r[k] = fabs(a[k]);
+            break;
+        case Operation::FLOOR:
+            for (int k = 0; k < n; k++) r[k] = floor(a[k]);
+            break;
+        case Operation::CEIL:
+            for (int k = 0; k < n; k++) r[k] = ceil(a[k]);
+            break;
+        case Operation::SELECT:
+            for (int k = 0; k < n; k++) r[k] = (a[k] != 0.0 ? b[k] : c[k]);
+            break;
+    }
+}